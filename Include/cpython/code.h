@@ -13,6 +13,7 @@ typedef uint16_t _Py_CODEUNIT;
 #endif
 
 typedef struct _PyOpcache _PyOpcache;
+typedef struct _PyExceptionTable _PyExceptionTable;
 
 /* Bytecode object */
 struct PyCodeObject {
@@ -61,6 +62,28 @@ struct PyCodeObject {
     _PyOpcache *co_opcache;
     int co_opcache_flag;  // used to determine when create a cache.
     unsigned char co_opcache_size;  // length of co_opcache.
+
+    // Private copy of co_code, created together with the opcache, in which
+    // the interpreter rewrites instructions to their specialized forms
+    // (see Python/specialize.c).  NULL if the code object is not hot yet
+    // or has nothing to specialize.
+    _Py_CODEUNIT *co_quickened;
+
+    // Try blocks of co_code, computed together with co_quickened.  Frames
+    // running co_quickened find their exception handlers in this table
+    // rather than on the frame block stack (see Objects/codeobject.c).
+    // NULL if the code has no try blocks or if they could not be analyzed.
+    _PyExceptionTable *co_exceptiontable;
+
+    // Machine code compiled from the bytecode with -X jit (see
+    // Python/jit.c), or NULL.  co_jit_warmup counts the calls and loop
+    // iterations of the code until it is compiled.
+    struct _PyJITCode *co_jit;
+    int co_jit_warmup;
+
+    // Number of times the code was entered while execution statistics
+    // were collected (see sys._stats_on()).
+    uint64_t co_stats_calls;
 };
 
 /* Masks for co_flags above */
@@ -38,6 +38,8 @@ struct _frame {
     int f_lineno;               /* Current line number */
     int f_iblock;               /* index in f_blockstack */
     char f_executing;           /* whether the frame is still executing */
+    char f_quickened;           /* whether the frame runs co_quickened */
+    char f_stackalloc;          /* whether it lives in the frame stack */
     PyTryBlock f_blockstack[CO_MAXBLOCKS]; /* for try and loop blocks */
     PyObject *f_localsplus[1];  /* locals+stack, dynamically sized */
 };
@@ -56,6 +58,12 @@ PyAPI_FUNC(PyFrameObject *) PyFrame_New(PyThreadState *, PyCodeObject *,
 PyFrameObject* _PyFrame_New_NoTrack(PyThreadState *, PyCodeObject *,
                                     PyObject *, PyObject *);
 
+/* Like _PyFrame_New_NoTrack(), but allocate the frame from the frame stack
+   of the thread state.  This is for the frames of calls made by the
+   interpreter, which are mostly deallocated in LIFO order. */
+PyFrameObject* _PyFrame_NewOnStack_NoTrack(PyThreadState *, PyCodeObject *,
+                                           PyObject *, PyObject *);
+
 
 /* The rest of the interface is specific for frame objects */
 
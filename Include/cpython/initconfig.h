@@ -419,6 +419,14 @@ typedef struct {
 
        _PyConfig_Write() initializes Py_GetArgcArgv() to this list. */
     PyWideStringList _orig_argv;
+
+    /* Compile hot code to machine code?
+       0 by default, set to 1 by -X jit and PYTHONJIT */
+    int _use_jit;
+
+    /* Collect execution statistics from the start, and write them to
+       stderr at exit?  0 by default, set to 1 by -X pystats */
+    int _pystats;
 } PyConfig;
 
 PyAPI_FUNC(void) PyConfig_InitPythonConfig(PyConfig *config);
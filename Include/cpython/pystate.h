@@ -8,6 +8,10 @@ PyAPI_FUNC(int) _PyInterpreterState_RequiresIDRef(PyInterpreterState *);
 PyAPI_FUNC(void) _PyInterpreterState_RequireIDRef(PyInterpreterState *, int);
 
 PyAPI_FUNC(PyObject *) _PyInterpreterState_GetMainModule(PyInterpreterState *);
+PyAPI_FUNC(int) _PyInterpreterState_HasOwnGIL(PyInterpreterState *);
+PyAPI_FUNC(int) _PyInterpreterState_SetRunningMain(PyInterpreterState *);
+PyAPI_FUNC(void) _PyInterpreterState_SetNotRunningMain(PyInterpreterState *);
+PyAPI_FUNC(int) _PyInterpreterState_IsRunningMain(PyInterpreterState *);
 
 /* State unique per thread */
 
@@ -43,6 +47,28 @@ typedef struct _err_stackitem {
 } _PyErr_StackItem;
 
 
+/* GIL statistics of a thread, see sys._getgilstats().
+   Times are in nanoseconds. */
+typedef struct {
+    /* Number of times the thread took the GIL, and how many of them
+       had to wait for another thread to drop it */
+    unsigned long long acquisitions;
+    unsigned long long contended;
+    /* Number of times the thread asked the holder to drop the GIL,
+       and was itself forced to drop it on request of another thread */
+    unsigned long long drop_requests;
+    unsigned long long forced_drops;
+    _PyTime_t wait_time;
+    _PyTime_t hold_time;
+    /* Longest time the GIL was held, with the code object and line which
+       were running when it was dropped.  These are only recorded when the
+       thread runs again (max_hold_pending is set until then). */
+    _PyTime_t max_hold_time;
+    PyObject *max_hold_code;
+    int max_hold_lineno;
+    int max_hold_pending;
+} _PyGILStats;
+
 // The PyThreadState typedef is in Include/pystate.h.
 struct _ts {
     /* See Python/ceval.c for comments explaining most fields */
@@ -132,6 +158,14 @@ struct _ts {
     /* Unique thread state id. */
     uint64_t id;
 
+    /* Chunk of memory the frames of calls are allocated from
+       (see Objects/frameobject.c) */
+    struct _PyFrameChunk *frame_stack;
+
+    _PyGILStats gil_stats;
+    /* Priority used by the priority GIL scheduling mode */
+    int gil_priority;
+
     /* XXX signal handlers should also be here */
 
 };
@@ -169,6 +203,10 @@ PyAPI_FUNC(PyInterpreterState *) _PyGILState_GetInterpreterStateUnsafe(void);
 */
 PyAPI_FUNC(PyObject *) _PyThread_CurrentFrames(void);
 
+/* The implementation of sys._getgilstats().  Return a dict mapping each
+   thread's thread id of the current interpreter to its GIL statistics. */
+PyAPI_FUNC(PyObject *) _PyThread_GILStats(void);
+
 /* Routines for advanced debuggers, requested by David Beazley.
    Don't use unless you know what you are doing! */
 PyAPI_FUNC(PyInterpreterState *) PyInterpreterState_Main(void);
@@ -34,6 +34,13 @@ PyAPI_FUNC(void) _PyEval_SetCoroutineOriginTrackingDepth(
 /* Private function */
 void _PyEval_Fini(void);
 
+/* Execution statistics (sys._stats_on() and -X pystats) */
+extern int _PyEval_SetStats(PyThreadState *tstate, int on);
+extern void _PyEval_ClearStats(PyInterpreterState *interp);
+extern void _PyEval_FiniStats(PyInterpreterState *interp);
+extern PyObject * _PyEval_GetStats(PyThreadState *tstate);
+extern void _PyEval_PrintStats(PyThreadState *tstate);
+
 static inline PyObject*
 _PyEval_EvalFrame(PyThreadState *tstate, PyFrameObject *f, int throwflag)
 {
@@ -50,16 +57,15 @@ extern PyObject *_PyEval_EvalCode(
     PyObject *kwdefs, PyObject *closure,
     PyObject *name, PyObject *qualname);
 
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
 extern int _PyEval_ThreadsInitialized(PyInterpreterState *interp);
-#else
-extern int _PyEval_ThreadsInitialized(struct pyruntimestate *runtime);
-#endif
-extern PyStatus _PyEval_InitGIL(PyThreadState *tstate);
+extern PyStatus _PyEval_InitGIL(PyThreadState *tstate, int own_gil);
 extern void _PyEval_FiniGIL(PyThreadState *tstate);
 
 extern void _PyEval_ReleaseLock(PyThreadState *tstate);
 
+extern void _PyEval_SetGILMode(int mode);
+extern int _PyEval_GetGILMode(void);
+
 
 /* --- _Py_EnterRecursiveCall() ----------------------------------------- */
 
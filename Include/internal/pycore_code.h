@@ -3,23 +3,112 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
- 
+
 typedef struct {
     PyObject *ptr;  /* Cached pointer (borrowed reference) */
     uint64_t globals_ver;  /* ma_version of global dict */
     uint64_t builtins_ver; /* ma_version of builtin dict */
 } _PyOpcache_LoadGlobal;
 
+typedef struct {
+    unsigned int tp_version;  /* tp_version_tag of the type of the owner */
+    Py_ssize_t index;  /* Index in the keys of the dict, or slot offset */
+} _PyOpcache_Attr;
+
 struct _PyOpcache {
     union {
         _PyOpcache_LoadGlobal lg;
+        _PyOpcache_Attr attr;
     } u;
     char optimized;
+    /* For adaptive instructions: number of executions left before trying
+       to specialize again.  For specialized instructions: number of guard
+       failures left before going back to the adaptive instruction. */
+    uint16_t counter;
+};
+
+/* A try block: the static equivalent of the PyTryBlock pushed by
+   SETUP_FINALLY, SETUP_WITH and SETUP_ASYNC_WITH. */
+typedef struct {
+    int handler;  /* Offset of the handler in bytes, like b_handler */
+    int level;    /* Value stack level, like b_level */
+    int parent;   /* Index of the enclosing try block, or -1 */
+} _PyTryBlockInfo;
+
+/* Instructions at offsets start <= offset < end (in bytes) are in the try
+   block at index block, which is the innermost one. */
+typedef struct {
+    int start;
+    int end;
+    int block;
+} _PyExceptionRange;
+
+struct _PyExceptionTable {
+    int nblocks;
+    int nranges;
+    _PyTryBlockInfo *blocks;
+    _PyExceptionRange *ranges;  /* Sorted and non-overlapping */
 };
 
 /* Private API */
 int _PyCode_InitOpcache(PyCodeObject *co);
 
+/* Return the index of the innermost try block of co->co_exceptiontable
+   containing the instruction at offset, or -1. */
+int _PyCode_FindTryBlock(PyCodeObject *co, int offset);
+
+
+/* Specialization (Python/specialize.c) */
+
+#ifdef WORDS_BIGENDIAN
+#  define _Py_MAKECODEUNIT(opcode, oparg) ((_Py_CODEUNIT)(((opcode) << 8) | (oparg)))
+#else
+#  define _Py_MAKECODEUNIT(opcode, oparg) ((_Py_CODEUNIT)((opcode) | ((oparg) << 8)))
+#endif
+
+/* Replace the opcode of an instruction, keeping its argument */
+#define _Py_SET_OPCODE(word, opcode) \
+    ((word) = _Py_MAKECODEUNIT((opcode), _Py_OPARG(word)))
+
+/* Executions of an adaptive instruction to skip after a failed attempt
+   to specialize it. */
+#define _Py_ADAPTIVE_BACKOFF 64
+
+/* Guard failures tolerated by a specialized instruction before it is
+   turned back into its adaptive form. */
+#define _Py_SPECIALIZED_MISS_BUDGET 16
+
+/* Flags that select the calling convention of a builtin */
+#define _Py_METH_CALL_FLAGS \
+    (METH_VARARGS | METH_KEYWORDS | METH_NOARGS | METH_O | \
+     METH_FASTCALL | METH_METHOD)
+
+/* Maps an opcode emitted by the compiler to its adaptive form, or to 0
+   if the instruction has no specialized forms. */
+extern const unsigned char _PyOpcode_Adaptive[256];
+
+/* Replace the first instruction of each frequent pair of instructions in
+   instrs by the superinstruction that runs both.  Return the number of
+   superinstructions. */
+Py_ssize_t _Py_InsertSuperinstructions(_Py_CODEUNIT *instrs, Py_ssize_t n);
+
+/* Each _Py_Specialize_XXX() function rewrites the adaptive instruction
+   at *instr to one of its specialized forms and returns 0, or leaves it
+   alone, sets the cache counter to back off and returns -1. */
+int _Py_Specialize_BinaryAdd(PyObject *left, PyObject *right,
+                             _Py_CODEUNIT *instr, _PyOpcache *cache);
+int _Py_Specialize_CompareOp(PyObject *left, PyObject *right,
+                             _Py_CODEUNIT *instr, _PyOpcache *cache);
+int _Py_Specialize_ForIter(PyObject *iter,
+                           _Py_CODEUNIT *instr, _PyOpcache *cache);
+int _Py_Specialize_CallFunction(PyObject *callable, int nargs,
+                                _Py_CODEUNIT *instr, _PyOpcache *cache);
+int _Py_Specialize_CallMethod(PyObject *meth, PyObject *self, int nargs,
+                              _Py_CODEUNIT *instr, _PyOpcache *cache);
+int _Py_Specialize_LoadAttr(PyObject *owner, PyObject *name,
+                            _Py_CODEUNIT *instr, _PyOpcache *cache);
+int _Py_Specialize_StoreAttr(PyObject *owner, PyObject *name,
+                             _Py_CODEUNIT *instr, _PyOpcache *cache);
 
 #ifdef __cplusplus
 }
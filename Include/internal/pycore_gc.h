@@ -40,10 +40,20 @@ typedef struct {
 #define _PyGC_PREV_SHIFT           (2)
 #define _PyGC_PREV_MASK            (((uintptr_t) -1) << _PyGC_PREV_SHIFT)
 
+/* Bit flags for _gc_next */
+/* Bit 1 is set on objects of the oldest generation already reached by the
+   incremental collection in progress, and on frozen objects when incremental
+   collection is enabled.  It is kept when the object is moved to another
+   list. */
+#define _PyGC_NEXT_MASK_VISITED    (2)
+
 // Lowest bit of _gc_next is used for flags only in GC.
 // But it is always 0 for normal code.
-#define _PyGCHead_NEXT(g)        ((PyGC_Head*)(g)->_gc_next)
-#define _PyGCHead_SET_NEXT(g, p) ((g)->_gc_next = (uintptr_t)(p))
+#define _PyGCHead_NEXT(g) \
+    ((PyGC_Head*)((g)->_gc_next & ~(uintptr_t)_PyGC_NEXT_MASK_VISITED))
+#define _PyGCHead_SET_NEXT(g, p) \
+    ((g)->_gc_next = ((g)->_gc_next & _PyGC_NEXT_MASK_VISITED) \
+                     | (uintptr_t)(p))
 
 // Lowest two bits of _gc_prev is used for _PyGC_PREV_MASK_* flags.
 #define _PyGCHead_PREV(g) ((PyGC_Head*)((g)->_gc_prev & _PyGC_PREV_MASK))
@@ -117,6 +127,15 @@ struct gc_generation {
                   generations */
 };
 
+/* Number of phases of a collection timed separately: update_refs,
+   subtract_refs, move_unreachable, handle_weakrefs, finalizers and
+   delete_garbage */
+#define NUM_GC_PHASES 6
+/* Number of buckets of the histogram of pause times: bucket 0 counts the
+   pauses shorter than 1 microsecond, bucket i the pauses of at least 2**(i-1)
+   and less than 2**i microseconds, and the last one the longer pauses. */
+#define NUM_GC_PAUSE_BUCKETS 24
+
 /* Running stats per generation */
 struct gc_generation_stats {
     /* total number of collections */
@@ -125,6 +144,16 @@ struct gc_generation_stats {
     Py_ssize_t collected;
     /* total number of uncollectable objects (put into gc.garbage) */
     Py_ssize_t uncollectable;
+    /* total number of objects examined */
+    Py_ssize_t examined;
+    /* total time the program was paused by collections, including steps of
+       incremental collections */
+    _PyTime_t pause_time;
+    /* longest pause */
+    _PyTime_t max_pause;
+    /* total time spent in each phase */
+    _PyTime_t phase_time[NUM_GC_PHASES];
+    Py_ssize_t pause_histogram[NUM_GC_PAUSE_BUCKETS];
 };
 
 struct _gc_runtime_state {
@@ -159,6 +188,19 @@ struct _gc_runtime_state {
        collections, and are awaiting to undergo a full collection for
        the first time. */
     Py_ssize_t long_lived_pending;
+
+    /* Incremental collection of the oldest generation, see
+       gc_collect_increment() in Modules/gcmodule.c */
+    int incremental;            /* true if enabled */
+    int incr_phase;             /* phase of the pass in progress */
+    _PyTime_t incr_budget;      /* time budget of a step, or 0 */
+    Py_ssize_t incr_budget_objects; /* object budget of a step, or 0 */
+    double incr_object_cost;    /* measured cost of collecting an
+                                   object in an increment, in ns */
+    Py_ssize_t incr_survivors;  /* objects which reached incr_visited */
+    PyGC_Head incr_pending;     /* objects not reached yet */
+    PyGC_Head incr_gray;        /* reached objects to traverse */
+    PyGC_Head incr_visited;     /* reached and traversed objects */
 };
 
 PyAPI_FUNC(void) _PyGC_InitState(struct _gc_runtime_state *);
@@ -169,9 +211,10 @@ extern void _PyFrame_ClearFreeList(PyThreadState *tstate);
 extern void _PyTuple_ClearFreeList(PyThreadState *tstate);
 extern void _PyFloat_ClearFreeList(PyThreadState *tstate);
 extern void _PyList_ClearFreeList(PyThreadState *tstate);
-extern void _PyDict_ClearFreeList(void);
+extern void _PyDict_ClearFreeList(PyThreadState *tstate);
 extern void _PyAsyncGen_ClearFreeLists(PyThreadState *tstate);
 extern void _PyContext_ClearFreeList(PyThreadState *tstate);
+extern void _PyThreadState_ClearFreeList(PyThreadState *tstate);
 
 #ifdef __cplusplus
 }
@@ -20,6 +20,24 @@ extern "C" {
 #undef FORCE_SWITCHING
 #define FORCE_SWITCHING
 
+/* GIL scheduling modes, see sys._setgilmode() */
+#define _PyGIL_MODE_DEFAULT 0
+#define _PyGIL_MODE_FIFO 1
+#define _PyGIL_MODE_PRIORITY 2
+
+/* A thread waiting for the GIL in the FIFO or priority mode.  It lives on
+   the stack of the waiting thread while it is linked in the waiters list. */
+struct _gil_waiter {
+    struct _gil_waiter *next;
+    /* The thread's GIL priority, see sys._setgilpriority() */
+    int priority;
+    /* 1 if the thread is coming back from a blocking call rather than
+       having been forced to drop the GIL (priority mode only) */
+    int boost;
+    /* Set when the GIL is handed off to this waiter */
+    int granted;
+};
+
 struct _gil_runtime_state {
     /* microseconds (the Python API uses seconds, though) */
     unsigned long interval;
@@ -42,6 +60,18 @@ struct _gil_runtime_state {
     PyCOND_T switch_cond;
     PyMUTEX_T switch_mutex;
 #endif
+    /* Scheduling mode.  In the FIFO and priority modes, threads which have
+       to wait for the GIL are queued in waiters, ordered by priority then
+       arrival, and drop_gil() hands the GIL off to the first of them.
+       Both are protected by the mutex. */
+    int mode;
+    struct _gil_waiter *waiters;
+    /* Whether GIL statistics are collected, see sys._setgilstats() */
+    int stats_enabled;
+    /* Thread state which took the GIL while statistics were collected,
+       and when it took it.  Only accessed by the GIL holder. */
+    struct _ts *stats_holder;
+    _PyTime_t stats_hold_start;
 };
 
 #ifdef __cplusplus
@@ -43,17 +43,25 @@ struct _ceval_state {
        of threads for which tstate->c_tracefunc is non-NULL, so if the
        value is 0, we know we don't have to check this thread's
        c_tracefunc.  This speeds up the if statement in
-       _PyEval_EvalFrameDefault() after fast_next_opcode. */
+       _PyEval_EvalFrameDefault() after fast_next_opcode.  Execution
+       statistics also add 1 while they are collected. */
     int tracing_possible;
+    /* Execution statistics (sys._stats_on(), -X pystats): collected while
+       stats is not NULL.  stats_data keeps them when they are stopped. */
+    struct _Py_EvalStats *stats;
+    struct _Py_EvalStats *stats_data;
     /* This single variable consolidates all requests to break out of
        the fast path in the eval loop. */
     _Py_atomic_int eval_breaker;
     /* Request for dropping the GIL */
     _Py_atomic_int gil_drop_request;
     struct _pending_calls pending;
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    struct _gil_runtime_state gil;
-#endif
+    /* The GIL taken by the threads of the interpreter: the runtime GIL of
+       the main interpreter, or own_gil_state if the interpreter has its
+       own GIL (see _PyEval_InitGIL()). */
+    struct _gil_runtime_state *gil;
+    int own_gil;
+    struct _gil_runtime_state own_gil_state;
 };
 
 /* fs_codec.encoding is initialized to NULL.
@@ -89,6 +97,18 @@ struct _Py_tuple_state {
 #endif
 };
 
+/* Dictionary reuse scheme to save calls to malloc and free */
+#ifndef PyDict_MAXFREELIST
+#  define PyDict_MAXFREELIST 80
+#endif
+
+struct _Py_dict_state {
+    PyDictObject *free_list[PyDict_MAXFREELIST];
+    int numfree;
+    PyDictKeysObject *keys_free_list[PyDict_MAXFREELIST];
+    int keys_numfree;
+};
+
 /* Empty list reuse scheme to save calls to malloc and free */
 #ifndef PyList_MAXFREELIST
 #  define PyList_MAXFREELIST 80
@@ -135,7 +155,36 @@ struct _Py_context_state {
     int numfree;
 };
 
+#ifndef PyThreadState_MAXFREELIST
+#  define PyThreadState_MAXFREELIST 16
+#endif
+
+struct _Py_tstate_state {
+    /* Thread states of exited threads, kept with their frame stack
+       chunk for reuse by new threads and PyGILState_Ensure() calls.
+       Linked via their next member and protected by the runtime
+       HEAD_LOCK(). */
+    struct _ts *free_list;
+    int numfree;
+};
+
+
+
+/* Type attribute cache, see _PyType_Lookup() */
+#define MCACHE_SIZE_EXP 12
+
+struct type_cache_entry {
+    unsigned int version;
+    PyObject *name;             /* reference to exactly a str or None */
+    PyObject *value;            /* borrowed */
+};
+
+struct type_cache {
+    struct type_cache_entry hashtable[1 << MCACHE_SIZE_EXP];
+};
+
 
+struct _obmalloc_state;
 
 /* interpreter state */
 
@@ -159,10 +208,16 @@ struct _is {
     PyThread_type_lock id_mutex;
 
     int finalizing;
+    /* Set while another interpreter runs code in this one, see
+       _PyInterpreterState_SetRunningMain() */
+    int running_main;
 
     struct _ceval_state ceval;
     struct _gc_runtime_state gc;
 
+    /* pools and arenas of pymalloc, see Objects/obmalloc.c */
+    struct _obmalloc_state *obmalloc;
+
     PyObject *modules;
     PyObject *modules_by_index;
     PyObject *sysdict;
@@ -209,6 +264,7 @@ struct _is {
     PyObject *pyexitmodule;
 
     uint64_t tstate_next_unique_id;
+    struct _Py_tstate_state tstate_pool;
 
     struct _warnings_runtime_state warnings;
 
@@ -226,6 +282,7 @@ struct _is {
 #endif
     struct _Py_tuple_state tuple;
     struct _Py_list_state list;
+    struct _Py_dict_state dict_state;
     struct _Py_float_state float_state;
     struct _Py_frame_state frame;
     struct _Py_async_gen_state async_gen;
@@ -234,6 +291,8 @@ struct _is {
     /* Using a cache is very effective since typically only a single slice is
        created and then deleted again. */
     PySliceObject *slice_cache;
+
+    struct type_cache type_cache;
 };
 
 /* Used by _PyImport_Cleanup() */
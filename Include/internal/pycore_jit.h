@@ -0,0 +1,75 @@
+#ifndef Py_INTERNAL_JIT_H
+#define Py_INTERNAL_JIT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef Py_BUILD_CORE
+#  error "this header requires Py_BUILD_CORE define"
+#endif
+
+#include "pycore_atomic.h"        // _Py_atomic_int
+
+/* Baseline JIT compiler (Python/jit.c), enabled by -X jit.
+
+   Hot code objects are translated to x86-64 machine code which runs on
+   the frame of the interpreter: the value stack, the local variables and
+   f_lasti have the same layout and meaning as in _PyEval_EvalFrameDefault(),
+   so the interpreter can take over at any instruction.  The machine code
+   gives control back whenever an instruction raises an exception, is not
+   supported by the compiler, or needs attention from the interpreter
+   (tracing, pending calls, error messages). */
+
+/* Machine code is only generated where this is defined */
+#if defined(__x86_64__) && defined(HAVE_MMAP) && !defined(MS_WINDOWS)
+#  define _Py_JIT_SUPPORTED
+#endif
+
+/* State shared by the interpreter and the machine code */
+typedef struct {
+    PyFrameObject *frame;
+    PyThreadState *tstate;
+    _Py_atomic_int *eval_breaker;
+    PyObject **stack_pointer;  /* Updated on exit */
+    PyObject *retval;          /* Set by _PyJIT_RETURN */
+    int lasti;                 /* Set by _PyJIT_ERROR and _PyJIT_EXIT */
+} _PyJITState;
+
+/* Results of _PyJIT_Execute() */
+#define _PyJIT_RETURN 0  /* The frame returned state->retval */
+#define _PyJIT_ERROR 1   /* The instruction at offset lasti raised */
+#define _PyJIT_EXIT 2    /* The interpreter continues at offset lasti */
+
+struct _PyJITCode {
+    /* Machine code, mapped read-only and executable */
+    char *code;
+    size_t size;
+    /* Was it compiled from co_quickened?  Only frames running the same
+       copy of the bytecode can run it. */
+    int quickened;
+    /* Address of the machine code of each instruction at which it can be
+       entered (the first instruction and the targets of jumps), indexed
+       by offset / sizeof(_Py_CODEUNIT); NULL for the others. */
+    char **entries;
+    /* The version compiled before co_quickened was created.  It is kept
+       until the code object is freed: a frame further up the C stack may
+       still be running it. */
+    struct _PyJITCode *previous;
+};
+
+/* Compile co to machine code in co->co_jit, replacing (but keeping) the
+   version already there.  Return 0 on success, or -1 without an exception
+   set if co cannot be compiled. */
+int _PyJIT_Compile(PyCodeObject *co);
+
+/* Run the machine code of state->frame from the instruction at offset,
+   which must have an entry in co_jit->entries.  Return one of the
+   _PyJIT_XXX results above. */
+int _PyJIT_Execute(PyCodeObject *co, _PyJITState *state, int offset);
+
+void _PyJIT_Free(PyCodeObject *co);
+
+#ifdef __cplusplus
+}
+#endif
+#endif   /* !Py_INTERNAL_JIT_H */
@@ -69,6 +69,11 @@ PyAPI_FUNC(int) _PyMem_GetAllocatorName(
    PYMEM_ALLOCATOR_NOT_SET does nothing. */
 PyAPI_FUNC(int) _PyMem_SetupAllocators(PyMemAllocatorName allocator);
 
+/* Set up and release the pymalloc state (pools and arenas) of
+   an interpreter */
+extern int _PyObject_InitState(PyInterpreterState *interp);
+extern void _PyObject_FiniState(PyInterpreterState *interp);
+
 /* bpo-35053: Expose _Py_tracemalloc_config for _Py_NewReference()
    which access directly _Py_tracemalloc_config.tracing for best
    performances. */
@@ -132,6 +132,13 @@ PyAPI_FUNC(PyThreadState *) _PyThreadState_Swap(
 
 PyAPI_FUNC(PyStatus) _PyInterpreterState_Enable(_PyRuntimeState *runtime);
 
+/* Release the frame stack of tstate (in Objects/frameobject.c).  If
+   keep_empty is non-zero, an empty chunk stays attached to tstate so that
+   a pooled thread state can reuse it. */
+extern void _PyFrame_ClearStack(PyThreadState *tstate, int keep_empty);
+
+extern void _PyThreadState_DebugMallocStats(FILE *out);
+
 #ifdef HAVE_FORK
 extern PyStatus _PyInterpreterState_DeleteExceptMain(_PyRuntimeState *runtime);
 extern PyStatus _PyGILState_Reinit(_PyRuntimeState *runtime);
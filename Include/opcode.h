@@ -101,6 +101,7 @@ extern "C" {
 #define LOAD_FAST               124
 #define STORE_FAST              125
 #define DELETE_FAST             126
+#define LOAD_FAST_AND_CLEAR     127
 #define RAISE_VARARGS           130
 #define CALL_FUNCTION           131
 #define MAKE_FUNCTION           132
@@ -128,6 +129,43 @@ extern "C" {
 #define DICT_MERGE              164
 #define DICT_UPDATE             165
 
+    /* Specialized instructions (see Python/specialize.c) */
+#define BINARY_ADD_ADAPTIVE       7
+#define BINARY_ADD_INT            8
+#define BINARY_ADD_FLOAT         13
+#define BINARY_ADD_UNICODE       14
+#define COMPARE_OP_ADAPTIVE      18
+#define COMPARE_OP_INT           21
+#define COMPARE_OP_FLOAT         30
+#define COMPARE_OP_STR           31
+#define FOR_ITER_ADAPTIVE        32
+#define FOR_ITER_LIST            33
+#define FOR_ITER_RANGE           34
+#define CALL_FUNCTION_ADAPTIVE   35
+#define CALL_FUNCTION_PY         36
+#define CALL_FUNCTION_BUILTIN_O  37
+#define CALL_FUNCTION_BUILTIN_FAST  38
+#define CALL_METHOD_ADAPTIVE     39
+#define CALL_METHOD_PY           40
+#define CALL_METHOD_DESCR_O      41
+#define CALL_METHOD_DESCR_FAST   42
+#define LOAD_ATTR_ADAPTIVE       43
+#define LOAD_ATTR_SPLIT_KEYS     44
+#define LOAD_ATTR_WITH_HINT      45
+#define LOAD_ATTR_SLOT           46
+#define LOAD_ATTR_MODULE         47
+#define STORE_ATTR_ADAPTIVE      53
+#define STORE_ATTR_SPLIT_KEYS    58
+#define STORE_ATTR_WITH_HINT     80
+#define STORE_ATTR_SLOT          81
+#define BEFORE_WITH              88
+#define LOAD_FAST__LOAD_FAST     99
+#define LOAD_FAST__LOAD_CONST   119
+#define LOAD_CONST__LOAD_FAST   120
+#define STORE_FAST__LOAD_FAST   123
+#define STORE_FAST__STORE_FAST  128
+#define LOAD_CONST__RETURN_VALUE 129
+
 /* EXCEPT_HANDLER is a special, implicit block type which is created when
    entering an except handler. It is not an opcode but we define it here
    as we want it to be available to both frameobject.c and ceval.c, while
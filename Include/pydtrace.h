@@ -30,6 +30,8 @@ static inline void PyDTrace_FUNCTION_ENTRY(const char *arg0, const char *arg1, i
 static inline void PyDTrace_FUNCTION_RETURN(const char *arg0, const char *arg1, int arg2) {}
 static inline void PyDTrace_GC_START(int arg0) {}
 static inline void PyDTrace_GC_DONE(Py_ssize_t arg0) {}
+static inline void PyDTrace_GC_PHASE(int arg0, const char *arg1, long long arg2) {}
+static inline void PyDTrace_GC_PAUSE(int arg0, long long arg1, Py_ssize_t arg2) {}
 static inline void PyDTrace_INSTANCE_NEW_START(int arg0) {}
 static inline void PyDTrace_INSTANCE_NEW_DONE(int arg0) {}
 static inline void PyDTrace_INSTANCE_DELETE_START(int arg0) {}
@@ -37,12 +39,17 @@ static inline void PyDTrace_INSTANCE_DELETE_DONE(int arg0) {}
 static inline void PyDTrace_IMPORT_FIND_LOAD_START(const char *arg0) {}
 static inline void PyDTrace_IMPORT_FIND_LOAD_DONE(const char *arg0, int arg1) {}
 static inline void PyDTrace_AUDIT(const char *arg0, void *arg1) {}
+static inline void PyDTrace_GIL_TAKE(long long arg0) {}
+static inline void PyDTrace_GIL_DROP(long long arg0, int arg1) {}
+static inline void PyDTrace_GIL_DROP_REQUEST(void) {}
 
 static inline int PyDTrace_LINE_ENABLED(void) { return 0; }
 static inline int PyDTrace_FUNCTION_ENTRY_ENABLED(void) { return 0; }
 static inline int PyDTrace_FUNCTION_RETURN_ENABLED(void) { return 0; }
 static inline int PyDTrace_GC_START_ENABLED(void) { return 0; }
 static inline int PyDTrace_GC_DONE_ENABLED(void) { return 0; }
+static inline int PyDTrace_GC_PHASE_ENABLED(void) { return 0; }
+static inline int PyDTrace_GC_PAUSE_ENABLED(void) { return 0; }
 static inline int PyDTrace_INSTANCE_NEW_START_ENABLED(void) { return 0; }
 static inline int PyDTrace_INSTANCE_NEW_DONE_ENABLED(void) { return 0; }
 static inline int PyDTrace_INSTANCE_DELETE_START_ENABLED(void) { return 0; }
@@ -50,6 +57,9 @@ static inline int PyDTrace_INSTANCE_DELETE_DONE_ENABLED(void) { return 0; }
 static inline int PyDTrace_IMPORT_FIND_LOAD_START_ENABLED(void) { return 0; }
 static inline int PyDTrace_IMPORT_FIND_LOAD_DONE_ENABLED(void) { return 0; }
 static inline int PyDTrace_AUDIT_ENABLED(void) { return 0; }
+static inline int PyDTrace_GIL_TAKE_ENABLED(void) { return 0; }
+static inline int PyDTrace_GIL_DROP_ENABLED(void) { return 0; }
+static inline int PyDTrace_GIL_DROP_REQUEST_ENABLED(void) { return 0; }
 
 #endif /* !WITH_DTRACE */
 
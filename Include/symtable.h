@@ -51,6 +51,8 @@ typedef struct _symtable_entry {
     unsigned ste_generator : 1;   /* true if namespace is a generator */
     unsigned ste_coroutine : 1;   /* true if namespace is a coroutine */
     unsigned ste_comprehension : 1; /* true if namespace is a list comprehension */
+    unsigned ste_comp_inlined : 1; /* true if the comprehension is compiled
+                                      inline in the enclosing function */
     unsigned ste_varargs : 1;     /* true if block has varargs */
     unsigned ste_varkeywords : 1; /* true if block has varkeywords */
     unsigned ste_returns_value : 1;  /* true if namespace uses return with
@@ -0,0 +1,206 @@
+# Licensed to PSF under a Contributor Agreement.
+
+"""Implements InterpreterPoolExecutor.
+
+Each worker thread of the pool owns a subinterpreter that it creates when it
+starts and destroys when it exits, so the interpreter startup cost is paid
+once per worker instead of once per task.
+
+Submitted calls are pickled in the submitting thread.  The worker thread runs
+a small script in its interpreter which unpickles the call, executes it and
+sends the pickled outcome back through a channel private to the worker.  The
+worker thread then receives the result and sets it on the future.
+"""
+
+import os
+import pickle
+import queue
+import sys
+import threading
+import traceback
+
+import _xxsubinterpreters as _interpreters
+
+from concurrent.futures import _base
+from concurrent.futures import thread as _thread
+
+
+# Hack to embed stringification of remote traceback in local traceback
+
+class _RemoteTraceback(Exception):
+    def __init__(self, tb):
+        self.tb = tb
+    def __str__(self):
+        return self.tb
+
+class _ExceptionWithTraceback:
+    def __init__(self, exc, tb):
+        tb = traceback.format_exception(type(exc), exc, tb)
+        tb = ''.join(tb)
+        self.exc = exc
+        self.tb = '\n"""\n%s"""' % tb
+    def __reduce__(self):
+        return _rebuild_exc, (self.exc, self.tb)
+
+def _rebuild_exc(exc, tb):
+    exc.__cause__ = _RemoteTraceback(tb)
+    return exc
+
+
+# The code below runs in the worker interpreters.
+
+_RUN_TASK = """\
+from concurrent.futures.interpreter import _run_task
+_run_task(_task, _cid)
+del _task, _cid
+"""
+
+def _exec_script(script):
+    exec(script, sys.modules['__main__'].__dict__)
+
+def _run_task(data, cid):
+    try:
+        fn, args, kwargs = pickle.loads(data)
+        del data
+        outcome = (True, fn(*args, **kwargs))
+    except BaseException as e:
+        outcome = (False, _ExceptionWithTraceback(e, e.__traceback__))
+    try:
+        data = pickle.dumps(outcome)
+    except BaseException as e:
+        # The result or the exception can't be pickled: report that instead.
+        data = pickle.dumps(
+            (False, _ExceptionWithTraceback(e, e.__traceback__)))
+    del outcome
+    _interpreters.channel_send(cid, data)
+
+
+# The code below runs in the worker threads of the main interpreter.
+
+class _WorkerInterpreter:
+    """A subinterpreter owned by a single worker thread."""
+
+    def __init__(self):
+        self.id = _interpreters.create()
+        try:
+            self.cid = _interpreters.channel_create()
+        except BaseException:
+            _interpreters.destroy(self.id)
+            raise
+
+    def run(self, data):
+        _interpreters.run_string(self.id, _RUN_TASK,
+                                 {'_task': data, '_cid': self.cid})
+        ok, value = pickle.loads(_interpreters.channel_recv(self.cid))
+        if ok:
+            return value
+        try:
+            raise value
+        finally:
+            # Break a reference cycle with the exception 'value'
+            value = None
+
+    def close(self):
+        try:
+            _interpreters.channel_destroy(self.cid)
+        finally:
+            _interpreters.destroy(self.id)
+
+
+_current = threading.local()
+
+def _call_in_interpreter(data):
+    return _current.interp.run(data)
+
+def _worker(executor_reference, work_queue, initializer, initargs):
+    try:
+        interp = _WorkerInterpreter()
+    except BaseException:
+        _base.LOGGER.critical('Exception in worker', exc_info=True)
+        executor = executor_reference()
+        if executor is not None:
+            executor._initializer_failed()
+        return
+    _current.interp = interp
+    try:
+        if initializer is not None:
+            try:
+                interp.run(pickle.dumps((initializer, initargs, {})))
+            except BaseException:
+                _base.LOGGER.critical('Exception in initializer:',
+                                      exc_info=True)
+                executor = executor_reference()
+                if executor is not None:
+                    executor._initializer_failed()
+                return
+        _thread._worker(executor_reference, work_queue, None, ())
+    finally:
+        del _current.interp
+        interp.close()
+
+
+class BrokenInterpreterPool(_thread.BrokenThreadPool):
+    """
+    Raised when a worker of an InterpreterPoolExecutor failed initializing.
+    """
+
+
+class InterpreterPoolExecutor(_thread.ThreadPoolExecutor):
+
+    _worker = staticmethod(_worker)
+
+    def __init__(self, max_workers=None, thread_name_prefix='',
+                 initializer=None, initargs=()):
+        """Initializes a new InterpreterPoolExecutor instance.
+
+        Args:
+            max_workers: The maximum number of interpreters that can be used
+                to execute the given calls.  If None or not given then as many
+                worker interpreters will be created as the machine has
+                processors.
+            thread_name_prefix: An optional name prefix to give the threads
+                driving the interpreters.
+            initializer: A picklable callable used to initialize worker
+                interpreters.
+            initargs: A tuple of arguments to pass to the initializer.
+        """
+        if max_workers is None:
+            # Workers are meant for CPU bound tasks, like process pools.
+            max_workers = os.cpu_count() or 1
+        super().__init__(max_workers, thread_name_prefix or
+                         ("InterpreterPoolExecutor-%d" % self._counter()),
+                         initializer, initargs)
+
+    def submit(self, fn, /, *args, **kwargs):
+        """Submits a callable or a script to be executed in a subinterpreter.
+
+        If *fn* is a string, it is executed as a script in the __main__
+        module of a worker interpreter and the future's result is None.
+        Otherwise *fn*, *args* and *kwargs* must be picklable; the call is
+        made in a worker interpreter and its result is pickled back.
+
+        Returns:
+            A Future representing the given call.
+        """
+        if self._broken:
+            raise BrokenInterpreterPool(self._broken)
+        if isinstance(fn, str):
+            if args or kwargs:
+                raise TypeError('a script takes no arguments')
+            fn, args = _exec_script, (fn,)
+        data = pickle.dumps((fn, args, kwargs))
+        return super().submit(_call_in_interpreter, data)
+
+    def _initializer_failed(self):
+        with self._shutdown_lock:
+            self._broken = ('An interpreter initializer failed, the '
+                            'interpreter pool is not usable anymore')
+            # Drain work queue and mark pending futures failed
+            while True:
+                try:
+                    work_item = self._work_queue.get_nowait()
+                except queue.Empty:
+                    break
+                if work_item is not None:
+                    work_item.future.set_exception(
+                        BrokenInterpreterPool(self._broken))
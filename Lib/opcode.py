@@ -171,6 +171,8 @@ def_op('STORE_FAST', 125)       # Local variable number
 haslocal.append(125)
 def_op('DELETE_FAST', 126)      # Local variable number
 haslocal.append(126)
+def_op('LOAD_FAST_AND_CLEAR', 127)  # Local variable number
+haslocal.append(127)
 
 def_op('RAISE_VARARGS', 130)    # Number of raise arguments (1, 2, or 3)
 def_op('CALL_FUNCTION', 131)    # #args
@@ -215,3 +217,60 @@ def_op('DICT_MERGE', 164)
 def_op('DICT_UPDATE', 165)
 
 del def_op, name_op, jrel_op, jabs_op
+
+# Specialized forms of the instructions above.  They are never emitted by
+# the compiler: the interpreter writes them into a private copy of the
+# bytecode of hot code objects (see Python/specialize.c), so they do not
+# appear in co_code and have no entry in opname or opmap.  Opcode numbers
+# are assigned from the unused slots by Tools/scripts/generate_opcode_h.py.
+_specialized_instructions = [
+    "BINARY_ADD_ADAPTIVE",
+    "BINARY_ADD_INT",
+    "BINARY_ADD_FLOAT",
+    "BINARY_ADD_UNICODE",
+    "COMPARE_OP_ADAPTIVE",
+    "COMPARE_OP_INT",
+    "COMPARE_OP_FLOAT",
+    "COMPARE_OP_STR",
+    "FOR_ITER_ADAPTIVE",
+    "FOR_ITER_LIST",
+    "FOR_ITER_RANGE",
+    "CALL_FUNCTION_ADAPTIVE",
+    "CALL_FUNCTION_PY",
+    "CALL_FUNCTION_BUILTIN_O",
+    "CALL_FUNCTION_BUILTIN_FAST",
+    "CALL_METHOD_ADAPTIVE",
+    "CALL_METHOD_PY",
+    "CALL_METHOD_DESCR_O",
+    "CALL_METHOD_DESCR_FAST",
+    "LOAD_ATTR_ADAPTIVE",
+    "LOAD_ATTR_SPLIT_KEYS",
+    "LOAD_ATTR_WITH_HINT",
+    "LOAD_ATTR_SLOT",
+    "LOAD_ATTR_MODULE",
+    "STORE_ATTR_ADAPTIVE",
+    "STORE_ATTR_SPLIT_KEYS",
+    "STORE_ATTR_WITH_HINT",
+    "STORE_ATTR_SLOT",
+    # SETUP_WITH without the block setup, for code using an exception table
+    "BEFORE_WITH",
+    # Superinstructions: the first instruction of a frequent pair, which
+    # also runs the second one.  The second instruction is left in place,
+    # so jumps to it still work.
+    "LOAD_FAST__LOAD_FAST",
+    "LOAD_FAST__LOAD_CONST",
+    "LOAD_CONST__LOAD_FAST",
+    "STORE_FAST__LOAD_FAST",
+    "STORE_FAST__STORE_FAST",
+    "LOAD_CONST__RETURN_VALUE",
+]
+
+# Their opcode numbers: the unused slots, in order
+_specialized_opmap = {}
+_op = 1
+for _name in _specialized_instructions:
+    while opname[_op] != '<%r>' % _op:
+        _op += 1
+    _specialized_opmap[_name] = _op
+    _op += 1
+del _op, _name
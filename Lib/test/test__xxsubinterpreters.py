@@ -4,6 +4,7 @@ import itertools
 import os
 import pickle
 import sys
+import sysconfig
 from textwrap import dedent
 import threading
 import time
@@ -628,6 +629,21 @@ class CreateTests(TestBase):
 
         self.assertEqual(set(interpreters.list_all()), {main, id1, id2})
 
+    @unittest.skipUnless(
+        sysconfig.get_config_var('EXPERIMENTAL_ISOLATED_SUBINTERPRETERS'),
+        'needs isolated interpreters with their own GIL')
+    def test_not_isolated_in_subinterpreter_with_own_gil(self):
+        id1 = interpreters.create()
+        out = _run_output(id1, dedent("""
+            import _xxsubinterpreters as _interpreters
+            try:
+                _interpreters.create(isolated=False)
+            except RuntimeError:
+                print('refused', end='')
+            """))
+
+        self.assertEqual(out, 'refused')
+
     def test_after_destroy_all(self):
         before = set(interpreters.list_all())
         # Create 3 subinterpreters.
@@ -793,6 +809,27 @@ class RunStringTests(TestBase):
 
         self.assertEqual(out, 'it worked!')
 
+    def test_in_parallel_threads(self):
+        # Isolated interpreters run in parallel when they have their own GIL
+        ids = [interpreters.create() for _ in range(4)]
+        results = {}
+        def f(id):
+            results[id] = _run_output(id, dedent("""
+                total = 0
+                for i in range(100_000):
+                    total += {i: i * i for i in range(3)}[i % 3]
+                print(total, end='')
+                """))
+
+        threads = [threading.Thread(target=f, args=(id,)) for id in ids]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        expected = str(sum((i % 3) ** 2 for i in range(100_000)))
+        self.assertEqual(results, dict.fromkeys(ids, expected))
+
     def test_create_thread(self):
         subinterp = interpreters.create(isolated=False)
         script, file = _captured_script("""
@@ -1483,6 +1520,98 @@ class ChannelTests(TestBase):
         self.assertEqual(obj5, b'eggs')
         self.assertIs(obj6, default)
 
+    def test_send_recv_many(self):
+        cid = interpreters.channel_create()
+        interpreters.channel_send_many(cid, [b'spam', 1, None])
+        interpreters.channel_send_many(cid, iter([b'eggs']))
+        interpreters.channel_send_many(cid, [])
+        objs1 = interpreters.channel_recv_many(cid, 2)
+        objs2 = interpreters.channel_recv_many(cid)
+        objs3 = interpreters.channel_recv_many(cid)
+
+        self.assertEqual(objs1, [b'spam', 1])
+        self.assertEqual(objs2, [None, b'eggs'])
+        self.assertEqual(objs3, [])
+
+    def test_send_many_not_shareable(self):
+        cid = interpreters.channel_create()
+        with self.assertRaises(ValueError):
+            interpreters.channel_send_many(cid, [b'spam', object()])
+
+        self.assertEqual(interpreters.channel_recv_many(cid), [])
+
+    def test_send_recv_many_different_interpreters(self):
+        cid = interpreters.channel_create()
+        id1 = interpreters.create()
+        _run_output(id1, dedent(f"""
+            import _xxsubinterpreters as _interpreters
+            _interpreters.channel_send_many({cid}, [b'spam'] * 100)
+            """))
+        objs = interpreters.channel_recv_many(cid)
+
+        self.assertEqual(objs, [b'spam'] * 100)
+
+    def test_share_buffers(self):
+        cid = interpreters.channel_create(share_buffers=True)
+        orig = bytearray(b'spam')
+        interpreters.channel_send(cid, orig)
+        interpreters.channel_send(cid, 1)
+        view = interpreters.channel_recv(cid)
+        obj = interpreters.channel_recv(cid)
+        orig[0] = ord('S')
+
+        self.assertIsInstance(view, memoryview)
+        self.assertFalse(view.readonly)
+        self.assertEqual(view, b'Spam')
+        self.assertEqual(obj, 1)
+        # The buffer stays exported until the view is released.
+        with self.assertRaises(BufferError):
+            orig.extend(b'eggs')
+        view.release()
+        orig.extend(b'eggs')
+
+    def test_share_buffers_format(self):
+        cid = interpreters.channel_create(share_buffers=True)
+        orig = memoryview(bytes(range(12))).cast('i', (3,))
+        interpreters.channel_send(cid, orig)
+        view = interpreters.channel_recv(cid)
+
+        self.assertTrue(view.readonly)
+        self.assertEqual(view.format, 'i')
+        self.assertEqual(view.tolist(), orig.tolist())
+
+    def test_share_buffers_not_contiguous(self):
+        cid = interpreters.channel_create(share_buffers=True)
+        with self.assertRaises(ValueError):
+            interpreters.channel_send(cid, memoryview(b'spam')[::2])
+
+    def test_share_buffers_different_interpreters(self):
+        cid = interpreters.channel_create(share_buffers=True)
+        id1 = interpreters.create()
+        _run_output(id1, dedent(f"""
+            import _xxsubinterpreters as _interpreters
+            data = bytearray(b'spam')
+            _interpreters.channel_send_many({cid}, [data, b'eggs'])
+            """))
+        view1, view2 = interpreters.channel_recv_many(cid)
+        out = _run_output(id1, dedent("""
+            data[0] = ord('S')
+            try:
+                data.extend(b'ham')
+            except BufferError:
+                print('exported')
+            """))
+
+        self.assertEqual(out.strip(), 'exported')
+        self.assertEqual(view1, b'Spam')
+        self.assertEqual(view2, b'eggs')
+        view1.release()
+        view2.release()
+        _run_output(id1, dedent("""
+            data.extend(b'ham')
+            assert data == b'Spamham', data
+            """))
+
     def test_run_string_arg_unresolved(self):
         cid = interpreters.channel_create()
         interp = interpreters.create()
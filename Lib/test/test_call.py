@@ -1,3 +1,4 @@
+import sys
 import unittest
 from test.support import cpython_only
 try:
@@ -27,6 +28,90 @@ class FunctionCalls(unittest.TestCase):
         self.assertEqual(list(res.items()), expected)
 
 
+class PythonCallsTests(unittest.TestCase):
+    """
+    Calls between Python functions which run in the caller's eval loop.
+    """
+
+    def method(self, a, b=2, *args, c=3, **kwargs):
+        return a, b, args, c, kwargs
+
+    def test_arguments(self):
+        def f(a, b=2, *args, c=3, **kwargs):
+            return a, b, args, c, kwargs
+        for func in (f, self.method):
+            self.assertEqual(func(1), (1, 2, (), 3, {}))
+            self.assertEqual(func(1, 5, 6, 7), (1, 5, (6, 7), 3, {}))
+            self.assertEqual(func(1, c=4), (1, 2, (), 4, {}))
+            self.assertEqual(func(b=5, a=1, d=6), (1, 5, (), 3, {'d': 6}))
+            self.assertRaises(TypeError, func)
+            self.assertRaises(TypeError, func, 1, a=1)
+
+    def test_closure(self):
+        x = 1
+        def f(y):
+            return x + y
+        for i in range(10):
+            self.assertEqual(f(i), i + 1)
+
+    def test_exception(self):
+        def inner():
+            1/0
+        def middle():
+            return inner() + 1
+        def outer():
+            return middle()
+        try:
+            outer()
+        except ZeroDivisionError as e:
+            tb = e.__traceback__
+        else:
+            self.fail("should have raised")
+        names = []
+        while tb is not None:
+            names.append(tb.tb_frame.f_code.co_name)
+            tb = tb.tb_next
+        self.assertEqual(names, ['test_exception', 'outer', 'middle', 'inner'])
+        def catch():
+            try:
+                return middle()
+            except ZeroDivisionError:
+                return 'caught'
+        self.assertEqual(catch(), 'caught')
+
+    def test_f_back(self):
+        def inner():
+            return sys._getframe()
+        def outer():
+            return inner()
+        f = outer()
+        self.assertEqual(f.f_code.co_name, 'inner')
+        self.assertEqual(f.f_back.f_code.co_name, 'outer')
+        self.assertIs(f.f_back.f_back, sys._getframe())
+
+    @cpython_only
+    def test_deep_recursion(self):
+        # Python-to-Python calls don't use the C stack, so the recursion
+        # limit can be raised well beyond what the C stack could support.
+        def recurse(n):
+            if n == 0:
+                return 0
+            return recurse(n - 1) + 1
+        if sys.gettrace() is not None:
+            self.skipTest('calls use the C stack when tracing')
+        limit = sys.getrecursionlimit()
+        sys.setrecursionlimit(100_000)
+        try:
+            self.assertEqual(recurse(50_000), 50_000)
+        finally:
+            sys.setrecursionlimit(limit)
+
+    def test_recursion_limit(self):
+        def recurse():
+            return recurse()
+        self.assertRaises(RecursionError, recurse)
+
+
 @cpython_only
 class CFunctionCallsErrorMessages(unittest.TestCase):
 
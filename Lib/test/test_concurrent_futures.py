@@ -99,6 +99,13 @@ class EventfulGCObj():
 def make_dummy_object(_):
     return MyObject()
 
+CALL_COUNT = 0
+
+def count_calls():
+    global CALL_COUNT
+    CALL_COUNT += 1
+    return CALL_COUNT
+
 
 class BaseTestCase(unittest.TestCase):
     def setUp(self):
@@ -155,6 +162,17 @@ class ThreadPoolMixin(ExecutorMixin):
     executor_type = futures.ThreadPoolExecutor
 
 
+class InterpreterPoolMixin(ExecutorMixin):
+    worker_count = 2
+
+    @property
+    def executor_type(self):
+        try:
+            return futures.InterpreterPoolExecutor
+        except ImportError:
+            self.skipTest("requires _xxsubinterpreters")
+
+
 class ProcessPoolForkMixin(ExecutorMixin):
     executor_type = futures.ProcessPoolExecutor
     ctx = "fork"
@@ -279,6 +297,10 @@ class FailingInitializerMixin(ExecutorMixin):
 
 create_executor_tests(InitializerMixin)
 create_executor_tests(FailingInitializerMixin)
+create_executor_tests(InitializerMixin,
+                      executor_mixins=(InterpreterPoolMixin,))
+create_executor_tests(FailingInitializerMixin,
+                      executor_mixins=(InterpreterPoolMixin,))
 
 
 class ExecutorShutdownTest:
@@ -1009,6 +1031,63 @@ create_executor_tests(ProcessPoolExecutorTest,
                                        ProcessPoolForkserverMixin,
                                        ProcessPoolSpawnMixin))
 
+
+class InterpreterPoolExecutorTest(InterpreterPoolMixin, ExecutorTest,
+                                  BaseTestCase):
+    def test_default_workers(self):
+        executor = self.executor_type()
+        self.assertEqual(executor._max_workers, os.cpu_count() or 1)
+        executor.shutdown(wait=True)
+
+    def test_submit_script(self):
+        future = self.executor.submit('x = 1 / 0')
+        with self.assertRaises(ZeroDivisionError):
+            future.result()
+        self.assertIsNone(self.executor.submit('x = 42').result())
+        with self.assertRaises(TypeError):
+            self.executor.submit('pass', 1)
+
+    def test_submit_not_picklable(self):
+        with self.assertRaises((PicklingError, AttributeError)):
+            self.executor.submit(lambda: None)
+        self.assertEqual(self.executor.submit(pow, 2, 8).result(), 256)
+
+    def test_interpreter_reuse(self):
+        # Tasks run in the worker's interpreter, which keeps its own module
+        # state between tasks.
+        executor = self.executor_type(max_workers=1)
+        results = [executor.submit(count_calls).result() for _ in range(3)]
+        executor.shutdown(wait=True)
+        self.assertEqual(results, [1, 2, 3])
+        self.assertEqual(CALL_COUNT, 0)
+
+    def test_interpreters_destroyed(self):
+        import _xxsubinterpreters as interpreters
+        before = len(interpreters.list_all())
+        executor = self.executor_type(max_workers=3)
+        list(executor.map(pow, range(10), range(10)))
+        self.assertGreater(len(interpreters.list_all()), before)
+        executor.shutdown(wait=True)
+        self.assertEqual(len(interpreters.list_all()), before)
+
+    @classmethod
+    def _test_traceback(cls):
+        raise RuntimeError(123) # some comment
+
+    def test_traceback(self):
+        # The traceback from the worker interpreter is contained in the
+        # traceback raised in the main interpreter.
+        future = self.executor.submit(self._test_traceback)
+        with self.assertRaises(RuntimeError) as cm:
+            future.result()
+
+        exc = cm.exception
+        self.assertEqual(exc.args, (123,))
+        cause = exc.__cause__
+        self.assertIs(type(cause), futures.interpreter._RemoteTraceback)
+        self.assertIn('raise RuntimeError(123) # some comment', cause.tb)
+
+
 def _crash(delay=None):
     """Induces a segfault."""
     if delay:
@@ -409,6 +409,8 @@ class InitConfigTests(EmbeddingTestsMixin, unittest.TestCase):
         'pathconfig_warnings': 1,
         '_init_main': 1,
         '_isolated_interpreter': 0,
+        '_use_jit': 0,
+        '_pystats': 0,
     }
     if MS_WINDOWS:
         CONFIG_COMPAT.update({
@@ -1,4 +1,6 @@
 import re
+import sys
+import threading
 import types
 import unittest
 import weakref
@@ -202,5 +204,85 @@ class ReprTest(unittest.TestCase):
                          % (file_repr, offset + 5))
 
 
+class EscapedFrameTest(unittest.TestCase):
+    """
+    Tests for frames which outlive their call.
+    """
+
+    def get_frame(self, x):
+        y = x * 2
+        return sys._getframe()
+
+    def raise_error(self, x):
+        y = [x]
+        raise ValueError(x)
+
+    def check_frame(self, f, x):
+        self.assertEqual(f.f_code.co_name, 'get_frame')
+        self.assertEqual(f.f_locals, {'self': self, 'x': x, 'y': x * 2})
+        self.assertIs(f.f_back, self.caller)
+
+    def test_getframe(self):
+        self.caller = sys._getframe()
+        frames = []
+        for i in range(10):
+            frames.append(self.get_frame(i))
+        # Make more calls while the frames are alive
+        for i in range(10):
+            self.get_frame(i)
+        for i, f in enumerate(frames):
+            self.check_frame(f, i)
+
+    def test_out_of_order(self):
+        self.caller = sys._getframe()
+        frames = []
+        for i in range(10):
+            frames.append(self.get_frame(i))
+        del frames[::2]
+        self.get_frame(0)
+        del frames[:2]
+        frames.append(self.get_frame(10))
+        for i, f in zip((5, 7, 9, 10), frames):
+            self.check_frame(f, i)
+
+    def test_traceback(self):
+        tracebacks = []
+        for i in range(5):
+            try:
+                self.raise_error(i)
+            except ValueError as exc:
+                tracebacks.append(exc.__traceback__)
+            self.get_frame(i)
+        for i, tb in enumerate(tracebacks):
+            f = tb.tb_next.tb_frame
+            self.assertEqual(f.f_code.co_name, 'raise_error')
+            self.assertEqual(f.f_locals, {'self': self, 'x': i, 'y': [i]})
+
+    def test_deep_recursion(self):
+        def recurse(n):
+            if n == 0:
+                return sys._getframe()
+            return recurse(n - 1)
+
+        f = recurse(300)
+        depth = 0
+        while f.f_code is recurse.__code__:
+            self.assertEqual(f.f_locals['n'], depth)
+            depth += 1
+            f = f.f_back
+        self.assertEqual(depth, 301)
+
+    def test_thread_exit(self):
+        frames = []
+        t = threading.Thread(target=lambda: frames.append(self.get_frame(7)))
+        self.caller = None
+        t.start()
+        t.join()
+        f, = frames
+        self.assertEqual(f.f_locals, {'self': self, 'x': 7, 'y': 14})
+        del f, frames
+        support.gc_collect()
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -760,10 +760,22 @@ class GCTests(unittest.TestCase):
         for st in stats:
             self.assertIsInstance(st, dict)
             self.assertEqual(set(st),
-                             {"collected", "collections", "uncollectable"})
+                             {"collected", "collections", "uncollectable",
+                              "examined", "pause_time", "max_pause",
+                              "phase_times", "pause_histogram"})
             self.assertGreaterEqual(st["collected"], 0)
             self.assertGreaterEqual(st["collections"], 0)
             self.assertGreaterEqual(st["uncollectable"], 0)
+            self.assertGreaterEqual(st["examined"], 0)
+            self.assertGreaterEqual(st["pause_time"], st["max_pause"])
+            self.assertGreaterEqual(st["max_pause"], 0)
+            self.assertEqual(set(st["phase_times"]),
+                             {"update_refs", "subtract_refs",
+                              "move_unreachable", "handle_weakrefs",
+                              "finalizers", "delete_garbage"})
+            self.assertLessEqual(sum(st["phase_times"].values()),
+                                 st["pause_time"])
+            self.assertEqual(len(st["pause_histogram"]), 24)
         # Check that collection counts are incremented correctly
         if gc.isenabled():
             self.addCleanup(gc.enable)
@@ -780,12 +792,132 @@ class GCTests(unittest.TestCase):
         self.assertEqual(new[1]["collections"], old[1]["collections"])
         self.assertEqual(new[2]["collections"], old[2]["collections"] + 1)
 
+    def test_get_stats_pauses(self):
+        if gc.isenabled():
+            self.addCleanup(gc.enable)
+            gc.disable()
+        l = []
+        l.append(l)
+        old = gc.get_stats()[0]
+        gc.collect(0)
+        new = gc.get_stats()[0]
+        self.assertGreater(new["examined"], old["examined"])
+        self.assertGreaterEqual(new["pause_time"], old["pause_time"])
+        self.assertGreaterEqual(new["max_pause"], old["max_pause"])
+        self.assertEqual(sum(new["pause_histogram"]),
+                         sum(old["pause_histogram"]) + 1)
+        for phase, t in new["phase_times"].items():
+            self.assertGreaterEqual(t, old["phase_times"][phase])
+
     def test_freeze(self):
         gc.freeze()
         self.assertGreater(gc.get_freeze_count(), 0)
         gc.unfreeze()
         self.assertEqual(gc.get_freeze_count(), 0)
 
+    def enable_incremental(self, **kwargs):
+        old = gc.get_incremental()
+        self.addCleanup(gc.set_incremental, old['enabled'],
+                        budget_ms=old['budget_ms'],
+                        budget_objects=old['budget_objects'])
+        self.addCleanup(gc.set_threshold, *gc.get_threshold())
+        if not gc.isenabled():
+            gc.enable()
+            self.addCleanup(gc.disable)
+        gc.set_incremental(True, **kwargs)
+        gc.set_threshold(100, 1, 1)
+
+    def run_incremental(self, predicate, limit=10**6):
+        # Allocate long-lived objects until predicate() is true, to make
+        # collections of the oldest generation happen
+        junk = []
+        for i in range(limit):
+            junk.append([])
+            if predicate():
+                return
+        self.fail("incremental collection didn't make progress")
+
+    def test_set_incremental(self):
+        old = gc.get_incremental()
+        self.addCleanup(gc.set_incremental, old['enabled'],
+                        budget_ms=old['budget_ms'],
+                        budget_objects=old['budget_objects'])
+        gc.set_incremental(True, budget_ms=0.5, budget_objects=100)
+        self.assertEqual(gc.get_incremental(),
+                         {'enabled': True, 'budget_ms': 0.5,
+                          'budget_objects': 100, 'phase': 'idle'})
+        gc.set_incremental(budget_ms=0, budget_objects=10)
+        self.assertEqual(gc.get_incremental()['budget_ms'], 0)
+        gc.set_incremental(False, budget_ms=0, budget_objects=0)
+        self.assertFalse(gc.get_incremental()['enabled'])
+
+        self.assertRaises(ValueError, gc.set_incremental, budget_ms=-1)
+        self.assertRaises(ValueError, gc.set_incremental,
+                          budget_ms=float('nan'))
+        self.assertRaises(ValueError, gc.set_incremental, budget_objects=-1)
+        self.assertRaises(ValueError, gc.set_incremental,
+                          budget_ms=0, budget_objects=0)
+        self.assertRaises(OverflowError, gc.set_incremental, budget_ms=1e300)
+        self.assertRaises(TypeError, gc.set_incremental, True, 2.0)
+        self.assertFalse(gc.get_incremental()['enabled'])
+
+    def test_incremental_collection(self):
+        class A:
+            pass
+        collected = []
+        live = A()
+        live.self = live
+        a = A()
+        a.self = a
+        wr = weakref.ref(a, collected.append)
+        gc.collect()
+        del a
+
+        self.enable_incremental(budget_ms=0, budget_objects=50)
+        collections = gc.get_stats()[2]['collections']
+        phases = set()
+        def pass_done():
+            phases.add(gc.get_incremental()['phase'])
+            return gc.get_stats()[2]['collections'] > collections
+        self.run_incremental(pass_done)
+        self.assertEqual(collected, [wr])
+        self.assertIn('sweep', phases)
+        self.assertIs(live.self, live)
+
+    def test_incremental_then_collect(self):
+        class A:
+            pass
+        collected = []
+        a = A()
+        a.self = a
+        wr = weakref.ref(a, collected.append)
+        gc.collect()
+        live = []
+        live.append(live)
+
+        self.enable_incremental(budget_ms=0, budget_objects=10)
+        self.run_incremental(
+            lambda: gc.get_incremental()['phase'] != 'idle')
+        del a
+        gc.collect()
+        self.assertEqual(gc.get_incremental()['phase'], 'idle')
+        self.assertEqual(collected, [wr])
+        self.assertTrue(any(live is obj
+                            for obj in gc.get_objects(generation=2)))
+
+    def test_incremental_freeze(self):
+        self.enable_incremental(budget_ms=0, budget_objects=100)
+        gc.freeze()
+        self.addCleanup(gc.unfreeze)
+        frozen = gc.get_freeze_count()
+        self.assertGreater(frozen, 0)
+        collections = gc.get_stats()[2]['collections']
+        self.run_incremental(
+            lambda: gc.get_stats()[2]['collections'] > collections + 1)
+        self.assertEqual(gc.get_freeze_count(), frozen)
+        gc.set_incremental(False)
+        self.assertEqual(gc.get_freeze_count(), frozen)
+
     def test_get_objects(self):
         gc.collect()
         l = []
@@ -1116,6 +1248,10 @@ class GCCallbackTests(unittest.TestCase):
             self.assertTrue("generation" in info)
             self.assertTrue("collected" in info)
             self.assertTrue("uncollectable" in info)
+            if v[1] == "stop":
+                self.assertGreater(info["examined"], 0)
+                self.assertGreaterEqual(info["pause"],
+                                        sum(info["phase_times"].values()))
 
     def test_collect_generation(self):
         self.preclean()
@@ -3610,10 +3610,10 @@ class TestSignatureBind(unittest.TestCase):
 
     @cpython_only
     def test_signature_bind_implicit_arg(self):
-        # Issue #19611: getcallargs should work with set comprehensions
-        def make_set():
-            return {z * z for z in range(5)}
-        setcomp_code = make_set.__code__.co_consts[1]
+        # Issue #19611: getcallargs should work with set comprehensions,
+        # which are compiled as functions outside of functions
+        setcomp_code = compile('{z * z for z in range(5)}', '<setcomp>',
+                               'eval').co_consts[0]
         setcomp_func = types.FunctionType(setcomp_code, {})
 
         iterator = iter(range(5))
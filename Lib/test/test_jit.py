@@ -0,0 +1,421 @@
+"""Tests for the baseline JIT compiler (Python/jit.c, -X jit).
+
+The JIT is enabled for the whole process, so every test runs its code in a
+child interpreter.  Code objects are compiled after JIT_MIN_RUNS calls or
+loop iterations, so the code under test runs many times, and most tests
+change the types or the state it sees once it has been compiled.
+"""
+
+import platform
+import sys
+import textwrap
+import unittest
+from test import support
+from test.support import script_helper
+
+# Comfortably above JIT_MIN_RUNS in Python/ceval.c
+RUNS = 10000
+
+JIT_SUPPORTED = (platform.machine() in ('x86_64', 'amd64', 'AMD64')
+                 and sys.platform != 'win32')
+
+
+class JITTests(unittest.TestCase):
+
+    def run_jit(self, code, compare=True):
+        code = f"RUNS = {RUNS}\n" + textwrap.dedent(code)
+        rc, out, err = script_helper.assert_python_ok('-X', 'jit', '-c', code)
+        self.assertEqual(err, b'')
+        if compare:
+            # The output must be the same in the interpreter
+            rc, expected, err = script_helper.assert_python_ok('-c', code)
+            self.assertEqual(out, expected)
+        return out.decode().splitlines()
+
+    def test_config(self):
+        out = self.run_jit("""
+            import sys
+            print(sys.flags.optimize, '-X jit' if 'jit' in sys._xoptions else '')
+        """, compare=False)
+        self.assertEqual(out, ['0 -X jit'])
+
+    @support.cpython_only
+    @unittest.skipUnless(JIT_SUPPORTED, 'the JIT only supports x86-64')
+    def test_compiled(self):
+        out = self.run_jit("""
+            def f(n):
+                total = 0
+                for i in range(n):
+                    total += i
+                return total
+            size = f.__code__.__sizeof__()
+            print(f(RUNS))
+            print(f.__code__.__sizeof__() > size)
+        """, compare=False)
+        self.assertEqual(out, [str(sum(range(RUNS))), 'True'])
+
+    def test_arithmetic(self):
+        out = self.run_jit("""
+            def f(a, b):
+                return (a + b, a - b, a * b, a / b, a // b, a % b, a ** 2,
+                        -a, ~a if isinstance(a, int) else None, not a,
+                        a < b, a <= b, a == b, a != b, a > b, a >= b,
+                        a is b, a is not b, a in [b], a not in [b],
+                        a & 6 if isinstance(a, int) else None)
+            for i in range(1, RUNS):
+                expected = f(i, 3)
+            print(f(7, 3))
+            print(f(7.5, 2.0))
+            print(f(2**100, 3))
+            print(f(True, True))
+        """)
+        self.assertEqual(out, [
+            str((10, 4, 21, 7 / 3, 2, 1, 49, -7, -8, False,
+                 False, False, False, True, True, True,
+                 False, True, False, True, 6)),
+            str((9.5, 5.5, 15.0, 3.75, 3.0, 1.5, 56.25, -7.5, None, False,
+                 False, False, False, True, True, True,
+                 False, True, False, True, None)),
+            str((2**100 + 3, 2**100 - 3, 3 * 2**100, 2**100 / 3, 2**100 // 3,
+                 2**100 % 3, 2**200, -2**100, ~2**100, False,
+                 False, False, False, True, True, True,
+                 False, True, False, True, 0)),
+            str((2, 0, 1, 1.0, 1, 0, 1, -1, -2, False,
+                 False, True, True, False, False, True,
+                 True, False, True, False, 0)),
+        ])
+
+    def test_loops(self):
+        out = self.run_jit("""
+            def f(n):
+                total = 0
+                i = 0
+                while i < n:
+                    if i % 3 == 0:
+                        total += i
+                    elif i % 3 == 1 and i > 5 or i == 2:
+                        total -= 1
+                    else:
+                        continue_ = True
+                    i += 1
+                for x in [1, 2, 3]:
+                    for y in (4, 5):
+                        if y == 5:
+                            break
+                        total += x * y
+                return total
+            print(f(RUNS))
+            def g():
+                return [x * 2 for x in range(RUNS) if x % 2]
+            print(sum(g()))
+        """)
+        expected = 0
+        for i in range(RUNS):
+            if i % 3 == 0:
+                expected += i
+            elif i % 3 == 1 and i > 5 or i == 2:
+                expected -= 1
+        expected += 4 + 8 + 12
+        self.assertEqual(out, [str(expected),
+                               str(sum(x * 2 for x in range(RUNS) if x % 2))])
+
+    def test_calls(self):
+        out = self.run_jit("""
+            class A:
+                def __init__(self, x):
+                    self.x = x
+                def method(self, y, *args, z=0, **kwargs):
+                    return self.x + y + len(args) + z + len(kwargs)
+            def f(n):
+                a = A(1)
+                total = 0
+                for i in range(n):
+                    total += a.method(i)
+                    total += a.method(i, 1, 2, z=3, w=4)
+                    total += len([i, i]) + abs(-i) + max(i, 1)
+                return total
+            print(f(RUNS))
+            def fib(n):
+                return n if n < 2 else fib(n - 1) + fib(n - 2)
+            print(fib(20))
+        """)
+        expected = sum((1 + i) + (1 + i + 2 + 3 + 1) + 2 + i + max(i, 1)
+                       for i in range(RUNS))
+        self.assertEqual(out, [str(expected), '6765'])
+
+    def test_attributes_and_items(self):
+        out = self.run_jit("""
+            class A:
+                __slots__ = ('x',)
+            class B:
+                pass
+            def f(obj, d, lst):
+                obj.x = obj.x + 1
+                d['k'] = d.get('k', 0) + 1
+                lst[0] += lst[-1]
+                del d['k']
+                d['k'] = obj.x
+                return obj.x, lst[0], lst[1:], (1, 2)[1]
+            a = A()
+            a.x = 0
+            b = B()
+            b.x = 0
+            d = {}
+            lst = [0, 1]
+            for i in range(RUNS):
+                r = f(a if i % 2 else b, d, lst)
+            print(r, a.x, b.x, d)
+            b.__dict__.clear()
+            try:
+                f(b, d, lst)
+            except AttributeError as e:
+                print(e)
+        """)
+        self.assertEqual(out, [
+            f"({RUNS // 2}, {RUNS}, [1], 2) {RUNS // 2} {RUNS // 2} "
+            f"{{'k': {RUNS // 2}}}",
+            "'B' object has no attribute 'x'",
+        ])
+
+    def test_globals_and_closures(self):
+        out = self.run_jit("""
+            counter = 0
+            def make():
+                cell = 0
+                def inc():
+                    nonlocal cell
+                    global counter
+                    cell += 1
+                    counter += 1
+                    return cell, counter, len
+                return inc
+            inc = make()
+            for i in range(RUNS):
+                r = inc()
+            print(r[:2])
+            len = 'shadowed'
+            print(inc()[2])
+            del len
+            print(inc()[2])
+            del counter
+            try:
+                inc()
+            except NameError as e:
+                print(e)
+        """)
+        self.assertEqual(out, [
+            f"({RUNS}, {RUNS})",
+            "shadowed",
+            "<built-in function len>",
+            "name 'counter' is not defined",
+        ])
+
+    def test_unbound_local(self):
+        out = self.run_jit("""
+            def f(flag):
+                if flag:
+                    x = 1
+                return x
+            for i in range(RUNS):
+                f(True)
+            try:
+                f(False)
+            except UnboundLocalError as e:
+                print(e)
+            def g(flag):
+                if flag:
+                    y = 1
+                def inner():
+                    return y
+                return inner()
+            for i in range(RUNS):
+                g(True)
+            try:
+                g(False)
+            except NameError as e:
+                print(e)
+        """)
+        self.assertEqual(out, [
+            "local variable 'x' referenced before assignment",
+            "free variable 'y' referenced before assignment in enclosing scope",
+        ])
+
+    def test_exceptions(self):
+        out = self.run_jit("""
+            import traceback
+            def div(a, b):
+                return a // b
+            def f(n):
+                caught = 0
+                for i in range(n):
+                    try:
+                        div(i, i % 100)
+                    except ZeroDivisionError:
+                        caught += 1
+                    finally:
+                        caught += 0
+                return caught
+            print(f(RUNS))
+            try:
+                div(1, 0)
+            except ZeroDivisionError as e:
+                tb = traceback.extract_tb(e.__traceback__)
+                print([(t.name, t.line) for t in tb])
+            def g():
+                for i in range(RUNS):
+                    pass
+                return [1, 2][5]
+            try:
+                g()
+            except IndexError as e:
+                tb = traceback.extract_tb(e.__traceback__)
+                print(tb[-1].name, tb[-1].line)
+        """)
+        self.assertEqual(out, [
+            str(RUNS // 100),
+            "[('<module>', ''), ('div', '')]",
+            "g ",
+        ])
+
+    def test_strings(self):
+        out = self.run_jit("""
+            def f(n):
+                s = ''
+                for i in range(n):
+                    s += 'a'
+                    s = s + 'b'
+                return s
+            s = f(RUNS)
+            print(len(s), s[:4])
+            def g(x):
+                return f'{x}-{x!r:>5}-{x:03}'
+            for i in range(RUNS):
+                r = g(i)
+            print(r)
+        """)
+        self.assertEqual(out, [f"{2 * RUNS} abab",
+                               f"{RUNS - 1}- {RUNS - 1!r}-{RUNS - 1}"])
+
+    def test_unpacking(self):
+        out = self.run_jit("""
+            def f(seq):
+                a, b = seq
+                return b, a
+            for i in range(RUNS):
+                r = f((i, 1)), f([i, 2])
+            print(r)
+            print(f(iter('xy')), f('zt'))
+            try:
+                f((1, 2, 3))
+            except ValueError as e:
+                print(e)
+        """)
+        self.assertEqual(out, [
+            f"((1, {RUNS - 1}), (2, {RUNS - 1}))",
+            "('y', 'x') ('t', 'z')",
+            "too many values to unpack (expected 2)",
+        ])
+
+    def test_generators(self):
+        out = self.run_jit("""
+            def gen(n):
+                for i in range(n):
+                    yield i * 2
+            def f(n):
+                return sum(gen(n))
+            for i in range(3):
+                r = f(RUNS)
+            print(r)
+        """)
+        self.assertEqual(out, [str(sum(i * 2 for i in range(RUNS)))])
+
+    def test_tracing(self):
+        # Tracing and profiling turned on while compiled code runs are seen
+        # like in the interpreter, which the code runs in from then on
+        out = self.run_jit("""
+            import sys
+            lines = []
+            def tracer(frame, event, arg):
+                if frame.f_code is f.__code__ and event == 'line':
+                    lines.append(frame.f_lineno - f.__code__.co_firstlineno)
+                return tracer
+            def f(n, trace):
+                total = 0
+                for i in range(n):
+                    if trace and i == n - 2:
+                        sys._getframe().f_trace = tracer
+                        sys.settrace(tracer)
+                    total += i
+                sys.settrace(None)
+                return total
+            for i in range(5):
+                f(RUNS, False)
+            print(f(RUNS, True), lines)
+            sys.settrace(tracer)
+            print(f(2, False), lines[6:])
+            sys.settrace(None)
+            calls = []
+            def profiler(frame, event, arg):
+                calls.append(event)
+            def g(n):
+                for i in range(n):
+                    if i == n - 2:
+                        sys.setprofile(profiler)
+                    abs(i)
+                sys.setprofile(None)
+            g(RUNS)
+            print(calls.count('c_call'))
+        """)
+        self.assertEqual(out, [
+            f"{sum(range(RUNS))} [6, 2, 3, 6, 2, 7]",
+            "1 [1, 2, 3, 6, 2, 3, 6, 2, 7]",
+            "3",
+        ])
+
+    def test_signals(self):
+        out = self.run_jit("""
+            import _thread, threading, time
+            def spin(started):
+                i = 0
+                while True:
+                    if i == RUNS:
+                        started.set()
+                    i += 1
+            def interrupt():
+                started.wait()
+                _thread.interrupt_main()
+            started = threading.Event()
+            t = threading.Thread(target=interrupt)
+            t.start()
+            try:
+                spin(started)
+            except KeyboardInterrupt:
+                print('interrupted')
+            t.join()
+        """)
+        self.assertEqual(out, ['interrupted'])
+
+    def test_deep_recursion(self):
+        out = self.run_jit("""
+            import sys
+            def recurse(n):
+                if n == 0:
+                    return 0
+                return recurse(n - 1) + 1
+            for i in range(RUNS // 100):
+                recurse(100)
+            sys.setrecursionlimit(100_000)
+            print(recurse(50_000))
+            def infinite(n):
+                return infinite(n + 1) + 1
+            sys.setrecursionlimit(1000)
+            try:
+                infinite(0)
+            except RecursionError:
+                print('RecursionError')
+        """)
+        self.assertEqual(out, ['50000', 'RecursionError'])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -139,6 +139,106 @@ We also repeat each of the above scoping tests inside a function
     >>> test_func()
     [2, 2, 2, 2, 2]
 
+########### Comprehensions compiled inline in functions ############
+
+List, set and dict comprehensions in a function do not create a function.
+
+    >>> import types
+    >>> def f(data):
+    ...     return [x for x in data], {x for x in data}, {x: x for x in data}
+    >>> [c for c in f.__code__.co_consts if isinstance(c, types.CodeType)]
+    []
+    >>> f([1, 2])
+    ([1, 2], {1, 2}, {1: 1, 2: 2})
+
+Their variables are isolated from the variables of the function.
+
+    >>> def f(x, data):
+    ...     r = [x * 2 for x in data]
+    ...     return r, x
+    >>> f(5, [1, 2])
+    ([2, 4], 5)
+    >>> def f(data):
+    ...     r = [x for x in data]
+    ...     return r, x
+    >>> f([1, 2])
+    Traceback (most recent call last):
+      ...
+    NameError: name 'x' is not defined
+    >>> def f(data):
+    ...     r = [x for x in data]
+    ...     return r, locals()
+    >>> f([1, 2])
+    ([1, 2], {'data': [1, 2], 'r': [1, 2]})
+
+even when the comprehension raises an exception caught in the function
+
+    >>> def f(data):
+    ...     x = 'outer'
+    ...     try:
+    ...         [1 / x for x in data]
+    ...     except ZeroDivisionError:
+    ...         pass
+    ...     return x
+    >>> f([1, 0])
+    'outer'
+    >>> def f(data):
+    ...     try:
+    ...         [1 / x for x in data]
+    ...     except ZeroDivisionError:
+    ...         pass
+    ...     return x
+    >>> f([1, 0])
+    Traceback (most recent call last):
+      ...
+    NameError: name 'x' is not defined
+
+The outermost iterable is evaluated in the function.
+
+    >>> def f(x):
+    ...     return [x + 1 for x in x], x
+    >>> f([1, 2])
+    ([2, 3], [1, 2])
+
+Nested comprehensions
+
+    >>> def f(rows):
+    ...     x = 'outer'
+    ...     return [[x * 2 for x in x] for x in rows], x
+    >>> f([[1, 2], [3]])
+    ([[2, 4], [6]], 'outer')
+    >>> def f(n):
+    ...     return {i: [j for j in range(i)] for i in range(n)}
+    >>> f(3)
+    {0: [], 1: [0], 2: [0, 1]}
+
+Assignment expressions bind in the function
+
+    >>> def f(data):
+    ...     r = [y := x + 1 for x in data]
+    ...     return r, y
+    >>> f([1, 2])
+    ([2, 3], 3)
+
+Closures over the variables of a comprehension or the function
+
+    >>> def f(data):
+    ...     return [(lambda: x)() for x in data]
+    >>> f([1, 2])
+    [1, 2]
+    >>> def f(data):
+    ...     x = 1
+    ...     r = [x for x in data]
+    ...     return r, (lambda: x)()
+    >>> f([5])
+    ([5], 1)
+    >>> def f(data):
+    ...     y = 10
+    ...     r = [x + y for x in data]
+    ...     return r, (lambda: y)()
+    >>> f([5])
+    ([15], 10)
+
 """
 
 
@@ -0,0 +1,600 @@
+"""Tests for the specialization of hot bytecode (Python/specialize.c).
+
+Code objects are quickened after OPCACHE_MIN_RUNS executions, so every
+test runs the code under test many times, first with the types it is
+specialized for and then with other types that must trigger a deopt.
+"""
+
+import unittest
+
+# Comfortably above OPCACHE_MIN_RUNS in Python/ceval.c
+RUNS = 2000
+
+
+class BinaryAddTests(unittest.TestCase):
+
+    def test_add(self):
+        def add(a, b):
+            return a + b
+        for i in range(RUNS):
+            self.assertEqual(add(i, 1), i + 1)
+            self.assertEqual(add(0.5, 1.0), 1.5)
+            self.assertEqual(add("a", "b"), "ab")
+        for i in range(RUNS):
+            self.assertEqual(add(2**100, i), 2**100 + i)
+            self.assertEqual(add(1, 0.5), 1.5)
+            self.assertEqual(add([1], [i]), [1, i])
+            self.assertEqual(add(True, True), 2)
+
+    def test_inplace_add(self):
+        def f(x, y):
+            x += y
+            return x
+        for i in range(RUNS):
+            self.assertEqual(f(i, i), 2 * i)
+            self.assertEqual(f("x", "y"), "xy")
+        lst = []
+        for i in range(RUNS):
+            self.assertIs(f(lst, [i]), lst)
+        self.assertEqual(lst, list(range(RUNS)))
+
+    def test_unicode_concat_in_place(self):
+        def f(n):
+            s = ""
+            for i in range(n):
+                s += "ab"
+            return s
+        for i in range(RUNS // 10):
+            self.assertEqual(f(10), "ab" * 10)
+
+    def test_subclasses(self):
+        class MyInt(int):
+            def __add__(self, other):
+                return "MyInt"
+        def add(a, b):
+            return a + b
+        for i in range(RUNS):
+            add(i, i)
+        for i in range(RUNS):
+            self.assertEqual(add(MyInt(i), MyInt(i)), "MyInt")
+
+
+class CompareOpTests(unittest.TestCase):
+
+    def test_compare(self):
+        def cmp(a, b):
+            return (a < b, a <= b, a == b, a != b, a > b, a >= b)
+        def expected(a, b):
+            return (a < b, a <= b, a == b, a != b, a > b, a >= b)
+        for i in range(RUNS):
+            self.assertEqual(cmp(i, 1000), expected(i, 1000))
+            self.assertEqual(cmp(-i, 5), expected(-i, 5))
+            self.assertEqual(cmp(i / 3, 100.0), expected(i / 3, 100.0))
+        for i in range(RUNS):
+            self.assertEqual(cmp(2**70 + i, 2**70), expected(2**70 + i, 2**70))
+            self.assertEqual(cmp(i, 100.0), expected(i, 100.0))
+            self.assertEqual(cmp("a", "b"), (True, True, False, True, False, False))
+
+    def test_nan(self):
+        nan = float("nan")
+        def cmp(a, b):
+            return (a < b, a == b, a != b)
+        for i in range(RUNS):
+            self.assertEqual(cmp(1.0, 2.0), (True, False, True))
+        for i in range(RUNS):
+            self.assertEqual(cmp(nan, nan), (False, False, True))
+
+    def test_str_equality(self):
+        def eq(a, b):
+            return a == b, a != b
+        for i in range(RUNS):
+            self.assertEqual(eq("spam", "sp" + "am"), (True, False))
+            self.assertEqual(eq("spam", "eggs"), (False, True))
+            self.assertEqual(eq("€", "€"), (True, False))
+            self.assertEqual(eq("a", "€"), (False, True))
+
+
+class ForIterTests(unittest.TestCase):
+
+    def test_for_iter(self):
+        def total(seq):
+            t = 0
+            for x in seq:
+                t += x
+            return t
+        for i in range(RUNS):
+            self.assertEqual(total([1, 2, 3]), 6)
+            self.assertEqual(total(range(i % 5)), sum(range(i % 5)))
+            self.assertEqual(total(range(10, 0, -3)), 22)
+        for i in range(RUNS):
+            self.assertEqual(total((1, 2, 3)), 6)
+            self.assertEqual(total({4: 0, 5: 0}), 9)
+            self.assertEqual(total(iter([1])), 1)
+
+    def test_list_modified_during_iteration(self):
+        def f(lst):
+            n = 0
+            for x in lst:
+                if n < 3:
+                    lst.append(x)
+                n += 1
+            return n
+        for i in range(RUNS):
+            self.assertEqual(f([1, 2]), 5)
+
+
+class CallTests(unittest.TestCase):
+
+    def test_call_function(self):
+        def g(x, y=2):
+            return x + y
+        def f(func, x):
+            return func(x)
+        for i in range(RUNS):
+            self.assertEqual(f(g, i), i + 2)
+            self.assertEqual(f(len, "ab"), 2)
+            self.assertEqual(f(abs, -i), i)
+        for i in range(RUNS):
+            self.assertEqual(f(str, i), str(i))
+            self.assertEqual(f(lambda x: x * 2, i), i * 2)
+            self.assertEqual(f([].__class__, "ab"), ["a", "b"])
+
+    def test_call_builtin_fast(self):
+        def f(x):
+            return isinstance(x, int), getattr(x, "real", None)
+        for i in range(RUNS):
+            self.assertEqual(f(i), (True, i))
+            self.assertEqual(f("x"), (False, None))
+
+    def test_call_errors(self):
+        def g(x):
+            return len(x)
+        for i in range(RUNS):
+            g("a")
+        for i in range(RUNS // 10):
+            with self.assertRaises(TypeError):
+                g(1)
+
+    def test_call_method(self):
+        class C:
+            def m(self, x):
+                return x * 2
+        class D:
+            def m(self, x):
+                return -x
+        def f(obj, x):
+            return obj.m(x)
+        def g(lst, x):
+            lst.append(x)
+            return lst.count(x)
+        for i in range(RUNS):
+            self.assertEqual(f(C(), i), 2 * i)
+            self.assertEqual(g([], i), 1)
+        for i in range(RUNS):
+            self.assertEqual(f(D(), i), -i)
+            d = {}
+            with self.assertRaises(AttributeError):
+                g(d, i)
+            self.assertEqual(f(type("E", (), {"m": staticmethod(abs)})(), -i), i)
+
+    def test_recursion_limit(self):
+        # The code object gets quickened in the middle of the recursion
+        def rec(n):
+            return rec(n + 1)
+        with self.assertRaises(RecursionError):
+            rec(0)
+        with self.assertRaises(RecursionError):
+            rec(0)
+
+
+class AttributeTests(unittest.TestCase):
+
+    def test_instance_attributes(self):
+        class C:
+            def __init__(self, x):
+                self.x = x
+                self.y = x + 1
+        def get(obj):
+            return obj.x, obj.y
+        def set_(obj, v):
+            obj.x = v
+        objs = [C(i) for i in range(RUNS)]
+        for i, obj in enumerate(objs):
+            self.assertEqual(get(obj), (i, i + 1))
+            set_(obj, -i)
+            self.assertEqual(get(obj), (-i, i + 1))
+        # Combined (non-shared) instance dicts
+        for i, obj in enumerate(objs):
+            del obj.y
+            obj.y = i
+            self.assertEqual(get(obj), (-i, i))
+            set_(obj, i)
+            self.assertEqual(obj.x, i)
+        # Missing attributes
+        for i in range(RUNS):
+            obj = C(i)
+            del obj.x
+            with self.assertRaises(AttributeError):
+                get(obj)
+            set_(obj, i)
+            self.assertEqual(get(obj), (i, i + 1))
+
+    def test_shared_keys_insertion_order(self):
+        class C:
+            def __init__(self, first):
+                if first:
+                    self.a = 1
+                    self.b = 2
+                else:
+                    self.b = 2
+                    self.a = 1
+        for i in range(RUNS):
+            self.assertEqual(list(vars(C(i % 2)).items()),
+                             [("a", 1), ("b", 2)] if i % 2 else
+                             [("b", 2), ("a", 1)])
+
+    def test_class_modified(self):
+        class C:
+            pass
+        def get(obj):
+            return obj.x
+        def set_(obj, v):
+            obj.x = v
+        obj = C()
+        for i in range(RUNS):
+            set_(obj, i)
+            self.assertEqual(get(obj), i)
+        C.x = property(lambda self: "property",
+                       lambda self, v: setattr(self, "stored", v))
+        for i in range(RUNS):
+            set_(obj, i)
+            self.assertEqual(obj.stored, i)
+            self.assertEqual(get(obj), "property")
+        del C.x
+        for i in range(RUNS):
+            self.assertEqual(get(obj), RUNS - 1)
+        C.__getattribute__ = lambda self, name: "getattribute"
+        C.__setattr__ = lambda self, name, v: None
+        for i in range(RUNS):
+            set_(obj, i)
+            self.assertEqual(get(obj), "getattribute")
+
+    def test_base_class_modified(self):
+        class A:
+            pass
+        class B(A):
+            pass
+        def get(obj):
+            return obj.x
+        obj = B()
+        obj.x = 1
+        for i in range(RUNS):
+            self.assertEqual(get(obj), 1)
+        A.x = property(lambda self: 2)
+        self.assertEqual(get(obj), 2)
+
+    def test_dict_replaced(self):
+        class C:
+            pass
+        def get(obj):
+            return obj.x
+        obj = C()
+        obj.x = 1
+        for i in range(RUNS):
+            self.assertEqual(get(obj), 1)
+        obj.__dict__ = {"y": 0, "x": 2}
+        self.assertEqual(get(obj), 2)
+        obj.__dict__ = {}
+        with self.assertRaises(AttributeError):
+            get(obj)
+
+    def test_slots(self):
+        class C:
+            __slots__ = ("x", "y")
+        def get(obj):
+            return obj.x
+        def set_(obj, v):
+            obj.x = v
+        obj = C()
+        for i in range(RUNS):
+            set_(obj, i)
+            self.assertEqual(get(obj), i)
+        del obj.x
+        with self.assertRaises(AttributeError):
+            get(obj)
+        set_(obj, "x")
+        self.assertEqual(get(obj), "x")
+
+    def test_module(self):
+        import math
+        import types
+        def get(mod):
+            return mod.pi
+        for i in range(RUNS):
+            self.assertEqual(get(math), math.pi)
+        mod = types.ModuleType("mod")
+        mod.pi = 3
+        self.assertEqual(get(mod), 3)
+        del mod.pi
+        with self.assertRaises(AttributeError):
+            get(mod)
+        mod.__getattr__ = lambda name: name
+        self.assertEqual(get(mod), "pi")
+
+    def test_gc_tracking(self):
+        import gc
+        import weakref
+        class C:
+            def __init__(self):
+                self.a = None
+        def set_(obj, v):
+            obj.a = v
+        for i in range(RUNS):
+            obj = C()
+            set_(obj, obj)
+        obj = C()
+        set_(obj, obj)
+        ref = weakref.ref(obj)
+        del obj
+        gc.collect()
+        self.assertIsNone(ref())
+
+
+class ExceptionTableTests(unittest.TestCase):
+    # Try blocks of quickened code are found in an exception table rather
+    # than on the block stack of the frame.
+
+    def test_try_except_finally(self):
+        def f(x):
+            log = []
+            try:
+                try:
+                    log.append(1 / x)
+                except ZeroDivisionError:
+                    log.append("except")
+                    try:
+                        [][x]
+                    except IndexError:
+                        log.append("nested")
+                else:
+                    log.append("else")
+            finally:
+                log.append("finally")
+            return log
+        for i in range(RUNS):
+            self.assertEqual(f(1), [1.0, "else", "finally"])
+            self.assertEqual(f(0), ["except", "nested", "finally"])
+            with self.assertRaises(TypeError):
+                f("x")
+
+    def test_raise_in_handler(self):
+        def f(x):
+            try:
+                try:
+                    raise KeyError(x)
+                except KeyError as e:
+                    raise ValueError(x) from e
+            except ValueError as e:
+                return e.__cause__.args[0], e.args[0]
+        for i in range(RUNS):
+            self.assertEqual(f(i), (i, i))
+
+    def test_return_break_continue(self):
+        def f(n):
+            total = 0
+            for i in range(n):
+                try:
+                    if i == 3:
+                        continue
+                    if i == 5:
+                        break
+                    total += i
+                finally:
+                    total += 100
+            try:
+                return total
+            finally:
+                total = -1
+        for i in range(RUNS):
+            self.assertEqual(f(10), 0 + 1 + 2 + 4 + 600)
+
+    def test_with(self):
+        class CM:
+            def __init__(self, log, swallow=False):
+                self.log = log
+                self.swallow = swallow
+            def __enter__(self):
+                self.log.append("enter")
+                return self
+            def __exit__(self, *exc):
+                self.log.append(exc[0])
+                return self.swallow
+        def f(x, swallow):
+            log = []
+            with CM(log, swallow):
+                with CM(log):
+                    log.append(1 / x)
+            return log
+        for i in range(RUNS):
+            self.assertEqual(f(1, False),
+                             ["enter", "enter", 1.0, None, None])
+            self.assertEqual(f(0, True),
+                             ["enter", "enter", ZeroDivisionError,
+                              ZeroDivisionError])
+            with self.assertRaises(ZeroDivisionError):
+                f(0, False)
+
+    def test_generator(self):
+        def gen(log):
+            try:
+                with open(__file__) as fp:
+                    log.append("with")
+                    try:
+                        yield 1
+                        yield 2
+                    except KeyError:
+                        log.append("KeyError")
+                        yield 3
+                log.append(fp.closed)
+            finally:
+                log.append("finally")
+        for i in range(RUNS):
+            log = []
+            self.assertEqual(list(gen(log)), [1, 2])
+            self.assertEqual(log, ["with", True, "finally"])
+            log = []
+            g = gen(log)
+            next(g)
+            self.assertEqual(g.throw(KeyError), 3)
+            g.close()
+            self.assertEqual(log, ["with", "KeyError", "finally"])
+
+    def test_generator_started_before_quickening(self):
+        def gen():
+            try:
+                yield 1
+                raise KeyError
+            except KeyError:
+                yield 2
+        started = gen()
+        next(started)
+        for i in range(RUNS):
+            self.assertEqual(list(gen()), [1, 2])
+        self.assertEqual(next(started), 2)
+
+    def test_coroutine(self):
+        class ACM:
+            def __init__(self, log):
+                self.log = log
+            async def __aenter__(self):
+                self.log.append("aenter")
+            async def __aexit__(self, *exc):
+                self.log.append(exc[0])
+                return True
+        async def coro(log, x):
+            async with ACM(log):
+                log.append(1 / x)
+        def run(coro):
+            try:
+                coro.send(None)
+            except StopIteration as e:
+                return e.value
+        for i in range(RUNS):
+            log = []
+            run(coro(log, 1))
+            run(coro(log, 0))
+            self.assertEqual(log, ["aenter", 1.0, None,
+                                   "aenter", ZeroDivisionError])
+
+    def test_jump_out_of_blocks(self):
+        import sys
+        class CM:
+            def __enter__(self):
+                return self
+            def __exit__(self, *exc):
+                pass
+        def f():
+            x = 1
+            for i in range(2):
+                with CM():
+                    try:
+                        x = 2
+                        x = 3
+                    finally:
+                        pass
+            return x
+        for i in range(RUNS):
+            self.assertEqual(f(), 3)
+        first = f.__code__.co_firstlineno
+        def tracer(frame, event, arg):
+            if event == "line" and frame.f_code is f.__code__:
+                if frame.f_lineno == first + 6:
+                    # Jump from "x = 3" to "return x"
+                    frame.f_lineno = first + 9
+            return tracer
+        sys.settrace(tracer)
+        try:
+            res = f()
+        finally:
+            sys.settrace(None)
+        self.assertEqual(res, 2)
+
+
+class SuperinstructionTests(unittest.TestCase):
+    # Frequent pairs of instructions are fused in quickened code
+
+    def test_pairs(self):
+        def f(a, b):
+            x = a
+            y = b
+            x, y = y, x
+            z = x + 1
+            return (a, b, x, y, z, 0)
+        def g(a):
+            return None
+        for i in range(RUNS):
+            self.assertEqual(f(i, 2), (i, 2, 2, i, 3, 0))
+            self.assertIsNone(g(i))
+
+    def test_unbound_local(self):
+        def f(flag):
+            if flag:
+                y = 1
+            x = 0
+            return x + y
+        for i in range(RUNS):
+            self.assertEqual(f(True), 1)
+        try:
+            f(False)
+        except UnboundLocalError as e:
+            tb = e.__traceback__
+        else:
+            self.fail("UnboundLocalError not raised")
+        while tb.tb_next:
+            tb = tb.tb_next
+        self.assertEqual(tb.tb_lineno, f.__code__.co_firstlineno + 4)
+
+    def test_jump_to_second_instruction(self):
+        def f(n):
+            a = b = 0
+            for i in range(n):
+                a = i
+                b = a
+            return a, b
+        for i in range(RUNS):
+            self.assertEqual(f(3), (2, 2))
+
+    def test_line_events(self):
+        import sys
+        def f(a):
+            b = a
+            c = b
+            return c
+        for i in range(RUNS):
+            f(i)
+        lines = []
+        def tracer(frame, event, arg):
+            if event == "line" and frame.f_code is f.__code__:
+                lines.append(frame.f_lineno - f.__code__.co_firstlineno)
+            return tracer
+        sys.settrace(tracer)
+        try:
+            f(1)
+        finally:
+            sys.settrace(None)
+        self.assertEqual(lines, [1, 2, 3])
+
+    def test_unicode_concat_in_place(self):
+        def f(n):
+            s = ""
+            for i in range(n):
+                s = s + "ab"
+                t = s
+                del t
+            return s
+        for i in range(RUNS // 10):
+            self.assertEqual(f(10), "ab" * 10)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -4,6 +4,7 @@ import gc
 import locale
 import operator
 import os
+import re
 import struct
 import subprocess
 import sys
@@ -203,6 +204,79 @@ class SysModuleTest(unittest.TestCase):
         finally:
             sys.setswitchinterval(orig)
 
+    @threading_helper.reap_threads
+    def test_gilstats(self):
+        import threading
+        import time
+        keys = {'acquisitions', 'contended', 'drop_requests', 'forced_drops',
+                'wait_time', 'hold_time', 'max_hold_time', 'max_hold_code',
+                'max_hold_lineno'}
+        results = []
+
+        def worker():
+            time.sleep(0.001)
+            results.append(sys._getgilstats()[threading.get_ident()])
+            # Statistics don't change when collection is disabled
+            sys._setgilstats(False)
+            time.sleep(0.001)
+            results.append(sys._getgilstats()[threading.get_ident()])
+
+        sys._setgilstats(True)
+        try:
+            t = threading.Thread(target=worker)
+            t.start()
+            t.join()
+        finally:
+            sys._setgilstats(False)
+
+        stats = results[0]
+        self.assertEqual(set(stats), keys)
+        # The worker took the GIL when starting and after sleeping
+        self.assertGreaterEqual(stats['acquisitions'], 2)
+        self.assertLessEqual(stats['contended'], stats['acquisitions'])
+        self.assertGreaterEqual(stats['wait_time'], 0.0)
+        self.assertGreater(stats['hold_time'], 0.0)
+        self.assertGreaterEqual(stats['hold_time'], stats['max_hold_time'])
+        self.assertIs(type(stats['max_hold_code']), type(worker.__code__))
+        self.assertIsInstance(stats['max_hold_lineno'], int)
+        self.assertEqual(results[1]['acquisitions'], stats['acquisitions'])
+        self.assertEqual(set(sys._getgilstats()[threading.get_ident()]), keys)
+
+    @threading_helper.reap_threads
+    def test_gilmode(self):
+        import threading
+        self.assertEqual(sys._getgilmode(), 'default')
+        self.assertRaises(ValueError, sys._setgilmode, 'spam')
+        self.assertRaises(TypeError, sys._setgilmode, 1)
+        orig_interval = sys.getswitchinterval()
+        orig_priority = sys._getgilpriority()
+        self.addCleanup(sys.setswitchinterval, orig_interval)
+        self.addCleanup(sys._setgilpriority, orig_priority)
+        self.addCleanup(sys._setgilmode, 'default')
+        sys.setswitchinterval(1e-5)
+
+        def worker(priority, results):
+            sys._setgilpriority(priority)
+            self.assertEqual(sys._getgilpriority(), priority)
+            n = 0
+            for i in range(20_000):
+                n += i
+            results.append(n)
+
+        for mode in ('fifo', 'priority', 'default'):
+            with self.subTest(mode=mode):
+                sys._setgilmode(mode)
+                self.assertEqual(sys._getgilmode(), mode)
+                results = []
+                threads = [threading.Thread(target=worker,
+                                            args=(i % 3 - 1, results))
+                           for i in range(6)]
+                for t in threads:
+                    t.start()
+                for t in threads:
+                    t.join()
+                self.assertEqual(results, [sum(range(20_000))] * 6)
+
     def test_recursionlimit(self):
         self.assertRaises(TypeError, sys.getrecursionlimit, 42)
         oldlimit = sys.getrecursionlimit()
@@ -516,7 +590,7 @@ class SysModuleTest(unittest.TestCase):
         info = sys.thread_info
         self.assertEqual(len(info), 3)
         self.assertIn(info.name, ('nt', 'pthread', 'solaris', None))
-        self.assertIn(info.lock, ('semaphore', 'mutex+cond', None))
+        self.assertIn(info.lock, ('futex', 'semaphore', 'mutex+cond', None))
 
     def test_43581(self):
         # Can't use sys.stdout, as this is a StringIO object when
@@ -583,6 +657,51 @@ class SysModuleTest(unittest.TestCase):
     def test_clear_type_cache(self):
         sys._clear_type_cache()
 
+    @test.support.cpython_only
+    def test_stats(self):
+        def f(x):
+            return abs(x) + 1
+        sys._stats_clear()
+        sys._stats_on()
+        try:
+            for i in range(2000):
+                f(i)
+        finally:
+            sys._stats_off()
+        stats = sys._stats_dump()
+        self.assertEqual(stats["calls"][f.__code__], 2000)
+        opcodes = stats["opcodes"]
+        self.assertGreaterEqual(opcodes["RETURN_VALUE"]["execution_count"],
+                                2000)
+        if not hasattr(sys, "gettotalrefcount"):
+            # The opcache is disabled in debug builds
+            add = opcodes["BINARY_ADD_ADAPTIVE"]
+            self.assertEqual(add["specialization_success"], 1)
+            self.assertGreater(opcodes["BINARY_ADD_INT"]["execution_count"],
+                               0)
+            self.assertGreater(opcodes["LOAD_GLOBAL"]["hit"], 0)
+        for counts in opcodes.values():
+            self.assertEqual(set(counts), {
+                "execution_count", "hit", "miss", "deopt",
+                "specialization_success", "specialization_failure"})
+
+        # Nothing is counted while the statistics are off
+        f(0)
+        self.assertEqual(sys._stats_dump(), stats)
+        sys._stats_clear()
+        self.assertEqual(sys._stats_dump(), {"opcodes": {}, "calls": {}})
+
+    @test.support.cpython_only
+    def test_pystats_option(self):
+        code = "import sys; print(len(sys._stats_dump()['calls']) > 0)"
+        rc, out, err = assert_python_ok("-X", "pystats", "-c", code)
+        self.assertEqual(out.rstrip(), b"True")
+        self.assertTrue(err.startswith(b"Execution statistics"), err)
+        self.assertIn(b"RETURN_VALUE: execution_count=", err)
+        rc, out, err = assert_python_ok("-c", code)
+        self.assertEqual(out.rstrip(), b"False")
+        self.assertEqual(err, b"")
+
     def test_ioencoding(self):
         env = dict(os.environ)
 
@@ -782,6 +901,23 @@ class SysModuleTest(unittest.TestCase):
         # The function has no parameter
         self.assertRaises(TypeError, sys._debugmallocstats, True)
 
+    @test.support.cpython_only
+    @unittest.skipUnless(support.with_pymalloc(), 'need pymalloc')
+    @unittest.skipIf(sysconfig.get_config_var('EXPERIMENTAL_ISOLATED_SUBINTERPRETERS'),
+                     'pymalloc is disabled with isolated subinterpreters')
+    def test_debugmallocstats_subinterpreter(self):
+        # Each interpreter allocates from its own arenas
+        code = textwrap.dedent("""
+            import sys, _testcapi
+            x = [str(i) for i in range(100_000)]
+            _testcapi.run_in_subinterp("import sys; sys._debugmallocstats()")
+            sys._debugmallocstats()
+        """)
+        ret, out, err = assert_python_ok('-c', code, PYTHONMALLOC='pymalloc')
+        sizes = re.findall(rb"# bytes in allocated blocks *= *([\d,]+)", err)
+        sub, main = [int(size.replace(b',', b'')) for size in sizes]
+        self.assertLess(sub, main // 2)
+
     @unittest.skipUnless(hasattr(sys, "getallocatedblocks"),
                          "sys.getallocatedblocks unavailable on this build")
     def test_getallocatedblocks(self):
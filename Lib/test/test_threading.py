@@ -383,6 +383,26 @@ class ThreadTests(BaseTestCase):
         finally:
             sys.setswitchinterval(old_interval)
 
+    def test_reused_thread_state(self):
+        # The thread states of exited threads are reused by new threads:
+        # check that nothing leaks from one thread to the next.
+        local = threading.local()
+        seen = []
+        def recurse(n):
+            return recurse(n - 1) if n else sys._getframe()
+        def f(i):
+            seen.append((getattr(local, 'x', None), sys.getprofile(),
+                         sys.exc_info()))
+            local.x = i
+            sys.setprofile(lambda *args: None)
+            self.assertIsNotNone(recurse(100))
+        for i in range(20):
+            t = threading.Thread(target=f, args=(i,))
+            t.start()
+            t.join()
+        expected = (None, threading._profile_hook, (None, None, None))
+        self.assertEqual(seen, [expected] * 20)
+
     def test_no_refcycle_through_target(self):
         class RunSelfFunction(object):
             def __init__(self, should_raise):
@@ -1351,6 +1371,59 @@ class ConditionAsRLockTests(lock_tests.RLockTests):
 class ConditionTests(lock_tests.ConditionTests):
     condtype = staticmethod(threading.Condition)
 
+class PyConditionAsRLockTests(lock_tests.RLockTests):
+    locktype = staticmethod(threading._PyCondition)
+
+class PyConditionTests(lock_tests.ConditionTests):
+    condtype = staticmethod(threading._PyCondition)
+
+@unittest.skipIf(threading._CCondition is None,
+                 'Condition not implemented in C')
+class CConditionTests(lock_tests.ConditionTests):
+    condtype = staticmethod(threading._CCondition)
+
+    def test_other_lock(self):
+        # Locks other than Lock and RLock are used through their methods.
+        cond = self.condtype(threading._PyRLock())
+        with cond:
+            with cond:
+                self.assertTrue(cond._is_owned())
+                self.assertFalse(cond.wait(0.01))
+                self.assertTrue(cond._is_owned())
+        self.assertFalse(cond._is_owned())
+        self.assertRaises(RuntimeError, cond.wait)
+
+        class Lock:
+            def __init__(self):
+                self.lock = threading.Lock()
+                self.acquire = self.lock.acquire
+                self.release = self.lock.release
+                self.__enter__ = self.lock.__enter__
+                self.__exit__ = self.lock.__exit__
+        cond = self.condtype(Lock())
+        self.assertRaises(RuntimeError, cond.notify)
+        with cond:
+            self.assertFalse(cond.wait(0.01))
+            cond.notify()
+
+    def test_uninitialized(self):
+        cond = self.condtype.__new__(self.condtype)
+        self.assertRaises(ValueError, cond.acquire)
+        self.assertRaises(ValueError, cond.wait)
+        self.assertRaises(ValueError, cond.notify)
+        repr(cond)
+
+    def test_subclass(self):
+        class MyCondition(self.condtype):
+            def __init__(self, value):
+                super().__init__(threading.Lock())
+                self.value = value
+        cond = MyCondition(5)
+        self.assertEqual(cond.value, 5)
+        with cond:
+            self.assertTrue(cond.wait_for(lambda: cond.value))
+            self.assertIs(cond.wait_for(lambda: None, 0.01), None)
+
 class SemaphoreTests(lock_tests.SemaphoreTests):
     semtype = staticmethod(threading.Semaphore)
 
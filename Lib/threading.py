@@ -46,6 +46,10 @@ try:
     _CRLock = _thread.RLock
 except AttributeError:
     _CRLock = None
+try:
+    _CCondition = _thread.Condition
+except AttributeError:
+    _CCondition = None
 TIMEOUT_MAX = _thread.TIMEOUT_MAX
 del _thread
 
@@ -213,7 +217,7 @@ class _RLock:
 _PyRLock = _RLock
 
 
-class Condition:
+class _PyCondition:
     """Class that implements a condition variable.
 
     A condition variable allows one or more threads to wait until they are
@@ -382,6 +386,11 @@ class Condition:
 
     notifyAll = notify_all
 
+if _CCondition is None:
+    Condition = _PyCondition
+else:
+    Condition = _CCondition
+
 
 class Semaphore:
     """This class implements semaphore objects.
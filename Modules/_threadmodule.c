@@ -6,6 +6,7 @@
 #include "pycore_pylifecycle.h"
 #include "pycore_interp.h"        // _PyInterpreterState.num_threads
 #include "pycore_pystate.h"       // _PyThreadState_Init()
+#include "structmember.h"         // PyMemberDef
 #include <stddef.h>               // offsetof()
 
 static PyObject *ThreadError;
@@ -585,6 +586,803 @@ newlockobject(void)
     return self;
 }
 
+/* Condition variable objects */
+
+/* Each thread waiting on a condition sleeps on its own lock, which it holds
+   when it enters the list of waiters and which is released by notify().
+   Waiters live on the stack of the waiting threads, the list is only accessed
+   with the GIL held.  A few waiter locks are kept in the condition object for
+   reuse, in the acquired state. */
+
+typedef struct condwaiter {
+    struct condwaiter *prev;
+    struct condwaiter *next;
+    PyThread_type_lock lock;
+    int notified;
+} condwaiter;
+
+/* Kind of the underlying lock: the operations on _thread.lock and
+   _thread.RLock objects are done directly, other locks are called through
+   their methods. */
+#define COND_LOCK 0
+#define COND_RLOCK 1
+#define COND_OTHER 2
+
+#define COND_MAX_SPARE_LOCKS 4
+
+typedef struct {
+    PyObject_HEAD
+    PyObject *cond_lock;
+    int cond_kind;
+    condwaiter *waiters_head;
+    condwaiter *waiters_tail;
+    Py_ssize_t nwaiters;
+    PyThread_type_lock spare_locks[COND_MAX_SPARE_LOCKS];
+    int nspare_locks;
+    PyObject *in_weakreflist;
+} condobject;
+
+/* State of the underlying lock saved by wait() */
+typedef struct {
+    unsigned long owner;
+    unsigned long count;
+    PyObject *state;    /* result of the _release_save() method, or NULL */
+} condsaved;
+
+_Py_IDENTIFIER(acquire);
+_Py_IDENTIFIER(release);
+_Py_IDENTIFIER(__enter__);
+_Py_IDENTIFIER(__exit__);
+_Py_IDENTIFIER(_is_owned);
+_Py_IDENTIFIER(_release_save);
+_Py_IDENTIFIER(_acquire_restore);
+_Py_IDENTIFIER(_at_fork_reinit);
+
+#define CHECK_COND_INITIALIZED(self) \
+    if ((self)->cond_lock == NULL) { \
+        PyErr_SetString(PyExc_ValueError, \
+                        "Condition object is not initialized"); \
+        return NULL; \
+    }
+
+static void
+cond_append_waiter(condobject *self, condwaiter *waiter)
+{
+    waiter->prev = self->waiters_tail;
+    waiter->next = NULL;
+    if (self->waiters_tail != NULL)
+        self->waiters_tail->next = waiter;
+    else
+        self->waiters_head = waiter;
+    self->waiters_tail = waiter;
+    self->nwaiters++;
+}
+
+static void
+cond_unlink_waiter(condobject *self, condwaiter *waiter)
+{
+    if (waiter->prev != NULL)
+        waiter->prev->next = waiter->next;
+    else
+        self->waiters_head = waiter->next;
+    if (waiter->next != NULL)
+        waiter->next->prev = waiter->prev;
+    else
+        self->waiters_tail = waiter->prev;
+    self->nwaiters--;
+}
+
+/* Return an acquired lock for a new waiter */
+static PyThread_type_lock
+cond_get_waiter_lock(condobject *self)
+{
+    PyThread_type_lock lock;
+
+    if (self->nspare_locks > 0)
+        return self->spare_locks[--self->nspare_locks];
+    lock = PyThread_allocate_lock();
+    if (lock == NULL) {
+        PyErr_SetString(ThreadError, "can't allocate lock");
+        return NULL;
+    }
+    /* Cannot fail on a new lock */
+    (void)PyThread_acquire_lock(lock, 0);
+    return lock;
+}
+
+static void
+cond_put_waiter_lock(condobject *self, PyThread_type_lock lock)
+{
+    if (self->nspare_locks < COND_MAX_SPARE_LOCKS) {
+        self->spare_locks[self->nspare_locks++] = lock;
+        return;
+    }
+    PyThread_release_lock(lock);
+    PyThread_free_lock(lock);
+}
+
+/* Return 1 if the underlying lock is owned by the current thread, 0 if it
+   isn't and -1 on error. */
+static int
+cond_is_owned(condobject *self)
+{
+    PyObject *meth, *res;
+    int r;
+
+    switch (self->cond_kind) {
+    case COND_LOCK:
+        /* A lock has no owner: assume the current thread holds it if it
+           is locked. */
+        return ((lockobject *)self->cond_lock)->locked;
+    case COND_RLOCK: {
+        rlockobject *rlock = (rlockobject *)self->cond_lock;
+        return (rlock->rlock_count > 0 &&
+                rlock->rlock_owner == PyThread_get_thread_ident());
+    }
+    }
+
+    if (_PyObject_LookupAttrId(self->cond_lock, &PyId__is_owned, &meth) < 0)
+        return -1;
+    if (meth != NULL) {
+        res = _PyObject_CallNoArg(meth);
+        Py_DECREF(meth);
+        if (res == NULL)
+            return -1;
+        r = PyObject_IsTrue(res);
+        Py_DECREF(res);
+        return r;
+    }
+
+    res = _PyObject_CallMethodIdOneArg(self->cond_lock, &PyId_acquire,
+                                       Py_False);
+    if (res == NULL)
+        return -1;
+    r = PyObject_IsTrue(res);
+    Py_DECREF(res);
+    if (r <= 0)
+        return r < 0 ? -1 : 1;
+    res = _PyObject_CallMethodIdNoArgs(self->cond_lock, &PyId_release);
+    if (res == NULL)
+        return -1;
+    Py_DECREF(res);
+    return 0;
+}
+
+/* Fully release the underlying lock, even if it was acquired recursively. */
+static int
+cond_release_save(condobject *self, condsaved *saved)
+{
+    PyObject *meth, *res;
+
+    switch (self->cond_kind) {
+    case COND_LOCK: {
+        lockobject *lock = (lockobject *)self->cond_lock;
+        if (!lock->locked) {
+            PyErr_SetString(ThreadError, "release unlocked lock");
+            return -1;
+        }
+        lock->locked = 0;
+        PyThread_release_lock(lock->lock_lock);
+        return 0;
+    }
+    case COND_RLOCK: {
+        rlockobject *rlock = (rlockobject *)self->cond_lock;
+        if (rlock->rlock_count == 0) {
+            PyErr_SetString(PyExc_RuntimeError,
+                            "cannot release un-acquired lock");
+            return -1;
+        }
+        saved->owner = rlock->rlock_owner;
+        saved->count = rlock->rlock_count;
+        rlock->rlock_count = 0;
+        rlock->rlock_owner = 0;
+        PyThread_release_lock(rlock->rlock_lock);
+        return 0;
+    }
+    }
+
+    if (_PyObject_LookupAttrId(self->cond_lock, &PyId__release_save,
+                               &meth) < 0)
+        return -1;
+    if (meth != NULL) {
+        saved->state = _PyObject_CallNoArg(meth);
+        Py_DECREF(meth);
+        return saved->state != NULL ? 0 : -1;
+    }
+    res = _PyObject_CallMethodIdNoArgs(self->cond_lock, &PyId_release);
+    if (res == NULL)
+        return -1;
+    Py_DECREF(res);
+    return 0;
+}
+
+/* Reacquire the underlying lock and restore the state saved by
+   cond_release_save().  Consume saved->state. */
+static int
+cond_acquire_restore(condobject *self, condsaved *saved)
+{
+    PyThread_type_lock lock;
+    PyObject *meth, *res;
+    int r = 1;
+
+    switch (self->cond_kind) {
+    case COND_LOCK:
+        lock = ((lockobject *)self->cond_lock)->lock_lock;
+        break;
+    case COND_RLOCK:
+        lock = ((rlockobject *)self->cond_lock)->rlock_lock;
+        break;
+    default:
+        if (_PyObject_LookupAttrId(self->cond_lock, &PyId__acquire_restore,
+                                   &meth) < 0) {
+            Py_CLEAR(saved->state);
+            return -1;
+        }
+        if (meth != NULL) {
+            res = PyObject_CallOneArg(meth,
+                                      saved->state ? saved->state : Py_None);
+            Py_DECREF(meth);
+        }
+        else {
+            res = _PyObject_CallMethodIdNoArgs(self->cond_lock,
+                                               &PyId_acquire);
+        }
+        Py_CLEAR(saved->state);
+        if (res == NULL)
+            return -1;
+        Py_DECREF(res);
+        return 0;
+    }
+
+    if (!PyThread_acquire_lock(lock, 0)) {
+        Py_BEGIN_ALLOW_THREADS
+        r = PyThread_acquire_lock(lock, 1);
+        Py_END_ALLOW_THREADS
+    }
+    if (!r) {
+        PyErr_SetString(ThreadError, "couldn't acquire lock");
+        return -1;
+    }
+    if (self->cond_kind == COND_LOCK) {
+        ((lockobject *)self->cond_lock)->locked = 1;
+    }
+    else {
+        rlockobject *rlock = (rlockobject *)self->cond_lock;
+        assert(rlock->rlock_count == 0);
+        rlock->rlock_owner = saved->owner;
+        rlock->rlock_count = saved->count;
+    }
+    return 0;
+}
+
+/* Convert the timeout argument of wait() and wait_for().  None means blocking
+   forever, which is stored as -1 second; negative timeouts don't block. */
+static int
+cond_parse_timeout(PyObject *timeout_obj, _PyTime_t *timeout)
+{
+    if (timeout_obj == Py_None) {
+        *timeout = _PyTime_FromSeconds(-1);
+        return 0;
+    }
+    if (_PyTime_FromSecondsObject(timeout, timeout_obj,
+                                  _PyTime_ROUND_TIMEOUT) < 0)
+        return -1;
+    if (*timeout < 0) {
+        *timeout = 0;
+    }
+    else if (_PyTime_AsMicroseconds(*timeout,
+                                    _PyTime_ROUND_TIMEOUT) >= PY_TIMEOUT_MAX) {
+        PyErr_SetString(PyExc_OverflowError,
+                        "timeout value is too large");
+        return -1;
+    }
+    return 0;
+}
+
+/* Return 1 if the thread was notified, 0 if the timeout expired and -1 on
+   error. */
+static int
+cond_wait_impl(condobject *self, _PyTime_t timeout)
+{
+    condwaiter waiter;
+    condsaved saved = {0, 0, NULL};
+    PyObject *exc, *val, *tb;
+    PyLockStatus r;
+    int owned, restored;
+
+    owned = cond_is_owned(self);
+    if (owned < 0)
+        return -1;
+    if (!owned) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "cannot wait on un-acquired lock");
+        return -1;
+    }
+
+    waiter.lock = cond_get_waiter_lock(self);
+    if (waiter.lock == NULL)
+        return -1;
+    waiter.notified = 0;
+    cond_append_waiter(self, &waiter);
+
+    if (cond_release_save(self, &saved) < 0) {
+        r = PY_LOCK_INTR;
+        restored = -1;
+    }
+    else {
+        r = acquire_timed(waiter.lock, timeout);
+
+        /* Restore the lock state no matter what (e.g. KeyboardInterrupt) */
+        PyErr_Fetch(&exc, &val, &tb);
+        restored = cond_acquire_restore(self, &saved);
+        _PyErr_ChainExceptions(exc, val, tb);
+    }
+
+    /* A notified waiter was already removed from the list and its lock was
+       released, unless we got it back in acquire_timed(). */
+    if (waiter.notified)
+        (void)PyThread_acquire_lock(waiter.lock, 0);
+    else
+        cond_unlink_waiter(self, &waiter);
+    cond_put_waiter_lock(self, waiter.lock);
+
+    if (r == PY_LOCK_INTR || restored < 0)
+        return -1;
+    return waiter.notified;
+}
+
+static PyObject *
+cond_wait(condobject *self, PyObject *args, PyObject *kwds)
+{
+    char *kwlist[] = {"timeout", NULL};
+    PyObject *timeout_obj = Py_None;
+    _PyTime_t timeout;
+    int r;
+
+    CHECK_COND_INITIALIZED(self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O:wait", kwlist,
+                                     &timeout_obj))
+        return NULL;
+    if (cond_parse_timeout(timeout_obj, &timeout) < 0)
+        return NULL;
+
+    r = cond_wait_impl(self, timeout);
+    if (r < 0)
+        return NULL;
+    return PyBool_FromLong(r);
+}
+
+PyDoc_STRVAR(cond_wait_doc,
+"wait(timeout=None) -> bool\n\
+\n\
+Wait until notified or until a timeout occurs.\n\
+\n\
+The underlying lock must be held by the current thread, otherwise a\n\
+RuntimeError is raised.  It is fully released, even if it was acquired\n\
+recursively, until another thread calls notify() or notify_all(), or until\n\
+the optional timeout expires.  The lock is then reacquired and restored to\n\
+its previous recursion level.  Return False if the timeout expired.");
+
+static PyObject *
+cond_wait_for(condobject *self, PyObject *args, PyObject *kwds)
+{
+    char *kwlist[] = {"predicate", "timeout", NULL};
+    PyObject *predicate, *result;
+    PyObject *timeout_obj = Py_None;
+    _PyTime_t timeout, endtime = 0;
+    int first = 1;
+
+    CHECK_COND_INITIALIZED(self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O:wait_for", kwlist,
+                                     &predicate, &timeout_obj))
+        return NULL;
+    if (cond_parse_timeout(timeout_obj, &timeout) < 0)
+        return NULL;
+    if (timeout_obj != Py_None)
+        endtime = _PyTime_GetMonotonicClock() + timeout;
+
+    while (1) {
+        int r;
+
+        result = _PyObject_CallNoArg(predicate);
+        if (result == NULL)
+            return NULL;
+        r = PyObject_IsTrue(result);
+        if (r != 0) {
+            if (r < 0)
+                Py_CLEAR(result);
+            return result;
+        }
+        if (timeout_obj != Py_None && !first) {
+            timeout = endtime - _PyTime_GetMonotonicClock();
+            if (timeout <= 0)
+                return result;
+        }
+        Py_DECREF(result);
+        first = 0;
+        if (cond_wait_impl(self, timeout) < 0)
+            return NULL;
+    }
+}
+
+PyDoc_STRVAR(cond_wait_for_doc,
+"wait_for(predicate, timeout=None)\n\
+\n\
+Wait until a condition evaluates to True.\n\
+\n\
+predicate should be a callable which result will be interpreted as a\n\
+boolean value.  A timeout may be provided giving the maximum time to\n\
+wait.  Return the last value returned by predicate.");
+
+static PyObject *
+cond_notify_impl(condobject *self, Py_ssize_t n)
+{
+    int owned = cond_is_owned(self);
+
+    if (owned < 0)
+        return NULL;
+    if (!owned) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "cannot notify on un-acquired lock");
+        return NULL;
+    }
+    while (n-- > 0 && self->waiters_head != NULL) {
+        condwaiter *waiter = self->waiters_head;
+        cond_unlink_waiter(self, waiter);
+        waiter->notified = 1;
+        /* The waiter cannot go away before we release the GIL */
+        PyThread_release_lock(waiter->lock);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+cond_notify(condobject *self, PyObject *args, PyObject *kwds)
+{
+    char *kwlist[] = {"n", NULL};
+    Py_ssize_t n = 1;
+
+    CHECK_COND_INITIALIZED(self);
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|n:notify", kwlist, &n))
+        return NULL;
+    return cond_notify_impl(self, n);
+}
+
+PyDoc_STRVAR(cond_notify_doc,
+"notify(n=1)\n\
+\n\
+Wake up at most n of the threads waiting on this condition, if any.\n\
+\n\
+The underlying lock must be held by the current thread, otherwise a\n\
+RuntimeError is raised.");
+
+static PyObject *
+cond_notify_all(condobject *self, PyObject *Py_UNUSED(ignored))
+{
+    CHECK_COND_INITIALIZED(self);
+    return cond_notify_impl(self, self->nwaiters);
+}
+
+PyDoc_STRVAR(cond_notify_all_doc,
+"notify_all()\n\
+\n\
+Wake up all threads waiting on this condition.\n\
+\n\
+The underlying lock must be held by the current thread, otherwise a\n\
+RuntimeError is raised.");
+
+static PyObject *
+cond_acquire(condobject *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *meth, *res;
+
+    CHECK_COND_INITIALIZED(self);
+    switch (self->cond_kind) {
+    case COND_LOCK:
+        return lock_PyThread_acquire_lock((lockobject *)self->cond_lock,
+                                          args, kwds);
+    case COND_RLOCK:
+        return rlock_acquire((rlockobject *)self->cond_lock, args, kwds);
+    }
+    meth = _PyObject_GetAttrId(self->cond_lock, &PyId_acquire);
+    if (meth == NULL)
+        return NULL;
+    res = PyObject_Call(meth, args, kwds);
+    Py_DECREF(meth);
+    return res;
+}
+
+PyDoc_STRVAR(cond_acquire_doc,
+"acquire(*args, **kwargs)\n\
+\n\
+Acquire the underlying lock.");
+
+static PyObject *
+cond_release(condobject *self, PyObject *Py_UNUSED(ignored))
+{
+    CHECK_COND_INITIALIZED(self);
+    switch (self->cond_kind) {
+    case COND_LOCK:
+        return lock_PyThread_release_lock((lockobject *)self->cond_lock,
+                                          NULL);
+    case COND_RLOCK:
+        return rlock_release((rlockobject *)self->cond_lock, NULL);
+    }
+    return _PyObject_CallMethodIdNoArgs(self->cond_lock, &PyId_release);
+}
+
+PyDoc_STRVAR(cond_release_doc,
+"release()\n\
+\n\
+Release the underlying lock.");
+
+static PyObject *
+cond_enter(condobject *self, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *args, *res;
+
+    CHECK_COND_INITIALIZED(self);
+    if (self->cond_kind == COND_OTHER)
+        return _PyObject_CallMethodIdNoArgs(self->cond_lock, &PyId___enter__);
+    args = PyTuple_New(0);
+    if (args == NULL)
+        return NULL;
+    res = cond_acquire(self, args, NULL);
+    Py_DECREF(args);
+    return res;
+}
+
+static PyObject *
+cond_exit(condobject *self, PyObject *args)
+{
+    PyObject *meth, *res;
+
+    CHECK_COND_INITIALIZED(self);
+    if (self->cond_kind != COND_OTHER)
+        return cond_release(self, NULL);
+    meth = _PyObject_GetAttrId(self->cond_lock, &PyId___exit__);
+    if (meth == NULL)
+        return NULL;
+    res = PyObject_Call(meth, args, NULL);
+    Py_DECREF(meth);
+    return res;
+}
+
+static PyObject *
+cond__is_owned(condobject *self, PyObject *Py_UNUSED(ignored))
+{
+    int r;
+
+    CHECK_COND_INITIALIZED(self);
+    r = cond_is_owned(self);
+    if (r < 0)
+        return NULL;
+    return PyBool_FromLong(r);
+}
+
+static PyObject *
+cond__release_save(condobject *self, PyObject *Py_UNUSED(ignored))
+{
+    condsaved saved = {0, 0, NULL};
+
+    CHECK_COND_INITIALIZED(self);
+    if (cond_release_save(self, &saved) < 0)
+        return NULL;
+    if (self->cond_kind == COND_RLOCK)
+        return Py_BuildValue("kk", saved.count, saved.owner);
+    if (saved.state == NULL)
+        Py_RETURN_NONE;
+    return saved.state;
+}
+
+static PyObject *
+cond__acquire_restore(condobject *self, PyObject *state)
+{
+    condsaved saved = {0, 0, NULL};
+
+    CHECK_COND_INITIALIZED(self);
+    if (self->cond_kind == COND_RLOCK) {
+        if (!PyArg_ParseTuple(state, "kk:_acquire_restore",
+                              &saved.count, &saved.owner))
+            return NULL;
+    }
+    else if (self->cond_kind == COND_OTHER) {
+        Py_INCREF(state);
+        saved.state = state;
+    }
+    if (cond_acquire_restore(self, &saved) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+#ifdef HAVE_FORK
+static PyObject *
+cond__at_fork_reinit(condobject *self, PyObject *Py_UNUSED(args))
+{
+    PyObject *res;
+
+    CHECK_COND_INITIALIZED(self);
+    res = _PyObject_CallMethodIdNoArgs(self->cond_lock, &PyId__at_fork_reinit);
+    if (res == NULL)
+        return NULL;
+    Py_DECREF(res);
+
+    /* The waiters belonged to the threads of the parent process. The spare
+       locks were not in use and can be kept. */
+    self->waiters_head = NULL;
+    self->waiters_tail = NULL;
+    self->nwaiters = 0;
+
+    Py_RETURN_NONE;
+}
+#endif  /* HAVE_FORK */
+
+static PyObject *
+cond_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    condobject *self = (condobject *) type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->cond_lock = NULL;
+    self->cond_kind = COND_OTHER;
+    self->waiters_head = NULL;
+    self->waiters_tail = NULL;
+    self->nwaiters = 0;
+    self->nspare_locks = 0;
+    self->in_weakreflist = NULL;
+    return (PyObject *) self;
+}
+
+static int
+cond_init(condobject *self, PyObject *args, PyObject *kwds)
+{
+    char *kwlist[] = {"lock", NULL};
+    PyObject *lock = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O:Condition", kwlist,
+                                     &lock))
+        return -1;
+
+    if (lock == Py_None) {
+        lock = rlock_new(&RLocktype, NULL, NULL);
+        if (lock == NULL)
+            return -1;
+    }
+    else {
+        Py_INCREF(lock);
+    }
+    Py_XSETREF(self->cond_lock, lock);
+
+    if (Py_IS_TYPE(lock, &Locktype))
+        self->cond_kind = COND_LOCK;
+    else if (Py_IS_TYPE(lock, &RLocktype))
+        self->cond_kind = COND_RLOCK;
+    else
+        self->cond_kind = COND_OTHER;
+    return 0;
+}
+
+static int
+cond_traverse(condobject *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->cond_lock);
+    return 0;
+}
+
+static void
+cond_dealloc(condobject *self)
+{
+    PyObject_GC_UnTrack(self);
+    if (self->in_weakreflist != NULL)
+        PyObject_ClearWeakRefs((PyObject *) self);
+    Py_CLEAR(self->cond_lock);
+    while (self->nspare_locks > 0) {
+        PyThread_type_lock lock = self->spare_locks[--self->nspare_locks];
+        /* Unlock the lock so it's safe to free it */
+        PyThread_release_lock(lock);
+        PyThread_free_lock(lock);
+    }
+    Py_TYPE(self)->tp_free(self);
+}
+
+static PyObject *
+cond_repr(condobject *self)
+{
+    return PyUnicode_FromFormat("<Condition(%S, %zd)>",
+        self->cond_lock ? self->cond_lock : Py_None, self->nwaiters);
+}
+
+static PyMethodDef cond_methods[] = {
+    {"acquire",      (PyCFunction)(void(*)(void))cond_acquire,
+     METH_VARARGS | METH_KEYWORDS, cond_acquire_doc},
+    {"release",      (PyCFunction)cond_release,
+     METH_NOARGS, cond_release_doc},
+    {"wait",         (PyCFunction)(void(*)(void))cond_wait,
+     METH_VARARGS | METH_KEYWORDS, cond_wait_doc},
+    {"wait_for",     (PyCFunction)(void(*)(void))cond_wait_for,
+     METH_VARARGS | METH_KEYWORDS, cond_wait_for_doc},
+    {"notify",       (PyCFunction)(void(*)(void))cond_notify,
+     METH_VARARGS | METH_KEYWORDS, cond_notify_doc},
+    {"notify_all",   (PyCFunction)cond_notify_all,
+     METH_NOARGS, cond_notify_all_doc},
+    {"notifyAll",    (PyCFunction)cond_notify_all,
+     METH_NOARGS, cond_notify_all_doc},
+    {"_is_owned",    (PyCFunction)cond__is_owned,
+     METH_NOARGS, NULL},
+    {"_release_save", (PyCFunction)cond__release_save,
+     METH_NOARGS, NULL},
+    {"_acquire_restore", (PyCFunction)cond__acquire_restore,
+     METH_O, NULL},
+    {"__enter__",    (PyCFunction)cond_enter,
+     METH_NOARGS, cond_acquire_doc},
+    {"__exit__",     (PyCFunction)cond_exit,
+     METH_VARARGS, cond_release_doc},
+#ifdef HAVE_FORK
+    {"_at_fork_reinit",    (PyCFunction)cond__at_fork_reinit,
+     METH_NOARGS, NULL},
+#endif
+    {NULL,           NULL}              /* sentinel */
+};
+
+static PyMemberDef cond_members[] = {
+    {"_lock", T_OBJECT, offsetof(condobject, cond_lock), READONLY},
+    {NULL}
+};
+
+PyDoc_STRVAR(cond_doc,
+"Condition(lock=None)\n\
+\n\
+A condition variable allows one or more threads to wait until they are\n\
+notified by another thread.\n\
+\n\
+If the lock argument is given and not None, it must be a Lock or RLock\n\
+object, and it is used as the underlying lock. Otherwise, a new RLock object\n\
+is created and used as the underlying lock.");
+
+static PyTypeObject Condtype = {
+    PyVarObject_HEAD_INIT(&PyType_Type, 0)
+    "_thread.Condition",                /*tp_name*/
+    sizeof(condobject),                 /*tp_basicsize*/
+    0,                                  /*tp_itemsize*/
+    /* methods */
+    (destructor)cond_dealloc,           /*tp_dealloc*/
+    0,                                  /*tp_vectorcall_offset*/
+    0,                                  /*tp_getattr*/
+    0,                                  /*tp_setattr*/
+    0,                                  /*tp_as_async*/
+    (reprfunc)cond_repr,                /*tp_repr*/
+    0,                                  /*tp_as_number*/
+    0,                                  /*tp_as_sequence*/
+    0,                                  /*tp_as_mapping*/
+    0,                                  /*tp_hash*/
+    0,                                  /*tp_call*/
+    0,                                  /*tp_str*/
+    0,                                  /*tp_getattro*/
+    0,                                  /*tp_setattro*/
+    0,                                  /*tp_as_buffer*/
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC, /* tp_flags */
+    cond_doc,                           /*tp_doc*/
+    (traverseproc)cond_traverse,        /*tp_traverse*/
+    0,                                  /*tp_clear*/
+    0,                                  /*tp_richcompare*/
+    offsetof(condobject, in_weakreflist), /*tp_weaklistoffset*/
+    0,                                  /*tp_iter*/
+    0,                                  /*tp_iternext*/
+    cond_methods,                       /*tp_methods*/
+    cond_members,                       /* tp_members */
+    0,                                  /* tp_getset */
+    0,                                  /* tp_base */
+    0,                                  /* tp_dict */
+    0,                                  /* tp_descr_get */
+    0,                                  /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    (initproc)cond_init,                /* tp_init */
+    PyType_GenericAlloc,                /* tp_alloc */
+    cond_new,                           /* tp_new */
+    PyObject_GC_Del,                    /* tp_free */
+};
+
 /* Thread-local objects */
 
 /* Quick overview:
@@ -1572,6 +2370,8 @@ PyInit__thread(void)
         return NULL;
     if (PyType_Ready(&RLocktype) < 0)
         return NULL;
+    if (PyType_Ready(&Condtype) < 0)
+        return NULL;
     if (ExceptHookArgsType.tp_name == NULL) {
         if (PyStructSequence_InitType2(&ExceptHookArgsType,
                                        &ExceptHookArgs_desc) < 0) {
@@ -1610,6 +2410,10 @@ PyInit__thread(void)
     if (PyModule_AddObject(m, "RLock", (PyObject *)&RLocktype) < 0)
         return NULL;
 
+    Py_INCREF(&Condtype);
+    if (PyModule_AddObject(m, "Condition", (PyObject *)&Condtype) < 0)
+        return NULL;
+
     Py_INCREF(&localtype);
     if (PyModule_AddObject(m, "_local", (PyObject *)&localtype) < 0)
         return NULL;
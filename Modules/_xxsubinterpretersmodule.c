@@ -443,22 +443,41 @@ _channelqueue_free(_channelqueue *queue)
 }
 
 static int
-_channelqueue_put(_channelqueue *queue, _PyCrossInterpreterData *data)
-{
-    _channelitem *item = _channelitem_new();
-    if (item == NULL) {
-        return -1;
+_channelqueue_put(_channelqueue *queue, _PyCrossInterpreterData **datas,
+                  Py_ssize_t count)
+{
+    // Allocate all the items first, so that either all the data or none
+    // of it ends up in the queue.
+    _channelitem *first = NULL;
+    _channelitem *last = NULL;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        _channelitem *item = _channelitem_new();
+        if (item == NULL) {
+            _channelitem_free_all(first);
+            return -1;
+        }
+        if (first == NULL) {
+            first = item;
+        }
+        else {
+            last->next = item;
+        }
+        last = item;
+    }
+    _channelitem *item = first;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        item->data = datas[i];
+        item = item->next;
     }
-    item->data = data;
 
-    queue->count += 1;
+    queue->count += count;
     if (queue->first == NULL) {
-        queue->first = item;
+        queue->first = first;
     }
     else {
-        queue->last->next = item;
+        queue->last->next = first;
     }
-    queue->last = item;
+    queue->last = last;
     return 0;
 }
 
@@ -714,10 +733,13 @@ typedef struct _channel {
     _channelends *ends;
     int open;
     struct _channel_closing *closing;
+    // Share buffers with the receiving interpreters instead of copying
+    // them (see _xibuffer_shared()).  Set once when the channel is created.
+    int share_buffers;
 } _PyChannelState;
 
 static _PyChannelState *
-_channel_new(void)
+_channel_new(int share_buffers)
 {
     _PyChannelState *chan = PyMem_NEW(_PyChannelState, 1);
     if (chan == NULL) {
@@ -743,6 +765,7 @@ _channel_new(void)
     }
     chan->open = 1;
     chan->closing = NULL;
+    chan->share_buffers = share_buffers;
     return chan;
 }
 
@@ -761,7 +784,7 @@ _channel_free(_PyChannelState *chan)
 
 static int
 _channel_add(_PyChannelState *chan, int64_t interp,
-             _PyCrossInterpreterData *data)
+             _PyCrossInterpreterData **datas, Py_ssize_t count)
 {
     int res = -1;
     PyThread_acquire_lock(chan->mutex, WAIT_LOCK);
@@ -774,7 +797,7 @@ _channel_add(_PyChannelState *chan, int64_t interp,
         goto done;
     }
 
-    if (_channelqueue_put(chan->queue, data) != 0) {
+    if (_channelqueue_put(chan->queue, datas, count) != 0) {
         goto done;
     }
 
@@ -784,10 +807,13 @@ done:
     return res;
 }
 
-static _PyCrossInterpreterData *
-_channel_next(_PyChannelState *chan, int64_t interp)
+/* Pop at most limit items off the channel into datas.  Return the number
+   of items, or -1 on error. */
+static Py_ssize_t
+_channel_next(_PyChannelState *chan, int64_t interp,
+              _PyCrossInterpreterData **datas, Py_ssize_t limit)
 {
-    _PyCrossInterpreterData *data = NULL;
+    Py_ssize_t count = -1;
     PyThread_acquire_lock(chan->mutex, WAIT_LOCK);
 
     if (!chan->open) {
@@ -798,8 +824,15 @@ _channel_next(_PyChannelState *chan, int64_t interp)
         goto done;
     }
 
-    data = _channelqueue_get(chan->queue);
-    if (data == NULL && !PyErr_Occurred() && chan->closing != NULL) {
+    count = 0;
+    while (count < limit) {
+        _PyCrossInterpreterData *data = _channelqueue_get(chan->queue);
+        if (data == NULL) {
+            break;
+        }
+        datas[count++] = data;
+    }
+    if (count == 0 && chan->closing != NULL) {
         chan->open = 0;
     }
 
@@ -808,7 +841,7 @@ done:
     if (chan->queue->count == 0) {
         _channel_finish_closing(chan);
     }
-    return data;
+    return count;
 }
 
 static int
@@ -1249,12 +1282,157 @@ _channel_finish_closing(struct _channel *chan) {
     _channel_free(chan);
 }
 
+/* zero-copy buffers */
+
+/* Channels created with share_buffers=True pass objects supporting the
+   buffer protocol without copying them.  The sending interpreter keeps its
+   buffer exported (and so its object alive) until the receiving interpreter
+   releases the memoryview it got, see xibuffer_dealloc(). */
+
+static PyTypeObject XIBufferViewtype;
+
+typedef struct xibufferview {
+    PyObject_HEAD
+    // The data->data Py_buffer of the sending interpreter
+    _PyCrossInterpreterData data;
+} xibufferview;
+
+static void
+_xibuffer_free(void *data)
+{
+    // Called in the sending interpreter.
+    Py_buffer *view = (Py_buffer *)data;
+    PyBuffer_Release(view);
+    PyMem_RawFree(view);
+}
+
+static PyObject *
+_xibuffer_new_object(_PyCrossInterpreterData *data)
+{
+    xibufferview *self = PyObject_New(xibufferview, &XIBufferViewtype);
+    if (self == NULL) {
+        return NULL;
+    }
+    // Take over the data: it is only released with the view.
+    self->data = *data;
+    data->data = NULL;
+    data->obj = NULL;
+
+    PyObject *view = PyMemoryView_FromObject((PyObject *)self);
+    Py_DECREF(self);
+    return view;
+}
+
+static int
+_xibuffer_shared(PyObject *obj, _PyCrossInterpreterData *data)
+{
+    Py_buffer *view = PyMem_RawMalloc(sizeof(Py_buffer));
+    if (view == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    if (PyObject_GetBuffer(obj, view, PyBUF_FULL_RO) != 0) {
+        PyMem_RawFree(view);
+        return -1;
+    }
+    if (!PyBuffer_IsContiguous(view, 'C')) {
+        PyBuffer_Release(view);
+        PyMem_RawFree(view);
+        PyErr_SetString(PyExc_ValueError,
+                        "only C-contiguous buffers can be shared");
+        return -1;
+    }
+
+    *data = (_PyCrossInterpreterData){0};
+    data->data = view;
+    data->new_object = _xibuffer_new_object;
+    data->free = _xibuffer_free;
+    data->interp = PyInterpreterState_GetID(PyInterpreterState_Get());
+    return 0;
+}
+
+static int
+_channel_get_xidata(_PyChannelState *chan, PyObject *obj,
+                    _PyCrossInterpreterData *data)
+{
+    if (chan->share_buffers && PyObject_CheckBuffer(obj)) {
+        return _xibuffer_shared(obj, data);
+    }
+    return _PyObject_GetCrossInterpreterData(obj, data);
+}
+
+static int
+xibuffer_getbuf(xibufferview *self, Py_buffer *view, int flags)
+{
+    Py_buffer *src = (Py_buffer *)self->data.data;
+    if ((flags & PyBUF_WRITABLE) && src->readonly) {
+        PyErr_SetString(PyExc_BufferError, "buffer is not writable");
+        return -1;
+    }
+    // The shared buffer is C-contiguous.
+    *view = *src;
+    Py_INCREF(self);
+    view->obj = (PyObject *)self;
+    view->internal = NULL;
+    if (!(flags & PyBUF_FORMAT)) {
+        view->format = NULL;
+    }
+    if ((flags & PyBUF_ND) != PyBUF_ND) {
+        view->shape = NULL;
+    }
+    if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES) {
+        view->strides = NULL;
+    }
+    return 0;
+}
+
+static void
+xibuffer_dealloc(xibufferview *self)
+{
+    // Release the buffer in the sending interpreter.
+    _PyCrossInterpreterData_Release(&self->data);
+    PyObject_Del(self);
+}
+
+static PyBufferProcs xibuffer_as_buffer = {
+    (getbufferproc)xibuffer_getbuf, /* bf_getbuffer */
+    0,                              /* bf_releasebuffer */
+};
+
+PyDoc_STRVAR(xibufferview_doc,
+"A buffer shared by another interpreter.");
+
+static PyTypeObject XIBufferViewtype = {
+    PyVarObject_HEAD_INIT(&PyType_Type, 0)
+    "_xxsubinterpreters.SharedBuffer", /* tp_name */
+    sizeof(xibufferview),           /* tp_basicsize */
+    0,                              /* tp_itemsize */
+    (destructor)xibuffer_dealloc,   /* tp_dealloc */
+    0,                              /* tp_vectorcall_offset */
+    0,                              /* tp_getattr */
+    0,                              /* tp_setattr */
+    0,                              /* tp_as_async */
+    0,                              /* tp_repr */
+    0,                              /* tp_as_number */
+    0,                              /* tp_as_sequence */
+    0,                              /* tp_as_mapping */
+    0,                              /* tp_hash */
+    0,                              /* tp_call */
+    0,                              /* tp_str */
+    0,                              /* tp_getattro */
+    0,                              /* tp_setattro */
+    &xibuffer_as_buffer,            /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,             /* tp_flags */
+    xibufferview_doc,               /* tp_doc */
+    // The type can't be instantiated from Python code (tp_new is NULL).
+};
+
 /* "high"-level channel-related functions */
 
 static int64_t
-_channel_create(_channels *channels)
+_channel_create(_channels *channels, int share_buffers)
 {
-    _PyChannelState *chan = _channel_new();
+    _PyChannelState *chan = _channel_new(share_buffers);
     if (chan == NULL) {
         return -1;
     }
@@ -1280,7 +1458,8 @@ _channel_destroy(_channels *channels, int64_t id)
 }
 
 static int
-_channel_send(_channels *channels, int64_t id, PyObject *obj)
+_channel_send(_channels *channels, int64_t id, PyObject **objs,
+              Py_ssize_t count)
 {
     PyInterpreterState *interp = _get_current();
     if (interp == NULL) {
@@ -1301,32 +1480,50 @@ _channel_send(_channels *channels, int64_t id, PyObject *obj)
         return -1;
     }
 
-    // Convert the object to cross-interpreter data.
-    _PyCrossInterpreterData *data = PyMem_NEW(_PyCrossInterpreterData, 1);
-    if (data == NULL) {
+    // Convert the objects to cross-interpreter data.
+    _PyCrossInterpreterData **datas = PyMem_New(_PyCrossInterpreterData *,
+                                                count);
+    if (datas == NULL) {
         PyThread_release_lock(mutex);
+        PyErr_NoMemory();
         return -1;
     }
-    if (_PyObject_GetCrossInterpreterData(obj, data) != 0) {
-        PyThread_release_lock(mutex);
-        PyMem_Free(data);
-        return -1;
+    Py_ssize_t converted = 0;
+    for (; converted < count; converted++) {
+        _PyCrossInterpreterData *data = PyMem_NEW(_PyCrossInterpreterData, 1);
+        if (data == NULL) {
+            PyErr_NoMemory();
+            break;
+        }
+        if (_channel_get_xidata(chan, objs[converted], data) != 0) {
+            PyMem_Free(data);
+            break;
+        }
+        datas[converted] = data;
     }
 
     // Add the data to the channel.
-    int res = _channel_add(chan, PyInterpreterState_GetID(interp), data);
+    int res = -1;
+    if (converted == count) {
+        res = _channel_add(chan, PyInterpreterState_GetID(interp),
+                           datas, count);
+    }
     PyThread_release_lock(mutex);
     if (res != 0) {
-        _PyCrossInterpreterData_Release(data);
-        PyMem_Free(data);
-        return -1;
+        for (Py_ssize_t i = 0; i < converted; i++) {
+            _PyCrossInterpreterData_Release(datas[i]);
+            PyMem_Free(datas[i]);
+        }
     }
-
-    return 0;
+    PyMem_Free(datas);
+    return res;
 }
 
+/* Pop at most limit items off the channel and convert them back to
+   objects.  Return a new list, which is empty if there is nothing to
+   receive. */
 static PyObject *
-_channel_recv(_channels *channels, int64_t id)
+_channel_recv(_channels *channels, int64_t id, Py_ssize_t limit)
 {
     PyInterpreterState *interp = _get_current();
     if (interp == NULL) {
@@ -1341,22 +1538,49 @@ _channel_recv(_channels *channels, int64_t id)
     }
     // Past this point we are responsible for releasing the mutex.
 
-    // Pop off the next item from the channel.
-    _PyCrossInterpreterData *data = _channel_next(chan, PyInterpreterState_GetID(interp));
-    PyThread_release_lock(mutex);
-    if (data == NULL) {
-        return NULL;
+    // Senders hold the mutex too: the queue can't grow before we pop.
+    if (limit > chan->queue->count) {
+        limit = (Py_ssize_t)chan->queue->count;
+    }
+    _PyCrossInterpreterData *one = NULL;
+    _PyCrossInterpreterData **datas = &one;
+    if (limit > 1) {
+        datas = PyMem_New(_PyCrossInterpreterData *, limit);
+        if (datas == NULL) {
+            PyThread_release_lock(mutex);
+            PyErr_NoMemory();
+            return NULL;
+        }
     }
 
-    // Convert the data back to an object.
-    PyObject *obj = _PyCrossInterpreterData_NewObject(data);
-    _PyCrossInterpreterData_Release(data);
-    PyMem_Free(data);
-    if (obj == NULL) {
-        return NULL;
-    }
+    // Pop off the next items from the channel.
+    Py_ssize_t count = _channel_next(chan, PyInterpreterState_GetID(interp),
+                                     datas, limit);
+    PyThread_release_lock(mutex);
 
-    return obj;
+    // Convert the data back to objects.
+    PyObject *objs = NULL;
+    if (count >= 0) {
+        objs = PyList_New(count);
+    }
+    for (Py_ssize_t i = 0; i < count; i++) {
+        _PyCrossInterpreterData *data = datas[i];
+        if (objs != NULL) {
+            PyObject *obj = _PyCrossInterpreterData_NewObject(data);
+            if (obj == NULL) {
+                Py_CLEAR(objs);
+            }
+            else {
+                PyList_SET_ITEM(objs, i, obj);
+            }
+        }
+        _PyCrossInterpreterData_Release(data);
+        PyMem_Free(data);
+    }
+    if (datas != &one) {
+        PyMem_Free(datas);
+    }
+    return objs;
 }
 
 static int
@@ -1834,6 +2058,15 @@ interp_exceptions_init(PyObject *ns)
 static int
 _is_running(PyInterpreterState *interp)
 {
+    if (_PyInterpreterState_IsRunningMain(interp)) {
+        return 1;
+    }
+    if (_PyInterpreterState_HasOwnGIL(interp)
+            && interp != PyInterpreterState_Get()) {
+        // Its threads run in parallel: don't look at their frames.
+        return 0;
+    }
+
     PyThreadState *tstate = PyInterpreterState_ThreadHead(interp);
     if (PyThreadState_Next(tstate) != NULL) {
         PyErr_SetString(PyExc_RuntimeError,
@@ -1926,6 +2159,53 @@ error:
     return -1;
 }
 
+/* An interpreter which has its own GIL runs in parallel with the other
+   interpreters: switching to or from it releases the GIL of the current
+   interpreter and takes the GIL of the other one. */
+
+static int
+_needs_gil_switch(PyInterpreterState *interp)
+{
+    return (_PyInterpreterState_HasOwnGIL(interp)
+            || _PyInterpreterState_HasOwnGIL(PyInterpreterState_Get()));
+}
+
+static PyThreadState *
+_enter_interpreter(PyThreadState *tstate, int switch_gil)
+{
+    if (!switch_gil) {
+        return PyThreadState_Swap(tstate);
+    }
+    PyThreadState *save_tstate = PyEval_SaveThread();
+    PyEval_RestoreThread(tstate);
+    return save_tstate;
+}
+
+/* The current thread state may have been deleted with its interpreter. */
+static void
+_exit_interpreter(PyThreadState *save_tstate, int switch_gil)
+{
+    if (!switch_gil) {
+        PyThreadState_Swap(save_tstate);
+        return;
+    }
+    if (_PyThreadState_UncheckedGet() != NULL) {
+        (void)PyEval_SaveThread();
+    }
+    PyEval_RestoreThread(save_tstate);
+}
+
+static void
+_end_interpreter(PyInterpreterState *interp)
+{
+    PyThreadState *tstate = PyInterpreterState_ThreadHead(interp);
+    int switch_gil = _needs_gil_switch(interp);
+    // XXX Possible GILState issues?
+    PyThreadState *save_tstate = _enter_interpreter(tstate, switch_gil);
+    Py_EndInterpreter(tstate);
+    _exit_interpreter(save_tstate, switch_gil);
+}
+
 static int
 _run_script_in_interpreter(PyInterpreterState *interp, const char *codestr,
                            PyObject *shareables)
@@ -1939,27 +2219,24 @@ _run_script_in_interpreter(PyInterpreterState *interp, const char *codestr,
         return -1;
     }
 
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    // Switch to interpreter.
-    PyThreadState *new_tstate = PyInterpreterState_ThreadHead(interp);
-    PyThreadState *save1 = PyEval_SaveThread();
-
-    (void)PyThreadState_Swap(new_tstate);
-
-    // Run the script.
-    _sharedexception *exc = NULL;
-    int result = _run_script(interp, codestr, shared, &exc);
+    // Claim the interpreter before releasing the GIL, so that it
+    // can't be run or destroyed concurrently.
+    if (_PyInterpreterState_SetRunningMain(interp) < 0) {
+        if (shared != NULL) {
+            _sharedns_free(shared);
+        }
+        return -1;
+    }
 
-    // Switch back.
-    PyEval_RestoreThread(save1);
-#else
     // Switch to interpreter.
     PyThreadState *save_tstate = NULL;
+    int switch_gil = 0;
     if (interp != PyInterpreterState_Get()) {
         // XXX Using the "head" thread isn't strictly correct.
         PyThreadState *tstate = PyInterpreterState_ThreadHead(interp);
+        switch_gil = _needs_gil_switch(interp);
         // XXX Possible GILState issues?
-        save_tstate = PyThreadState_Swap(tstate);
+        save_tstate = _enter_interpreter(tstate, switch_gil);
     }
 
     // Run the script.
@@ -1968,9 +2245,9 @@ _run_script_in_interpreter(PyInterpreterState *interp, const char *codestr,
 
     // Switch back.
     if (save_tstate != NULL) {
-        PyThreadState_Swap(save_tstate);
+        _exit_interpreter(save_tstate, switch_gil);
     }
-#endif
+    _PyInterpreterState_SetNotRunningMain(interp);
 
     // Propagate any exception out to the caller.
     if (exc != NULL) {
@@ -2024,10 +2301,23 @@ interp_create(PyObject *self, PyObject *args, PyObject *kwds)
         return NULL;
     }
 
+    if (!isolated && _PyInterpreterState_HasOwnGIL(PyInterpreterState_Get())) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "an interpreter with its own GIL can only create "
+                        "isolated interpreters");
+        return NULL;
+    }
+
     // Create and initialize the new interpreter.
     PyThreadState *save_tstate = PyThreadState_Swap(NULL);
     // XXX Possible GILState issues?
     PyThreadState *tstate = _Py_NewInterpreter(isolated);
+    if (tstate != NULL
+        && _PyInterpreterState_HasOwnGIL(PyThreadState_GetInterpreter(tstate)))
+    {
+        // Release the GIL of the new interpreter.
+        (void)PyEval_SaveThread();
+    }
     PyThreadState_Swap(save_tstate);
     if (tstate == NULL) {
         /* Since no new thread state was created, there is no exception to
@@ -2039,10 +2329,7 @@ interp_create(PyObject *self, PyObject *args, PyObject *kwds)
     PyInterpreterState *interp = PyThreadState_GetInterpreter(tstate);
     PyObject *idobj = _PyInterpreterState_GetIDObject(interp);
     if (idobj == NULL) {
-        // XXX Possible GILState issues?
-        save_tstate = PyThreadState_Swap(tstate);
-        Py_EndInterpreter(tstate);
-        PyThreadState_Swap(save_tstate);
+        _end_interpreter(interp);
         return NULL;
     }
     _PyInterpreterState_RequireIDRef(interp, 1);
@@ -2089,13 +2376,12 @@ interp_destroy(PyObject *self, PyObject *args, PyObject *kwds)
     if (_ensure_not_running(interp) < 0) {
         return NULL;
     }
+    if (_PyInterpreterState_SetRunningMain(interp) < 0) {
+        return NULL;
+    }
 
     // Destroy the interpreter.
-    PyThreadState *tstate = PyInterpreterState_ThreadHead(interp);
-    // XXX Possible GILState issues?
-    PyThreadState *save_tstate = PyThreadState_Swap(tstate);
-    Py_EndInterpreter(tstate);
-    PyThreadState_Swap(save_tstate);
+    _end_interpreter(interp);
 
     Py_RETURN_NONE;
 }
@@ -2276,9 +2562,16 @@ PyDoc_STRVAR(is_running_doc,
 Return whether or not the identified interpreter is running.");
 
 static PyObject *
-channel_create(PyObject *self, PyObject *Py_UNUSED(ignored))
+channel_create(PyObject *self, PyObject *args, PyObject *kwds)
 {
-    int64_t cid = _channel_create(&_globals.channels);
+    static char *kwlist[] = {"share_buffers", NULL};
+    int share_buffers = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|$p:channel_create", kwlist,
+                                     &share_buffers)) {
+        return NULL;
+    }
+
+    int64_t cid = _channel_create(&_globals.channels, share_buffers);
     if (cid < 0) {
         return NULL;
     }
@@ -2295,9 +2588,14 @@ channel_create(PyObject *self, PyObject *Py_UNUSED(ignored))
 }
 
 PyDoc_STRVAR(channel_create_doc,
-"channel_create() -> cid\n\
+"channel_create(*, share_buffers=False) -> cid\n\
 \n\
-Create a new cross-interpreter channel and return a unique generated ID.");
+Create a new cross-interpreter channel and return a unique generated ID.\n\
+\n\
+If share_buffers is true, objects supporting the buffer protocol are\n\
+received as a memoryview of the sender's buffer instead of a copy.  The\n\
+sender's object is kept alive, and its buffer exported, until the\n\
+memoryview is released.");
 
 static PyObject *
 channel_destroy(PyObject *self, PyObject *args, PyObject *kwds)
@@ -2431,7 +2729,7 @@ channel_send(PyObject *self, PyObject *args, PyObject *kwds)
         return NULL;
     }
 
-    if (_channel_send(&_globals.channels, cid, obj) != 0) {
+    if (_channel_send(&_globals.channels, cid, &obj, 1) != 0) {
         return NULL;
     }
     Py_RETURN_NONE;
@@ -2442,6 +2740,42 @@ PyDoc_STRVAR(channel_send_doc,
 \n\
 Add the object's data to the channel's queue.");
 
+static PyObject *
+channel_send_many(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"cid", "objs", NULL};
+    int64_t cid;
+    PyObject *objs;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&O:channel_send_many",
+                                     kwlist, channel_id_converter, &cid,
+                                     &objs)) {
+        return NULL;
+    }
+
+    PyObject *seq = PySequence_Fast(objs, "objs must be iterable");
+    if (seq == NULL) {
+        return NULL;
+    }
+    int res = 0;
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    if (count > 0) {
+        res = _channel_send(&_globals.channels, cid,
+                            PySequence_Fast_ITEMS(seq), count);
+    }
+    Py_DECREF(seq);
+    if (res != 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(channel_send_many_doc,
+"channel_send_many(cid, objs)\n\
+\n\
+Add the data of all the objects to the channel's queue at once.\n\
+\n\
+If one of the objects can't be shared, nothing is added.");
+
 static PyObject *
 channel_recv(PyObject *self, PyObject *args, PyObject *kwds)
 {
@@ -2454,14 +2788,19 @@ channel_recv(PyObject *self, PyObject *args, PyObject *kwds)
     }
     Py_XINCREF(dflt);
 
-    PyObject *obj = _channel_recv(&_globals.channels, cid);
-    if (obj != NULL) {
-        Py_XDECREF(dflt);
-        return obj;
-    } else if (PyErr_Occurred()) {
+    PyObject *objs = _channel_recv(&_globals.channels, cid, 1);
+    if (objs == NULL) {
         Py_XDECREF(dflt);
         return NULL;
-    } else if (dflt != NULL) {
+    } else if (PyList_GET_SIZE(objs) != 0) {
+        Py_XDECREF(dflt);
+        PyObject *obj = PyList_GET_ITEM(objs, 0);
+        Py_INCREF(obj);
+        Py_DECREF(objs);
+        return obj;
+    }
+    Py_DECREF(objs);
+    if (dflt != NULL) {
         return dflt;
     } else {
         PyErr_Format(ChannelEmptyError, "channel %" PRId64 " is empty", cid);
@@ -2477,6 +2816,35 @@ Return a new object from the data at the front of the channel's queue.\n\
 If there is nothing to receive then raise ChannelEmptyError, unless\n\
 a default value is provided.  In that case return it.");
 
+static PyObject *
+channel_recv_many(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"cid", "limit", NULL};
+    int64_t cid;
+    Py_ssize_t limit = -1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&|n:channel_recv_many",
+                                     kwlist, channel_id_converter, &cid,
+                                     &limit)) {
+        return NULL;
+    }
+    if (limit < 0) {
+        limit = PY_SSIZE_T_MAX;
+    }
+    else if (limit == 0) {
+        return PyList_New(0);
+    }
+
+    return _channel_recv(&_globals.channels, cid, limit);
+}
+
+PyDoc_STRVAR(channel_recv_many_doc,
+"channel_recv_many(cid, limit=-1) -> list\n\
+\n\
+Return new objects from the data at the front of the channel's queue.\n\
+\n\
+At most limit objects are returned, all of them if limit is negative.\n\
+The list is empty if there is nothing to receive.");
+
 static PyObject *
 channel_close(PyObject *self, PyObject *args, PyObject *kwds)
 {
@@ -2584,8 +2952,8 @@ static PyMethodDef module_functions[] = {
     {"is_shareable",              (PyCFunction)(void(*)(void))object_is_shareable,
      METH_VARARGS | METH_KEYWORDS, is_shareable_doc},
 
-    {"channel_create",            channel_create,
-     METH_NOARGS, channel_create_doc},
+    {"channel_create",            (PyCFunction)(void(*)(void))channel_create,
+     METH_VARARGS | METH_KEYWORDS, channel_create_doc},
     {"channel_destroy",           (PyCFunction)(void(*)(void))channel_destroy,
      METH_VARARGS | METH_KEYWORDS, channel_destroy_doc},
     {"channel_list_all",          channel_list_all,
@@ -2594,8 +2962,12 @@ static PyMethodDef module_functions[] = {
      METH_VARARGS | METH_KEYWORDS, channel_list_interpreters_doc},
     {"channel_send",              (PyCFunction)(void(*)(void))channel_send,
      METH_VARARGS | METH_KEYWORDS, channel_send_doc},
+    {"channel_send_many",         (PyCFunction)(void(*)(void))channel_send_many,
+     METH_VARARGS | METH_KEYWORDS, channel_send_many_doc},
     {"channel_recv",              (PyCFunction)(void(*)(void))channel_recv,
      METH_VARARGS | METH_KEYWORDS, channel_recv_doc},
+    {"channel_recv_many",         (PyCFunction)(void(*)(void))channel_recv_many,
+     METH_VARARGS | METH_KEYWORDS, channel_recv_many_doc},
     {"channel_close",             (PyCFunction)(void(*)(void))channel_close,
      METH_VARARGS | METH_KEYWORDS, channel_close_doc},
     {"channel_release",           (PyCFunction)(void(*)(void))channel_release,
@@ -2637,6 +3009,9 @@ PyInit__xxsubinterpreters(void)
     if (PyType_Ready(&ChannelIDtype) != 0) {
         return NULL;
     }
+    if (PyType_Ready(&XIBufferViewtype) != 0) {
+        return NULL;
+    }
 
     /* Create the module */
     PyObject *module = PyModule_Create(&interpretersmodule);
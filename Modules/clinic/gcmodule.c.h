@@ -372,4 +372,111 @@ gc_get_freeze_count(PyObject *module, PyObject *Py_UNUSED(ignored))
 exit:
     return return_value;
 }
-/*[clinic end generated code: output=61e15f3a549f3ab5 input=a9049054013a1b77]*/
+
+PyDoc_STRVAR(gc_set_incremental__doc__,
+"set_incremental($module, /, enabled=True, *, budget_ms=2.0,\n"
+"                budget_objects=0)\n"
+"--\n"
+"\n"
+"Enable or disable the incremental collection of the oldest generation.\n"
+"\n"
+"When enabled, the automatic collections of the oldest generation are split\n"
+"into steps, run along with the collections of the middle generation.  A step\n"
+"stops when it has run for budget_ms milliseconds or has examined\n"
+"budget_objects objects.  A budget of 0 means no limit, but at least one\n"
+"budget must be set.  gc.collect() always runs a full collection.");
+
+#define GC_SET_INCREMENTAL_METHODDEF    \
+    {"set_incremental", (PyCFunction)(void(*)(void))gc_set_incremental, METH_FASTCALL|METH_KEYWORDS, gc_set_incremental__doc__},
+
+static PyObject *
+gc_set_incremental_impl(PyObject *module, int enabled, double budget_ms,
+                        Py_ssize_t budget_objects);
+
+static PyObject *
+gc_set_incremental(PyObject *module, PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames)
+{
+    PyObject *return_value = NULL;
+    static const char * const _keywords[] = {"enabled", "budget_ms", "budget_objects", NULL};
+    static _PyArg_Parser _parser = {NULL, _keywords, "set_incremental", 0};
+    PyObject *argsbuf[3];
+    Py_ssize_t noptargs = nargs + (kwnames ? PyTuple_GET_SIZE(kwnames) : 0) - 0;
+    int enabled = 1;
+    double budget_ms = 2.0;
+    Py_ssize_t budget_objects = 0;
+
+    args = _PyArg_UnpackKeywords(args, nargs, NULL, kwnames, &_parser, 0, 1, 0, argsbuf);
+    if (!args) {
+        goto exit;
+    }
+    if (!noptargs) {
+        goto skip_optional_pos;
+    }
+    if (args[0]) {
+        enabled = PyObject_IsTrue(args[0]);
+        if (enabled < 0) {
+            goto exit;
+        }
+        if (!--noptargs) {
+            goto skip_optional_pos;
+        }
+    }
+skip_optional_pos:
+    if (!noptargs) {
+        goto skip_optional_kwonly;
+    }
+    if (args[1]) {
+        if (PyFloat_CheckExact(args[1])) {
+            budget_ms = PyFloat_AS_DOUBLE(args[1]);
+        }
+        else
+        {
+            budget_ms = PyFloat_AsDouble(args[1]);
+            if (budget_ms == -1.0 && PyErr_Occurred()) {
+                goto exit;
+            }
+        }
+        if (!--noptargs) {
+            goto skip_optional_kwonly;
+        }
+    }
+    {
+        Py_ssize_t ival = -1;
+        PyObject *iobj = _PyNumber_Index(args[2]);
+        if (iobj != NULL) {
+            ival = PyLong_AsSsize_t(iobj);
+            Py_DECREF(iobj);
+        }
+        if (ival == -1 && PyErr_Occurred()) {
+            goto exit;
+        }
+        budget_objects = ival;
+    }
+skip_optional_kwonly:
+    return_value = gc_set_incremental_impl(module, enabled, budget_ms, budget_objects);
+
+exit:
+    return return_value;
+}
+
+PyDoc_STRVAR(gc_get_incremental__doc__,
+"get_incremental($module, /)\n"
+"--\n"
+"\n"
+"Return a dictionary describing the incremental collection settings.\n"
+"\n"
+"The dictionary has the keys \'enabled\', \'budget_ms\' and \'budget_objects\',\n"
+"and \'phase\', the phase of the pass in progress (\'idle\' if there is none).");
+
+#define GC_GET_INCREMENTAL_METHODDEF    \
+    {"get_incremental", (PyCFunction)gc_get_incremental, METH_NOARGS, gc_get_incremental__doc__},
+
+static PyObject *
+gc_get_incremental_impl(PyObject *module);
+
+static PyObject *
+gc_get_incremental(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return gc_get_incremental_impl(module);
+}
+/*[clinic end generated code: output=4a3855373eb55cc9 input=a9049054013a1b77]*/
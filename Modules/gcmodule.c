@@ -69,6 +69,47 @@ module gc
 // most gc_list_* functions for it.
 #define NEXT_MASK_UNREACHABLE  (1)
 
+// Bit 1 of _gc_next is used for VISITED flag by incremental collection.
+//
+// It is set on the objects an incremental pass doesn't have to examine
+// anymore (see gc_collect_increment()), and on frozen objects when
+// incremental collection is enabled.  update_refs() clears it, so it is never
+// set on objects being collected.
+#define NEXT_MASK_VISITED      _PyGC_NEXT_MASK_VISITED
+
+/* Phases of an incremental collection of the oldest generation */
+#define INCR_IDLE   0   /* no pass in progress */
+#define INCR_MARK   1   /* traversing objects reachable from the roots */
+#define INCR_SWEEP  2   /* collecting the objects not reached */
+#define INCR_CLEAR  3   /* moving the objects back to the oldest generation */
+
+/* Phases of a collection timed by the statistics */
+#define PHASE_UPDATE_REFS       0
+#define PHASE_SUBTRACT_REFS     1
+#define PHASE_MOVE_UNREACHABLE  2
+#define PHASE_HANDLE_WEAKREFS   3
+#define PHASE_FINALIZERS        4
+#define PHASE_DELETE_GARBAGE    5
+
+static const char *gc_phase_names[NUM_GC_PHASES] = {
+    "update_refs",
+    "subtract_refs",
+    "move_unreachable",
+    "handle_weakrefs",
+    "finalizers",
+    "delete_garbage",
+};
+
+/* Statistics of a single collection, or step of an incremental collection */
+struct gc_collection_stats {
+    int generation;
+    Py_ssize_t examined;
+    Py_ssize_t collected;
+    Py_ssize_t uncollectable;
+    _PyTime_t pause;
+    _PyTime_t phase_time[NUM_GC_PHASES];
+};
+
 /* Get an object's GC head */
 #define AS_GC(o) ((PyGC_Head *)(o)-1)
 
@@ -108,6 +149,33 @@ gc_reset_refs(PyGC_Head *g, Py_ssize_t refs)
         | ((uintptr_t)(refs) << _PyGC_PREV_SHIFT);
 }
 
+static inline int
+gc_is_visited(PyGC_Head *g)
+{
+    return (g->_gc_next & NEXT_MASK_VISITED) != 0;
+}
+
+static inline void
+gc_set_visited(PyGC_Head *g)
+{
+    g->_gc_next |= NEXT_MASK_VISITED;
+}
+
+static inline void
+gc_clear_visited(PyGC_Head *g)
+{
+    g->_gc_next &= ~NEXT_MASK_VISITED;
+}
+
+/* True if an incremental pass is looking for the objects of the oldest
+ * generation which aren't garbage. */
+static inline int
+incr_scanning(GCState *gcstate)
+{
+    return (gcstate->incr_phase == INCR_MARK
+            || gcstate->incr_phase == INCR_SWEEP);
+}
+
 static inline void
 gc_decref(PyGC_Head *g)
 {
@@ -158,6 +226,17 @@ _PyGC_InitState(GCState *gcstate)
            (uintptr_t)&gcstate->permanent_generation.head}, 0, 0
     };
     gcstate->permanent_generation = permanent_generation;
+
+    gcstate->incr_phase = INCR_IDLE;
+    gcstate->incr_budget = 2 * 1000 * 1000;  /* 2 ms */
+    gcstate->incr_object_cost = 100.0;  /* a guess, measured afterwards */
+    PyGC_Head *incr_lists[] = {&gcstate->incr_pending,
+                               &gcstate->incr_gray,
+                               &gcstate->incr_visited};
+    for (size_t i = 0; i < Py_ARRAY_LENGTH(incr_lists); i++) {
+        incr_lists[i]->_gc_prev = (uintptr_t)incr_lists[i];
+        incr_lists[i]->_gc_next = (uintptr_t)incr_lists[i];
+    }
 }
 
 
@@ -224,6 +303,11 @@ NEXT_MASK_UNREACHABLE
     The flag is unset and the object is moved back to "reachable" set.
 
     move_legacy_finalizers() will remove this flag from "unreachable" set.
+
+NEXT_MASK_VISITED
+    Set on the objects an incremental collection of the oldest generation
+    has reached, see gc_collect_increment().  Unlike NEXT_MASK_UNREACHABLE,
+    it is kept by the list functions.
 */
 
 /*** list functions ***/
@@ -335,6 +419,25 @@ gc_list_clear_collecting(PyGC_Head *collectable)
     }
 }
 
+/* Set or clear the VISITED flag of all objects of the list.
+ * Return the size of the list. */
+static Py_ssize_t
+gc_list_set_visited(PyGC_Head *list, int visited)
+{
+    PyGC_Head *gc;
+    Py_ssize_t n = 0;
+    for (gc = GC_NEXT(list); gc != list; gc = GC_NEXT(gc)) {
+        if (visited) {
+            gc_set_visited(gc);
+        }
+        else {
+            gc_clear_visited(gc);
+        }
+        n++;
+    }
+    return n;
+}
+
 /* Append objects in a GC list to a Python list.
  * Return 0 if all OK, < 0 if error (out of memory for list)
  */
@@ -395,7 +498,8 @@ validate_list(PyGC_Head *head, enum flagstates flags)
     PyGC_Head *gc = GC_NEXT(head);
     while (gc != head) {
         PyGC_Head *trueprev = GC_PREV(gc);
-        PyGC_Head *truenext = (PyGC_Head *)(gc->_gc_next  & ~NEXT_MASK_UNREACHABLE);
+        PyGC_Head *truenext = (PyGC_Head *)(gc->_gc_next
+            & ~(NEXT_MASK_UNREACHABLE | NEXT_MASK_VISITED));
         assert(truenext != NULL);
         assert(trueprev == prev);
         assert((gc->_gc_prev & PREV_MASK_COLLECTING) == prev_value);
@@ -413,14 +517,17 @@ validate_list(PyGC_Head *head, enum flagstates flags)
 
 
 /* Set all gc_refs = ob_refcnt.  After this, gc_refs is > 0 and
- * PREV_MASK_COLLECTING bit is set for all objects in containers.
+ * PREV_MASK_COLLECTING bit is set for all objects in containers, and the
+ * NEXT_MASK_VISITED bit is cleared.  Return the number of objects.
  */
-static void
+static Py_ssize_t
 update_refs(PyGC_Head *containers)
 {
+    Py_ssize_t n = 0;
     PyGC_Head *gc = GC_NEXT(containers);
-    for (; gc != containers; gc = GC_NEXT(gc)) {
+    for (; gc != containers; gc = GC_NEXT(gc), n++) {
         gc_reset_refs(gc, Py_REFCNT(FROM_GC(gc)));
+        gc_clear_visited(gc);
         /* Python's cyclic gc should never see an incoming refcount
          * of 0:  if something decref'ed to 0, it should have been
          * deallocated immediately at that time.
@@ -441,6 +548,7 @@ update_refs(PyGC_Head *containers)
          */
         _PyObject_ASSERT(FROM_GC(gc), gc_get_refs(gc) != 0);
     }
+    return n;
 }
 
 /* A traversal callback for subtract_refs. */
@@ -1038,9 +1146,10 @@ clear_freelists(PyThreadState *tstate)
     _PyTuple_ClearFreeList(tstate);
     _PyFloat_ClearFreeList(tstate);
     _PyList_ClearFreeList(tstate);
-    _PyDict_ClearFreeList();
+    _PyDict_ClearFreeList(tstate);
     _PyAsyncGen_ClearFreeLists(tstate);
     _PyContext_ClearFreeList(tstate);
+    _PyThreadState_ClearFreeList(tstate);
 }
 
 // Show stats for objects in each generations
@@ -1051,9 +1160,13 @@ show_stats_each_generations(GCState *gcstate)
     size_t pos = 0;
 
     for (int i = 0; i < NUM_GENERATIONS && pos < sizeof(buf); i++) {
-        pos += PyOS_snprintf(buf+pos, sizeof(buf)-pos,
-                             " %zd",
-                             gc_list_size(GEN_HEAD(gcstate, i)));
+        Py_ssize_t size = gc_list_size(GEN_HEAD(gcstate, i));
+        if (i == NUM_GENERATIONS - 1) {
+            size += gc_list_size(&gcstate->incr_pending);
+            size += gc_list_size(&gcstate->incr_gray);
+            size += gc_list_size(&gcstate->incr_visited);
+        }
+        pos += PyOS_snprintf(buf+pos, sizeof(buf)-pos, " %zd", size);
     }
 
     PySys_FormatStderr(
@@ -1062,6 +1175,19 @@ show_stats_each_generations(GCState *gcstate)
         buf, gc_list_size(&gcstate->permanent_generation.head));
 }
 
+/* Account the time elapsed since '*t' to a phase of the collection, and
+ * reset '*t' to the current time. */
+static inline void
+gc_phase_done(struct gc_collection_stats *cs, int phase, _PyTime_t *t)
+{
+    _PyTime_t now = _PyTime_GetMonotonicClock();
+    cs->phase_time[phase] += now - *t;
+    if (PyDTrace_GC_PHASE_ENABLED()) {
+        PyDTrace_GC_PHASE(cs->generation, gc_phase_names[phase], now - *t);
+    }
+    *t = now;
+}
+
 /* Deduce which objects among "base" are unreachable from outside the list
    and move them to 'unreachable'. The process consist in the following steps:
 
@@ -1084,21 +1210,32 @@ Contracts:
     * The "unreachable" list must be uninitialized (this function calls
       gc_list_init over 'unreachable').
 
+    * If 'cs' is not NULL, the steps are timed and the objects of "base"
+      counted as examined.
+
 IMPORTANT: This function leaves 'unreachable' with the NEXT_MASK_UNREACHABLE
 flag set but it does not clear it to skip unnecessary iteration. Before the
 flag is cleared (for example, by using 'clear_unreachable_mask' function or
 by a call to 'move_legacy_finalizers'), the 'unreachable' list is not a normal
 list and we can not use most gc_list_* functions for it. */
 static inline void
-deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable) {
+deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable,
+                   struct gc_collection_stats *cs, _PyTime_t *t) {
     validate_list(base, collecting_clear_unreachable_clear);
     /* Using ob_refcnt and gc_refs, calculate which objects in the
      * container set are reachable from outside the set (i.e., have a
      * refcount greater than 0 when all the references within the
      * set are taken into account).
      */
-    update_refs(base);  // gc_prev is used for gc_refs
+    Py_ssize_t n = update_refs(base);  // gc_prev is used for gc_refs
+    if (cs != NULL) {
+        cs->examined += n;
+        gc_phase_done(cs, PHASE_UPDATE_REFS, t);
+    }
     subtract_refs(base);
+    if (cs != NULL) {
+        gc_phase_done(cs, PHASE_SUBTRACT_REFS, t);
+    }
 
     /* Leave everything reachable from outside base in base, and move
      * everything else (in base) to unreachable.
@@ -1139,6 +1276,9 @@ deduce_unreachable(PyGC_Head *base, PyGC_Head *unreachable) {
     move_unreachable(base, unreachable);  // gc_prev is pointer again
     validate_list(base, collecting_clear_unreachable_clear);
     validate_list(unreachable, collecting_set_unreachable_set);
+    if (cs != NULL) {
+        gc_phase_done(cs, PHASE_MOVE_UNREACHABLE, t);
+    }
 }
 
 /* Handle objects that may have resurrected after a call to 'finalize_garbage', moving
@@ -1166,82 +1306,46 @@ handle_resurrected_objects(PyGC_Head *unreachable, PyGC_Head* still_unreachable,
     // have the PREV_MARK_COLLECTING set, but the objects are going to be
     // removed so we can skip the expense of clearing the flag.
     PyGC_Head* resurrected = unreachable;
-    deduce_unreachable(resurrected, still_unreachable);
+    deduce_unreachable(resurrected, still_unreachable, NULL, NULL);
     clear_unreachable_mask(still_unreachable);
 
     // Move the resurrected objects to the old generation for future collection.
     gc_list_merge(resurrected, old_generation);
 }
 
-/* This is the main function.  Read this to understand how the
- * collection process works. */
-static Py_ssize_t
-collect(PyThreadState *tstate, int generation,
-        Py_ssize_t *n_collected, Py_ssize_t *n_uncollectable, int nofail)
+/* Collect the objects of 'young' which can't be reached from outside of it.
+ * The objects which survive are moved to 'old', which can be 'young' itself.
+ * Dicts are examined for untracking only if 'full' is true.  The number of
+ * objects found reachable from outside 'young' is stored in '*n_reachable',
+ * the other statistics are added to 'cs'.
+ */
+static void
+gc_collect_region(PyThreadState *tstate, PyGC_Head *young, PyGC_Head *old,
+                  int full, Py_ssize_t *n_reachable,
+                  struct gc_collection_stats *cs)
 {
-    int i;
     Py_ssize_t m = 0; /* # objects collected */
     Py_ssize_t n = 0; /* # unreachable objects that couldn't be collected */
-    PyGC_Head *young; /* the generation we are examining */
-    PyGC_Head *old; /* next older generation */
     PyGC_Head unreachable; /* non-problematic unreachable trash */
     PyGC_Head finalizers;  /* objects with, & reachable from, __del__ */
     PyGC_Head *gc;
-    _PyTime_t t1 = 0;   /* initialize to prevent a compiler warning */
     GCState *gcstate = &tstate->interp->gc;
+    _PyTime_t t = _PyTime_GetMonotonicClock();
 
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    if (tstate->interp->config._isolated_interpreter) {
-        // bpo-40533: The garbage collector must not be run on parallel on
-        // Python objects shared by multiple interpreters.
-        return 0;
-    }
-#endif
-
-    if (gcstate->debug & DEBUG_STATS) {
-        PySys_WriteStderr("gc: collecting generation %d...\n", generation);
-        show_stats_each_generations(gcstate);
-        t1 = _PyTime_GetMonotonicClock();
-    }
-
-    if (PyDTrace_GC_START_ENABLED())
-        PyDTrace_GC_START(generation);
-
-    /* update collection and allocation counters */
-    if (generation+1 < NUM_GENERATIONS)
-        gcstate->generations[generation+1].count += 1;
-    for (i = 0; i <= generation; i++)
-        gcstate->generations[i].count = 0;
-
-    /* merge younger generations with one we are currently collecting */
-    for (i = 0; i < generation; i++) {
-        gc_list_merge(GEN_HEAD(gcstate, i), GEN_HEAD(gcstate, generation));
-    }
-
-    /* handy references */
-    young = GEN_HEAD(gcstate, generation);
-    if (generation < NUM_GENERATIONS-1)
-        old = GEN_HEAD(gcstate, generation+1);
-    else
-        old = young;
     validate_list(old, collecting_clear_unreachable_clear);
 
-    deduce_unreachable(young, &unreachable);
+    deduce_unreachable(young, &unreachable, cs, &t);
 
     untrack_tuples(young);
-    /* Move reachable objects to next generation. */
-    if (young != old) {
-        if (generation == NUM_GENERATIONS - 2) {
-            gcstate->long_lived_pending += gc_list_size(young);
-        }
-        gc_list_merge(young, old);
-    }
-    else {
+    if (full) {
         /* We only un-track dicts in full collections, to avoid quadratic
            dict build-up. See issue #14775. */
         untrack_dicts(young);
-        gcstate->long_lived_pending = 0;
-        gcstate->long_lived_total = gc_list_size(young);
+    }
+    *n_reachable = gc_list_size(young);
+    /* Move reachable objects to next generation. */
+    if (young != old) {
+        gc_list_merge(young, old);
     }
 
     /* All objects in unreachable are trash, but objects reachable from
@@ -1266,12 +1370,14 @@ collect(PyThreadState *tstate, int generation,
             debug_cycle("collectable", FROM_GC(gc));
         }
     }
+    gc_phase_done(cs, PHASE_MOVE_UNREACHABLE, &t);
 
     /* Clear weakrefs and invoke callbacks as necessary. */
     m += handle_weakrefs(&unreachable, old);
 
     validate_list(old, collecting_clear_unreachable_clear);
     validate_list(&unreachable, collecting_set_unreachable_clear);
+    gc_phase_done(cs, PHASE_HANDLE_WEAKREFS, &t);
 
     /* Call tp_finalize on objects which have one. */
     finalize_garbage(tstate, &unreachable);
@@ -1281,6 +1387,7 @@ collect(PyThreadState *tstate, int generation,
      * objects that are still unreachable */
     PyGC_Head final_unreachable;
     handle_resurrected_objects(&unreachable, &final_unreachable, old);
+    gc_phase_done(cs, PHASE_FINALIZERS, &t);
 
     /* Call tp_clear on objects in the final_unreachable set.  This will cause
     * the reference cycles to be broken.  It may also cause some objects
@@ -1288,6 +1395,7 @@ collect(PyThreadState *tstate, int generation,
     */
     m += gc_list_size(&final_unreachable);
     delete_garbage(tstate, gcstate, &final_unreachable, old);
+    gc_phase_done(cs, PHASE_DELETE_GARBAGE, &t);
 
     /* Collect statistics on uncollectable objects found and print
      * debugging information. */
@@ -1296,12 +1404,6 @@ collect(PyThreadState *tstate, int generation,
         if (gcstate->debug & DEBUG_UNCOLLECTABLE)
             debug_cycle("uncollectable", FROM_GC(gc));
     }
-    if (gcstate->debug & DEBUG_STATS) {
-        double d = _PyTime_AsSecondsDouble(_PyTime_GetMonotonicClock() - t1);
-        PySys_WriteStderr(
-            "gc: done, %zd unreachable, %zd uncollectable, %.4fs elapsed\n",
-            n+m, n, d);
-    }
 
     /* Append instances in the uncollectable set to a Python
      * reachable list of garbage.  The programmer has to deal with
@@ -1309,6 +1411,144 @@ collect(PyThreadState *tstate, int generation,
      */
     handle_legacy_finalizers(tstate, gcstate, &finalizers, old);
     validate_list(old, collecting_clear_unreachable_clear);
+    gc_phase_done(cs, PHASE_FINALIZERS, &t);
+
+    cs->collected += m;
+    cs->uncollectable += n;
+}
+
+/* Return the index of the bucket of the pause time histogram */
+static int
+gc_pause_bucket(_PyTime_t pause)
+{
+    _PyTime_t us = _PyTime_AsMicroseconds(pause, _PyTime_ROUND_FLOOR);
+    if (us <= 0) {
+        return 0;
+    }
+    if (us >= ((_PyTime_t)1 << (NUM_GC_PAUSE_BUCKETS - 2))) {
+        return NUM_GC_PAUSE_BUCKETS - 1;
+    }
+    return (int)_Py_bit_length((unsigned long)us);
+}
+
+/* Add the statistics of a collection to the running stats of its
+ * generation. */
+static void
+gc_add_stats(GCState *gcstate, struct gc_collection_stats *cs)
+{
+    struct gc_generation_stats *stats =
+        &gcstate->generation_stats[cs->generation];
+    stats->collected += cs->collected;
+    stats->uncollectable += cs->uncollectable;
+    stats->examined += cs->examined;
+    stats->pause_time += cs->pause;
+    if (cs->pause > stats->max_pause) {
+        stats->max_pause = cs->pause;
+    }
+    for (int i = 0; i < NUM_GC_PHASES; i++) {
+        stats->phase_time[i] += cs->phase_time[i];
+    }
+    stats->pause_histogram[gc_pause_bucket(cs->pause)]++;
+
+    if (PyDTrace_GC_PAUSE_ENABLED()) {
+        PyDTrace_GC_PAUSE(cs->generation, cs->pause, cs->examined);
+    }
+}
+
+/* Abandon the incremental pass in progress, if any, returning all the
+ * objects it holds to the oldest generation. */
+static void
+incr_abort(GCState *gcstate)
+{
+    if (gcstate->incr_phase == INCR_IDLE) {
+        return;
+    }
+    PyGC_Head *old = GEN_HEAD(gcstate, NUM_GENERATIONS-1);
+    gc_list_merge(&gcstate->incr_gray, old);
+    gc_list_merge(&gcstate->incr_visited, old);
+    gc_list_merge(&gcstate->incr_pending, old);
+    gc_list_set_visited(old, 0);
+    gcstate->incr_phase = INCR_IDLE;
+}
+
+/* This is the main function.  Read this to understand how the
+ * collection process works.  The statistics of the collection are stored
+ * in 'cs'. */
+static Py_ssize_t
+collect(PyThreadState *tstate, int generation,
+        struct gc_collection_stats *cs, int nofail)
+{
+    int i;
+    Py_ssize_t reachable;
+    PyGC_Head *young; /* the generation we are examining */
+    PyGC_Head *old; /* next older generation */
+    PyGC_Head promoted; /* survivors promoted during an incremental pass */
+    GCState *gcstate = &tstate->interp->gc;
+
+    memset(cs, 0, sizeof(*cs));
+    cs->generation = generation;
+
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    if (tstate->interp->config._isolated_interpreter) {
+        // bpo-40533: The garbage collector must not be run on parallel on
+        // Python objects shared by multiple interpreters.
+        return 0;
+    }
+#endif
+
+    if (generation == NUM_GENERATIONS-1) {
+        /* A full collection supersedes the incremental pass in progress */
+        incr_abort(gcstate);
+    }
+
+    if (gcstate->debug & DEBUG_STATS) {
+        PySys_WriteStderr("gc: collecting generation %d...\n", generation);
+        show_stats_each_generations(gcstate);
+    }
+
+    if (PyDTrace_GC_START_ENABLED())
+        PyDTrace_GC_START(generation);
+
+    _PyTime_t t1 = _PyTime_GetMonotonicClock();
+
+    /* update collection and allocation counters */
+    if (generation+1 < NUM_GENERATIONS)
+        gcstate->generations[generation+1].count += 1;
+    for (i = 0; i <= generation; i++)
+        gcstate->generations[i].count = 0;
+
+    /* merge younger generations with one we are currently collecting */
+    for (i = 0; i < generation; i++) {
+        gc_list_merge(GEN_HEAD(gcstate, i), GEN_HEAD(gcstate, generation));
+    }
+
+    /* handy references */
+    young = GEN_HEAD(gcstate, generation);
+    if (generation < NUM_GENERATIONS-1) {
+        old = GEN_HEAD(gcstate, generation+1);
+        if (generation == NUM_GENERATIONS-2 && incr_scanning(gcstate)) {
+            gc_list_init(&promoted);
+            old = &promoted;
+        }
+    }
+    else
+        old = young;
+
+    gc_collect_region(tstate, young, old, young == old, &reachable, cs);
+
+    if (young == old) {
+        gcstate->long_lived_pending = 0;
+        gcstate->long_lived_total = reachable;
+    }
+    else if (generation == NUM_GENERATIONS - 2) {
+        gcstate->long_lived_pending += reachable;
+    }
+    if (old == &promoted) {
+        /* The incremental pass treats objects promoted while it runs as
+           reachable: they are examined by the next pass. */
+        gc_list_set_visited(&promoted, incr_scanning(gcstate));
+        gc_list_merge(&promoted, GEN_HEAD(gcstate, NUM_GENERATIONS-1));
+    }
 
     /* Clear free list only during the collection of the highest
      * generation */
@@ -1316,6 +1556,16 @@ collect(PyThreadState *tstate, int generation,
         clear_freelists(tstate);
     }
 
+    Py_ssize_t m = cs->collected;
+    Py_ssize_t n = cs->uncollectable;
+    cs->pause = _PyTime_GetMonotonicClock() - t1;
+    if (gcstate->debug & DEBUG_STATS) {
+        double d = _PyTime_AsSecondsDouble(cs->pause);
+        PySys_WriteStderr(
+            "gc: done, %zd unreachable, %zd uncollectable, %.4fs elapsed\n",
+            n+m, n, d);
+    }
+
     if (_PyErr_Occurred(tstate)) {
         if (nofail) {
             _PyErr_Clear(tstate);
@@ -1326,17 +1576,8 @@ collect(PyThreadState *tstate, int generation,
     }
 
     /* Update stats */
-    if (n_collected) {
-        *n_collected = m;
-    }
-    if (n_uncollectable) {
-        *n_uncollectable = n;
-    }
-
-    struct gc_generation_stats *stats = &gcstate->generation_stats[generation];
-    stats->collections++;
-    stats->collected += m;
-    stats->uncollectable += n;
+    gcstate->generation_stats[generation].collections++;
+    gc_add_stats(gcstate, cs);
 
     if (PyDTrace_GC_DONE_ENABLED()) {
         PyDTrace_GC_DONE(n + m);
@@ -1346,13 +1587,34 @@ collect(PyThreadState *tstate, int generation,
     return n + m;
 }
 
+/* Return a dict mapping the names of the phases of a collection to the time
+ * spent in them, in seconds. */
+static PyObject *
+gc_phase_times(const _PyTime_t *phase_time)
+{
+    PyObject *dict = PyDict_New();
+    if (dict == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < NUM_GC_PHASES; i++) {
+        PyObject *t = PyFloat_FromDouble(
+            _PyTime_AsSecondsDouble(phase_time[i]));
+        if (t == NULL || PyDict_SetItemString(dict, gc_phase_names[i], t) < 0) {
+            Py_XDECREF(t);
+            Py_DECREF(dict);
+            return NULL;
+        }
+        Py_DECREF(t);
+    }
+    return dict;
+}
+
 /* Invoke progress callbacks to notify clients that garbage collection
- * is starting or stopping
+ * is starting or stopping.  'cs' is NULL when it is starting.
  */
 static void
 invoke_gc_callback(PyThreadState *tstate, const char *phase,
-                   int generation, Py_ssize_t collected,
-                   Py_ssize_t uncollectable)
+                   int generation, struct gc_collection_stats *cs)
 {
     assert(!_PyErr_Occurred(tstate));
 
@@ -1366,10 +1628,21 @@ invoke_gc_callback(PyThreadState *tstate, const char *phase,
     assert(PyList_CheckExact(gcstate->callbacks));
     PyObject *info = NULL;
     if (PyList_GET_SIZE(gcstate->callbacks) != 0) {
-        info = Py_BuildValue("{sisnsn}",
-            "generation", generation,
-            "collected", collected,
-            "uncollectable", uncollectable);
+        if (cs == NULL) {
+            info = Py_BuildValue("{sisnsn}",
+                "generation", generation,
+                "collected", (Py_ssize_t)0,
+                "uncollectable", (Py_ssize_t)0);
+        }
+        else {
+            info = Py_BuildValue("{sisnsnsnsdsN}",
+                "generation", generation,
+                "collected", cs->collected,
+                "uncollectable", cs->uncollectable,
+                "examined", cs->examined,
+                "pause", _PyTime_AsSecondsDouble(cs->pause),
+                "phase_times", gc_phase_times(cs->phase_time));
+        }
         if (info == NULL) {
             PyErr_WriteUnraisable(NULL);
             return;
@@ -1398,14 +1671,326 @@ static Py_ssize_t
 collect_with_callback(PyThreadState *tstate, int generation)
 {
     assert(!_PyErr_Occurred(tstate));
-    Py_ssize_t result, collected, uncollectable;
-    invoke_gc_callback(tstate, "start", generation, 0, 0);
-    result = collect(tstate, generation, &collected, &uncollectable, 0);
-    invoke_gc_callback(tstate, "stop", generation, collected, uncollectable);
+    Py_ssize_t result;
+    struct gc_collection_stats cs;
+    invoke_gc_callback(tstate, "start", generation, NULL);
+    result = collect(tstate, generation, &cs, 0);
+    invoke_gc_callback(tstate, "stop", generation, &cs);
     assert(!_PyErr_Occurred(tstate));
     return result;
 }
 
+/* Incremental collection of the oldest generation
+ * ------------------------------------------------
+ *
+ * When enabled by gc.set_incremental(), the automatic collections of the
+ * oldest generation are split into steps limited by a time or object budget,
+ * so that a program with a large heap doesn't stop for the time needed to
+ * examine all of it.  A pass goes through these phases:
+ *
+ * INCR_MARK: incr_start() moves the oldest generation to incr_pending, then
+ *     the objects reachable from the sys and builtins dicts and from the
+ *     frames of all threads are moved to incr_visited, a chunk at a time.
+ *
+ * INCR_SWEEP: the objects left in incr_pending are collected a slice at a
+ *     time.  A slice is extended with every object it refers to, directly or
+ *     not, which hasn't been reached yet, so that an unreachable cycle is
+ *     collected by a single slice.  The survivors go to incr_visited.
+ *
+ * INCR_CLEAR: the objects of incr_visited are moved back to the oldest
+ *     generation.
+ *
+ * A slice is collected exactly like a young generation: references from
+ * objects outside of it keep its objects alive.  This is why no write barrier
+ * is needed.  Changes made by the program between two steps can only make a
+ * pass miss garbage, which is found by the next one.  The marking only saves
+ * the sweep the work of examining the objects known to be alive.
+ *
+ * The objects reached by the pass are flagged with NEXT_MASK_VISITED.  So are
+ * the objects promoted to the oldest generation while it scans, and the
+ * frozen objects, which must never be moved by a pass.
+ */
+
+/* Number of objects traversed between two checks of the budget */
+#define INCR_CHUNK 1024
+/* Minimum number of objects of a slice */
+#define INCR_MIN_SLICE 100
+
+static const char *incr_phase_names[] = {"idle", "mark", "sweep", "clear"};
+
+/* A traversal callback moving the objects not reached yet to 'list'. */
+static int
+visit_incr_reach(PyObject *op, PyGC_Head *list)
+{
+    if (_PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        if (gc->_gc_next != 0 && !gc_is_visited(gc)) {
+            gc_list_move(gc, list);
+            gc_set_visited(gc);
+        }
+    }
+    return 0;
+}
+
+static void
+incr_start(PyThreadState *tstate)
+{
+    PyInterpreterState *interp = tstate->interp;
+    GCState *gcstate = &interp->gc;
+    PyGC_Head *gray = &gcstate->incr_gray;
+    assert(gcstate->incr_phase == INCR_IDLE);
+
+    gc_list_merge(GEN_HEAD(gcstate, NUM_GENERATIONS-1),
+                  &gcstate->incr_pending);
+    gcstate->generations[NUM_GENERATIONS-1].count = 0;
+    gcstate->long_lived_pending = 0;
+    gcstate->incr_survivors = 0;
+    gcstate->incr_phase = INCR_MARK;
+
+    if (interp->sysdict != NULL) {
+        visit_incr_reach(interp->sysdict, gray);
+    }
+    if (interp->builtins != NULL) {
+        visit_incr_reach(interp->builtins, gray);
+    }
+    PyThread_acquire_lock(interp->runtime->interpreters.mutex, WAIT_LOCK);
+    for (PyThreadState *t = interp->tstate_head; t != NULL; t = t->next) {
+        if (t->frame != NULL) {
+            visit_incr_reach((PyObject *)t->frame, gray);
+        }
+        if (t->dict != NULL) {
+            visit_incr_reach(t->dict, gray);
+        }
+    }
+    PyThread_release_lock(interp->runtime->interpreters.mutex);
+}
+
+/* Traverse up to 'limit' reached objects.  Return their number. */
+static Py_ssize_t
+incr_mark(GCState *gcstate, Py_ssize_t limit)
+{
+    PyGC_Head *gray = &gcstate->incr_gray;
+    Py_ssize_t n = 0;
+    while (n < limit && !gc_list_is_empty(gray)) {
+        PyGC_Head *gc = GC_NEXT(gray);
+        PyObject *op = FROM_GC(gc);
+        gc_list_move(gc, &gcstate->incr_visited);
+        (void) Py_TYPE(op)->tp_traverse(op, (visitproc)visit_incr_reach,
+                                        gray);
+        n++;
+    }
+    gcstate->incr_survivors += n;
+    return n;
+}
+
+/* Collect a slice made of up to 'limit' objects of incr_pending and of the
+ * objects they refer to which haven't been reached yet.  Return the size of
+ * the slice. */
+static Py_ssize_t
+incr_sweep(PyThreadState *tstate, Py_ssize_t limit,
+           struct gc_collection_stats *cs)
+{
+    GCState *gcstate = &tstate->interp->gc;
+    PyGC_Head *pending = &gcstate->incr_pending;
+    PyGC_Head slice, survivors;
+    PyGC_Head *gc;
+    Py_ssize_t size = 0, reachable;
+
+    _PyTime_t t1 = _PyTime_GetMonotonicClock();
+    gc_list_init(&slice);
+    gc_list_init(&survivors);
+    while (size < limit && !gc_list_is_empty(pending)) {
+        gc = GC_NEXT(pending);
+        gc_list_move(gc, &slice);
+        gc_set_visited(gc);
+        size++;
+    }
+    /* The traversal appends objects to the slice while it walks it */
+    size = 0;
+    for (gc = GC_NEXT(&slice); gc != &slice; gc = GC_NEXT(gc)) {
+        PyObject *op = FROM_GC(gc);
+        (void) Py_TYPE(op)->tp_traverse(op, (visitproc)visit_incr_reach,
+                                        &slice);
+        size++;
+    }
+
+    gc_collect_region(tstate, &slice, &survivors, 1, &reachable, cs);
+
+    if (incr_scanning(gcstate)) {
+        gcstate->incr_survivors += gc_list_set_visited(&survivors, 1);
+        gc_list_merge(&survivors, &gcstate->incr_visited);
+    }
+    else {
+        /* A finalizer aborted the pass */
+        gc_list_set_visited(&survivors, 0);
+        gc_list_merge(&survivors, GEN_HEAD(gcstate, NUM_GENERATIONS-1));
+    }
+
+    double cost = (double)(_PyTime_GetMonotonicClock() - t1) / size;
+    gcstate->incr_object_cost = 0.75 * gcstate->incr_object_cost + 0.25 * cost;
+    return size;
+}
+
+static void
+incr_finish(PyThreadState *tstate)
+{
+    GCState *gcstate = &tstate->interp->gc;
+    gcstate->generation_stats[NUM_GENERATIONS-1].collections++;
+    /* Add the objects promoted during the pass */
+    gc_list_merge(GEN_HEAD(gcstate, NUM_GENERATIONS-1),
+                  &gcstate->incr_visited);
+    gcstate->long_lived_total = (gcstate->incr_survivors
+                                 + gcstate->long_lived_pending);
+    gcstate->long_lived_pending = 0;
+    clear_freelists(tstate);
+    gcstate->incr_phase = INCR_CLEAR;
+}
+
+/* Move up to 'limit' reached objects back to the oldest generation.  Return
+ * their number. */
+static Py_ssize_t
+incr_clear(GCState *gcstate, Py_ssize_t limit)
+{
+    PyGC_Head *visited = &gcstate->incr_visited;
+    Py_ssize_t n = 0;
+    while (n < limit && !gc_list_is_empty(visited)) {
+        PyGC_Head *gc = GC_NEXT(visited);
+        gc_list_move(gc, GEN_HEAD(gcstate, NUM_GENERATIONS-1));
+        gc_clear_visited(gc);
+        n++;
+    }
+    return n;
+}
+
+/* Return the number of objects the next slice may start with, to end the
+ * step around 'deadline' (if not 0) and after 'limit' objects. */
+static Py_ssize_t
+incr_slice_size(GCState *gcstate, _PyTime_t deadline, Py_ssize_t limit)
+{
+    if (deadline != 0) {
+        _PyTime_t left = deadline - _PyTime_GetMonotonicClock();
+        double n = left / gcstate->incr_object_cost;
+        if (n < INCR_MIN_SLICE) {
+            n = INCR_MIN_SLICE;
+        }
+        if (n < (double)limit) {
+            limit = (Py_ssize_t)n;
+        }
+    }
+    return limit;
+}
+
+/* Advance the pass in progress until the budget of a step is exhausted. */
+static void
+incr_step(PyThreadState *tstate, struct gc_collection_stats *cs)
+{
+    GCState *gcstate = &tstate->interp->gc;
+    Py_ssize_t budget = gcstate->incr_budget_objects;
+    Py_ssize_t work = 0;
+    _PyTime_t deadline = 0;
+
+    if (gcstate->incr_budget > 0) {
+        deadline = _PyTime_GetMonotonicClock() + gcstate->incr_budget;
+    }
+    for (;;) {
+        Py_ssize_t limit = budget > 0 ? budget - work : PY_SSIZE_T_MAX;
+        Py_ssize_t n;
+        switch (gcstate->incr_phase) {
+        case INCR_MARK:
+            n = incr_mark(gcstate, Py_MIN(limit, INCR_CHUNK));
+            cs->examined += n;
+            work += n;
+            if (gc_list_is_empty(&gcstate->incr_gray)) {
+                gcstate->incr_phase = INCR_SWEEP;
+            }
+            break;
+        case INCR_SWEEP:
+            if (gc_list_is_empty(&gcstate->incr_pending)) {
+                incr_finish(tstate);
+                break;
+            }
+            limit = incr_slice_size(gcstate, deadline, limit);
+            work += incr_sweep(tstate, limit, cs);
+            break;
+        case INCR_CLEAR:
+            work += incr_clear(gcstate, Py_MIN(limit, INCR_CHUNK));
+            if (gc_list_is_empty(&gcstate->incr_visited)) {
+                gcstate->incr_phase = INCR_IDLE;
+            }
+            break;
+        default:
+            return;
+        }
+        if (budget > 0 && work >= budget) {
+            return;
+        }
+        if (deadline != 0 && _PyTime_GetMonotonicClock() >= deadline) {
+            return;
+        }
+    }
+}
+
+/* Collect the young generations, then run a step of the incremental
+ * collection of the oldest generation, starting a new pass if needed. */
+static Py_ssize_t
+gc_collect_increment(PyThreadState *tstate)
+{
+    GCState *gcstate = &tstate->interp->gc;
+    struct gc_collection_stats cs;
+
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    if (tstate->interp->config._isolated_interpreter) {
+        // bpo-40533: The garbage collector must not be run on parallel on
+        // Python objects shared by multiple interpreters.
+        return 0;
+    }
+#endif
+
+    Py_ssize_t result = collect_with_callback(tstate, NUM_GENERATIONS - 2);
+    if (gcstate->incr_phase == INCR_IDLE) {
+        if (!gcstate->incremental) {
+            return result;
+        }
+        incr_start(tstate);
+    }
+
+    invoke_gc_callback(tstate, "start", NUM_GENERATIONS - 1, NULL);
+    if (gcstate->debug & DEBUG_STATS) {
+        PySys_WriteStderr("gc: collecting generation %d incrementally "
+                          "(%s)...\n", NUM_GENERATIONS - 1,
+                          incr_phase_names[gcstate->incr_phase]);
+    }
+    if (PyDTrace_GC_START_ENABLED()) {
+        PyDTrace_GC_START(NUM_GENERATIONS - 1);
+    }
+
+    memset(&cs, 0, sizeof(cs));
+    cs.generation = NUM_GENERATIONS - 1;
+    _PyTime_t t1 = _PyTime_GetMonotonicClock();
+    incr_step(tstate, &cs);
+    cs.pause = _PyTime_GetMonotonicClock() - t1;
+
+    Py_ssize_t m = cs.collected;
+    Py_ssize_t n = cs.uncollectable;
+    if (gcstate->debug & DEBUG_STATS) {
+        double d = _PyTime_AsSecondsDouble(cs.pause);
+        PySys_WriteStderr(
+            "gc: done, %zd objects examined, %zd unreachable, "
+            "%zd uncollectable, %.4fs elapsed\n",
+            cs.examined, n+m, n, d);
+    }
+    if (_PyErr_Occurred(tstate)) {
+        _PyErr_WriteUnraisableMsg("in garbage collection", NULL);
+    }
+
+    gc_add_stats(gcstate, &cs);
+    if (PyDTrace_GC_DONE_ENABLED()) {
+        PyDTrace_GC_DONE(n + m);
+    }
+    invoke_gc_callback(tstate, "stop", NUM_GENERATIONS - 1, &cs);
+    return result + n + m;
+}
+
 static Py_ssize_t
 collect_generations(PyThreadState *tstate)
 {
@@ -1455,7 +2040,17 @@ collect_generations(PyThreadState *tstate)
             if (i == NUM_GENERATIONS - 1
                 && gcstate->long_lived_pending < gcstate->long_lived_total / 4)
                 continue;
-            n = collect_with_callback(tstate, i);
+            /* Once started, an incremental pass advances each time the
+               middle generation is collected. */
+            if (gcstate->incremental && i >= NUM_GENERATIONS - 2
+                && (i == NUM_GENERATIONS - 1
+                    || gcstate->incr_phase != INCR_IDLE))
+            {
+                n = gc_collect_increment(tstate);
+            }
+            else {
+                n = collect_with_callback(tstate, i);
+            }
             break;
         }
     }
@@ -1686,6 +2281,7 @@ gc_get_referrers(PyObject *self, PyObject *args)
     }
 
     GCState *gcstate = get_gc_state();
+    incr_abort(gcstate);
     for (int i = 0; i < NUM_GENERATIONS; i++) {
         if (!(gc_referrers_for(args, GEN_HEAD(gcstate, i), result))) {
             Py_DECREF(result);
@@ -1756,6 +2352,7 @@ gc_get_objects_impl(PyObject *module, Py_ssize_t generation)
     if (result == NULL) {
         return NULL;
     }
+    incr_abort(gcstate);
 
     /* If generation is passed, we extract only that generation */
     if (generation != -1) {
@@ -1793,6 +2390,25 @@ error:
     return NULL;
 }
 
+/* Return the pause time histogram as a list of counts */
+static PyObject *
+gc_pause_histogram(const Py_ssize_t *histogram)
+{
+    PyObject *list = PyList_New(NUM_GC_PAUSE_BUCKETS);
+    if (list == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < NUM_GC_PAUSE_BUCKETS; i++) {
+        PyObject *n = PyLong_FromSsize_t(histogram[i]);
+        if (n == NULL) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, n);
+    }
+    return list;
+}
+
 /*[clinic input]
 gc.get_stats
 
@@ -1820,10 +2436,18 @@ gc_get_stats_impl(PyObject *module)
     for (i = 0; i < NUM_GENERATIONS; i++) {
         PyObject *dict;
         st = &stats[i];
-        dict = Py_BuildValue("{snsnsn}",
+        dict = Py_BuildValue("{snsnsnsnsdsdsNsN}",
                              "collections", st->collections,
                              "collected", st->collected,
-                             "uncollectable", st->uncollectable
+                             "uncollectable", st->uncollectable,
+                             "examined", st->examined,
+                             "pause_time",
+                             _PyTime_AsSecondsDouble(st->pause_time),
+                             "max_pause",
+                             _PyTime_AsSecondsDouble(st->max_pause),
+                             "phase_times", gc_phase_times(st->phase_time),
+                             "pause_histogram",
+                             gc_pause_histogram(st->pause_histogram)
                             );
         if (dict == NULL)
             goto error;
@@ -1900,10 +2524,15 @@ gc_freeze_impl(PyObject *module)
 /*[clinic end generated code: output=502159d9cdc4c139 input=b602b16ac5febbe5]*/
 {
     GCState *gcstate = get_gc_state();
+    incr_abort(gcstate);
     for (int i = 0; i < NUM_GENERATIONS; ++i) {
         gc_list_merge(GEN_HEAD(gcstate, i), &gcstate->permanent_generation.head);
         gcstate->generations[i].count = 0;
     }
+    if (gcstate->incremental) {
+        /* Incremental passes must not move frozen objects */
+        gc_list_set_visited(&gcstate->permanent_generation.head, 1);
+    }
     Py_RETURN_NONE;
 }
 
@@ -1920,6 +2549,9 @@ gc_unfreeze_impl(PyObject *module)
 /*[clinic end generated code: output=1c15f2043b25e169 input=2dd52b170f4cef6c]*/
 {
     GCState *gcstate = get_gc_state();
+    if (gcstate->incremental) {
+        gc_list_set_visited(&gcstate->permanent_generation.head, 0);
+    }
     gc_list_merge(&gcstate->permanent_generation.head,
                   GEN_HEAD(gcstate, NUM_GENERATIONS-1));
     Py_RETURN_NONE;
@@ -1939,6 +2571,83 @@ gc_get_freeze_count_impl(PyObject *module)
     return gc_list_size(&gcstate->permanent_generation.head);
 }
 
+/*[clinic input]
+gc.set_incremental
+
+    enabled: bool = True
+    *
+    budget_ms: double = 2.0
+    budget_objects: Py_ssize_t = 0
+
+Enable or disable the incremental collection of the oldest generation.
+
+When enabled, the automatic collections of the oldest generation are split
+into steps, run along with the collections of the middle generation.  A step
+stops when it has run for budget_ms milliseconds or has examined
+budget_objects objects.  A budget of 0 means no limit, but at least one
+budget must be set.  gc.collect() always runs a full collection.
+[clinic start generated code]*/
+
+static PyObject *
+gc_set_incremental_impl(PyObject *module, int enabled, double budget_ms,
+                        Py_ssize_t budget_objects)
+/*[clinic end generated code: output=33af1afd52276ce3 input=8eca2901b7416acb]*/
+{
+    GCState *gcstate = get_gc_state();
+
+    if (!(budget_ms >= 0.0)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "budget_ms must be a non-negative number");
+        return NULL;
+    }
+    if (budget_ms > (double)_PyTime_MAX / 1e6) {
+        PyErr_SetString(PyExc_OverflowError, "budget_ms is too large");
+        return NULL;
+    }
+    if (budget_objects < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "budget_objects must be non-negative");
+        return NULL;
+    }
+    if (enabled && budget_ms == 0.0 && budget_objects == 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "budget_ms and budget_objects cannot both be 0");
+        return NULL;
+    }
+
+    if (enabled != gcstate->incremental) {
+        if (!enabled) {
+            incr_abort(gcstate);
+        }
+        gc_list_set_visited(&gcstate->permanent_generation.head, enabled);
+        gcstate->incremental = enabled;
+    }
+    gcstate->incr_budget = (_PyTime_t)(budget_ms * 1e6);
+    gcstate->incr_budget_objects = budget_objects;
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+gc.get_incremental
+
+Return a dictionary describing the incremental collection settings.
+
+The dictionary has the keys 'enabled', 'budget_ms' and 'budget_objects',
+and 'phase', the phase of the pass in progress ('idle' if there is none).
+[clinic start generated code]*/
+
+static PyObject *
+gc_get_incremental_impl(PyObject *module)
+/*[clinic end generated code: output=7dd3078b18c0e4ba input=051111464f2ef90f]*/
+{
+    GCState *gcstate = get_gc_state();
+    return Py_BuildValue("{sNsdsnss}",
+                         "enabled", PyBool_FromLong(gcstate->incremental),
+                         "budget_ms", gcstate->incr_budget / 1e6,
+                         "budget_objects", gcstate->incr_budget_objects,
+                         "phase", incr_phase_names[gcstate->incr_phase]);
+}
+
 
 PyDoc_STRVAR(gc__doc__,
 "This module provides access to the garbage collector for reference cycles.\n"
@@ -1960,7 +2669,9 @@ PyDoc_STRVAR(gc__doc__,
 "get_referents() -- Return the list of objects that an object refers to.\n"
 "freeze() -- Freeze all tracked objects and ignore them for future collections.\n"
 "unfreeze() -- Unfreeze all objects in the permanent generation.\n"
-"get_freeze_count() -- Return the number of objects in the permanent generation.\n");
+"get_freeze_count() -- Return the number of objects in the permanent generation.\n"
+"set_incremental() -- Configure incremental collection of the oldest generation.\n"
+"get_incremental() -- Return the incremental collection settings.\n");
 
 static PyMethodDef GcMethods[] = {
     GC_ENABLE_METHODDEF
@@ -1983,6 +2694,8 @@ static PyMethodDef GcMethods[] = {
     GC_FREEZE_METHODDEF
     GC_UNFREEZE_METHODDEF
     GC_GET_FREEZE_COUNT_METHODDEF
+    GC_SET_INCREMENTAL_METHODDEF
+    GC_GET_INCREMENTAL_METHODDEF
     {NULL,      NULL}           /* Sentinel */
 };
 
@@ -2095,7 +2808,8 @@ _PyGC_CollectNoFail(void)
     }
     else {
         gcstate->collecting = 1;
-        n = collect(tstate, NUM_GENERATIONS - 1, NULL, NULL, 1);
+        struct gc_collection_stats cs;
+        n = collect(tstate, NUM_GENERATIONS - 1, &cs, 1);
         gcstate->collecting = 0;
     }
     return n;
@@ -315,7 +315,7 @@ function_code_fastcall(PyThreadState *tstate, PyCodeObject *co,
        _PyFrame_New_NoTrack() that doesn't take locals, but does
        take builtins without sanity checking them.
        */
-    PyFrameObject *f = _PyFrame_New_NoTrack(tstate, co, globals, NULL);
+    PyFrameObject *f = _PyFrame_NewOnStack_NoTrack(tstate, co, globals, NULL);
     if (f == NULL) {
         return NULL;
     }
@@ -6,6 +6,7 @@
 #include "structmember.h"         // PyMemberDef
 #include "pycore_code.h"
 #include "pycore_interp.h"        // PyInterpreterState.co_extra_freefuncs
+#include "pycore_jit.h"           // _PyJIT_Free()
 #include "pycore_pystate.h"       // _PyInterpreterState_GET()
 #include "pycore_tupleobject.h"
 #include "clinic/codeobject.c.h"
@@ -268,6 +269,11 @@ PyCode_NewWithPosOnlyArgs(int argcount, int posonlyargcount, int kwonlyargcount,
     co->co_opcache = NULL;
     co->co_opcache_flag = 0;
     co->co_opcache_size = 0;
+    co->co_quickened = NULL;
+    co->co_exceptiontable = NULL;
+    co->co_jit = NULL;
+    co->co_jit_warmup = 0;
+    co->co_stats_calls = 0;
     return co;
 }
 
@@ -285,26 +291,281 @@ PyCode_New(int argcount, int kwonlyargcount,
                                      name, firstlineno, lnotab);
 }
 
+/* Exception table
+
+   In co_code, try blocks are pushed on the block stack of the frame by
+   SETUP_FINALLY, SETUP_WITH and SETUP_ASYNC_WITH and popped by POP_BLOCK,
+   so that every try and with statement costs a few instructions even
+   when nothing is raised.  When a code object is quickened, its try
+   blocks are instead computed once, by following the control flow of
+   co_code like the compiler does to compute co_stacksize: for every
+   instruction, the innermost try block containing it, and for every try
+   block, the stack level at which it is set up.  In co_quickened, the
+   block setup instructions are then replaced by NOP (BEFORE_WITH for
+   SETUP_WITH) and exception_unwind in ceval.c looks up the handler of
+   the failing instruction in the table.  The EXCEPT_HANDLER blocks pushed
+   when entering a handler stay on the block stack.
+
+   The analysis gives up (and the block stack is used as before) if the
+   bytecode does not have the shape generated by the compiler, which can
+   happen with code objects created by hand.
+*/
+
+#define UNVISITED (-2)
+
+typedef struct {
+    int depth;  /* Value stack depth before the instruction, or UNVISITED */
+    int block;  /* Innermost try block (index in the table), or -1 */
+} instr_state;
+
+static int
+get_oparg(const _Py_CODEUNIT *code, Py_ssize_t i)
+{
+    int oparg = _Py_OPARG(code[i]);
+    for (int shift = 8; i > 0 && shift <= 24; shift += 8) {
+        i--;
+        if (_Py_OPCODE(code[i]) != EXTENDED_ARG) {
+            break;
+        }
+        oparg |= _Py_OPARG(code[i]) << shift;
+    }
+    return oparg;
+}
+
+/* Record that instruction i is reached with the given state.  Return -1
+   if it was already reached with a different state. */
+static int
+visit(instr_state *states, Py_ssize_t n, Py_ssize_t *todo, Py_ssize_t *ntodo,
+      Py_ssize_t i, int depth, int block)
+{
+    if (i < 0 || i >= n || depth < 0) {
+        return -1;
+    }
+    if (states[i].depth == UNVISITED) {
+        states[i].depth = depth;
+        states[i].block = block;
+        todo[(*ntodo)++] = i;
+        return 0;
+    }
+    return (states[i].depth == depth && states[i].block == block) ? 0 : -1;
+}
+
+/* Compute the exception table of co.  Return -1 with an exception set on
+   memory error.  Set *ptable to NULL if there is nothing to do or if the
+   bytecode cannot be analyzed. */
+static int
+compute_exception_table(PyCodeObject *co, _PyExceptionTable **ptable)
+{
+    const _Py_CODEUNIT *code = (_Py_CODEUNIT *)PyBytes_AS_STRING(co->co_code);
+    Py_ssize_t n = PyBytes_GET_SIZE(co->co_code) / sizeof(_Py_CODEUNIT);
+    instr_state *states = NULL;
+    Py_ssize_t *todo = NULL, ntodo = 0;
+    _PyTryBlockInfo *blocks = NULL;
+    _PyExceptionTable *table;
+    int nsetup = 0, nblocks = 0, nranges = 0, prev;
+    int res = -1;
+
+    *ptable = NULL;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        int opcode = _Py_OPCODE(code[i]);
+        if (opcode == SETUP_FINALLY || opcode == SETUP_WITH ||
+            opcode == SETUP_ASYNC_WITH) {
+            nsetup++;
+        }
+    }
+    if (nsetup == 0) {
+        return 0;
+    }
+
+    states = PyMem_New(instr_state, n);
+    todo = PyMem_New(Py_ssize_t, n);
+    blocks = PyMem_New(_PyTryBlockInfo, nsetup);
+    if (states == NULL || todo == NULL || blocks == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (Py_ssize_t i = 0; i < n; i++) {
+        states[i].depth = UNVISITED;
+    }
+
+#define VISIT(i, depth, block) \
+    if (visit(states, n, todo, &ntodo, (i), (depth), (block)) < 0) { \
+        goto cannot_analyze; \
+    }
+
+    VISIT(0, 0, -1);
+    while (ntodo > 0) {
+        Py_ssize_t i = todo[--ntodo];
+        int depth = states[i].depth;
+        int block = states[i].block;
+        int opcode = _Py_OPCODE(code[i]);
+        int oparg = get_oparg(code, i);
+        int effect = PyCompile_OpcodeStackEffectWithJump(opcode, oparg, 0);
+        int jump_effect = PyCompile_OpcodeStackEffectWithJump(opcode, oparg, 1);
+        Py_ssize_t target = -1;
+
+        if (effect == PY_INVALID_STACK_EFFECT ||
+            jump_effect == PY_INVALID_STACK_EFFECT) {
+            goto cannot_analyze;
+        }
+        switch (opcode) {
+            case SETUP_FINALLY:
+            case SETUP_WITH:
+            case SETUP_ASYNC_WITH:
+                assert(nblocks < nsetup);
+                target = i + 1 + oparg / sizeof(_Py_CODEUNIT);
+                blocks[nblocks].handler = (int)(target * sizeof(_Py_CODEUNIT));
+                /* SETUP_ASYNC_WITH sets up the block below the result of
+                   __aenter__ */
+                blocks[nblocks].level =
+                    opcode == SETUP_ASYNC_WITH ? depth - 1 : depth;
+                blocks[nblocks].parent = block;
+                VISIT(target, depth + jump_effect, block);
+                VISIT(i + 1, depth + effect, nblocks);
+                nblocks++;
+                break;
+            case POP_BLOCK:
+                if (block < 0) {
+                    goto cannot_analyze;
+                }
+                VISIT(i + 1, depth, blocks[block].parent);
+                break;
+            case JUMP_ABSOLUTE:
+                VISIT(oparg / sizeof(_Py_CODEUNIT), depth + jump_effect, block);
+                break;
+            case JUMP_FORWARD:
+                VISIT(i + 1 + oparg / sizeof(_Py_CODEUNIT),
+                      depth + jump_effect, block);
+                break;
+            case POP_JUMP_IF_FALSE:
+            case POP_JUMP_IF_TRUE:
+            case JUMP_IF_FALSE_OR_POP:
+            case JUMP_IF_TRUE_OR_POP:
+            case JUMP_IF_NOT_EXC_MATCH:
+                VISIT(oparg / sizeof(_Py_CODEUNIT), depth + jump_effect, block);
+                VISIT(i + 1, depth + effect, block);
+                break;
+            case FOR_ITER:
+                VISIT(i + 1 + oparg / sizeof(_Py_CODEUNIT),
+                      depth + jump_effect, block);
+                VISIT(i + 1, depth + effect, block);
+                break;
+            case RETURN_VALUE:
+            case RAISE_VARARGS:
+            case RERAISE:
+                break;
+            default:
+                VISIT(i + 1, depth + effect, block);
+        }
+    }
+#undef VISIT
+
+    prev = -1;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        int block = states[i].depth == UNVISITED ? -1 : states[i].block;
+        if (block >= 0 && block != prev) {
+            nranges++;
+        }
+        prev = block;
+    }
+    table = PyMem_Malloc(sizeof(_PyExceptionTable) +
+                         nblocks * sizeof(_PyTryBlockInfo) +
+                         nranges * sizeof(_PyExceptionRange));
+    if (table == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    table->nblocks = nblocks;
+    table->nranges = nranges;
+    table->blocks = (_PyTryBlockInfo *)(table + 1);
+    table->ranges = (_PyExceptionRange *)(table->blocks + nblocks);
+    memcpy(table->blocks, blocks, nblocks * sizeof(_PyTryBlockInfo));
+    nranges = 0;
+    prev = -1;
+    for (Py_ssize_t i = 0; i < n; i++) {
+        int block = states[i].depth == UNVISITED ? -1 : states[i].block;
+        if (block != prev) {
+            if (prev >= 0) {
+                table->ranges[nranges - 1].end = (int)(i * sizeof(_Py_CODEUNIT));
+            }
+            if (block >= 0) {
+                table->ranges[nranges].start = (int)(i * sizeof(_Py_CODEUNIT));
+                table->ranges[nranges].block = block;
+                nranges++;
+            }
+        }
+        prev = block;
+    }
+    if (prev >= 0) {
+        table->ranges[nranges - 1].end = (int)(n * sizeof(_Py_CODEUNIT));
+    }
+    assert(nranges == table->nranges);
+    *ptable = table;
+    res = 0;
+    goto done;
+
+cannot_analyze:
+    /* *ptable is left to NULL: frames will use the block stack */
+    res = 0;
+done:
+    PyMem_Free(states);
+    PyMem_Free(todo);
+    PyMem_Free(blocks);
+    return res;
+}
+
+int
+_PyCode_FindTryBlock(PyCodeObject *co, int offset)
+{
+    _PyExceptionTable *table = co->co_exceptiontable;
+    int lo = 0, hi;
+
+    if (table == NULL) {
+        return -1;
+    }
+    hi = table->nranges;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        _PyExceptionRange *range = &table->ranges[mid];
+        if (offset < range->start) {
+            hi = mid;
+        }
+        else if (offset >= range->end) {
+            lo = mid + 1;
+        }
+        else {
+            return range->block;
+        }
+    }
+    return -1;
+}
+
 int
 _PyCode_InitOpcache(PyCodeObject *co)
 {
     Py_ssize_t co_size = PyBytes_Size(co->co_code) / sizeof(_Py_CODEUNIT);
-    co->co_opcache_map = (unsigned char *)PyMem_Calloc(co_size, 1);
+    // The map is indexed by (next_instr - first_instr), which ranges from
+    // 1 to co_size inclusive.
+    co->co_opcache_map = (unsigned char *)PyMem_Calloc(co_size + 1, 1);
     if (co->co_opcache_map == NULL) {
         return -1;
     }
 
     _Py_CODEUNIT *opcodes = (_Py_CODEUNIT*)PyBytes_AS_STRING(co->co_code);
     Py_ssize_t opts = 0;
+    Py_ssize_t nadaptive = 0;
 
     for (Py_ssize_t i = 0; i < co_size;) {
         unsigned char opcode = _Py_OPCODE(opcodes[i]);
         i++;  // 'i' is now aligned to (next_instr - first_instr)
 
-        // TODO: LOAD_METHOD, LOAD_ATTR
-        if (opcode == LOAD_GLOBAL) {
+        // TODO: LOAD_METHOD
+        if (opcode == LOAD_GLOBAL || _PyOpcode_Adaptive[opcode]) {
             opts++;
             co->co_opcache_map[i] = (unsigned char)opts;
+            if (_PyOpcode_Adaptive[opcode]) {
+                nadaptive++;
+            }
             if (opts > 254) {
                 break;
             }
@@ -325,7 +586,60 @@ _PyCode_InitOpcache(PyCodeObject *co)
     }
 
     co->co_opcache_size = (unsigned char)opts;
+
+    _PyExceptionTable *exceptiontable;
+    if (compute_exception_table(co, &exceptiontable) < 0) {
+        goto error;
+    }
+
+    /* Quicken: make a private copy of the bytecode in which every
+       instruction that got a cache entry and has specialized forms is
+       replaced by its adaptive form, in which frequent pairs of
+       instructions are fused, and in which try blocks are not set up when
+       there is an exception table. */
+    _Py_CODEUNIT *quickened = PyMem_Malloc(co_size * sizeof(_Py_CODEUNIT));
+    if (quickened == NULL) {
+        PyMem_Free(exceptiontable);
+        goto error;
+    }
+    memcpy(quickened, opcodes, co_size * sizeof(_Py_CODEUNIT));
+    Py_ssize_t nsuper = _Py_InsertSuperinstructions(quickened, co_size);
+    if (nadaptive || nsuper || exceptiontable != NULL) {
+        for (Py_ssize_t i = 0; i < co_size; i++) {
+            unsigned char opcode = _Py_OPCODE(opcodes[i]);
+            unsigned char adaptive = _PyOpcode_Adaptive[opcode];
+            if (adaptive && co->co_opcache_map != NULL &&
+                co->co_opcache_map[i + 1]) {
+                _Py_SET_OPCODE(quickened[i], adaptive);
+            }
+            else if (exceptiontable != NULL) {
+                switch (opcode) {
+                    case SETUP_FINALLY:
+                    case SETUP_ASYNC_WITH:
+                    case POP_BLOCK:
+                        _Py_SET_OPCODE(quickened[i], NOP);
+                        break;
+                    case SETUP_WITH:
+                        _Py_SET_OPCODE(quickened[i], BEFORE_WITH);
+                        break;
+                }
+            }
+        }
+        co->co_quickened = quickened;
+        co->co_exceptiontable = exceptiontable;
+    }
+    else {
+        PyMem_Free(quickened);
+    }
     return 0;
+
+error:
+    PyMem_FREE(co->co_opcache);
+    PyMem_FREE(co->co_opcache_map);
+    co->co_opcache_map = NULL;
+    co->co_opcache = NULL;
+    co->co_opcache_size = 0;
+    return -1;
 }
 
 PyCodeObject *
@@ -559,6 +873,15 @@ code_dealloc(PyCodeObject *co)
     if (co->co_opcache_map != NULL) {
         PyMem_FREE(co->co_opcache_map);
     }
+    if (co->co_quickened != NULL) {
+        PyMem_FREE(co->co_quickened);
+    }
+    if (co->co_exceptiontable != NULL) {
+        PyMem_FREE(co->co_exceptiontable);
+    }
+    if (co->co_jit != NULL) {
+        _PyJIT_Free(co);
+    }
     co->co_opcache_flag = 0;
     co->co_opcache_size = 0;
 
@@ -611,10 +934,24 @@ code_sizeof(PyCodeObject *co, PyObject *Py_UNUSED(args))
     if (co->co_opcache != NULL) {
         assert(co->co_opcache_map != NULL);
         // co_opcache_map
-        res += PyBytes_GET_SIZE(co->co_code) / sizeof(_Py_CODEUNIT);
+        res += PyBytes_GET_SIZE(co->co_code) / sizeof(_Py_CODEUNIT) + 1;
         // co_opcache
         res += co->co_opcache_size * sizeof(_PyOpcache);
     }
+    if (co->co_quickened != NULL) {
+        res += PyBytes_GET_SIZE(co->co_code);
+    }
+    if (co->co_exceptiontable != NULL) {
+        _PyExceptionTable *table = co->co_exceptiontable;
+        res += sizeof(_PyExceptionTable) +
+               table->nblocks * sizeof(_PyTryBlockInfo) +
+               table->nranges * sizeof(_PyExceptionRange);
+    }
+    for (struct _PyJITCode *jit = co->co_jit; jit; jit = jit->previous) {
+        res += sizeof(struct _PyJITCode) + jit->size +
+               PyBytes_GET_SIZE(co->co_code) / sizeof(_Py_CODEUNIT) *
+               sizeof(char *);
+    }
     return PyLong_FromSsize_t(res);
 }
 
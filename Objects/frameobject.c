@@ -2,6 +2,7 @@
 
 #include "Python.h"
 #include "pycore_object.h"
+#include "pycore_code.h"     // _PyCode_FindTryBlock()
 #include "pycore_gc.h"       // _PyObject_GC_IS_TRACKED()
 
 #include "code.h"
@@ -296,18 +297,33 @@ frame_stack_pop(PyFrameObject *f)
 }
 
 static void
-frame_block_unwind(PyFrameObject *f)
+frame_stack_unwind(PyFrameObject *f, int level)
 {
-    assert(f->f_iblock > 0);
-    f->f_iblock--;
-    PyTryBlock *b = &f->f_blockstack[f->f_iblock];
-    intptr_t delta = (f->f_stacktop - f->f_valuestack) - b->b_level;
+    intptr_t delta = (f->f_stacktop - f->f_valuestack) - level;
     while (delta > 0) {
         frame_stack_pop(f);
         delta--;
     }
 }
 
+/* Unwind the innermost try block.  It is on the block stack, unless the
+   frame runs co_quickened with an exception table: *try_block is then
+   its index in the table, and is updated to the enclosing try block. */
+static void
+frame_block_unwind(PyFrameObject *f, int *try_block)
+{
+    _PyExceptionTable *table = f->f_code->co_exceptiontable;
+    if (f->f_quickened && table != NULL) {
+        assert(*try_block >= 0);
+        frame_stack_unwind(f, table->blocks[*try_block].level);
+        *try_block = table->blocks[*try_block].parent;
+        return;
+    }
+    assert(f->f_iblock > 0);
+    f->f_iblock--;
+    frame_stack_unwind(f, f->f_blockstack[f->f_iblock].b_level);
+}
+
 
 /* Setter for f_lineno - you can set f_lineno from within a trace function in
  * order to jump to a given line of code, subject to some restrictions.  Most
@@ -453,6 +469,7 @@ frame_setlineno(PyFrameObject *f, PyObject* p_new_lineno, void *Py_UNUSED(ignore
     }
 
     /* Unwind block stack. */
+    int try_block = _PyCode_FindTryBlock(f->f_code, f->f_lasti);
     while (start_block_stack > best_block_stack) {
         Kind kind = top_block(start_block_stack);
         switch(kind) {
@@ -460,10 +477,10 @@ frame_setlineno(PyFrameObject *f, PyObject* p_new_lineno, void *Py_UNUSED(ignore
             frame_stack_pop(f);
             break;
         case Try:
-            frame_block_unwind(f);
+            frame_block_unwind(f, &try_block);
             break;
         case With:
-            frame_block_unwind(f);
+            frame_block_unwind(f, &try_block);
             // Pop the exit function
             frame_stack_pop(f);
             break;
@@ -561,6 +578,139 @@ static PyGetSetDef frame_getsetlist[] = {
 /* max value for numfree */
 #define PyFrame_MAXFREELIST 200
 
+/* The frames of function calls made by the interpreter don't come from
+   the zombie frames or the free list: they are carved out of a per-thread
+   frame stack.  It is a sequence of memory chunks; the current chunk of a
+   thread is tstate->frame_stack, and frames are pushed on it and popped
+   from it like activation records on the C stack.
+
+   Calls return in LIFO order, so the common case only moves the top of
+   the chunk.  But a frame object can outlive its call: a traceback, a
+   debugger or sys._getframe() may still hold a reference when the call
+   returns.  Such a frame stays where it is until it is deallocated, and
+   new frames are pushed above it.  Frames below it which die first leave
+   holes, which are reclaimed when the frame above them dies.  When the
+   current chunk is full, the thread moves to a new one; like a pymalloc
+   arena, a chunk is freed once it holds no frame and it is not the
+   current chunk of a thread.
+
+   Generator frames, and frames created by PyFrame_New(), have arbitrary
+   lifetimes and are not allocated from the frame stack. */
+
+#define FRAME_CHUNK_SIZE (32 * 1024)
+#define FRAME_STACK_ALIGN 16
+#define FRAME_STACK_ROUND(n) _Py_SIZE_ROUND_UP((n), FRAME_STACK_ALIGN)
+
+/* Header preceding the GC header of each frame in a chunk */
+typedef struct _frame_slot {
+    struct _frame_slot *prev;   /* slot pushed before this one, or NULL */
+    struct _PyFrameChunk *chunk;
+    int dead;                   /* whether the frame was deallocated */
+} frame_slot;
+
+struct _PyFrameChunk {
+    char *top;                  /* first free byte */
+    char *limit;                /* end of the chunk */
+    frame_slot *last;           /* slot on the top, or NULL if empty */
+    int current;                /* whether it is the current chunk
+                                   of a thread */
+};
+
+#define SLOT_HEADER_SIZE FRAME_STACK_ROUND(sizeof(frame_slot))
+#define CHUNK_HEADER_SIZE FRAME_STACK_ROUND(sizeof(struct _PyFrameChunk))
+
+#define SLOT_TO_FRAME(slot) \
+    ((PyFrameObject *)((char *)(slot) + SLOT_HEADER_SIZE + sizeof(PyGC_Head)))
+#define FRAME_TO_SLOT(f) \
+    ((frame_slot *)((char *)(f) - sizeof(PyGC_Head) - SLOT_HEADER_SIZE))
+
+static struct _PyFrameChunk *
+frame_chunk_new(size_t size)
+{
+    if (size < FRAME_CHUNK_SIZE - CHUNK_HEADER_SIZE) {
+        size = FRAME_CHUNK_SIZE - CHUNK_HEADER_SIZE;
+    }
+    struct _PyFrameChunk *chunk = PyMem_RawMalloc(CHUNK_HEADER_SIZE + size);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    chunk->top = (char *)chunk + CHUNK_HEADER_SIZE;
+    chunk->limit = chunk->top + size;
+    chunk->last = NULL;
+    chunk->current = 1;
+    return chunk;
+}
+
+/* Allocate an untracked frame with room for extras pointers in
+   f_localsplus from the frame stack of tstate. */
+static PyFrameObject *
+frame_stack_alloc(PyThreadState *tstate, Py_ssize_t extras)
+{
+    size_t size = FRAME_STACK_ROUND(SLOT_HEADER_SIZE + sizeof(PyGC_Head)
+                                    + _PyObject_VAR_SIZE(&PyFrame_Type,
+                                                         extras));
+    struct _PyFrameChunk *chunk = tstate->frame_stack;
+    if (chunk == NULL || (size_t)(chunk->limit - chunk->top) < size) {
+        struct _PyFrameChunk *new_chunk = frame_chunk_new(size);
+        if (new_chunk == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        if (chunk != NULL) {
+            chunk->current = 0;
+            if (chunk->last == NULL) {
+                PyMem_RawFree(chunk);
+            }
+        }
+        tstate->frame_stack = chunk = new_chunk;
+    }
+
+    frame_slot *slot = (frame_slot *)chunk->top;
+    slot->prev = chunk->last;
+    slot->chunk = chunk;
+    slot->dead = 0;
+    chunk->last = slot;
+    chunk->top += size;
+
+    PyFrameObject *f = SLOT_TO_FRAME(slot);
+    PyGC_Head *gc = _Py_AS_GC(f);
+    gc->_gc_next = 0;
+    gc->_gc_prev = 0;
+    (void)PyObject_INIT_VAR(f, &PyFrame_Type, extras);
+    return f;
+}
+
+static void
+frame_stack_free(PyFrameObject *f)
+{
+    frame_slot *slot = FRAME_TO_SLOT(f);
+    struct _PyFrameChunk *chunk = slot->chunk;
+    slot->dead = 1;
+    /* Pop the frame, and the holes left below it */
+    while (chunk->last != NULL && chunk->last->dead) {
+        chunk->top = (char *)chunk->last;
+        chunk->last = chunk->last->prev;
+    }
+    if (chunk->last == NULL && !chunk->current) {
+        PyMem_RawFree(chunk);
+    }
+}
+
+void
+_PyFrame_ClearStack(PyThreadState *tstate, int keep_empty)
+{
+    struct _PyFrameChunk *chunk = tstate->frame_stack;
+    if (chunk == NULL || (keep_empty && chunk->last == NULL)) {
+        return;
+    }
+    tstate->frame_stack = NULL;
+    /* Frames which outlived their call may be deallocated later */
+    chunk->current = 0;
+    if (chunk->last == NULL) {
+        PyMem_RawFree(chunk);
+    }
+}
+
 static void _Py_HOT_FUNCTION
 frame_dealloc(PyFrameObject *f)
 {
@@ -589,7 +739,10 @@ frame_dealloc(PyFrameObject *f)
     Py_CLEAR(f->f_trace);
 
     PyCodeObject *co = f->f_code;
-    if (co->co_zombieframe == NULL) {
+    if (f->f_stackalloc) {
+        frame_stack_free(f);
+    }
+    else if (co->co_zombieframe == NULL) {
         co->co_zombieframe = f;
     }
     else {
@@ -769,24 +922,32 @@ PyTypeObject PyFrame_Type = {
 _Py_IDENTIFIER(__builtins__);
 
 static inline PyFrameObject*
-frame_alloc(PyCodeObject *code)
+frame_alloc(PyThreadState *tstate, PyCodeObject *code, int on_stack)
 {
     PyFrameObject *f;
 
-    f = code->co_zombieframe;
-    if (f != NULL) {
-        code->co_zombieframe = NULL;
-        _Py_NewReference((PyObject *)f);
-        assert(f->f_code == code);
-        return f;
+    if (!on_stack) {
+        f = code->co_zombieframe;
+        if (f != NULL) {
+            code->co_zombieframe = NULL;
+            _Py_NewReference((PyObject *)f);
+            assert(f->f_code == code);
+            assert(!f->f_stackalloc);
+            return f;
+        }
     }
 
     Py_ssize_t ncells = PyTuple_GET_SIZE(code->co_cellvars);
     Py_ssize_t nfrees = PyTuple_GET_SIZE(code->co_freevars);
     Py_ssize_t extras = code->co_stacksize + code->co_nlocals + ncells + nfrees;
-    PyInterpreterState *interp = _PyInterpreterState_GET();
-    struct _Py_frame_state *state = &interp->frame;
-    if (state->free_list == NULL)
+    struct _Py_frame_state *state = &tstate->interp->frame;
+    if (on_stack) {
+        f = frame_stack_alloc(tstate, extras);
+        if (f == NULL) {
+            return NULL;
+        }
+    }
+    else if (state->free_list == NULL)
     {
         f = PyObject_GC_NewVar(PyFrameObject, &PyFrame_Type, extras);
         if (f == NULL) {
@@ -814,6 +975,7 @@ frame_alloc(PyCodeObject *code)
     }
 
     f->f_code = code;
+    f->f_stackalloc = (char)on_stack;
     extras = code->co_nlocals + ncells + nfrees;
     f->f_valuestack = f->f_localsplus + extras;
     for (Py_ssize_t i=0; i<extras; i++) {
@@ -867,9 +1029,9 @@ frame_get_builtins(PyFrameObject *back, PyObject *globals)
 }
 
 
-PyFrameObject* _Py_HOT_FUNCTION
-_PyFrame_New_NoTrack(PyThreadState *tstate, PyCodeObject *code,
-                     PyObject *globals, PyObject *locals)
+static inline PyFrameObject*
+frame_new(PyThreadState *tstate, PyCodeObject *code,
+          PyObject *globals, PyObject *locals, int on_stack)
 {
 #ifdef Py_DEBUG
     if (code == NULL || globals == NULL || !PyDict_Check(globals) ||
@@ -885,7 +1047,7 @@ _PyFrame_New_NoTrack(PyThreadState *tstate, PyCodeObject *code,
         return NULL;
     }
 
-    PyFrameObject *f = frame_alloc(code);
+    PyFrameObject *f = frame_alloc(tstate, code, on_stack);
     if (f == NULL) {
         Py_DECREF(builtins);
         return NULL;
@@ -921,6 +1083,7 @@ _PyFrame_New_NoTrack(PyThreadState *tstate, PyCodeObject *code,
     f->f_lineno = code->co_firstlineno;
     f->f_iblock = 0;
     f->f_executing = 0;
+    f->f_quickened = 0;
     f->f_gen = NULL;
     f->f_trace_opcodes = 0;
     f->f_trace_lines = 1;
@@ -930,6 +1093,20 @@ _PyFrame_New_NoTrack(PyThreadState *tstate, PyCodeObject *code,
     return f;
 }
 
+PyFrameObject* _Py_HOT_FUNCTION
+_PyFrame_New_NoTrack(PyThreadState *tstate, PyCodeObject *code,
+                     PyObject *globals, PyObject *locals)
+{
+    return frame_new(tstate, code, globals, locals, 0);
+}
+
+PyFrameObject* _Py_HOT_FUNCTION
+_PyFrame_NewOnStack_NoTrack(PyThreadState *tstate, PyCodeObject *code,
+                            PyObject *globals, PyObject *locals)
+{
+    return frame_new(tstate, code, globals, locals, 1);
+}
+
 PyFrameObject*
 PyFrame_New(PyThreadState *tstate, PyCodeObject *code,
             PyObject *globals, PyObject *locals)
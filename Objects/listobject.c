@@ -2,6 +2,7 @@
 
 #include "Python.h"
 #include "pycore_abstract.h"   // _PyIndex_Check()
+#include "pycore_list.h"       // _PyListIterObject
 #include "pycore_object.h"
 #include "pycore_tupleobject.h"
 #include "pycore_accu.h"
@@ -3071,11 +3072,7 @@ PyTypeObject PyList_Type = {
 
 /*********************** List Iterator **************************/
 
-typedef struct {
-    PyObject_HEAD
-    Py_ssize_t it_index;
-    PyListObject *it_seq; /* Set to NULL when iterator is exhausted */
-} listiterobject;
+typedef _PyListIterObject listiterobject;
 
 static void listiter_dealloc(listiterobject *);
 static int listiter_traverse(listiterobject *, visitproc, void *);
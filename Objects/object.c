@@ -1940,6 +1940,7 @@ _PyObject_DebugTypeStats(FILE *out)
     _PyFrame_DebugMallocStats(out);
     _PyList_DebugMallocStats(out);
     _PyTuple_DebugMallocStats(out);
+    _PyThreadState_DebugMallocStats(out);
 }
 
 /* These methods are used to control infinite recursion in repr, str, print,
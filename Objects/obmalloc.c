@@ -1,5 +1,7 @@
 #include "Python.h"
+#include "pycore_interp.h"        // PyInterpreterState.obmalloc
 #include "pycore_pymem.h"         // _PyTraceMalloc_Config
+#include "pycore_pystate.h"       // _PyThreadState_GET()
 
 #include <stdbool.h>
 
@@ -1098,36 +1100,10 @@ on that C doesn't insert any padding anywhere in a pool_header at or before
 the prevpool member.
 **************************************************************************** */
 
-#define PTA(x)  ((poolp )((uint8_t *)&(usedpools[2*(x)]) - 2*sizeof(block *)))
+#define PTA(x)  ((poolp )((uint8_t *)&(main_state.usedpools[2*(x)]) - 2*sizeof(block *)))
 #define PT(x)   PTA(x), PTA(x)
 
-static poolp usedpools[2 * ((NB_SMALL_SIZE_CLASSES + 7) / 8) * 8] = {
-    PT(0), PT(1), PT(2), PT(3), PT(4), PT(5), PT(6), PT(7)
-#if NB_SMALL_SIZE_CLASSES > 8
-    , PT(8), PT(9), PT(10), PT(11), PT(12), PT(13), PT(14), PT(15)
-#if NB_SMALL_SIZE_CLASSES > 16
-    , PT(16), PT(17), PT(18), PT(19), PT(20), PT(21), PT(22), PT(23)
-#if NB_SMALL_SIZE_CLASSES > 24
-    , PT(24), PT(25), PT(26), PT(27), PT(28), PT(29), PT(30), PT(31)
-#if NB_SMALL_SIZE_CLASSES > 32
-    , PT(32), PT(33), PT(34), PT(35), PT(36), PT(37), PT(38), PT(39)
-#if NB_SMALL_SIZE_CLASSES > 40
-    , PT(40), PT(41), PT(42), PT(43), PT(44), PT(45), PT(46), PT(47)
-#if NB_SMALL_SIZE_CLASSES > 48
-    , PT(48), PT(49), PT(50), PT(51), PT(52), PT(53), PT(54), PT(55)
-#if NB_SMALL_SIZE_CLASSES > 56
-    , PT(56), PT(57), PT(58), PT(59), PT(60), PT(61), PT(62), PT(63)
-#if NB_SMALL_SIZE_CLASSES > 64
-#error "NB_SMALL_SIZE_CLASSES should be less than 64"
-#endif /* NB_SMALL_SIZE_CLASSES > 64 */
-#endif /* NB_SMALL_SIZE_CLASSES > 56 */
-#endif /* NB_SMALL_SIZE_CLASSES > 48 */
-#endif /* NB_SMALL_SIZE_CLASSES > 40 */
-#endif /* NB_SMALL_SIZE_CLASSES > 32 */
-#endif /* NB_SMALL_SIZE_CLASSES > 24 */
-#endif /* NB_SMALL_SIZE_CLASSES > 16 */
-#endif /* NB_SMALL_SIZE_CLASSES >  8 */
-};
+#define NB_USEDPOOLS (2 * ((NB_SMALL_SIZE_CLASSES + 7) / 8) * 8)
 
 /*==========================================================================
 Arena management.
@@ -1176,56 +1152,123 @@ with nfp free pools.  This is NULL if and only if there is no arena with
 nfp free pools in usable_arenas.
 */
 
-/* Array of objects used to track chunks of memory (arenas). */
-static struct arena_object* arenas = NULL;
-/* Number of slots currently allocated in the `arenas` vector. */
-static uint maxarenas = 0;
-
-/* The head of the singly-linked, NULL-terminated list of available
- * arena_objects.
- */
-static struct arena_object* unused_arena_objects = NULL;
-
-/* The head of the doubly-linked, NULL-terminated at each end, list of
- * arena_objects associated with arenas that have pools available.
- */
-static struct arena_object* usable_arenas = NULL;
-
-/* nfp2lasta[nfp] is the last arena in usable_arenas with nfp free pools */
-static struct arena_object* nfp2lasta[MAX_POOLS_IN_ARENA + 1] = { NULL };
-
 /* How many arena_objects do we initially allocate?
  * 16 = can allocate 16 arenas = 16 * ARENA_SIZE = 4MB before growing the
  * `arenas` vector.
  */
 #define INITIAL_ARENA_OBJECTS 16
 
-/* Number of arenas allocated that haven't been free()'d. */
-static size_t narenas_currently_allocated = 0;
+/* The state of the allocator: its pools and arenas.
+
+   Each interpreter allocates from its own state (interp->obmalloc), so that
+   the arenas of a subinterpreter are private and can be released in one step
+   when it is deleted, see _PyObject_FiniState().  The main interpreter uses
+   main_state, which is also used when there is no current thread state.
+
+   A block may be freed by another interpreter than the one which allocated
+   it: pymalloc_free() looks for the state owning the block in the list of
+   all states.  The GIL protects every state. */
+struct _obmalloc_state {
+    poolp usedpools[NB_USEDPOOLS];
+
+    /* Array of objects used to track chunks of memory (arenas). */
+    struct arena_object* arenas;
+    /* Number of slots currently allocated in the `arenas` vector. */
+    uint maxarenas;
+
+    /* The head of the singly-linked, NULL-terminated list of available
+     * arena_objects.
+     */
+    struct arena_object* unused_arena_objects;
+
+    /* The head of the doubly-linked, NULL-terminated at each end, list of
+     * arena_objects associated with arenas that have pools available.
+     */
+    struct arena_object* usable_arenas;
+
+    /* nfp2lasta[nfp] is the last arena in usable_arenas with nfp free pools */
+    struct arena_object* nfp2lasta[MAX_POOLS_IN_ARENA + 1];
+
+    /* Number of arenas allocated that haven't been free()'d. */
+    size_t narenas_currently_allocated;
+
+    /* Total number of times malloc() called to allocate an arena. */
+    size_t ntimes_arena_allocated;
+    /* High water mark (max value ever seen) for narenas_currently_allocated. */
+    size_t narenas_highwater;
+
+    /* Set if the interpreter was deleted while other interpreters still
+       used blocks of its arenas: the state is released with its last
+       arena. */
+    int orphaned;
+
+    /* Next state in the list of all states */
+    struct _obmalloc_state *next;
+};
+
+static struct _obmalloc_state main_state = {
+    .usedpools = {
+        PT(0), PT(1), PT(2), PT(3), PT(4), PT(5), PT(6), PT(7)
+#if NB_SMALL_SIZE_CLASSES > 8
+        , PT(8), PT(9), PT(10), PT(11), PT(12), PT(13), PT(14), PT(15)
+#if NB_SMALL_SIZE_CLASSES > 16
+        , PT(16), PT(17), PT(18), PT(19), PT(20), PT(21), PT(22), PT(23)
+#if NB_SMALL_SIZE_CLASSES > 24
+        , PT(24), PT(25), PT(26), PT(27), PT(28), PT(29), PT(30), PT(31)
+#if NB_SMALL_SIZE_CLASSES > 32
+        , PT(32), PT(33), PT(34), PT(35), PT(36), PT(37), PT(38), PT(39)
+#if NB_SMALL_SIZE_CLASSES > 40
+        , PT(40), PT(41), PT(42), PT(43), PT(44), PT(45), PT(46), PT(47)
+#if NB_SMALL_SIZE_CLASSES > 48
+        , PT(48), PT(49), PT(50), PT(51), PT(52), PT(53), PT(54), PT(55)
+#if NB_SMALL_SIZE_CLASSES > 56
+        , PT(56), PT(57), PT(58), PT(59), PT(60), PT(61), PT(62), PT(63)
+#if NB_SMALL_SIZE_CLASSES > 64
+#error "NB_SMALL_SIZE_CLASSES should be less than 64"
+#endif /* NB_SMALL_SIZE_CLASSES > 64 */
+#endif /* NB_SMALL_SIZE_CLASSES > 56 */
+#endif /* NB_SMALL_SIZE_CLASSES > 48 */
+#endif /* NB_SMALL_SIZE_CLASSES > 40 */
+#endif /* NB_SMALL_SIZE_CLASSES > 32 */
+#endif /* NB_SMALL_SIZE_CLASSES > 24 */
+#endif /* NB_SMALL_SIZE_CLASSES > 16 */
+#endif /* NB_SMALL_SIZE_CLASSES >  8 */
+    },
+};
 
-/* Total number of times malloc() called to allocate an arena. */
-static size_t ntimes_arena_allocated = 0;
-/* High water mark (max value ever seen) for narenas_currently_allocated. */
-static size_t narenas_highwater = 0;
+/* List of all states, see find_state() */
+static struct _obmalloc_state *obmalloc_states = &main_state;
+
+static inline struct _obmalloc_state *
+get_state(void)
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    if (tstate == NULL) {
+        return &main_state;
+    }
+    assert(tstate->interp->obmalloc != NULL);
+    return tstate->interp->obmalloc;
+}
 
 static Py_ssize_t raw_allocated_blocks;
 
-Py_ssize_t
-_Py_GetAllocatedBlocks(void)
+/* Number of blocks allocated in the arenas of state */
+static Py_ssize_t
+state_allocated_blocks(struct _obmalloc_state *state)
 {
-    Py_ssize_t n = raw_allocated_blocks;
+    Py_ssize_t n = 0;
     /* add up allocated blocks for used pools */
-    for (uint i = 0; i < maxarenas; ++i) {
+    for (uint i = 0; i < state->maxarenas; ++i) {
         /* Skip arenas which are not allocated. */
-        if (arenas[i].address == 0) {
+        if (state->arenas[i].address == 0) {
             continue;
         }
 
-        uintptr_t base = (uintptr_t)_Py_ALIGN_UP(arenas[i].address, POOL_SIZE);
+        uintptr_t base = (uintptr_t)_Py_ALIGN_UP(state->arenas[i].address, POOL_SIZE);
 
         /* visit every pool in the arena */
-        assert(base <= (uintptr_t) arenas[i].pool_address);
-        for (; base < (uintptr_t) arenas[i].pool_address; base += POOL_SIZE) {
+        assert(base <= (uintptr_t) state->arenas[i].pool_address);
+        for (; base < (uintptr_t) state->arenas[i].pool_address; base += POOL_SIZE) {
             poolp p = (poolp)base;
             n += p->ref.count;
         }
@@ -1233,6 +1276,17 @@ _Py_GetAllocatedBlocks(void)
     return n;
 }
 
+Py_ssize_t
+_Py_GetAllocatedBlocks(void)
+{
+    Py_ssize_t n = raw_allocated_blocks;
+    for (struct _obmalloc_state *state = obmalloc_states; state != NULL;
+         state = state->next) {
+        n += state_allocated_blocks(state);
+    }
+    return n;
+}
+
 
 /* Allocate a new arena.  If we run out of memory, return NULL.  Else
  * allocate a new arena, and return the address of an arena_object
@@ -1240,7 +1294,7 @@ _Py_GetAllocatedBlocks(void)
  * `usable_arenas` to the return value.
  */
 static struct arena_object*
-new_arena(void)
+new_arena(struct _obmalloc_state *state)
 {
     struct arena_object* arenaobj;
     uint excess;        /* number of bytes above pool alignment */
@@ -1254,7 +1308,7 @@ new_arena(void)
     if (debug_stats)
         _PyObject_DebugMallocStats(stderr);
 
-    if (unused_arena_objects == NULL) {
+    if (state->unused_arena_objects == NULL) {
         uint i;
         uint numarenas;
         size_t nbytes;
@@ -1262,18 +1316,18 @@ new_arena(void)
         /* Double the number of arena objects on each allocation.
          * Note that it's possible for `numarenas` to overflow.
          */
-        numarenas = maxarenas ? maxarenas << 1 : INITIAL_ARENA_OBJECTS;
-        if (numarenas <= maxarenas)
+        numarenas = state->maxarenas ? state->maxarenas << 1 : INITIAL_ARENA_OBJECTS;
+        if (numarenas <= state->maxarenas)
             return NULL;                /* overflow */
 #if SIZEOF_SIZE_T <= SIZEOF_INT
-        if (numarenas > SIZE_MAX / sizeof(*arenas))
+        if (numarenas > SIZE_MAX / sizeof(*state->arenas))
             return NULL;                /* overflow */
 #endif
-        nbytes = numarenas * sizeof(*arenas);
-        arenaobj = (struct arena_object *)PyMem_RawRealloc(arenas, nbytes);
+        nbytes = numarenas * sizeof(*state->arenas);
+        arenaobj = (struct arena_object *)PyMem_RawRealloc(state->arenas, nbytes);
         if (arenaobj == NULL)
             return NULL;
-        arenas = arenaobj;
+        state->arenas = arenaobj;
 
         /* We might need to fix pointers that were copied.  However,
          * new_arena only gets called when all the pages in the
@@ -1281,41 +1335,41 @@ new_arena(void)
          * into the old array. Thus, we don't have to worry about
          * invalid pointers.  Just to be sure, some asserts:
          */
-        assert(usable_arenas == NULL);
-        assert(unused_arena_objects == NULL);
+        assert(state->usable_arenas == NULL);
+        assert(state->unused_arena_objects == NULL);
 
         /* Put the new arenas on the unused_arena_objects list. */
-        for (i = maxarenas; i < numarenas; ++i) {
-            arenas[i].address = 0;              /* mark as unassociated */
-            arenas[i].nextarena = i < numarenas - 1 ?
-                                   &arenas[i+1] : NULL;
+        for (i = state->maxarenas; i < numarenas; ++i) {
+            state->arenas[i].address = 0;              /* mark as unassociated */
+            state->arenas[i].nextarena = i < numarenas - 1 ?
+                                   &state->arenas[i+1] : NULL;
         }
 
         /* Update globals. */
-        unused_arena_objects = &arenas[maxarenas];
-        maxarenas = numarenas;
+        state->unused_arena_objects = &state->arenas[state->maxarenas];
+        state->maxarenas = numarenas;
     }
 
     /* Take the next available arena object off the head of the list. */
-    assert(unused_arena_objects != NULL);
-    arenaobj = unused_arena_objects;
-    unused_arena_objects = arenaobj->nextarena;
+    assert(state->unused_arena_objects != NULL);
+    arenaobj = state->unused_arena_objects;
+    state->unused_arena_objects = arenaobj->nextarena;
     assert(arenaobj->address == 0);
     address = _PyObject_Arena.alloc(_PyObject_Arena.ctx, ARENA_SIZE);
     if (address == NULL) {
         /* The allocation failed: return NULL after putting the
          * arenaobj back.
          */
-        arenaobj->nextarena = unused_arena_objects;
-        unused_arena_objects = arenaobj;
+        arenaobj->nextarena = state->unused_arena_objects;
+        state->unused_arena_objects = arenaobj;
         return NULL;
     }
     arenaobj->address = (uintptr_t)address;
 
-    ++narenas_currently_allocated;
-    ++ntimes_arena_allocated;
-    if (narenas_currently_allocated > narenas_highwater)
-        narenas_highwater = narenas_currently_allocated;
+    ++state->narenas_currently_allocated;
+    ++state->ntimes_arena_allocated;
+    if (state->narenas_currently_allocated > state->narenas_highwater)
+        state->narenas_highwater = state->narenas_currently_allocated;
     arenaobj->freepools = NULL;
     /* pool_address <- first pool-aligned address in the arena
        nfreepools <- number of whole pools that fit after alignment */
@@ -1410,7 +1464,7 @@ extremely desirable that it be this fast.
 static bool _Py_NO_SANITIZE_ADDRESS
             _Py_NO_SANITIZE_THREAD
             _Py_NO_SANITIZE_MEMORY
-address_in_range(void *p, poolp pool)
+address_in_range(struct _obmalloc_state *state, void *p, poolp pool)
 {
     // Since address_in_range may be reading from memory which was not allocated
     // by Python, it is important that pool->arenaindex is read only once, as
@@ -1418,9 +1472,28 @@ address_in_range(void *p, poolp pool)
     // the GIL. The following dance forces the compiler to read pool->arenaindex
     // only once.
     uint arenaindex = *((volatile uint *)&pool->arenaindex);
-    return arenaindex < maxarenas &&
-        (uintptr_t)p - arenas[arenaindex].address < ARENA_SIZE &&
-        arenas[arenaindex].address != 0;
+    return arenaindex < state->maxarenas &&
+        (uintptr_t)p - state->arenas[arenaindex].address < ARENA_SIZE &&
+        state->arenas[arenaindex].address != 0;
+}
+
+/* Return the state whose arenas contain P, or NULL if P was not allocated by
+   pymalloc.  The state of the current interpreter is checked first: blocks
+   are usually freed by the interpreter which allocated them. */
+static inline struct _obmalloc_state *
+find_state(void *p, poolp pool)
+{
+    struct _obmalloc_state *state = get_state();
+    if (LIKELY(address_in_range(state, p, pool))) {
+        return state;
+    }
+    for (struct _obmalloc_state *other = obmalloc_states; other != NULL;
+         other = other->next) {
+        if (other != state && address_in_range(other, p, pool)) {
+            return other;
+        }
+    }
+    return NULL;
 }
 
 
@@ -1451,60 +1524,60 @@ pymalloc_pool_extend(poolp pool, uint size)
  * This function takes new pool and allocate a block from it.
  */
 static void*
-allocate_from_new_pool(uint size)
+allocate_from_new_pool(struct _obmalloc_state *state, uint size)
 {
     /* There isn't a pool of the right size class immediately
      * available:  use a free pool.
      */
-    if (UNLIKELY(usable_arenas == NULL)) {
+    if (UNLIKELY(state->usable_arenas == NULL)) {
         /* No arena has a free pool:  allocate a new arena. */
 #ifdef WITH_MEMORY_LIMITS
-        if (narenas_currently_allocated >= MAX_ARENAS) {
+        if (state->narenas_currently_allocated >= MAX_ARENAS) {
             return NULL;
         }
 #endif
-        usable_arenas = new_arena();
-        if (usable_arenas == NULL) {
+        state->usable_arenas = new_arena(state);
+        if (state->usable_arenas == NULL) {
             return NULL;
         }
-        usable_arenas->nextarena = usable_arenas->prevarena = NULL;
-        assert(nfp2lasta[usable_arenas->nfreepools] == NULL);
-        nfp2lasta[usable_arenas->nfreepools] = usable_arenas;
+        state->usable_arenas->nextarena = state->usable_arenas->prevarena = NULL;
+        assert(state->nfp2lasta[state->usable_arenas->nfreepools] == NULL);
+        state->nfp2lasta[state->usable_arenas->nfreepools] = state->usable_arenas;
     }
-    assert(usable_arenas->address != 0);
+    assert(state->usable_arenas->address != 0);
 
     /* This arena already had the smallest nfreepools value, so decreasing
      * nfreepools doesn't change that, and we don't need to rearrange the
      * usable_arenas list.  However, if the arena becomes wholly allocated,
      * we need to remove its arena_object from usable_arenas.
      */
-    assert(usable_arenas->nfreepools > 0);
-    if (nfp2lasta[usable_arenas->nfreepools] == usable_arenas) {
+    assert(state->usable_arenas->nfreepools > 0);
+    if (state->nfp2lasta[state->usable_arenas->nfreepools] == state->usable_arenas) {
         /* It's the last of this size, so there won't be any. */
-        nfp2lasta[usable_arenas->nfreepools] = NULL;
+        state->nfp2lasta[state->usable_arenas->nfreepools] = NULL;
     }
     /* If any free pools will remain, it will be the new smallest. */
-    if (usable_arenas->nfreepools > 1) {
-        assert(nfp2lasta[usable_arenas->nfreepools - 1] == NULL);
-        nfp2lasta[usable_arenas->nfreepools - 1] = usable_arenas;
+    if (state->usable_arenas->nfreepools > 1) {
+        assert(state->nfp2lasta[state->usable_arenas->nfreepools - 1] == NULL);
+        state->nfp2lasta[state->usable_arenas->nfreepools - 1] = state->usable_arenas;
     }
 
     /* Try to get a cached free pool. */
-    poolp pool = usable_arenas->freepools;
+    poolp pool = state->usable_arenas->freepools;
     if (LIKELY(pool != NULL)) {
         /* Unlink from cached pools. */
-        usable_arenas->freepools = pool->nextpool;
-        usable_arenas->nfreepools--;
-        if (UNLIKELY(usable_arenas->nfreepools == 0)) {
+        state->usable_arenas->freepools = pool->nextpool;
+        state->usable_arenas->nfreepools--;
+        if (UNLIKELY(state->usable_arenas->nfreepools == 0)) {
             /* Wholly allocated:  remove. */
-            assert(usable_arenas->freepools == NULL);
-            assert(usable_arenas->nextarena == NULL ||
-                   usable_arenas->nextarena->prevarena ==
-                   usable_arenas);
-            usable_arenas = usable_arenas->nextarena;
-            if (usable_arenas != NULL) {
-                usable_arenas->prevarena = NULL;
-                assert(usable_arenas->address != 0);
+            assert(state->usable_arenas->freepools == NULL);
+            assert(state->usable_arenas->nextarena == NULL ||
+                   state->usable_arenas->nextarena->prevarena ==
+                   state->usable_arenas);
+            state->usable_arenas = state->usable_arenas->nextarena;
+            if (state->usable_arenas != NULL) {
+                state->usable_arenas->prevarena = NULL;
+                assert(state->usable_arenas->address != 0);
             }
         }
         else {
@@ -1513,41 +1586,41 @@ allocate_from_new_pool(uint size)
              * off all the arena's pools for the first
              * time.
              */
-            assert(usable_arenas->freepools != NULL ||
-                   usable_arenas->pool_address <=
-                   (block*)usable_arenas->address +
+            assert(state->usable_arenas->freepools != NULL ||
+                   state->usable_arenas->pool_address <=
+                   (block*)state->usable_arenas->address +
                        ARENA_SIZE - POOL_SIZE);
         }
     }
     else {
         /* Carve off a new pool. */
-        assert(usable_arenas->nfreepools > 0);
-        assert(usable_arenas->freepools == NULL);
-        pool = (poolp)usable_arenas->pool_address;
-        assert((block*)pool <= (block*)usable_arenas->address +
+        assert(state->usable_arenas->nfreepools > 0);
+        assert(state->usable_arenas->freepools == NULL);
+        pool = (poolp)state->usable_arenas->pool_address;
+        assert((block*)pool <= (block*)state->usable_arenas->address +
                                  ARENA_SIZE - POOL_SIZE);
-        pool->arenaindex = (uint)(usable_arenas - arenas);
-        assert(&arenas[pool->arenaindex] == usable_arenas);
+        pool->arenaindex = (uint)(state->usable_arenas - state->arenas);
+        assert(&state->arenas[pool->arenaindex] == state->usable_arenas);
         pool->szidx = DUMMY_SIZE_IDX;
-        usable_arenas->pool_address += POOL_SIZE;
-        --usable_arenas->nfreepools;
+        state->usable_arenas->pool_address += POOL_SIZE;
+        --state->usable_arenas->nfreepools;
 
-        if (usable_arenas->nfreepools == 0) {
-            assert(usable_arenas->nextarena == NULL ||
-                   usable_arenas->nextarena->prevarena ==
-                   usable_arenas);
+        if (state->usable_arenas->nfreepools == 0) {
+            assert(state->usable_arenas->nextarena == NULL ||
+                   state->usable_arenas->nextarena->prevarena ==
+                   state->usable_arenas);
             /* Unlink the arena:  it is completely allocated. */
-            usable_arenas = usable_arenas->nextarena;
-            if (usable_arenas != NULL) {
-                usable_arenas->prevarena = NULL;
-                assert(usable_arenas->address != 0);
+            state->usable_arenas = state->usable_arenas->nextarena;
+            if (state->usable_arenas != NULL) {
+                state->usable_arenas->prevarena = NULL;
+                assert(state->usable_arenas->address != 0);
             }
         }
     }
 
     /* Frontlink to used pools. */
     block *bp;
-    poolp next = usedpools[size + size]; /* == prev */
+    poolp next = state->usedpools[size + size]; /* == prev */
     pool->nextpool = next;
     pool->prevpool = next;
     next->nextpool = pool;
@@ -1587,7 +1660,7 @@ allocate_from_new_pool(uint size)
    or when the max memory limit has been reached.
 */
 static inline void*
-pymalloc_alloc(void *ctx, size_t nbytes)
+pymalloc_alloc(struct _obmalloc_state *state, void *ctx, size_t nbytes)
 {
 #ifdef WITH_VALGRIND
     if (UNLIKELY(running_on_valgrind == -1)) {
@@ -1606,7 +1679,7 @@ pymalloc_alloc(void *ctx, size_t nbytes)
     }
 
     uint size = (uint)(nbytes - 1) >> ALIGNMENT_SHIFT;
-    poolp pool = usedpools[size + size];
+    poolp pool = state->usedpools[size + size];
     block *bp;
 
     if (LIKELY(pool != pool->nextpool)) {
@@ -1627,7 +1700,7 @@ pymalloc_alloc(void *ctx, size_t nbytes)
         /* There isn't a pool of the right size class immediately
          * available:  use a free pool.
          */
-        bp = allocate_from_new_pool(size);
+        bp = allocate_from_new_pool(state, size);
     }
 
     return (void *)bp;
@@ -1637,7 +1710,7 @@ pymalloc_alloc(void *ctx, size_t nbytes)
 static void *
 _PyObject_Malloc(void *ctx, size_t nbytes)
 {
-    void* ptr = pymalloc_alloc(ctx, nbytes);
+    void* ptr = pymalloc_alloc(get_state(), ctx, nbytes);
     if (LIKELY(ptr != NULL)) {
         return ptr;
     }
@@ -1656,7 +1729,7 @@ _PyObject_Calloc(void *ctx, size_t nelem, size_t elsize)
     assert(elsize == 0 || nelem <= (size_t)PY_SSIZE_T_MAX / elsize);
     size_t nbytes = nelem * elsize;
 
-    void* ptr = pymalloc_alloc(ctx, nbytes);
+    void* ptr = pymalloc_alloc(get_state(), ctx, nbytes);
     if (LIKELY(ptr != NULL)) {
         memset(ptr, 0, nbytes);
         return ptr;
@@ -1670,13 +1743,78 @@ _PyObject_Calloc(void *ctx, size_t nelem, size_t elsize)
 }
 
 
+/* Unlink the wholly free arena ao from usable_arenas and free it */
+static void
+free_arena(struct _obmalloc_state *state, struct arena_object *ao)
+{
+    /* First unlink ao from usable_arenas.
+     */
+    assert(ao->prevarena == NULL ||
+           ao->prevarena->address != 0);
+    assert(ao ->nextarena == NULL ||
+           ao->nextarena->address != 0);
+
+    /* Fix the pointer in the prevarena, or the
+     * usable_arenas pointer.
+     */
+    if (ao->prevarena == NULL) {
+        state->usable_arenas = ao->nextarena;
+        assert(state->usable_arenas == NULL ||
+               state->usable_arenas->address != 0);
+    }
+    else {
+        assert(ao->prevarena->nextarena == ao);
+        ao->prevarena->nextarena =
+            ao->nextarena;
+    }
+    /* Fix the pointer in the nextarena. */
+    if (ao->nextarena != NULL) {
+        assert(ao->nextarena->prevarena == ao);
+        ao->nextarena->prevarena =
+            ao->prevarena;
+    }
+    /* Record that this arena_object slot is
+     * available to be reused.
+     */
+    ao->nextarena = state->unused_arena_objects;
+    state->unused_arena_objects = ao;
+
+    /* Free the entire arena. */
+    _PyObject_Arena.free(_PyObject_Arena.ctx,
+                         (void *)ao->address, ARENA_SIZE);
+    ao->address = 0;                        /* mark unassociated */
+    --state->narenas_currently_allocated;
+}
+
+/* Free the arenas of state and state itself */
+static void
+free_state(struct _obmalloc_state *state)
+{
+    assert(state != &main_state);
+    for (uint i = 0; i < state->maxarenas; ++i) {
+        struct arena_object *ao = &state->arenas[i];
+        if (ao->address != 0) {
+            _PyObject_Arena.free(_PyObject_Arena.ctx,
+                                 (void *)ao->address, ARENA_SIZE);
+        }
+    }
+    PyMem_RawFree(state->arenas);
+
+    struct _obmalloc_state **p = &obmalloc_states;
+    while (*p != state) {
+        p = &(*p)->next;
+    }
+    *p = state->next;
+    PyMem_RawFree(state);
+}
+
 static void
-insert_to_usedpool(poolp pool)
+insert_to_usedpool(struct _obmalloc_state *state, poolp pool)
 {
     assert(pool->ref.count > 0);            /* else the pool is empty */
 
     uint size = pool->szidx;
-    poolp next = usedpools[size + size];
+    poolp next = state->usedpools[size + size];
     poolp prev = next->prevpool;
 
     /* insert pool before next:   prev <-> pool <-> next */
@@ -1687,7 +1825,7 @@ insert_to_usedpool(poolp pool)
 }
 
 static void
-insert_to_freepool(poolp pool)
+insert_to_freepool(struct _obmalloc_state *state, poolp pool)
 {
     poolp next = pool->nextpool;
     poolp prev = pool->prevpool;
@@ -1697,7 +1835,7 @@ insert_to_freepool(poolp pool)
     /* Link the pool to freepools.  This is a singly-linked
      * list, and pool->prevpool isn't used there.
      */
-    struct arena_object *ao = &arenas[pool->arenaindex];
+    struct arena_object *ao = &state->arenas[pool->arenaindex];
     pool->nextpool = ao->freepools;
     ao->freepools = pool;
     uint nf = ao->nfreepools;
@@ -1705,7 +1843,7 @@ insert_to_freepool(poolp pool)
      * nfp2lasta[nf] needs to change.  Caution:  if nf is 0, there
      * are no arenas in usable_arenas with that value.
      */
-    struct arena_object* lastnf = nfp2lasta[nf];
+    struct arena_object* lastnf = state->nfp2lasta[nf];
     assert((nf == 0 && lastnf == NULL) ||
            (nf > 0 &&
             lastnf != NULL &&
@@ -1714,7 +1852,7 @@ insert_to_freepool(poolp pool)
              nf < lastnf->nextarena->nfreepools)));
     if (lastnf == ao) {  /* it is the rightmost */
         struct arena_object* p = ao->prevarena;
-        nfp2lasta[nf] = (p != NULL && p->nfreepools == nf) ? p : NULL;
+        state->nfp2lasta[nf] = (p != NULL && p->nfreepools == nf) ? p : NULL;
     }
     ao->nfreepools = ++nf;
 
@@ -1726,7 +1864,9 @@ insert_to_freepool(poolp pool)
      *    keeping one wholly free arena in the list avoids
      *    pathological cases where a simple loop would
      *    otherwise provoke needing to allocate and free an
-     *    arena on every iteration.  See bpo-37257.
+     *    arena on every iteration.  See bpo-37257.  Nothing
+     *    allocates from an orphaned state anymore: free its
+     *    last arena, and then the state itself.
      * 2. If this is the only free pool in the arena,
      *    add the arena back to the `usable_arenas` list.
      * 3. If the "next" arena has a smaller count of free
@@ -1735,45 +1875,14 @@ insert_to_freepool(poolp pool)
      *    nfreepools.
      * 4. Else there's nothing more to do.
      */
-    if (nf == ao->ntotalpools && ao->nextarena != NULL) {
-        /* Case 1.  First unlink ao from usable_arenas.
-         */
-        assert(ao->prevarena == NULL ||
-               ao->prevarena->address != 0);
-        assert(ao ->nextarena == NULL ||
-               ao->nextarena->address != 0);
+    if (nf == ao->ntotalpools
+        && (ao->nextarena != NULL || state->orphaned)) {
+        /* Case 1. */
+        free_arena(state, ao);
 
-        /* Fix the pointer in the prevarena, or the
-         * usable_arenas pointer.
-         */
-        if (ao->prevarena == NULL) {
-            usable_arenas = ao->nextarena;
-            assert(usable_arenas == NULL ||
-                   usable_arenas->address != 0);
-        }
-        else {
-            assert(ao->prevarena->nextarena == ao);
-            ao->prevarena->nextarena =
-                ao->nextarena;
+        if (state->orphaned && state->narenas_currently_allocated == 0) {
+            free_state(state);
         }
-        /* Fix the pointer in the nextarena. */
-        if (ao->nextarena != NULL) {
-            assert(ao->nextarena->prevarena == ao);
-            ao->nextarena->prevarena =
-                ao->prevarena;
-        }
-        /* Record that this arena_object slot is
-         * available to be reused.
-         */
-        ao->nextarena = unused_arena_objects;
-        unused_arena_objects = ao;
-
-        /* Free the entire arena. */
-        _PyObject_Arena.free(_PyObject_Arena.ctx,
-                             (void *)ao->address, ARENA_SIZE);
-        ao->address = 0;                        /* mark unassociated */
-        --narenas_currently_allocated;
-
         return;
     }
 
@@ -1783,14 +1892,14 @@ insert_to_freepool(poolp pool)
          * ao->nfreepools was 0 before, ao isn't
          * currently on the usable_arenas list.
          */
-        ao->nextarena = usable_arenas;
+        ao->nextarena = state->usable_arenas;
         ao->prevarena = NULL;
-        if (usable_arenas)
-            usable_arenas->prevarena = ao;
-        usable_arenas = ao;
-        assert(usable_arenas->address != 0);
-        if (nfp2lasta[1] == NULL) {
-            nfp2lasta[1] = ao;
+        if (state->usable_arenas)
+            state->usable_arenas->prevarena = ao;
+        state->usable_arenas = ao;
+        assert(state->usable_arenas->address != 0);
+        if (state->nfp2lasta[1] == NULL) {
+            state->nfp2lasta[1] = ao;
         }
 
         return;
@@ -1804,8 +1913,8 @@ insert_to_freepool(poolp pool)
      * approach allowed a lot more memory to be freed.
      */
     /* If this is the only arena with nf, record that. */
-    if (nfp2lasta[nf] == NULL) {
-        nfp2lasta[nf] = ao;
+    if (state->nfp2lasta[nf] == NULL) {
+        state->nfp2lasta[nf] = ao;
     } /* else the rightmost with nf doesn't change */
     /* If this was the rightmost of the old size, it remains in place. */
     if (ao == lastnf) {
@@ -1829,8 +1938,8 @@ insert_to_freepool(poolp pool)
     }
     else {
         /* ao is at the head of the list */
-        assert(usable_arenas == ao);
-        usable_arenas = ao->nextarena;
+        assert(state->usable_arenas == ao);
+        state->usable_arenas = ao->nextarena;
     }
     ao->nextarena->prevarena = ao->prevarena;
     /* And insert after lastnf. */
@@ -1844,7 +1953,7 @@ insert_to_freepool(poolp pool)
     assert(ao->nextarena == NULL || nf <= ao->nextarena->nfreepools);
     assert(ao->prevarena == NULL || nf > ao->prevarena->nfreepools);
     assert(ao->nextarena == NULL || ao->nextarena->prevarena == ao);
-    assert((usable_arenas == ao && ao->prevarena == NULL)
+    assert((state->usable_arenas == ao && ao->prevarena == NULL)
            || ao->prevarena->nextarena == ao);
 }
 
@@ -1863,7 +1972,8 @@ pymalloc_free(void *ctx, void *p)
 #endif
 
     poolp pool = POOL_ADDR(p);
-    if (UNLIKELY(!address_in_range(p, pool))) {
+    struct _obmalloc_state *state = find_state(p, pool);
+    if (UNLIKELY(state == NULL)) {
         return 0;
     }
     /* We allocated this address. */
@@ -1887,7 +1997,7 @@ pymalloc_free(void *ctx, void *p)
          * targets optimal filling when several pools contain
          * blocks of the same size class.
          */
-        insert_to_usedpool(pool);
+        insert_to_usedpool(state, pool);
         return 1;
     }
 
@@ -1904,7 +2014,7 @@ pymalloc_free(void *ctx, void *p)
      * previously freed pools will be allocated later
      * (being not referenced, they are perhaps paged out).
      */
-    insert_to_freepool(pool);
+    insert_to_freepool(state, pool);
     return 1;
 }
 
@@ -1951,7 +2061,7 @@ pymalloc_realloc(void *ctx, void **newptr_p, void *p, size_t nbytes)
 #endif
 
     pool = POOL_ADDR(p);
-    if (!address_in_range(p, pool)) {
+    if (find_state(p, pool) == NULL) {
         /* pymalloc is not managing this block.
 
            If nbytes <= SMALL_REQUEST_THRESHOLD, it's tempting to try to take
@@ -2011,6 +2121,65 @@ _PyObject_Realloc(void *ctx, void *ptr, size_t nbytes)
     return PyMem_RawRealloc(ptr, nbytes);
 }
 
+
+/* Set up the allocator state of a new interpreter.  The main interpreter,
+   which is created first, uses main_state.  Return -1 on memory allocation
+   failure. */
+int
+_PyObject_InitState(PyInterpreterState *interp)
+{
+    if (interp->runtime->interpreters.main == NULL) {
+        interp->obmalloc = &main_state;
+        return 0;
+    }
+
+    struct _obmalloc_state *state = PyMem_RawCalloc(1, sizeof(*state));
+    if (state == NULL) {
+        return -1;
+    }
+    for (uint i = 0; i < NB_USEDPOOLS; i += 2) {
+        poolp p = (poolp)((uint8_t *)&state->usedpools[i] - 2*sizeof(block *));
+        state->usedpools[i] = state->usedpools[i + 1] = p;
+    }
+    state->next = obmalloc_states;
+    obmalloc_states = state;
+    interp->obmalloc = state;
+    return 0;
+}
+
+/* Release the arenas of a deleted interpreter.  Arenas holding blocks which
+   are still used by other interpreters are released when these blocks are
+   freed. */
+void
+_PyObject_FiniState(PyInterpreterState *interp)
+{
+    struct _obmalloc_state *state = interp->obmalloc;
+    interp->obmalloc = NULL;
+    if (state == NULL || state == &main_state) {
+        return;
+    }
+
+    if (state_allocated_blocks(state) == 0) {
+        free_state(state);
+        return;
+    }
+
+    state->orphaned = 1;
+    /* Free the wholly free arenas: no pool will be freed in them */
+    for (uint i = 0; i < state->maxarenas; ++i) {
+        struct arena_object *ao = &state->arenas[i];
+        if (ao->address == 0 || ao->nfreepools != ao->ntotalpools) {
+            continue;
+        }
+        uint nf = ao->nfreepools;
+        if (state->nfp2lasta[nf] == ao) {
+            struct arena_object* p = ao->prevarena;
+            state->nfp2lasta[nf] = (p != NULL && p->nfreepools == nf) ? p : NULL;
+        }
+        free_arena(state, ao);
+    }
+}
+
 #else   /* ! WITH_PYMALLOC */
 
 /*==========================================================================*/
@@ -2023,6 +2192,17 @@ _Py_GetAllocatedBlocks(void)
     return 0;
 }
 
+int
+_PyObject_InitState(PyInterpreterState *interp)
+{
+    return 0;
+}
+
+void
+_PyObject_FiniState(PyInterpreterState *interp)
+{
+}
+
 #endif /* WITH_PYMALLOC */
 
 
@@ -2598,6 +2778,7 @@ _PyObject_DebugMallocStats(FILE *out)
         return 0;
     }
 
+    struct _obmalloc_state *state = get_state();
     uint i;
     const uint numclasses = SMALL_REQUEST_THRESHOLD >> ALIGNMENT_SHIFT;
     /* # of pools, allocated blocks, and free blocks per class index */
@@ -2635,16 +2816,16 @@ _PyObject_DebugMallocStats(FILE *out)
      * to march over all the arenas.  If we're lucky, most of the memory
      * will be living in full pools -- would be a shame to miss them.
      */
-    for (i = 0; i < maxarenas; ++i) {
+    for (i = 0; i < state->maxarenas; ++i) {
         uint j;
-        uintptr_t base = arenas[i].address;
+        uintptr_t base = state->arenas[i].address;
 
         /* Skip arenas which are not allocated. */
-        if (arenas[i].address == (uintptr_t)NULL)
+        if (state->arenas[i].address == (uintptr_t)NULL)
             continue;
         narenas += 1;
 
-        numfreepools += arenas[i].nfreepools;
+        numfreepools += state->arenas[i].nfreepools;
 
         /* round up to pool alignment */
         if (base & (uintptr_t)POOL_SIZE_MASK) {
@@ -2654,8 +2835,8 @@ _PyObject_DebugMallocStats(FILE *out)
         }
 
         /* visit every pool in the arena */
-        assert(base <= (uintptr_t) arenas[i].pool_address);
-        for (j = 0; base < (uintptr_t) arenas[i].pool_address;
+        assert(base <= (uintptr_t) state->arenas[i].pool_address);
+        for (j = 0; base < (uintptr_t) state->arenas[i].pool_address;
              ++j, base += POOL_SIZE) {
             poolp p = (poolp)base;
             const uint sz = p->szidx;
@@ -2664,7 +2845,7 @@ _PyObject_DebugMallocStats(FILE *out)
             if (p->ref.count == 0) {
                 /* currently unused */
 #ifdef Py_DEBUG
-                assert(pool_is_in_list(p, arenas[i].freepools));
+                assert(pool_is_in_list(p, state->arenas[i].freepools));
 #endif
                 continue;
             }
@@ -2674,11 +2855,11 @@ _PyObject_DebugMallocStats(FILE *out)
             numfreeblocks[sz] += freeblocks;
 #ifdef Py_DEBUG
             if (freeblocks > 0)
-                assert(pool_is_in_list(p, usedpools[sz + sz]));
+                assert(pool_is_in_list(p, state->usedpools[sz + sz]));
 #endif
         }
     }
-    assert(narenas == narenas_currently_allocated);
+    assert(narenas == state->narenas_currently_allocated);
 
     fputc('\n', out);
     fputs("class   size   num pools   blocks in use  avail blocks\n"
@@ -2707,9 +2888,9 @@ _PyObject_DebugMallocStats(FILE *out)
         (void)printone(out, "# times object malloc called", serialno);
     }
 #endif
-    (void)printone(out, "# arenas allocated total", ntimes_arena_allocated);
-    (void)printone(out, "# arenas reclaimed", ntimes_arena_allocated - narenas);
-    (void)printone(out, "# arenas highwater mark", narenas_highwater);
+    (void)printone(out, "# arenas allocated total", state->ntimes_arena_allocated);
+    (void)printone(out, "# arenas reclaimed", state->ntimes_arena_allocated - narenas);
+    (void)printone(out, "# arenas highwater mark", state->narenas_highwater);
     (void)printone(out, "# arenas allocated current", narenas);
 
     PyOS_snprintf(buf, sizeof(buf),
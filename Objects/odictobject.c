@@ -467,7 +467,7 @@ later:
 #include "Python.h"
 #include "pycore_object.h"
 #include <stddef.h>               // offsetof()
-#include "dict-common.h"
+#include "pycore_dict.h"        // PyDictKeysObject
 #include <stddef.h>
 
 #include "clinic/odictobject.c.h"
@@ -2,6 +2,7 @@
 
 #include "Python.h"
 #include "pycore_abstract.h"   // _PyIndex_Check()
+#include "pycore_range.h"      // _PyRangeIterObject
 #include "pycore_tupleobject.h"
 #include "structmember.h"         // PyMemberDef
 
@@ -744,13 +745,7 @@ PyTypeObject PyRange_Type = {
    in the normal case, but possible for any numeric value.
 */
 
-typedef struct {
-        PyObject_HEAD
-        long    index;
-        long    start;
-        long    step;
-        long    len;
-} rangeiterobject;
+typedef _PyRangeIterObject rangeiterobject;
 
 static PyObject *
 rangeiter_next(rangeiterobject *r)
@@ -19,12 +19,6 @@ class object "PyObject *" "&PyBaseObject_Type"
 
 #include "clinic/typeobject.c.h"
 
-/* bpo-40521: Type method cache is shared by all subinterpreters */
-#ifndef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-#  define MCACHE
-#endif
-
-#ifdef MCACHE
 /* Support type attribute cache */
 
 /* The cache can keep references to the names alive for longer than
@@ -32,7 +26,6 @@ class object "PyObject *" "&PyBaseObject_Type"
    MCACHE_MAX_ATTR_SIZE, since it might be a problem if very large
    strings are used as attribute names. */
 #define MCACHE_MAX_ATTR_SIZE    100
-#define MCACHE_SIZE_EXP         12
 #define MCACHE_HASH(version, name_hash)                                 \
         (((unsigned int)(version) ^ (unsigned int)(name_hash))          \
          & ((1 << MCACHE_SIZE_EXP) - 1))
@@ -45,15 +38,9 @@ class object "PyObject *" "&PyBaseObject_Type"
         PyUnicode_IS_READY(name) &&                             \
         PyUnicode_GET_LENGTH(name) <= MCACHE_MAX_ATTR_SIZE
 
-struct method_cache_entry {
-    unsigned int version;
-    PyObject *name;             /* reference to exactly a str or None */
-    PyObject *value;            /* borrowed */
-};
-
-static struct method_cache_entry method_cache[1 << MCACHE_SIZE_EXP];
+/* Each interpreter has its own cache, but the version tags are shared by
+   all interpreters. */
 static unsigned int next_version_tag = 0;
-#endif
 
 #define MCACHE_STATS 0
 
@@ -220,11 +207,48 @@ _PyType_GetTextSignatureFromInternalDoc(const char *name, const char *internal_d
     return PyUnicode_FromStringAndSize(start, end - start);
 }
 
+static struct type_cache*
+get_type_cache(void)
+{
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    return &interp->type_cache;
+}
+
+static void
+type_cache_clear(struct type_cache *cache, int use_none)
+{
+    for (Py_ssize_t i = 0; i < (1 << MCACHE_SIZE_EXP); i++) {
+        struct type_cache_entry *entry = &cache->hashtable[i];
+        entry->version = 0;
+        if (use_none) {
+            Py_INCREF(Py_None);
+            Py_XSETREF(entry->name, Py_None);
+        }
+        else {
+            Py_CLEAR(entry->name);
+        }
+        entry->value = NULL;
+    }
+}
+
+/* Clear the caches of all interpreters: needed when the version tags are
+   reset, since the tags are shared by all interpreters. */
+static void
+type_cache_clear_all(int use_none)
+{
+    _PyRuntimeState *runtime = &_PyRuntime;
+    PyThread_acquire_lock(runtime->interpreters.mutex, WAIT_LOCK);
+    for (PyInterpreterState *interp = runtime->interpreters.head;
+         interp != NULL; interp = interp->next)
+    {
+        type_cache_clear(&interp->type_cache, use_none);
+    }
+    PyThread_release_lock(runtime->interpreters.mutex);
+}
+
 unsigned int
 PyType_ClearCache(void)
 {
-#ifdef MCACHE
-    Py_ssize_t i;
     unsigned int cur_version_tag = next_version_tag - 1;
 
 #if MCACHE_STATS
@@ -236,28 +260,26 @@ PyType_ClearCache(void)
     fprintf(stderr, "-- Method cache collisions  = %zd (%d%%)\n",
             method_cache_collisions, (int) (100.0 * method_cache_collisions / total));
     fprintf(stderr, "-- Method cache size        = %zd KiB\n",
-            sizeof(method_cache) / 1024);
+            sizeof(struct type_cache) / 1024);
 #endif
 
-    for (i = 0; i < (1 << MCACHE_SIZE_EXP); i++) {
-        method_cache[i].version = 0;
-        Py_CLEAR(method_cache[i].name);
-        method_cache[i].value = NULL;
-    }
+    type_cache_clear_all(0);
     next_version_tag = 0;
     /* mark all version tags as invalid */
     PyType_Modified(&PyBaseObject_Type);
     return cur_version_tag;
-#else
-    return 0;
-#endif
 }
 
 void
-_PyType_Fini(void)
+_PyType_Fini(PyThreadState *tstate)
 {
-    PyType_ClearCache();
-    clear_slotdefs();
+    if (_Py_IsMainInterpreter(tstate)) {
+        PyType_ClearCache();
+        clear_slotdefs();
+    }
+    else {
+        type_cache_clear(&tstate->interp->type_cache, 0);
+    }
 }
 
 void
@@ -278,9 +300,10 @@ PyType_Modified(PyTypeObject *type)
 
        This function clears the Py_TPFLAGS_VALID_VERSION_TAG of a
        type (so it must first clear it on all subclasses).  The
-       tp_version_tag value is meaningless unless this flag is set.
-       We don't assign new version tags eagerly, but only as
-       needed.
+       tp_version_tag value is meaningless unless this flag is set;
+       it is also reset to 0, so that the attribute caches of the eval
+       loop, which only compare tags, miss.  We don't assign new
+       version tags eagerly, but only as needed.
      */
     PyObject *raw, *ref;
     Py_ssize_t i;
@@ -301,6 +324,7 @@ PyType_Modified(PyTypeObject *type)
         }
     }
     type->tp_flags &= ~Py_TPFLAGS_VALID_VERSION_TAG;
+    type->tp_version_tag = 0;
 }
 
 static void
@@ -359,9 +383,9 @@ type_mro_modified(PyTypeObject *type, PyObject *bases) {
     Py_XDECREF(type_mro_meth);
     type->tp_flags &= ~(Py_TPFLAGS_HAVE_VERSION_TAG|
                         Py_TPFLAGS_VALID_VERSION_TAG);
+    type->tp_version_tag = 0;
 }
 
-#ifdef MCACHE
 static int
 assign_version_tag(PyTypeObject *type)
 {
@@ -388,11 +412,7 @@ assign_version_tag(PyTypeObject *type)
            cache by filling names with references to Py_None.
            Values are also set to NULL for added protection, as they
            are borrowed reference */
-        for (i = 0; i < (1 << MCACHE_SIZE_EXP); i++) {
-            method_cache[i].value = NULL;
-            Py_INCREF(Py_None);
-            Py_XSETREF(method_cache[i].name, Py_None);
-        }
+        type_cache_clear_all(1);
         /* mark all version tags as invalid */
         PyType_Modified(&PyBaseObject_Type);
         return 1;
@@ -408,7 +428,6 @@ assign_version_tag(PyTypeObject *type)
     type->tp_flags |= Py_TPFLAGS_VALID_VERSION_TAG;
     return 1;
 }
-#endif
 
 
 static PyMemberDef type_members[] = {
@@ -3222,20 +3241,20 @@ _PyType_Lookup(PyTypeObject *type, PyObject *name)
     PyObject *res;
     int error;
 
-#ifdef MCACHE
+    struct type_cache *cache = get_type_cache();
     if (MCACHE_CACHEABLE_NAME(name) &&
         _PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG)) {
         /* fast path */
         unsigned int h = MCACHE_HASH_METHOD(type, name);
-        if (method_cache[h].version == type->tp_version_tag &&
-            method_cache[h].name == name) {
+        struct type_cache_entry *entry = &cache->hashtable[h];
+        if (entry->version == type->tp_version_tag &&
+            entry->name == name) {
 #if MCACHE_STATS
             method_cache_hits++;
 #endif
-            return method_cache[h].value;
+            return entry->value;
         }
     }
-#endif
 
     /* We may end up clearing live exceptions below, so make sure it's ours. */
     assert(!PyErr_Occurred());
@@ -3257,22 +3276,21 @@ _PyType_Lookup(PyTypeObject *type, PyObject *name)
         return NULL;
     }
 
-#ifdef MCACHE
     if (MCACHE_CACHEABLE_NAME(name) && assign_version_tag(type)) {
         unsigned int h = MCACHE_HASH_METHOD(type, name);
-        method_cache[h].version = type->tp_version_tag;
-        method_cache[h].value = res;  /* borrowed */
+        struct type_cache_entry *entry = &cache->hashtable[h];
+        entry->version = type->tp_version_tag;
+        entry->value = res;  /* borrowed */
         Py_INCREF(name);
         assert(((PyASCIIObject *)(name))->hash != -1);
 #if MCACHE_STATS
-        if (method_cache[h].name != Py_None && method_cache[h].name != name)
+        if (entry->name != Py_None && entry->name != name)
             method_cache_collisions++;
         else
             method_cache_misses++;
 #endif
-        Py_SETREF(method_cache[h].name, name);
+        Py_XSETREF(entry->name, name);
     }
-#endif
     return res;
 }
 
@@ -15612,6 +15612,10 @@ PyUnicode_InternInPlace(PyObject **p)
        The deallocator will take care of this */
     Py_SET_REFCNT(s, Py_REFCNT(s) - 2);
     _PyUnicode_STATE(s).interned = SSTATE_INTERNED_MORTAL;
+#else
+    /* Dict lookups by identifier expect the hash of interned strings to
+       be already computed */
+    (void)unicode_hash(s);
 #endif
 }
 
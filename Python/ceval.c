@@ -14,18 +14,23 @@
 #include "pycore_call.h"
 #include "pycore_ceval.h"
 #include "pycore_code.h"
+#include "pycore_dict.h"          // DK_ENTRIES()
 #include "pycore_initconfig.h"
+#include "pycore_jit.h"
+#include "pycore_list.h"          // _PyListIterObject
 #include "pycore_object.h"
 #include "pycore_pyerrors.h"
 #include "pycore_pylifecycle.h"
 #include "pycore_pymem.h"         // _PyMem_IsPtrFreed()
 #include "pycore_pystate.h"       // _PyInterpreterState_GET()
+#include "pycore_range.h"         // _PyRangeIterObject
 #include "pycore_sysmodule.h"
 #include "pycore_tupleobject.h"
 
 #include "code.h"
 #include "dictobject.h"
 #include "frameobject.h"
+#include "longintrepr.h"
 #include "opcode.h"
 #include "pydtrace.h"
 #include "setobject.h"
@@ -83,6 +88,10 @@ static PyObject * special_lookup(PyThreadState *, PyObject *, _Py_Identifier *);
 static int check_args_iterable(PyThreadState *, PyObject *func, PyObject *vararg);
 static void format_kwargs_error(PyThreadState *, PyObject *func, PyObject *kwargs);
 static void format_awaitable_error(PyThreadState *, PyTypeObject *, int, int);
+static PyFrameObject *make_call_frame(PyThreadState *, PyObject *,
+                                      PyObject *const *, Py_ssize_t,
+                                      PyObject *);
+static inline void release_frame(PyThreadState *, PyFrameObject *);
 
 #define NAME_ERROR_MSG \
     "name '%.200s' is not defined"
@@ -111,16 +120,33 @@ static long dxp[256];
 #else
 #define OPCACHE_MIN_RUNS 1024  /* create opcache when code executed this time */
 #endif
-#define OPCACHE_STATS 0  /* Enable stats */
 
-#if OPCACHE_STATS
-static size_t opcache_code_objects = 0;
-static size_t opcache_code_objects_extra_mem = 0;
-
-static size_t opcache_global_opts = 0;
-static size_t opcache_global_hits = 0;
-static size_t opcache_global_misses = 0;
-#endif
+/* With -X jit, compile code to machine code once it has entered the
+   interpreter or jumped back this many times */
+#define JIT_MIN_RUNS 4096
+
+/* Execution statistics, collected while sys._stats_on() or -X pystats is
+   in effect.  Counters that no instruction updates stay at 0: hits are
+   only counted by LOAD_GLOBAL, since every execution of a specialized
+   instruction which is not a miss is a hit. */
+typedef struct {
+    uint64_t execution_count;
+    uint64_t hit;
+    uint64_t miss;
+    uint64_t deopt;
+    uint64_t specialization_success;
+    uint64_t specialization_failure;
+} _PyOpcodeStats;
+
+struct _Py_EvalStats {
+    _PyOpcodeStats opcodes[256];
+    /* Weak references to the code objects whose co_stats_calls is set */
+    PyObject *code_objects;
+    /* Length of code_objects at which its dead references are removed */
+    Py_ssize_t prune_at;
+};
+
+#define STATS_MIN_PRUNE 1024
 
 
 #ifndef NDEBUG
@@ -249,58 +275,56 @@ _Py_FatalError_TstateNULL(const char *func)
                        "(the current Python thread state is NULL)");
 }
 
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
 int
 _PyEval_ThreadsInitialized(PyInterpreterState *interp)
 {
-    return gil_created(&interp->ceval.gil);
+    struct _gil_runtime_state *gil = interp->ceval.gil;
+    return (gil != NULL && gil_created(gil));
 }
 
 int
 PyEval_ThreadsInitialized(void)
 {
-    // Fatal error if there is no current interpreter
-    PyInterpreterState *interp = PyInterpreterState_Get();
-    return _PyEval_ThreadsInitialized(interp);
-}
-#else
-int
-_PyEval_ThreadsInitialized(_PyRuntimeState *runtime)
-{
+    /* The GIL of the main interpreter is created first and destroyed
+       last */
+    _PyRuntimeState *runtime = &_PyRuntime;
     return gil_created(&runtime->ceval.gil);
 }
 
-int
-PyEval_ThreadsInitialized(void)
-{
-    _PyRuntimeState *runtime = &_PyRuntime;
-    return _PyEval_ThreadsInitialized(runtime);
-}
-#endif
+/* Create the GIL of the interpreter of tstate and take it.
 
+   The main interpreter creates the runtime GIL.  A subinterpreter either
+   creates its own GIL (own_gil is non-zero), and then runs in parallel with
+   the other interpreters, or shares the GIL of the main interpreter, which
+   must be held by the current thread. */
 PyStatus
-_PyEval_InitGIL(PyThreadState *tstate)
+_PyEval_InitGIL(PyThreadState *tstate, int own_gil)
 {
-#ifndef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    if (!_Py_IsMainInterpreter(tstate)) {
-        /* Currently, the GIL is shared by all interpreters,
-           and only the main interpreter is responsible to create
-           and destroy it. */
-        return _PyStatus_OK();
-    }
-#endif
+    PyInterpreterState *interp = tstate->interp;
+    struct _ceval_state *ceval2 = &interp->ceval;
+    struct _gil_runtime_state *gil;
+    assert(ceval2->gil == NULL);
 
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    struct _gil_runtime_state *gil = &tstate->interp->ceval.gil;
-#else
-    struct _gil_runtime_state *gil = &tstate->interp->runtime->ceval.gil;
-#endif
+    if (own_gil) {
+        assert(!_Py_IsMainInterpreter(tstate));
+        gil = &ceval2->own_gil_state;
+    }
+    else {
+        gil = &interp->runtime->ceval.gil;
+        if (!_Py_IsMainInterpreter(tstate)) {
+            assert(gil_created(gil));
+            ceval2->gil = gil;
+            return _PyStatus_OK();
+        }
+    }
     assert(!gil_created(gil));
 
     PyThread_init_thread();
     create_gil(gil);
+    ceval2->gil = gil;
+    ceval2->own_gil = own_gil;
 
-    take_gil(tstate);
+    take_gil(tstate, 0);
 
     assert(gil_created(gil));
     return _PyStatus_OK();
@@ -309,20 +333,20 @@ _PyEval_InitGIL(PyThreadState *tstate)
 void
 _PyEval_FiniGIL(PyThreadState *tstate)
 {
-#ifndef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    if (!_Py_IsMainInterpreter(tstate)) {
-        /* Currently, the GIL is shared by all interpreters,
-           and only the main interpreter is responsible to create
-           and destroy it. */
+    PyInterpreterState *interp = tstate->interp;
+    struct _gil_runtime_state *gil;
+    if (_Py_IsMainInterpreter(tstate)) {
+        /* The GIL of a previous Py_Initialize() call */
+        gil = &interp->runtime->ceval.gil;
+    }
+    else if (interp->ceval.own_gil) {
+        gil = interp->ceval.gil;
+    }
+    else {
+        /* The GIL of the main interpreter is destroyed by the main
+           interpreter */
         return;
     }
-#endif
-
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    struct _gil_runtime_state *gil = &tstate->interp->ceval.gil;
-#else
-    struct _gil_runtime_state *gil = &tstate->interp->runtime->ceval.gil;
-#endif
     if (!gil_created(gil)) {
         /* First Py_InitializeFromConfig() call: the GIL doesn't exist
            yet: do nothing. */
@@ -342,30 +366,6 @@ PyEval_InitThreads(void)
 void
 _PyEval_Fini(void)
 {
-#if OPCACHE_STATS
-    fprintf(stderr, "-- Opcode cache number of objects  = %zd\n",
-            opcache_code_objects);
-
-    fprintf(stderr, "-- Opcode cache total extra mem    = %zd\n",
-            opcache_code_objects_extra_mem);
-
-    fprintf(stderr, "\n");
-
-    fprintf(stderr, "-- Opcode cache LOAD_GLOBAL hits   = %zd (%d%%)\n",
-            opcache_global_hits,
-            (int) (100.0 * opcache_global_hits /
-                (opcache_global_hits + opcache_global_misses)));
-
-    fprintf(stderr, "-- Opcode cache LOAD_GLOBAL misses = %zd (%d%%)\n",
-            opcache_global_misses,
-            (int) (100.0 * opcache_global_misses /
-                (opcache_global_hits + opcache_global_misses)));
-
-    fprintf(stderr, "-- Opcode cache LOAD_GLOBAL opts   = %zd\n",
-            opcache_global_opts);
-
-    fprintf(stderr, "\n");
-#endif
 }
 
 void
@@ -375,7 +375,7 @@ PyEval_AcquireLock(void)
     PyThreadState *tstate = _PyRuntimeState_GetThreadState(runtime);
     _Py_EnsureTstateNotNULL(tstate);
 
-    take_gil(tstate);
+    take_gil(tstate, 0);
 }
 
 void
@@ -404,7 +404,7 @@ PyEval_AcquireThread(PyThreadState *tstate)
 {
     _Py_EnsureTstateNotNULL(tstate);
 
-    take_gil(tstate);
+    take_gil(tstate, 0);
 
     struct _gilstate_runtime_state *gilstate = &tstate->interp->runtime->gilstate;
 #ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
@@ -414,6 +414,7 @@ PyEval_AcquireThread(PyThreadState *tstate)
         Py_FatalError("non-NULL old thread state");
     }
 #endif
+    gil_stats_resume(tstate);
 }
 
 void
@@ -440,17 +441,13 @@ _PyEval_ReInitThreads(PyThreadState *tstate)
 {
     _PyRuntimeState *runtime = tstate->interp->runtime;
 
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    struct _gil_runtime_state *gil = &tstate->interp->ceval.gil;
-#else
-    struct _gil_runtime_state *gil = &runtime->ceval.gil;
-#endif
-    if (!gil_created(gil)) {
+    struct _gil_runtime_state *gil = tstate->interp->ceval.gil;
+    if (gil == NULL || !gil_created(gil)) {
         return _PyStatus_OK();
     }
     recreate_gil(gil);
 
-    take_gil(tstate);
+    take_gil(tstate, 0);
 
     struct _pending_calls *pending = &tstate->interp->ceval.pending;
     if (_PyThread_at_fork_reinit(&pending->lock) < 0) {
@@ -487,11 +484,7 @@ PyEval_SaveThread(void)
 
     struct _ceval_runtime_state *ceval = &runtime->ceval;
     struct _ceval_state *ceval2 = &tstate->interp->ceval;
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    assert(gil_created(&ceval2->gil));
-#else
-    assert(gil_created(&ceval->gil));
-#endif
+    assert(gil_created(ceval2->gil));
     drop_gil(ceval, ceval2, tstate);
     return tstate;
 }
@@ -501,10 +494,11 @@ PyEval_RestoreThread(PyThreadState *tstate)
 {
     _Py_EnsureTstateNotNULL(tstate);
 
-    take_gil(tstate);
+    take_gil(tstate, 0);
 
     struct _gilstate_runtime_state *gilstate = &tstate->interp->runtime->gilstate;
     _PyThreadState_Swap(gilstate, tstate);
+    gil_stats_resume(tstate);
 }
 
 
@@ -750,9 +744,7 @@ void
 _PyEval_InitRuntimeState(struct _ceval_runtime_state *ceval)
 {
     _Py_CheckRecursionLimit = Py_DEFAULT_RECURSION_LIMIT;
-#ifndef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
     _gil_initialize(&ceval->gil);
-#endif
 }
 
 int
@@ -768,9 +760,7 @@ _PyEval_InitState(struct _ceval_state *ceval)
         return -1;
     }
 
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    _gil_initialize(&ceval->gil);
-#endif
+    _gil_initialize(&ceval->own_gil_state);
 
     return 0;
 }
@@ -914,7 +904,7 @@ eval_frame_handle_pending(PyThreadState *tstate)
 
         /* Other threads may run now */
 
-        take_gil(tstate);
+        take_gil(tstate, 1);
 
 #ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
         (void)_PyThreadState_Swap(&runtime->gilstate, tstate);
@@ -923,6 +913,7 @@ eval_frame_handle_pending(PyThreadState *tstate)
             Py_FatalError("orphan tstate");
         }
 #endif
+        gil_stats_resume(tstate);
     }
 
     /* Check for asynchronous exception. */
@@ -938,6 +929,138 @@ eval_frame_handle_pending(PyThreadState *tstate)
     return 0;
 }
 
+/* Helpers for the specialized instructions */
+
+/* Is x an int with at most one digit? */
+#define IS_MEDIUM_INT(x) (Py_ABS(Py_SIZE(x)) <= 1)
+
+/* Value of an int for which IS_MEDIUM_INT() is true */
+static inline sdigit
+medium_int_value(PyObject *x)
+{
+    PyLongObject *v = (PyLongObject *)x;
+    assert(IS_MEDIUM_INT(x));
+    return Py_SIZE(v) < 0 ? -(sdigit)v->ob_digit[0] :
+           (Py_SIZE(v) == 0 ? (sdigit)0 : (sdigit)v->ob_digit[0]);
+}
+
+static PyObject *
+compare_medium_ints(PyObject *left, PyObject *right, int op)
+{
+    sdigit a = medium_int_value(left);
+    sdigit b = medium_int_value(right);
+    Py_RETURN_RICHCOMPARE(a, b, op);
+}
+
+static PyObject *
+compare_floats(PyObject *left, PyObject *right, int op)
+{
+    double a = PyFloat_AS_DOUBLE(left);
+    double b = PyFloat_AS_DOUBLE(right);
+    Py_RETURN_RICHCOMPARE(a, b, op);
+}
+
+/* Instance dict of an object whose type has a positive tp_dictoffset */
+#define INSTANCE_DICT(obj, type) \
+    (*(PyDictObject **)((char *)(obj) + (type)->tp_dictoffset))
+
+/* Return the entry at the given index of a combined dict if its key is
+   name, or NULL */
+static inline PyDictKeyEntry *
+dict_entry_hint(PyDictObject *dict, Py_ssize_t index, PyObject *name)
+{
+    PyDictKeysObject *keys = dict->ma_keys;
+    PyDictKeyEntry *ep;
+
+    if (dict->ma_values != NULL || index >= keys->dk_nentries) {
+        return NULL;
+    }
+    ep = &DK_ENTRIES(keys)[index];
+    return ep->me_key == name ? ep : NULL;
+}
+
+/* Return the address of the value at the given index of a split dict if
+   its key is name, or NULL */
+static inline PyObject **
+dict_split_value(PyDictObject *dict, Py_ssize_t index, PyObject *name)
+{
+    PyDictKeysObject *keys = dict->ma_keys;
+
+    if (dict->ma_values == NULL || index >= keys->dk_nentries ||
+        DK_ENTRIES(keys)[index].me_key != name) {
+        return NULL;
+    }
+    return &dict->ma_values[index];
+}
+
+/* Count a call of co in the execution statistics */
+static void
+count_call(struct _Py_EvalStats *stats, PyCodeObject *co)
+{
+    if (co->co_stats_calls++ > 0) {
+        return;
+    }
+    /* First call since the statistics were cleared: list co.  An
+       exception may be set when a generator starts with throw(). */
+    PyObject *type, *value, *traceback;
+    PyErr_Fetch(&type, &value, &traceback);
+    PyObject *codes = stats->code_objects;
+    if (PyList_GET_SIZE(codes) >= stats->prune_at) {
+        /* Remove the references to dead code objects */
+        Py_ssize_t j = 0;
+        for (Py_ssize_t i = 0; i < PyList_GET_SIZE(codes); i++) {
+            PyObject *ref = PyList_GET_ITEM(codes, i);
+            if (PyWeakref_GET_OBJECT(ref) != Py_None) {
+                Py_INCREF(ref);
+                PyList_SetItem(codes, j++, ref);
+            }
+        }
+        PyList_SetSlice(codes, j, PyList_GET_SIZE(codes), NULL);
+        stats->prune_at = Py_MAX(STATS_MIN_PRUNE, 2 * j);
+    }
+    PyObject *ref = PyWeakref_NewRef((PyObject *)co, NULL);
+    if (ref == NULL || PyList_Append(codes, ref) < 0) {
+        /* The statistics are best effort: the calls of co are not
+           reported */
+        PyErr_Clear();
+    }
+    Py_XDECREF(ref);
+    PyErr_Restore(type, value, traceback);
+}
+
+/* Can the frame continue in the machine code of its code object at the
+   given offset?  Count the calls and loop iterations of the code, and
+   compile it when it is hot enough (-X jit).  Code compiled before it got
+   co_quickened is compiled again once it has it, since new frames run
+   co_quickened.  Execution statistics are only collected by the
+   interpreter. */
+static inline int
+jit_can_enter(PyThreadState *tstate, PyFrameObject *f, PyCodeObject *co,
+              int offset)
+{
+    if (co->co_jit == NULL) {
+        if (co->co_jit_warmup >= JIT_MIN_RUNS) {
+            /* The code cannot be compiled */
+            return 0;
+        }
+        if (++co->co_jit_warmup < JIT_MIN_RUNS ||
+            _PyJIT_Compile(co) < 0) {
+            return 0;
+        }
+    }
+    else if (co->co_jit->quickened != (co->co_quickened != NULL)) {
+        /* Recompile for co_quickened, keeping the old version */
+        if (co->co_jit->previous != NULL || _PyJIT_Compile(co) < 0) {
+            return 0;
+        }
+    }
+    return (f->f_quickened == co->co_jit->quickened &&
+            !tstate->use_tracing && f->f_trace == NULL &&
+            tstate->interp->ceval.stats == NULL &&
+            !PyDTrace_LINE_ENABLED() &&
+            co->co_jit->entries[offset / sizeof(_Py_CODEUNIT)] != NULL);
+}
+
 PyObject* _Py_HOT_FUNCTION
 _PyEval_EvalFrameDefault(PyThreadState *tstate, PyFrameObject *f, int throwflag)
 {
@@ -947,7 +1070,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, PyFrameObject *f, int throwflag)
     int lastopcode = 0;
 #endif
     PyObject **stack_pointer;  /* Next free slot in value stack */
-    const _Py_CODEUNIT *next_instr;
+    _Py_CODEUNIT *next_instr;
     int opcode;        /* Current opcode */
     int oparg;         /* Current opcode argument, if any */
     PyObject **fastlocals, **freevars;
@@ -955,6 +1078,12 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, PyFrameObject *f, int throwflag)
     struct _ceval_state * const ceval2 = &tstate->interp->ceval;
     _Py_atomic_int * const eval_breaker = &ceval2->eval_breaker;
     PyCodeObject *co;
+    int try_block;  /* See exception_unwind */
+    PyTryBlock try_block_copy;
+    PyFrameObject *new_frame;  /* See push_frame */
+    int inline_calls = 0;  /* Frames started by push_frame still running */
+    const int use_jit = tstate->interp->config._use_jit;
+    _PyJITState jit_state;
 
     /* when tracing we set things up so that
 
@@ -965,7 +1094,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, PyFrameObject *f, int throwflag)
        time it is tested. */
     int instr_ub = -1, instr_lb = 0, instr_prev = -1;
 
-    const _Py_CODEUNIT *first_instr;
+    _Py_CODEUNIT *first_instr;
     PyObject *names;
     PyObject *consts;
     _PyOpcache *co_opcache;
@@ -1247,30 +1376,99 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, PyFrameObject *f, int throwflag)
         } \
     } while (0)
 
-#if OPCACHE_STATS
-
-#define OPCACHE_STAT_GLOBAL_HIT() \
+    /* macros for execution statistics (sys._stats_on()) */
+#define STAT_INC(op, name) \
     do { \
-        if (co->co_opcache != NULL) opcache_global_hits++; \
+        if (ceval2->stats != NULL) { \
+            ceval2->stats->opcodes[op].name++; \
+        } \
     } while (0)
 
-#define OPCACHE_STAT_GLOBAL_MISS() \
+#define OPCACHE_STAT_GLOBAL_HIT() STAT_INC(LOAD_GLOBAL, hit)
+#define OPCACHE_STAT_GLOBAL_MISS() STAT_INC(LOAD_GLOBAL, miss)
+#define OPCACHE_STAT_GLOBAL_OPT() STAT_INC(LOAD_GLOBAL, specialization_success)
+
+    /* macros for specialized instructions (see Python/specialize.c) */
+
+/* Run the base form of the current instruction, as found in co_code */
+#define GO_TO_BASE_INSTRUCTION() \
     do { \
-        if (co->co_opcache != NULL) opcache_global_misses++; \
+        _Py_CODEUNIT *base_instr = \
+            (_Py_CODEUNIT *)PyBytes_AS_STRING(co->co_code); \
+        opcode = _Py_OPCODE(base_instr[next_instr - first_instr - 1]); \
+        goto dispatch_opcode; \
     } while (0)
 
-#define OPCACHE_STAT_GLOBAL_OPT() \
+/* Body of the adaptive instructions.  SPECIALIZE is a call to the
+   _Py_Specialize_XXX() function for the current instruction. */
+#define ADAPTIVE(SPECIALIZE) \
     do { \
-        if (co->co_opcache != NULL) opcache_global_opts++; \
+        OPCACHE_CHECK(); \
+        assert(co_opcache != NULL); \
+        if (co_opcache->counter == 0) { \
+            if ((SPECIALIZE) == 0) { \
+                STAT_INC(opcode, specialization_success); \
+                opcode = _Py_OPCODE(next_instr[-1]); \
+                goto dispatch_opcode; \
+            } \
+            STAT_INC(opcode, specialization_failure); \
+        } \
+        else { \
+            co_opcache->counter--; \
+        } \
+        GO_TO_BASE_INSTRUCTION(); \
     } while (0)
 
-#else /* OPCACHE_STATS */
+/* Whether a call to func can run in this invocation of the eval loop
+   (see push_frame).  Generators don't run when called, and tracing and
+   PEP 523 frame evaluation functions need the C call.  The line tracing
+   state of a frame with a trace function (instr_prev) must also survive
+   the call. */
+#define CAN_INLINE_CALL(func) \
+    (Py_IS_TYPE((func), &PyFunction_Type) && \
+     !(((PyCodeObject *)PyFunction_GET_CODE(func))->co_flags & \
+       (CO_GENERATOR | CO_COROUTINE | CO_ASYNC_GENERATOR)) && \
+     !tstate->use_tracing && f->f_trace == NULL && \
+     tstate->interp->eval_frame == _PyEval_EvalFrameDefault)
+
+/* Make the frame of a call to the Python function func, pop the npop
+   entries of the value stack used by the call, and start running the
+   frame. */
+#define INLINE_CALL(func, args, nargs, kwnames, npop) \
+    do { \
+        new_frame = make_call_frame(tstate, (func), (args), (nargs), \
+                                    (kwnames)); \
+        for (int i_ = 0; i_ < (npop); i_++) { \
+            PyObject *w_ = POP(); \
+            Py_XDECREF(w_); \
+        } \
+        if (new_frame == NULL) { \
+            goto error; \
+        } \
+        goto push_frame; \
+    } while (0)
 
-#define OPCACHE_STAT_GLOBAL_HIT()
-#define OPCACHE_STAT_GLOBAL_MISS()
-#define OPCACHE_STAT_GLOBAL_OPT()
+/* Go on to the second instruction of a superinstruction, without going
+   back to the top of the loop: the eval breaker can wait, but line events
+   can't, so the second instruction runs on its own when they may be
+   needed. */
+#define NEXT_OF_PAIR() \
+    do { \
+        if (_Py_TracingPossible(ceval2) || PyDTrace_LINE_ENABLED()) { \
+            FAST_DISPATCH(); \
+        } \
+        f->f_lasti = INSTR_OFFSET(); \
+        NEXTOPARG(); \
+    } while (0)
 
-#endif
+/* Guard of a specialized instruction.  Must be checked before the
+   instruction has any side effect. */
+#define DEOPT_IF(cond) \
+    do { \
+        if (cond) { \
+            goto miss; \
+        } \
+    } while (0)
 
 /* Start of code */
 
@@ -1279,6 +1477,7 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, PyFrameObject *f, int throwflag)
         return NULL;
     }
 
+enter_frame:
     tstate->frame = f;
 
     if (tstate->use_tracing) {
@@ -1319,15 +1518,44 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, PyFrameObject *f, int throwflag)
         dtrace_function_entry(f);
 
     co = f->f_code;
-    names = co->co_names;
-    consts = co->co_consts;
-    fastlocals = f->f_localsplus;
-    freevars = f->f_localsplus + co->co_nlocals;
     assert(PyBytes_Check(co->co_code));
     assert(PyBytes_GET_SIZE(co->co_code) <= INT_MAX);
     assert(PyBytes_GET_SIZE(co->co_code) % sizeof(_Py_CODEUNIT) == 0);
     assert(_Py_IS_ALIGNED(PyBytes_AS_STRING(co->co_code), sizeof(_Py_CODEUNIT)));
-    first_instr = (_Py_CODEUNIT *) PyBytes_AS_STRING(co->co_code);
+
+    if (co->co_opcache_flag < OPCACHE_MIN_RUNS) {
+        co->co_opcache_flag++;
+        if (co->co_opcache_flag == OPCACHE_MIN_RUNS) {
+            if (_PyCode_InitOpcache(co) < 0) {
+                goto exit_eval_frame;
+            }
+        }
+    }
+
+    /* Run the specialized copy of the bytecode once there is one.  Both
+       copies have the same layout, so f_lasti is valid in either, but a
+       frame must stick to the copy it started with: try blocks are not
+       on the block stack in co_quickened when there is an exception
+       table. */
+    if (f->f_lasti < 0) {
+        f->f_quickened = (co->co_quickened != NULL);
+        if (ceval2->stats != NULL) {
+            count_call(ceval2->stats, co);
+        }
+    }
+
+resume_frame:
+    co = f->f_code;
+    names = co->co_names;
+    consts = co->co_consts;
+    fastlocals = f->f_localsplus;
+    freevars = f->f_localsplus + co->co_nlocals;
+    if (f->f_quickened) {
+        first_instr = co->co_quickened;
+    }
+    else {
+        first_instr = (_Py_CODEUNIT *) PyBytes_AS_STRING(co->co_code);
+    }
     /*
        f->f_lasti refers to the index of the last instruction,
        unless it's -1 in which case next_instr should be first_instr.
@@ -1351,23 +1579,12 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, PyFrameObject *f, int throwflag)
     }
     stack_pointer = f->f_stacktop;
     assert(stack_pointer != NULL);
-    f->f_stacktop = NULL;       /* remains NULL unless yield suspends frame */
+    /* f_stacktop remains NULL unless a yield or a call suspends the frame */
+    f->f_stacktop = NULL;
     f->f_executing = 1;
-
-    if (co->co_opcache_flag < OPCACHE_MIN_RUNS) {
-        co->co_opcache_flag++;
-        if (co->co_opcache_flag == OPCACHE_MIN_RUNS) {
-            if (_PyCode_InitOpcache(co) < 0) {
-                goto exit_eval_frame;
-            }
-#if OPCACHE_STATS
-            opcache_code_objects_extra_mem +=
-                PyBytes_Size(co->co_code) / sizeof(_Py_CODEUNIT) +
-                sizeof(_PyOpcache) * co->co_opcache_size;
-            opcache_code_objects++;
-#endif
-        }
-    }
+    instr_ub = -1;
+    instr_lb = 0;
+    instr_prev = -1;
 
 #ifdef LLTRACE
     lltrace = _PyDict_GetItemId(f->f_globals, &PyId___ltrace__) != NULL;
@@ -1383,6 +1600,11 @@ _PyEval_EvalFrameDefault(PyThreadState *tstate, PyFrameObject *f, int throwflag)
     assert(!_PyErr_Occurred(tstate));
 #endif
 
+    /* Start the frame, or continue it after a call, in machine code */
+    if (use_jit && jit_can_enter(tstate, f, co, INSTR_OFFSET())) {
+        goto jit_code;
+    }
+
 main_loop:
     for (;;) {
         assert(stack_pointer >= f->f_valuestack); /* else underflow */
@@ -1398,7 +1620,9 @@ main_loop:
            Py_MakePendingCalls() above. */
 
         if (_Py_atomic_load_relaxed(eval_breaker)) {
-            opcode = _Py_OPCODE(*next_instr);
+            /* Look at co_code: SETUP_FINALLY can be a NOP in co_quickened */
+            opcode = _Py_OPCODE(((_Py_CODEUNIT *)PyBytes_AS_STRING(
+                co->co_code))[INSTR_OFFSET() / sizeof(_Py_CODEUNIT)]);
             if (opcode == SETUP_FINALLY ||
                 opcode == SETUP_WITH ||
                 opcode == BEFORE_ASYNC_WITH ||
@@ -1460,6 +1684,7 @@ main_loop:
         /* Extract opcode and argument */
 
         NEXTOPARG();
+        STAT_INC(opcode, execution_count);
     dispatch_opcode:
 #ifdef DYNAMIC_EXECUTION_PROFILE
 #ifdef DXPAIRS
@@ -1522,6 +1747,93 @@ main_loop:
             FAST_DISPATCH();
         }
 
+        case TARGET(LOAD_FAST_AND_CLEAR): {
+            /* The local may be unbound: NULL is pushed and stored back by
+               STORE_FAST */
+            PyObject *value = GETLOCAL(oparg);
+            GETLOCAL(oparg) = NULL;
+            PUSH(value);
+            FAST_DISPATCH();
+        }
+
+        case TARGET(LOAD_FAST__LOAD_FAST): {
+            PyObject *value = GETLOCAL(oparg);
+            if (value == NULL) {
+                goto unbound_local_error;
+            }
+            Py_INCREF(value);
+            PUSH(value);
+            NEXT_OF_PAIR();
+            value = GETLOCAL(oparg);
+            if (value == NULL) {
+                goto unbound_local_error;
+            }
+            Py_INCREF(value);
+            PUSH(value);
+            FAST_DISPATCH();
+        }
+
+        case TARGET(LOAD_FAST__LOAD_CONST): {
+            PyObject *value = GETLOCAL(oparg);
+            if (value == NULL) {
+                goto unbound_local_error;
+            }
+            Py_INCREF(value);
+            PUSH(value);
+            NEXT_OF_PAIR();
+            value = GETITEM(consts, oparg);
+            Py_INCREF(value);
+            PUSH(value);
+            FAST_DISPATCH();
+        }
+
+        case TARGET(LOAD_CONST__LOAD_FAST): {
+            PyObject *value = GETITEM(consts, oparg);
+            Py_INCREF(value);
+            PUSH(value);
+            NEXT_OF_PAIR();
+            value = GETLOCAL(oparg);
+            if (value == NULL) {
+                goto unbound_local_error;
+            }
+            Py_INCREF(value);
+            PUSH(value);
+            FAST_DISPATCH();
+        }
+
+        case TARGET(STORE_FAST__LOAD_FAST): {
+            PyObject *value = POP();
+            SETLOCAL(oparg, value);
+            NEXT_OF_PAIR();
+            value = GETLOCAL(oparg);
+            if (value == NULL) {
+                goto unbound_local_error;
+            }
+            Py_INCREF(value);
+            PUSH(value);
+            FAST_DISPATCH();
+        }
+
+        case TARGET(STORE_FAST__STORE_FAST): {
+            PyObject *value = POP();
+            SETLOCAL(oparg, value);
+            NEXT_OF_PAIR();
+            value = POP();
+            SETLOCAL(oparg, value);
+            FAST_DISPATCH();
+        }
+
+        case TARGET(LOAD_CONST__RETURN_VALUE): {
+            PyObject *value = GETITEM(consts, oparg);
+            Py_INCREF(value);
+            PUSH(value);
+            NEXT_OF_PAIR();
+            retval = POP();
+            assert(f->f_iblock == 0);
+            assert(EMPTY());
+            goto exiting;
+        }
+
         case TARGET(POP_TOP): {
             PyObject *value = POP();
             Py_DECREF(value);
@@ -1730,6 +2042,66 @@ main_loop:
             DISPATCH();
         }
 
+        case TARGET(BINARY_ADD_ADAPTIVE): {
+            ADAPTIVE(_Py_Specialize_BinaryAdd(SECOND(), TOP(),
+                                              next_instr - 1, co_opcache));
+        }
+
+        case TARGET(BINARY_ADD_INT): {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            PyObject *sum;
+            DEOPT_IF(!PyLong_CheckExact(left));
+            DEOPT_IF(!PyLong_CheckExact(right));
+            if (IS_MEDIUM_INT(left) && IS_MEDIUM_INT(right)) {
+                sum = PyLong_FromLong((long)medium_int_value(left) +
+                                      medium_int_value(right));
+            }
+            else {
+                sum = PyLong_Type.tp_as_number->nb_add(left, right);
+            }
+            STACK_SHRINK(1);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(BINARY_ADD_FLOAT): {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            PyObject *sum;
+            DEOPT_IF(!PyFloat_CheckExact(left));
+            DEOPT_IF(!PyFloat_CheckExact(right));
+            sum = PyFloat_FromDouble(PyFloat_AS_DOUBLE(left) +
+                                     PyFloat_AS_DOUBLE(right));
+            STACK_SHRINK(1);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(BINARY_ADD_UNICODE): {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            PyObject *sum;
+            DEOPT_IF(!PyUnicode_CheckExact(left));
+            DEOPT_IF(!PyUnicode_CheckExact(right));
+            STACK_SHRINK(1);
+            sum = unicode_concatenate(tstate, left, right, f, next_instr);
+            /* unicode_concatenate consumed the ref to left */
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            DISPATCH();
+        }
+
         case TARGET(BINARY_SUBTRACT): {
             PyObject *right = POP();
             PyObject *left = TOP();
@@ -2180,13 +2552,18 @@ main_loop:
             PyObject *iter = _PyCoro_GetAwaitableIter(iterable);
 
             if (iter == NULL) {
+                /* Look at co_code: the previous instructions may have
+                   been specialized in co_quickened */
+                const _Py_CODEUNIT *base_instr =
+                    (_Py_CODEUNIT *)PyBytes_AS_STRING(co->co_code) +
+                    (next_instr - first_instr);
                 int opcode_at_minus_3 = 0;
                 if ((next_instr - first_instr) > 2) {
-                    opcode_at_minus_3 = _Py_OPCODE(next_instr[-3]);
+                    opcode_at_minus_3 = _Py_OPCODE(base_instr[-3]);
                 }
                 format_awaitable_error(tstate, Py_TYPE(iterable),
                                        opcode_at_minus_3,
-                                       _Py_OPCODE(next_instr[-2]));
+                                       _Py_OPCODE(base_instr[-2]));
             }
 
             Py_DECREF(iterable);
@@ -2463,13 +2840,89 @@ main_loop:
             DISPATCH();
         }
 
-        case TARGET(DELETE_ATTR): {
+        case TARGET(STORE_ATTR_ADAPTIVE): {
+            ADAPTIVE(_Py_Specialize_StoreAttr(TOP(), GETITEM(names, oparg),
+                                              next_instr - 1, co_opcache));
+        }
+
+        case TARGET(STORE_ATTR_SPLIT_KEYS): {
             PyObject *name = GETITEM(names, oparg);
-            PyObject *owner = POP();
-            int err;
-            err = PyObject_SetAttr(owner, name, (PyObject *)NULL);
-            Py_DECREF(owner);
-            if (err != 0)
+            PyObject *owner = TOP();
+            PyObject *v = SECOND();
+            PyTypeObject *type = Py_TYPE(owner);
+            PyDictObject *dict;
+            PyObject **value_addr, *old_value;
+            OPCACHE_CHECK();
+            DEOPT_IF(type->tp_version_tag != co_opcache->u.attr.tp_version);
+            dict = INSTANCE_DICT(owner, type);
+            DEOPT_IF(dict == NULL);
+            value_addr = dict_split_value(dict, co_opcache->u.attr.index, name);
+            DEOPT_IF(value_addr == NULL);
+            old_value = *value_addr;
+            if (old_value == NULL) {
+                /* The values of a split dict are in insertion order */
+                DEOPT_IF(co_opcache->u.attr.index != dict->ma_used);
+                dict->ma_used++;
+            }
+            *value_addr = v;
+            if (!_PyObject_GC_IS_TRACKED(dict) && _PyObject_GC_MAY_BE_TRACKED(v)) {
+                _PyObject_GC_TRACK(dict);
+            }
+            dict->ma_version_tag = DICT_NEXT_VERSION();
+            STACK_SHRINK(2);
+            Py_XDECREF(old_value);
+            Py_DECREF(owner);
+            DISPATCH();
+        }
+
+        case TARGET(STORE_ATTR_WITH_HINT): {
+            PyObject *name = GETITEM(names, oparg);
+            PyObject *owner = TOP();
+            PyObject *v = SECOND();
+            PyTypeObject *type = Py_TYPE(owner);
+            PyDictObject *dict;
+            PyDictKeyEntry *ep;
+            PyObject *old_value;
+            OPCACHE_CHECK();
+            DEOPT_IF(type->tp_version_tag != co_opcache->u.attr.tp_version);
+            dict = INSTANCE_DICT(owner, type);
+            DEOPT_IF(dict == NULL);
+            ep = dict_entry_hint(dict, co_opcache->u.attr.index, name);
+            DEOPT_IF(ep == NULL || ep->me_value == NULL);
+            old_value = ep->me_value;
+            ep->me_value = v;
+            if (!_PyObject_GC_IS_TRACKED(dict) && _PyObject_GC_MAY_BE_TRACKED(v)) {
+                _PyObject_GC_TRACK(dict);
+            }
+            dict->ma_version_tag = DICT_NEXT_VERSION();
+            STACK_SHRINK(2);
+            Py_DECREF(old_value);
+            Py_DECREF(owner);
+            DISPATCH();
+        }
+
+        case TARGET(STORE_ATTR_SLOT): {
+            PyObject *owner = TOP();
+            PyObject *v = SECOND();
+            PyObject **addr, *old_value;
+            OPCACHE_CHECK();
+            DEOPT_IF(Py_TYPE(owner)->tp_version_tag != co_opcache->u.attr.tp_version);
+            addr = (PyObject **)((char *)owner + co_opcache->u.attr.index);
+            old_value = *addr;
+            *addr = v;
+            STACK_SHRINK(2);
+            Py_XDECREF(old_value);
+            Py_DECREF(owner);
+            DISPATCH();
+        }
+
+        case TARGET(DELETE_ATTR): {
+            PyObject *name = GETITEM(names, oparg);
+            PyObject *owner = POP();
+            int err;
+            err = PyObject_SetAttr(owner, name, (PyObject *)NULL);
+            Py_DECREF(owner);
+            if (err != 0)
                 goto error;
             DISPATCH();
         }
@@ -3022,6 +3475,82 @@ main_loop:
             DISPATCH();
         }
 
+        case TARGET(LOAD_ATTR_ADAPTIVE): {
+            ADAPTIVE(_Py_Specialize_LoadAttr(TOP(), GETITEM(names, oparg),
+                                             next_instr - 1, co_opcache));
+        }
+
+        case TARGET(LOAD_ATTR_SPLIT_KEYS): {
+            PyObject *name = GETITEM(names, oparg);
+            PyObject *owner = TOP();
+            PyTypeObject *type = Py_TYPE(owner);
+            PyDictObject *dict;
+            PyObject **value_addr, *res;
+            OPCACHE_CHECK();
+            DEOPT_IF(type->tp_version_tag != co_opcache->u.attr.tp_version);
+            dict = INSTANCE_DICT(owner, type);
+            DEOPT_IF(dict == NULL);
+            value_addr = dict_split_value(dict, co_opcache->u.attr.index, name);
+            DEOPT_IF(value_addr == NULL || *value_addr == NULL);
+            res = *value_addr;
+            Py_INCREF(res);
+            SET_TOP(res);
+            Py_DECREF(owner);
+            DISPATCH();
+        }
+
+        case TARGET(LOAD_ATTR_WITH_HINT): {
+            PyObject *name = GETITEM(names, oparg);
+            PyObject *owner = TOP();
+            PyTypeObject *type = Py_TYPE(owner);
+            PyDictObject *dict;
+            PyDictKeyEntry *ep;
+            PyObject *res;
+            OPCACHE_CHECK();
+            DEOPT_IF(type->tp_version_tag != co_opcache->u.attr.tp_version);
+            dict = INSTANCE_DICT(owner, type);
+            DEOPT_IF(dict == NULL);
+            ep = dict_entry_hint(dict, co_opcache->u.attr.index, name);
+            DEOPT_IF(ep == NULL || ep->me_value == NULL);
+            res = ep->me_value;
+            Py_INCREF(res);
+            SET_TOP(res);
+            Py_DECREF(owner);
+            DISPATCH();
+        }
+
+        case TARGET(LOAD_ATTR_SLOT): {
+            PyObject *owner = TOP();
+            PyObject *res;
+            OPCACHE_CHECK();
+            DEOPT_IF(Py_TYPE(owner)->tp_version_tag != co_opcache->u.attr.tp_version);
+            res = *(PyObject **)((char *)owner + co_opcache->u.attr.index);
+            DEOPT_IF(res == NULL);
+            Py_INCREF(res);
+            SET_TOP(res);
+            Py_DECREF(owner);
+            DISPATCH();
+        }
+
+        case TARGET(LOAD_ATTR_MODULE): {
+            PyObject *name = GETITEM(names, oparg);
+            PyObject *owner = TOP();
+            PyDictObject *dict;
+            PyDictKeyEntry *ep;
+            PyObject *res;
+            DEOPT_IF(!PyModule_CheckExact(owner));
+            dict = INSTANCE_DICT(owner, &PyModule_Type);
+            DEOPT_IF(dict == NULL);
+            OPCACHE_CHECK();
+            ep = dict_entry_hint(dict, co_opcache->u.attr.index, name);
+            DEOPT_IF(ep == NULL || ep->me_value == NULL);
+            res = ep->me_value;
+            Py_INCREF(res);
+            SET_TOP(res);
+            Py_DECREF(owner);
+            DISPATCH();
+        }
+
         case TARGET(COMPARE_OP): {
             assert(oparg <= Py_GE);
             PyObject *right = POP();
@@ -3037,6 +3566,69 @@ main_loop:
             DISPATCH();
         }
 
+        case TARGET(COMPARE_OP_ADAPTIVE): {
+            ADAPTIVE(_Py_Specialize_CompareOp(SECOND(), TOP(),
+                                              next_instr - 1, co_opcache));
+        }
+
+        case TARGET(COMPARE_OP_INT): {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            PyObject *res;
+            DEOPT_IF(!PyLong_CheckExact(left));
+            DEOPT_IF(!PyLong_CheckExact(right));
+            if (IS_MEDIUM_INT(left) && IS_MEDIUM_INT(right)) {
+                res = compare_medium_ints(left, right, oparg);
+            }
+            else {
+                res = PyLong_Type.tp_richcompare(left, right, oparg);
+            }
+            STACK_SHRINK(1);
+            SET_TOP(res);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            if (res == NULL)
+                goto error;
+            PREDICT(POP_JUMP_IF_FALSE);
+            PREDICT(POP_JUMP_IF_TRUE);
+            DISPATCH();
+        }
+
+        case TARGET(COMPARE_OP_FLOAT): {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            PyObject *res;
+            DEOPT_IF(!PyFloat_CheckExact(left));
+            DEOPT_IF(!PyFloat_CheckExact(right));
+            res = compare_floats(left, right, oparg);
+            STACK_SHRINK(1);
+            SET_TOP(res);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            PREDICT(POP_JUMP_IF_FALSE);
+            PREDICT(POP_JUMP_IF_TRUE);
+            DISPATCH();
+        }
+
+        case TARGET(COMPARE_OP_STR): {
+            PyObject *right = TOP();
+            PyObject *left = SECOND();
+            PyObject *res;
+            assert(oparg == Py_EQ || oparg == Py_NE);
+            DEOPT_IF(!PyUnicode_CheckExact(left));
+            DEOPT_IF(!PyUnicode_CheckExact(right));
+            res = (_PyUnicode_EQ(left, right) ^ (oparg == Py_NE)) ?
+                  Py_True : Py_False;
+            Py_INCREF(res);
+            STACK_SHRINK(1);
+            SET_TOP(res);
+            Py_DECREF(left);
+            Py_DECREF(right);
+            PREDICT(POP_JUMP_IF_FALSE);
+            PREDICT(POP_JUMP_IF_TRUE);
+            DISPATCH();
+        }
+
         case TARGET(IS_OP): {
             PyObject *right = POP();
             PyObject *left = TOP();
@@ -3266,6 +3858,9 @@ main_loop:
         case TARGET(JUMP_ABSOLUTE): {
             PREDICTED(JUMP_ABSOLUTE);
             JUMPTO(oparg);
+            if (use_jit && jit_can_enter(tstate, f, co, oparg)) {
+                goto jit_code;
+            }
 #if FAST_LOOPS
             /* Enabling this path speeds-up all while and for-loops by bypassing
                the per-loop checks for signals.  By default, this should be turned-off
@@ -3350,6 +3945,61 @@ main_loop:
             DISPATCH();
         }
 
+        case TARGET(FOR_ITER_ADAPTIVE): {
+            ADAPTIVE(_Py_Specialize_ForIter(TOP(), next_instr - 1,
+                                            co_opcache));
+        }
+
+        case TARGET(FOR_ITER_LIST): {
+            PyObject *iter = TOP();
+            DEOPT_IF(!Py_IS_TYPE(iter, &PyListIter_Type));
+            _PyListIterObject *it = (_PyListIterObject *)iter;
+            PyListObject *seq = it->it_seq;
+            if (seq != NULL) {
+                if (it->it_index < PyList_GET_SIZE(seq)) {
+                    PyObject *next = PyList_GET_ITEM(seq, it->it_index++);
+                    Py_INCREF(next);
+                    PUSH(next);
+                    PREDICT(STORE_FAST);
+                    PREDICT(UNPACK_SEQUENCE);
+                    DISPATCH();
+                }
+                it->it_seq = NULL;
+                Py_DECREF(seq);
+            }
+            /* iterator ended normally */
+            STACK_SHRINK(1);
+            Py_DECREF(iter);
+            JUMPBY(oparg);
+            PREDICT(POP_BLOCK);
+            DISPATCH();
+        }
+
+        case TARGET(FOR_ITER_RANGE): {
+            PyObject *iter = TOP();
+            DEOPT_IF(!Py_IS_TYPE(iter, &PyRangeIter_Type));
+            _PyRangeIterObject *r = (_PyRangeIterObject *)iter;
+            if (r->index < r->len) {
+                /* cast to unsigned to avoid possible signed overflow
+                   in intermediate calculations. */
+                PyObject *next = PyLong_FromLong(
+                    (long)(r->start + (unsigned long)(r->index++) * r->step));
+                if (next == NULL) {
+                    goto error;
+                }
+                PUSH(next);
+                PREDICT(STORE_FAST);
+                PREDICT(UNPACK_SEQUENCE);
+                DISPATCH();
+            }
+            /* iterator ended normally */
+            STACK_SHRINK(1);
+            Py_DECREF(iter);
+            JUMPBY(oparg);
+            PREDICT(POP_BLOCK);
+            DISPATCH();
+        }
+
         case TARGET(SETUP_FINALLY): {
             PyFrame_BlockSetup(f, SETUP_FINALLY, INSTR_OFFSET() + oparg,
                                STACK_LEVEL());
@@ -3420,6 +4070,32 @@ main_loop:
             DISPATCH();
         }
 
+        case TARGET(BEFORE_WITH): {
+            /* SETUP_WITH in co_quickened, when the try block is in
+               co_exceptiontable */
+            _Py_IDENTIFIER(__enter__);
+            _Py_IDENTIFIER(__exit__);
+            PyObject *mgr = TOP();
+            PyObject *enter = special_lookup(tstate, mgr, &PyId___enter__);
+            PyObject *res;
+            if (enter == NULL) {
+                goto error;
+            }
+            PyObject *exit = special_lookup(tstate, mgr, &PyId___exit__);
+            if (exit == NULL) {
+                Py_DECREF(enter);
+                goto error;
+            }
+            SET_TOP(exit);
+            Py_DECREF(mgr);
+            res = _PyObject_CallNoArg(enter);
+            Py_DECREF(enter);
+            if (res == NULL)
+                goto error;
+            PUSH(res);
+            DISPATCH();
+        }
+
         case TARGET(WITH_EXCEPT_START): {
             /* At the top of the stack are 7 values:
                - (TOP, SECOND, THIRD) = exc_info()
@@ -3493,6 +4169,10 @@ main_loop:
 
             meth = PEEK(oparg + 2);
             if (meth == NULL) {
+                if (CAN_INLINE_CALL(PEEK(oparg + 1))) {
+                    INLINE_CALL(PEEK(oparg + 1), stack_pointer - oparg, oparg,
+                                NULL, oparg + 2);
+                }
                 /* `meth` is NULL when LOAD_METHOD thinks that it's not
                    a method call.
 
@@ -3524,6 +4204,10 @@ main_loop:
                   We'll be passing `oparg + 1` to call_function, to
                   make it accept the `self` as a first argument.
                 */
+                if (CAN_INLINE_CALL(meth)) {
+                    INLINE_CALL(meth, stack_pointer - oparg - 1, oparg + 1,
+                                NULL, oparg + 2);
+                }
                 res = call_function(tstate, &sp, oparg + 1, NULL);
                 stack_pointer = sp;
             }
@@ -3534,9 +4218,107 @@ main_loop:
             DISPATCH();
         }
 
+        case TARGET(CALL_METHOD_ADAPTIVE): {
+            ADAPTIVE(_Py_Specialize_CallMethod(PEEK(oparg + 2),
+                                               PEEK(oparg + 1), oparg,
+                                               next_instr - 1, co_opcache));
+        }
+
+        case TARGET(CALL_METHOD_PY): {
+            /* Same stack layouts as CALL_METHOD */
+            PyObject *meth = PEEK(oparg + 2);
+            Py_ssize_t nargs = oparg + (meth != NULL);
+            PyObject *callable = PEEK(nargs + 1);
+            PyObject *res;
+            DEOPT_IF(!Py_IS_TYPE(callable, &PyFunction_Type));
+            if (CAN_INLINE_CALL(callable)) {
+                INLINE_CALL(callable, stack_pointer - nargs, nargs, NULL,
+                            oparg + 2);
+            }
+            res = _PyFunction_Vectorcall(callable, stack_pointer - nargs,
+                    nargs | PY_VECTORCALL_ARGUMENTS_OFFSET, NULL);
+            assert((res != NULL) ^ (_PyErr_Occurred(tstate) != NULL));
+            /* Pop the arguments, the callable and the NULL if any */
+            for (Py_ssize_t i = 0; i < oparg + 2; i++) {
+                PyObject *w = POP();
+                Py_XDECREF(w);
+            }
+            PUSH(res);
+            if (res == NULL)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(CALL_METHOD_DESCR_O): {
+            assert(oparg == 1);
+            PyObject *meth = THIRD();
+            PyObject *self = SECOND();
+            PyObject *arg = TOP();
+            PyObject *res;
+            DEOPT_IF(meth == NULL);
+            DEOPT_IF(!Py_IS_TYPE(meth, &PyMethodDescr_Type));
+            PyMethodDef *ml = ((PyMethodDescrObject *)meth)->d_method;
+            DEOPT_IF((ml->ml_flags & _Py_METH_CALL_FLAGS) != METH_O);
+            DEOPT_IF(!PyObject_TypeCheck(self, PyDescr_TYPE(meth)));
+            DEOPT_IF(tstate->use_tracing);
+            if (_Py_EnterRecursiveCall(tstate, " while calling a Python object")) {
+                goto error;
+            }
+            res = ml->ml_meth(self, arg);
+            _Py_LeaveRecursiveCall(tstate);
+            res = _Py_CheckFunctionResult(tstate, meth, res, NULL);
+            STACK_SHRINK(2);
+            Py_DECREF(arg);
+            Py_DECREF(self);
+            Py_DECREF(meth);
+            SET_TOP(res);
+            if (res == NULL)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(CALL_METHOD_DESCR_FAST): {
+            PyObject *meth = PEEK(oparg + 2);
+            PyObject *self = PEEK(oparg + 1);
+            PyObject *res;
+            DEOPT_IF(meth == NULL);
+            DEOPT_IF(!Py_IS_TYPE(meth, &PyMethodDescr_Type));
+            PyMethodDef *ml = ((PyMethodDescrObject *)meth)->d_method;
+            int flags = ml->ml_flags & _Py_METH_CALL_FLAGS;
+            DEOPT_IF((flags & ~METH_KEYWORDS) != METH_FASTCALL);
+            DEOPT_IF(!PyObject_TypeCheck(self, PyDescr_TYPE(meth)));
+            DEOPT_IF(tstate->use_tracing);
+            if (_Py_EnterRecursiveCall(tstate, " while calling a Python object")) {
+                goto error;
+            }
+            if (flags & METH_KEYWORDS) {
+                res = ((_PyCFunctionFastWithKeywords)(void(*)(void))ml->ml_meth)(
+                    self, stack_pointer - oparg, oparg, NULL);
+            }
+            else {
+                res = ((_PyCFunctionFast)(void(*)(void))ml->ml_meth)(
+                    self, stack_pointer - oparg, oparg);
+            }
+            _Py_LeaveRecursiveCall(tstate);
+            res = _Py_CheckFunctionResult(tstate, meth, res, NULL);
+            /* Pop the arguments, self and the method */
+            for (int i = 0; i < oparg + 2; i++) {
+                PyObject *w = POP();
+                Py_DECREF(w);
+            }
+            PUSH(res);
+            if (res == NULL)
+                goto error;
+            DISPATCH();
+        }
+
         case TARGET(CALL_FUNCTION): {
             PREDICTED(CALL_FUNCTION);
             PyObject **sp, *res;
+            if (CAN_INLINE_CALL(PEEK(oparg + 1))) {
+                INLINE_CALL(PEEK(oparg + 1), stack_pointer - oparg, oparg,
+                            NULL, oparg + 1);
+            }
             sp = stack_pointer;
             res = call_function(tstate, &sp, oparg, NULL);
             stack_pointer = sp;
@@ -3547,12 +4329,99 @@ main_loop:
             DISPATCH();
         }
 
+        case TARGET(CALL_FUNCTION_ADAPTIVE): {
+            ADAPTIVE(_Py_Specialize_CallFunction(PEEK(oparg + 1), oparg,
+                                                 next_instr - 1, co_opcache));
+        }
+
+        case TARGET(CALL_FUNCTION_PY): {
+            PyObject *callable = PEEK(oparg + 1);
+            PyObject *res;
+            DEOPT_IF(!Py_IS_TYPE(callable, &PyFunction_Type));
+            if (CAN_INLINE_CALL(callable)) {
+                INLINE_CALL(callable, stack_pointer - oparg, oparg, NULL,
+                            oparg + 1);
+            }
+            res = _PyFunction_Vectorcall(callable, stack_pointer - oparg,
+                    oparg | PY_VECTORCALL_ARGUMENTS_OFFSET, NULL);
+            assert((res != NULL) ^ (_PyErr_Occurred(tstate) != NULL));
+            /* Pop the arguments and the callable */
+            for (int i = 0; i < oparg + 1; i++) {
+                PyObject *w = POP();
+                Py_DECREF(w);
+            }
+            PUSH(res);
+            if (res == NULL)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(CALL_FUNCTION_BUILTIN_O): {
+            assert(oparg == 1);
+            PyObject *callable = SECOND();
+            PyObject *arg = TOP();
+            PyObject *res;
+            DEOPT_IF(!PyCFunction_CheckExact(callable));
+            DEOPT_IF((PyCFunction_GET_FLAGS(callable) & _Py_METH_CALL_FLAGS)
+                     != METH_O);
+            DEOPT_IF(tstate->use_tracing);
+            if (_Py_EnterRecursiveCall(tstate, " while calling a Python object")) {
+                goto error;
+            }
+            res = PyCFunction_GET_FUNCTION(callable)(
+                PyCFunction_GET_SELF(callable), arg);
+            _Py_LeaveRecursiveCall(tstate);
+            res = _Py_CheckFunctionResult(tstate, callable, res, NULL);
+            STACK_SHRINK(1);
+            Py_DECREF(arg);
+            Py_DECREF(callable);
+            SET_TOP(res);
+            if (res == NULL)
+                goto error;
+            DISPATCH();
+        }
+
+        case TARGET(CALL_FUNCTION_BUILTIN_FAST): {
+            PyObject *callable = PEEK(oparg + 1);
+            PyObject *res;
+            DEOPT_IF(!PyCFunction_CheckExact(callable));
+            int flags = PyCFunction_GET_FLAGS(callable) & _Py_METH_CALL_FLAGS;
+            DEOPT_IF((flags & ~METH_KEYWORDS) != METH_FASTCALL);
+            DEOPT_IF(tstate->use_tracing);
+            PyCFunction cfunc = PyCFunction_GET_FUNCTION(callable);
+            PyObject *self = PyCFunction_GET_SELF(callable);
+            if (flags & METH_KEYWORDS) {
+                res = ((_PyCFunctionFastWithKeywords)(void(*)(void))cfunc)(
+                    self, stack_pointer - oparg, oparg, NULL);
+            }
+            else {
+                res = ((_PyCFunctionFast)(void(*)(void))cfunc)(
+                    self, stack_pointer - oparg, oparg);
+            }
+            res = _Py_CheckFunctionResult(tstate, callable, res, NULL);
+            /* Pop the arguments and the callable */
+            for (int i = 0; i < oparg + 1; i++) {
+                PyObject *w = POP();
+                Py_DECREF(w);
+            }
+            PUSH(res);
+            if (res == NULL)
+                goto error;
+            DISPATCH();
+        }
+
         case TARGET(CALL_FUNCTION_KW): {
             PyObject **sp, *res, *names;
 
-            names = POP();
+            names = TOP();
             assert(PyTuple_Check(names));
             assert(PyTuple_GET_SIZE(names) <= oparg);
+            if (CAN_INLINE_CALL(PEEK(oparg + 2))) {
+                INLINE_CALL(PEEK(oparg + 2), stack_pointer - oparg - 1,
+                            oparg - PyTuple_GET_SIZE(names), names,
+                            oparg + 2);
+            }
+            STACK_SHRINK(1);
             /* We assume without checking that names contains only strings */
             sp = stack_pointer;
             res = call_function(tstate, &sp, oparg, names);
@@ -3748,6 +4617,74 @@ main_loop:
            or goto error. */
         Py_UNREACHABLE();
 
+unbound_local_error:
+        /* LOAD_FAST in a superinstruction, on an unbound local */
+        format_exc_check_arg(tstate, PyExc_UnboundLocalError,
+                             UNBOUNDLOCAL_ERROR_MSG,
+                             PyTuple_GetItem(co->co_varnames, oparg));
+        goto error;
+
+miss:
+        /* A guard of the specialized instruction failed (DEOPT_IF()) */
+        STAT_INC(opcode, miss);
+        OPCACHE_CHECK();
+        assert(co_opcache != NULL);
+        if (co_opcache->counter == 0) {
+            STAT_INC(opcode, deopt);
+            /* Too many misses: the types seen here have changed.  Go back
+               to the adaptive instruction, which will specialize again
+               once it has backed off. */
+            _Py_CODEUNIT *base_instr =
+                (_Py_CODEUNIT *)PyBytes_AS_STRING(co->co_code);
+            int base = _Py_OPCODE(base_instr[next_instr - first_instr - 1]);
+            assert(_PyOpcode_Adaptive[base] != 0);
+            _Py_SET_OPCODE(next_instr[-1], _PyOpcode_Adaptive[base]);
+            co_opcache->counter = _Py_ADAPTIVE_BACKOFF;
+        }
+        else {
+            co_opcache->counter--;
+        }
+        GO_TO_BASE_INSTRUCTION();
+
+push_frame:
+        /* Call a Python function without a new C call: the state of f is
+           saved in the frame, and new_frame runs in its place until it
+           returns to f in exit_eval_frame. */
+        if (_Py_EnterRecursiveCall(tstate, "")) {
+            release_frame(tstate, new_frame);
+            goto error;
+        }
+        f->f_lasti = INSTR_OFFSET() - sizeof(_Py_CODEUNIT);
+        f->f_stacktop = stack_pointer;
+        f = new_frame;
+        inline_calls++;
+        throwflag = 0;
+        goto enter_frame;
+
+jit_code:
+        /* Run the frame in machine code from next_instr (see
+           Python/jit.c) */
+        jit_state.frame = f;
+        jit_state.tstate = tstate;
+        jit_state.eval_breaker = eval_breaker;
+        jit_state.stack_pointer = stack_pointer;
+        switch (_PyJIT_Execute(co, &jit_state, INSTR_OFFSET())) {
+        case _PyJIT_RETURN:
+            stack_pointer = jit_state.stack_pointer;
+            retval = jit_state.retval;
+            assert(f->f_iblock == 0);
+            assert(EMPTY());
+            goto exiting;
+        case _PyJIT_ERROR:
+            stack_pointer = jit_state.stack_pointer;
+            f->f_lasti = jit_state.lasti;
+            goto error;
+        default:
+            stack_pointer = jit_state.stack_pointer;
+            JUMPTO(jit_state.lasti);
+            DISPATCH();
+        }
+
 error:
         /* Double-check exception status. */
 #ifdef NDEBUG
@@ -3768,9 +4705,32 @@ error:
 
 exception_unwind:
         /* Unwind stacks if an exception occurred */
-        while (f->f_iblock > 0) {
-            /* Pop the current block. */
-            PyTryBlock *b = &f->f_blockstack[--f->f_iblock];
+        try_block = -1;
+        if (f->f_quickened && co->co_exceptiontable != NULL) {
+            try_block = _PyCode_FindTryBlock(co, f->f_lasti);
+        }
+        while (f->f_iblock > 0 || try_block >= 0) {
+            PyTryBlock *b;
+            if (try_block >= 0 &&
+                (f->f_iblock == 0 ||
+                 f->f_blockstack[f->f_iblock - 1].b_level <
+                     co->co_exceptiontable->blocks[try_block].level)) {
+                /* The try block containing the failing instruction is
+                   the innermost block.  The EXCEPT_HANDLER of a block
+                   nested in it has at least its level, while a try block
+                   set up in an except handler has a higher level than
+                   the handler (which has pushed exception info). */
+                _PyTryBlockInfo *info = &co->co_exceptiontable->blocks[try_block];
+                try_block_copy.b_type = SETUP_FINALLY;
+                try_block_copy.b_handler = info->handler;
+                try_block_copy.b_level = info->level;
+                b = &try_block_copy;
+                try_block = -1;
+            }
+            else {
+                /* Pop the current block. */
+                b = &f->f_blockstack[--f->f_iblock];
+            }
 
             if (b->b_type == EXCEPT_HANDLER) {
                 UNWIND_EXCEPT_HANDLER(b);
@@ -3866,6 +4826,25 @@ exit_eval_frame:
     f->f_executing = 0;
     tstate->frame = f->f_back;
 
+    if (inline_calls > 0) {
+        /* Return to the caller, which push_frame suspended */
+        PyFrameObject *back = f->f_back;
+        retval = _Py_CheckFunctionResult(tstate, NULL, retval, __func__);
+        release_frame(tstate, f);
+        f = back;
+        inline_calls--;
+        if (retval != NULL) {
+            *(f->f_stacktop++) = retval;
+            retval = NULL;
+            throwflag = 0;
+        }
+        else {
+            /* Raise the exception in the caller */
+            throwflag = 1;
+        }
+        goto resume_frame;
+    }
+
     return _Py_CheckFunctionResult(tstate, NULL, retval, __func__);
 }
 
@@ -4090,50 +5069,20 @@ fail:
 
 }
 
-/* This is gonna seem *real weird*, but if you put some other code between
-   PyEval_EvalFrame() and _PyEval_EvalFrameDefault() you will need to adjust
-   the test in the if statements in Misc/gdbinit (pystack and pystackv). */
-
-PyObject *
-_PyEval_EvalCode(PyThreadState *tstate,
-           PyObject *_co, PyObject *globals, PyObject *locals,
-           PyObject *const *args, Py_ssize_t argcount,
-           PyObject *const *kwnames, PyObject *const *kwargs,
-           Py_ssize_t kwcount, int kwstep,
-           PyObject *const *defs, Py_ssize_t defcount,
-           PyObject *kwdefs, PyObject *closure,
-           PyObject *name, PyObject *qualname)
+/* Bind the arguments of a call to the local variables of the new frame f,
+   and set up its cell and free variables.  Return -1 with an exception
+   set on failure. */
+static int
+initialize_locals(PyThreadState *tstate, PyFrameObject *f,
+                  PyObject *const *args, Py_ssize_t argcount,
+                  PyObject *const *kwnames, PyObject *const *kwargs,
+                  Py_ssize_t kwcount, int kwstep,
+                  PyObject *const *defs, Py_ssize_t defcount,
+                  PyObject *kwdefs, PyObject *closure,
+                  PyObject *qualname)
 {
-    assert(is_tstate_valid(tstate));
-
-    PyCodeObject *co = (PyCodeObject*)_co;
-
-    if (!name) {
-        name = co->co_name;
-    }
-    assert(name != NULL);
-    assert(PyUnicode_Check(name));
-
-    if (!qualname) {
-        qualname = name;
-    }
-    assert(qualname != NULL);
-    assert(PyUnicode_Check(qualname));
-
-    PyObject *retval = NULL;
+    PyCodeObject *co = f->f_code;
     const Py_ssize_t total_args = co->co_argcount + co->co_kwonlyargcount;
-
-    if (globals == NULL) {
-        _PyErr_SetString(tstate, PyExc_SystemError,
-                         "PyEval_EvalCodeEx: NULL globals");
-        return NULL;
-    }
-
-    /* Create the frame */
-    PyFrameObject *f = _PyFrame_New_NoTrack(tstate, co, globals, locals);
-    if (f == NULL) {
-        return NULL;
-    }
     PyObject **fastlocals = f->f_localsplus;
     PyObject **freevars = f->f_localsplus + co->co_nlocals;
 
@@ -4335,6 +5284,140 @@ _PyEval_EvalCode(PyThreadState *tstate,
         freevars[PyTuple_GET_SIZE(co->co_cellvars) + i] = o;
     }
 
+    return 0;
+
+fail:
+    return -1;
+}
+
+/* Drop the reference to the frame of a finished call.  The frame is
+   tracked by the garbage collector if it is still referenced elsewhere,
+   by a traceback for instance. */
+static inline void
+release_frame(PyThreadState *tstate, PyFrameObject *f)
+{
+    /* decref'ing the frame can cause __del__ methods to get invoked,
+       which can call back into Python.  While we're done with the
+       current Python frame (f), the associated C stack is still in use,
+       so recursion_depth must be boosted for the duration.
+    */
+    if (Py_REFCNT(f) > 1) {
+        Py_DECREF(f);
+        _PyObject_GC_TRACK(f);
+    }
+    else {
+        ++tstate->recursion_depth;
+        Py_DECREF(f);
+        --tstate->recursion_depth;
+    }
+}
+
+/* Create the frame of a call to the Python function func, with arguments
+   laid out like for a vectorcall, for _PyEval_EvalFrameDefault() to run
+   it without a new C call. */
+static PyFrameObject *
+make_call_frame(PyThreadState *tstate, PyObject *func,
+                PyObject *const *args, Py_ssize_t nargs, PyObject *kwnames)
+{
+    PyCodeObject *co = (PyCodeObject *)PyFunction_GET_CODE(func);
+    PyObject *globals = PyFunction_GET_GLOBALS(func);
+    PyObject *argdefs = PyFunction_GET_DEFAULTS(func);
+    Py_ssize_t nkwargs = (kwnames == NULL) ? 0 : PyTuple_GET_SIZE(kwnames);
+    assert(!(co->co_flags & (CO_GENERATOR | CO_COROUTINE | CO_ASYNC_GENERATOR)));
+
+    PyFrameObject *f = _PyFrame_NewOnStack_NoTrack(tstate, co, globals, NULL);
+    if (f == NULL) {
+        return NULL;
+    }
+
+    /* Same fast path as _PyFunction_Vectorcall() */
+    if (co->co_kwonlyargcount == 0 && nkwargs == 0 &&
+        (co->co_flags & ~PyCF_MASK) == (CO_OPTIMIZED | CO_NEWLOCALS | CO_NOFREE))
+    {
+        if (argdefs == NULL && co->co_argcount == nargs) {
+            for (Py_ssize_t i = 0; i < nargs; i++) {
+                Py_INCREF(args[i]);
+                f->f_localsplus[i] = args[i];
+            }
+            return f;
+        }
+    }
+
+    PyObject *const *defs = NULL;
+    Py_ssize_t ndefs = 0;
+    if (argdefs != NULL) {
+        defs = _PyTuple_ITEMS(argdefs);
+        ndefs = PyTuple_GET_SIZE(argdefs);
+    }
+    if (initialize_locals(tstate, f, args, nargs,
+                          nkwargs ? _PyTuple_ITEMS(kwnames) : NULL,
+                          args + nargs, nkwargs, 1, defs, ndefs,
+                          PyFunction_GET_KW_DEFAULTS(func),
+                          PyFunction_GET_CLOSURE(func),
+                          ((PyFunctionObject *)func)->func_qualname) < 0)
+    {
+        release_frame(tstate, f);
+        return NULL;
+    }
+    return f;
+}
+
+/* This is gonna seem *real weird*, but if you put some other code between
+   PyEval_EvalFrame() and _PyEval_EvalFrameDefault() you will need to adjust
+   the test in the if statements in Misc/gdbinit (pystack and pystackv). */
+
+PyObject *
+_PyEval_EvalCode(PyThreadState *tstate,
+           PyObject *_co, PyObject *globals, PyObject *locals,
+           PyObject *const *args, Py_ssize_t argcount,
+           PyObject *const *kwnames, PyObject *const *kwargs,
+           Py_ssize_t kwcount, int kwstep,
+           PyObject *const *defs, Py_ssize_t defcount,
+           PyObject *kwdefs, PyObject *closure,
+           PyObject *name, PyObject *qualname)
+{
+    assert(is_tstate_valid(tstate));
+
+    PyCodeObject *co = (PyCodeObject*)_co;
+
+    if (!name) {
+        name = co->co_name;
+    }
+    assert(name != NULL);
+    assert(PyUnicode_Check(name));
+
+    if (!qualname) {
+        qualname = name;
+    }
+    assert(qualname != NULL);
+    assert(PyUnicode_Check(qualname));
+
+    PyObject *retval = NULL;
+
+    if (globals == NULL) {
+        _PyErr_SetString(tstate, PyExc_SystemError,
+                         "PyEval_EvalCodeEx: NULL globals");
+        return NULL;
+    }
+
+    /* Create the frame.  A generator owns its frame, which can outlive
+       any number of other calls: don't allocate it from the frame stack. */
+    PyFrameObject *f;
+    if (co->co_flags & (CO_GENERATOR | CO_COROUTINE | CO_ASYNC_GENERATOR)) {
+        f = _PyFrame_New_NoTrack(tstate, co, globals, locals);
+    }
+    else {
+        f = _PyFrame_NewOnStack_NoTrack(tstate, co, globals, locals);
+    }
+    if (f == NULL) {
+        return NULL;
+    }
+    if (initialize_locals(tstate, f, args, argcount, kwnames, kwargs,
+                          kwcount, kwstep, defs, defcount, kwdefs, closure,
+                          qualname) < 0) {
+        goto fail;
+    }
+
     /* Handle generator/coroutine/asynchronous generator */
     if (co->co_flags & (CO_GENERATOR | CO_COROUTINE | CO_ASYNC_GENERATOR)) {
         PyObject *gen;
@@ -4365,21 +5448,7 @@ _PyEval_EvalCode(PyThreadState *tstate,
     retval = _PyEval_EvalFrame(tstate, f, 0);
 
 fail: /* Jump here from prelude on failure */
-
-    /* decref'ing the frame can cause __del__ methods to get invoked,
-       which can call back into Python.  While we're done with the
-       current Python frame (f), the associated C stack is still in use,
-       so recursion_depth must be boosted for the duration.
-    */
-    if (Py_REFCNT(f) > 1) {
-        Py_DECREF(f);
-        _PyObject_GC_TRACK(f);
-    }
-    else {
-        ++tstate->recursion_depth;
-        Py_DECREF(f);
-        --tstate->recursion_depth;
-    }
+    release_frame(tstate, f);
     return retval;
 }
 
@@ -4854,6 +5923,252 @@ PyEval_SetTrace(Py_tracefunc func, PyObject *arg)
     }
 }
 
+/* Start or stop collecting the execution statistics of the interpreter.
+   While they are collected, tracing_possible is incremented, so that every
+   instruction goes through fast_next_opcode, where it is counted: the
+   statistics cost nothing when they are off. */
+int
+_PyEval_SetStats(PyThreadState *tstate, int on)
+{
+    struct _ceval_state *ceval2 = &tstate->interp->ceval;
+    if (on) {
+        if (ceval2->stats != NULL) {
+            return 0;
+        }
+        if (ceval2->stats_data == NULL) {
+            struct _Py_EvalStats *stats = PyMem_RawCalloc(1, sizeof(*stats));
+            if (stats == NULL) {
+                _PyErr_NoMemory(tstate);
+                return -1;
+            }
+            stats->code_objects = PyList_New(0);
+            if (stats->code_objects == NULL) {
+                PyMem_RawFree(stats);
+                return -1;
+            }
+            stats->prune_at = STATS_MIN_PRUNE;
+            ceval2->stats_data = stats;
+        }
+        ceval2->stats = ceval2->stats_data;
+        ceval2->tracing_possible++;
+    }
+    else if (ceval2->stats != NULL) {
+        ceval2->stats = NULL;
+        ceval2->tracing_possible--;
+    }
+    return 0;
+}
+
+void
+_PyEval_ClearStats(PyInterpreterState *interp)
+{
+    struct _Py_EvalStats *stats = interp->ceval.stats_data;
+    if (stats == NULL) {
+        return;
+    }
+    memset(stats->opcodes, 0, sizeof(stats->opcodes));
+    PyObject *codes = stats->code_objects;
+    for (Py_ssize_t i = 0; i < PyList_GET_SIZE(codes); i++) {
+        PyObject *co = PyWeakref_GET_OBJECT(PyList_GET_ITEM(codes, i));
+        if (co != Py_None) {
+            ((PyCodeObject *)co)->co_stats_calls = 0;
+        }
+    }
+    /* Deleting the items of a list cannot fail */
+    (void)PyList_SetSlice(codes, 0, PyList_GET_SIZE(codes), NULL);
+    stats->prune_at = STATS_MIN_PRUNE;
+}
+
+/* Stop collecting the statistics of the interpreter and free them */
+void
+_PyEval_FiniStats(PyInterpreterState *interp)
+{
+    struct _ceval_state *ceval2 = &interp->ceval;
+    if (ceval2->stats_data == NULL) {
+        return;
+    }
+    _PyEval_ClearStats(interp);
+    if (ceval2->stats != NULL) {
+        ceval2->stats = NULL;
+        ceval2->tracing_possible--;
+    }
+    Py_CLEAR(ceval2->stats_data->code_objects);
+    PyMem_RawFree(ceval2->stats_data);
+    ceval2->stats_data = NULL;
+}
+
+/* Return the statistics as {"opcodes": {name: {counter: value}},
+   "calls": {code: calls}}.  Only the instructions with a counter that is
+   not 0 are listed. */
+PyObject *
+_PyEval_GetStats(PyThreadState *tstate)
+{
+    struct _Py_EvalStats *stats = tstate->interp->ceval.stats_data;
+    PyObject *names = NULL, *specialized = NULL;
+    PyObject *opcodes = NULL, *calls = NULL, *result = NULL;
+
+    PyObject *module = PyImport_ImportModule("opcode");
+    if (module == NULL) {
+        return NULL;
+    }
+    PyObject *opname = PyObject_GetAttrString(module, "opname");
+    if (opname != NULL) {
+        names = PySequence_List(opname);
+        Py_DECREF(opname);
+    }
+    specialized = PyObject_GetAttrString(module, "_specialized_opmap");
+    Py_DECREF(module);
+    if (names == NULL || specialized == NULL) {
+        goto error;
+    }
+    if (PyList_GET_SIZE(names) != 256 || !PyDict_Check(specialized)) {
+        PyErr_SetString(PyExc_RuntimeError, "unexpected opcode module");
+        goto error;
+    }
+    Py_ssize_t pos = 0;
+    PyObject *name, *value;
+    while (PyDict_Next(specialized, &pos, &name, &value)) {
+        long op = PyLong_AsLong(value);
+        if (op < 0 || op > 255) {
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_RuntimeError, "invalid opcode");
+            }
+            goto error;
+        }
+        Py_INCREF(name);
+        PyList_SetItem(names, op, name);
+    }
+
+    opcodes = PyDict_New();
+    calls = PyDict_New();
+    if (opcodes == NULL || calls == NULL) {
+        goto error;
+    }
+    for (int op = 0; stats != NULL && op < 256; op++) {
+        _PyOpcodeStats counts = stats->opcodes[op];
+        if (counts.execution_count == 0 && counts.hit == 0 &&
+            counts.miss == 0 && counts.deopt == 0 &&
+            counts.specialization_success == 0 &&
+            counts.specialization_failure == 0) {
+            continue;
+        }
+        PyObject *d = Py_BuildValue(
+            "{sKsKsKsKsKsK}",
+            "execution_count", counts.execution_count,
+            "hit", counts.hit,
+            "miss", counts.miss,
+            "deopt", counts.deopt,
+            "specialization_success", counts.specialization_success,
+            "specialization_failure", counts.specialization_failure);
+        if (d == NULL ||
+            PyDict_SetItem(opcodes, PyList_GET_ITEM(names, op), d) < 0) {
+            Py_XDECREF(d);
+            goto error;
+        }
+        Py_DECREF(d);
+    }
+    for (Py_ssize_t i = 0;
+         stats != NULL && i < PyList_GET_SIZE(stats->code_objects); i++) {
+        PyObject *ref = PyList_GET_ITEM(stats->code_objects, i);
+        PyObject *co = PyWeakref_GET_OBJECT(ref);
+        if (co == Py_None) {
+            continue;
+        }
+        value = PyLong_FromUnsignedLongLong(
+            ((PyCodeObject *)co)->co_stats_calls);
+        if (value == NULL || PyDict_SetItem(calls, co, value) < 0) {
+            Py_XDECREF(value);
+            goto error;
+        }
+        Py_DECREF(value);
+    }
+    result = Py_BuildValue("{sOsO}", "opcodes", opcodes, "calls", calls);
+
+error:
+    Py_XDECREF(names);
+    Py_XDECREF(specialized);
+    Py_XDECREF(opcodes);
+    Py_XDECREF(calls);
+    return result;
+}
+
+/* Number of code objects listed by _PyEval_PrintStats() */
+#define STATS_PRINTED_CODE_OBJECTS 20
+
+static int
+print_stats(PyThreadState *tstate)
+{
+    PyObject *stats = _PyEval_GetStats(tstate);
+    if (stats == NULL) {
+        return -1;
+    }
+    PyObject *opcodes = PyDict_GetItemString(stats, "opcodes");
+    PyObject *calls = PyDict_GetItemString(stats, "calls");
+    PyObject *name, *counts, *key, *value;
+    Py_ssize_t pos = 0;
+
+    PySys_WriteStderr("Execution statistics (-X pystats):\n");
+    while (PyDict_Next(opcodes, &pos, &name, &counts)) {
+        PySys_FormatStderr("  %U:", name);
+        Py_ssize_t i = 0;
+        while (PyDict_Next(counts, &i, &key, &value)) {
+            if (PyObject_IsTrue(value)) {
+                PySys_FormatStderr(" %U=%S", key, value);
+            }
+        }
+        PySys_WriteStderr("\n");
+    }
+
+    /* The most called code objects */
+    PyObject *list = PyList_New(0);
+    if (list == NULL) {
+        Py_DECREF(stats);
+        return -1;
+    }
+    pos = 0;
+    while (PyDict_Next(calls, &pos, &key, &value)) {
+        PyCodeObject *co = (PyCodeObject *)key;
+        PyObject *item = Py_BuildValue("(OOOi)", value, co->co_name,
+                                       co->co_filename, co->co_firstlineno);
+        if (item == NULL || PyList_Append(list, item) < 0) {
+            Py_XDECREF(item);
+            goto error;
+        }
+        Py_DECREF(item);
+    }
+    if (PyList_Sort(list) < 0 || PyList_Reverse(list) < 0) {
+        goto error;
+    }
+    PySys_WriteStderr("Calls:\n");
+    for (Py_ssize_t i = 0;
+         i < PyList_GET_SIZE(list) && i < STATS_PRINTED_CODE_OBJECTS; i++) {
+        PyObject *item = PyList_GET_ITEM(list, i);
+        PySys_FormatStderr("  %S: %U (%U:%S)\n",
+                           PyTuple_GET_ITEM(item, 0),
+                           PyTuple_GET_ITEM(item, 1),
+                           PyTuple_GET_ITEM(item, 2),
+                           PyTuple_GET_ITEM(item, 3));
+    }
+    Py_DECREF(list);
+    Py_DECREF(stats);
+    return 0;
+
+error:
+    Py_DECREF(list);
+    Py_DECREF(stats);
+    return -1;
+}
+
+/* Write the statistics to stderr (-X pystats) */
+void
+_PyEval_PrintStats(PyThreadState *tstate)
+{
+    if (print_stats(tstate) < 0) {
+        _PyErr_WriteUnraisableMsg("while printing execution statistics",
+                                  NULL);
+    }
+}
+
 
 void
 _PyEval_SetCoroutineOriginTrackingDepth(PyThreadState *tstate, int new_depth)
@@ -5551,6 +6866,8 @@ unicode_concatenate(PyThreadState *tstate, PyObject *v, PyObject *w,
         NEXTOPARG();
         switch (opcode) {
         case STORE_FAST:
+        case STORE_FAST__LOAD_FAST:
+        case STORE_FAST__STORE_FAST:
         {
             PyObject **fastlocals = f->f_localsplus;
             if (GETLOCAL(oparg) == v)
@@ -47,6 +47,23 @@
      run and end up being the first to re-acquire it, making the "timeslices"
      much longer than expected.
      (Note: this mechanism is enabled with FORCE_SWITCHING above)
+
+   - The above gives no ordering guarantee between waiting threads: a
+     CPU-bound thread which drops the GIL can take it again before the
+     waiting threads get scheduled, and starve a thread coming back from
+     blocking I/O for many intervals.  In the FIFO and priority scheduling
+     modes (see sys._setgilmode()), threads which have to wait are queued
+     in gil->waiters and drop_gil() hands the GIL off to the first one
+     without unlocking it.  In priority mode, the queue is ordered by the
+     threads' priorities, and threads coming back from a blocking call go
+     before threads which were forced to drop the GIL.
+
+   - When enabled with sys._setgilstats() (or when the gil__take or
+     gil__drop DTrace probes are enabled), the time spent waiting for and
+     holding the GIL is measured and accumulated in the gil_stats of the
+     thread states.  The holder records the time it took the GIL in the
+     GIL itself (stats_holder, stats_hold_start) so that drop_gil() never
+     needs to access a thread state which may be dangling.
 */
 
 #include "condvar.h"
@@ -73,6 +90,9 @@
 #define COND_SIGNAL(cond) \
     if (PyCOND_SIGNAL(&(cond))) { \
         Py_FatalError("PyCOND_SIGNAL(" #cond ") failed"); };
+#define COND_BROADCAST(cond) \
+    if (PyCOND_BROADCAST(&(cond))) { \
+        Py_FatalError("PyCOND_BROADCAST(" #cond ") failed"); };
 #define COND_WAIT(cond, mut) \
     if (PyCOND_WAIT(&(cond), &(mut))) { \
         Py_FatalError("PyCOND_WAIT(" #cond ") failed"); };
@@ -95,6 +115,8 @@ static void _gil_initialize(struct _gil_runtime_state *gil)
     _Py_atomic_int uninitialized = {-1};
     gil->locked = uninitialized;
     gil->interval = DEFAULT_INTERVAL;
+    gil->mode = _PyGIL_MODE_DEFAULT;
+    gil->stats_enabled = 0;
 }
 
 static int gil_created(struct _gil_runtime_state *gil)
@@ -113,6 +135,8 @@ static void create_gil(struct _gil_runtime_state *gil)
     COND_INIT(gil->switch_cond);
 #endif
     _Py_atomic_store_relaxed(&gil->last_holder, 0);
+    gil->waiters = NULL;
+    gil->stats_holder = NULL;
     _Py_ANNOTATE_RWLOCK_CREATE(&gil->locked);
     _Py_atomic_store_explicit(&gil->locked, 0, _Py_memory_order_release);
 }
@@ -140,19 +164,134 @@ static void recreate_gil(struct _gil_runtime_state *gil)
     create_gil(gil);
 }
 
+static inline int
+gil_stats_collected(struct _gil_runtime_state *gil)
+{
+    return (gil->stats_enabled
+            || PyDTrace_GIL_TAKE_ENABLED()
+            || PyDTrace_GIL_DROP_ENABLED());
+}
+
+/* Called by the thread which just took the GIL.  tstate must be valid. */
+static void
+gil_stats_take(struct _gil_runtime_state *gil, PyThreadState *tstate,
+               int contended, _PyTime_t wait_start)
+{
+    _PyGILStats *stats = &tstate->gil_stats;
+    _PyTime_t now = _PyTime_GetPerfCounter();
+    _PyTime_t wait = 0;
+
+    stats->acquisitions++;
+    if (contended) {
+        wait = now - wait_start;
+        stats->contended++;
+        stats->wait_time += wait;
+    }
+    gil->stats_holder = tstate;
+    gil->stats_hold_start = now;
+
+    if (PyDTrace_GIL_TAKE_ENABLED()) {
+        PyDTrace_GIL_TAKE(wait);
+    }
+}
+
+/* Called by the GIL holder just before dropping it.  Only the time is
+   recorded: the code which was running is looked up by gil_stats_resume(),
+   since reference counts can't be touched here. */
+static void
+gil_stats_drop(struct _gil_runtime_state *gil, int forced)
+{
+    PyThreadState *holder = gil->stats_holder;
+    _PyGILStats *stats = &holder->gil_stats;
+    _PyTime_t hold = _PyTime_GetPerfCounter() - gil->stats_hold_start;
+
+    gil->stats_holder = NULL;
+    stats->hold_time += hold;
+    if (forced) {
+        stats->forced_drops++;
+    }
+    if (hold > stats->max_hold_time) {
+        stats->max_hold_time = hold;
+        stats->max_hold_pending = 1;
+    }
+
+    if (PyDTrace_GIL_DROP_ENABLED()) {
+        PyDTrace_GIL_DROP(hold, forced);
+    }
+}
+
+/* Called when tstate runs again after having dropped the GIL: its frame
+   is still the one which was running when the GIL was dropped.
+   tstate must be the current thread state. */
+static inline void
+gil_stats_resume(PyThreadState *tstate)
+{
+    _PyGILStats *stats = &tstate->gil_stats;
+    if (!stats->max_hold_pending) {
+        return;
+    }
+    stats->max_hold_pending = 0;
+
+    PyFrameObject *frame = tstate->frame;
+    PyObject *code = NULL;
+    int lineno = -1;
+    if (frame != NULL) {
+        code = (PyObject *)frame->f_code;
+        Py_INCREF(code);
+        lineno = PyFrame_GetLineNumber(frame);
+    }
+    stats->max_hold_lineno = lineno;
+    Py_XSETREF(stats->max_hold_code, code);
+}
+
+/* Return 1 if waiter a must take the GIL before waiter b. */
+static inline int
+gil_waiter_precedes(struct _gil_waiter *a, struct _gil_waiter *b)
+{
+    if (a->priority != b->priority) {
+        return a->priority > b->priority;
+    }
+    return a->boost > b->boost;
+}
+
+/* gil->mutex must be held. */
+static void
+gil_enqueue(struct _gil_runtime_state *gil, struct _gil_waiter *waiter)
+{
+    struct _gil_waiter **p = &gil->waiters;
+    while (*p != NULL && !gil_waiter_precedes(waiter, *p)) {
+        p = &(*p)->next;
+    }
+    waiter->next = *p;
+    *p = waiter;
+}
+
+/* gil->mutex must be held. */
+static void
+gil_dequeue(struct _gil_runtime_state *gil, struct _gil_waiter *waiter)
+{
+    struct _gil_waiter **p = &gil->waiters;
+    while (*p != waiter) {
+        assert(*p != NULL);
+        p = &(*p)->next;
+    }
+    *p = waiter->next;
+}
+
 static void
 drop_gil(struct _ceval_runtime_state *ceval, struct _ceval_state *ceval2,
          PyThreadState *tstate)
 {
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    struct _gil_runtime_state *gil = &ceval2->gil;
-#else
-    struct _gil_runtime_state *gil = &ceval->gil;
-#endif
+    struct _gil_runtime_state *gil = ceval2->gil;
     if (!_Py_atomic_load_relaxed(&gil->locked)) {
         Py_FatalError("drop_gil: GIL is not locked");
     }
 
+    if (gil->stats_holder != NULL) {
+        gil_stats_drop(gil,
+                       _Py_atomic_load_relaxed(&ceval2->gil_drop_request));
+    }
+
     /* tstate is allowed to be NULL (early interpreter init) */
     if (tstate != NULL) {
         /* Sub-interpreter support: threads might have been switched
@@ -163,8 +302,18 @@ drop_gil(struct _ceval_runtime_state *ceval, struct _ceval_state *ceval2,
 
     MUTEX_LOCK(gil->mutex);
     _Py_ANNOTATE_RWLOCK_RELEASED(&gil->locked, /*is_write=*/1);
-    _Py_atomic_store_relaxed(&gil->locked, 0);
-    COND_SIGNAL(gil->cond);
+    struct _gil_waiter *waiter = gil->waiters;
+    if (waiter != NULL) {
+        /* Hand the GIL off to the first waiter: it stays locked so that
+           no other thread can take it first. */
+        gil->waiters = waiter->next;
+        waiter->granted = 1;
+        COND_BROADCAST(gil->cond);
+    }
+    else {
+        _Py_atomic_store_relaxed(&gil->locked, 0);
+        COND_SIGNAL(gil->cond);
+    }
     MUTEX_UNLOCK(gil->mutex);
 
 #ifdef FORCE_SWITCHING
@@ -210,9 +359,12 @@ tstate_must_exit(PyThreadState *tstate)
 
    The function saves errno at entry and restores its value at exit.
 
+   preempted is 1 if the thread has just dropped the GIL on request of
+   another thread, 0 if it comes back from a blocking call.
+
    tstate must be non-NULL. */
 static void
-take_gil(PyThreadState *tstate)
+take_gil(PyThreadState *tstate, int preempted)
 {
     int err = errno;
 
@@ -232,22 +384,37 @@ take_gil(PyThreadState *tstate)
     PyInterpreterState *interp = tstate->interp;
     struct _ceval_runtime_state *ceval = &interp->runtime->ceval;
     struct _ceval_state *ceval2 = &interp->ceval;
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    struct _gil_runtime_state *gil = &ceval2->gil;
-#else
-    struct _gil_runtime_state *gil = &ceval->gil;
-#endif
+    struct _gil_runtime_state *gil = ceval2->gil;
 
     /* Check that _PyEval_InitThreads() was called to create the lock */
     assert(gil_created(gil));
 
+    int collect_stats = gil_stats_collected(gil);
+    int contended = 0;
+    _PyTime_t wait_start = 0;
+
     MUTEX_LOCK(gil->mutex);
 
     if (!_Py_atomic_load_relaxed(&gil->locked)) {
         goto _ready;
     }
 
-    while (_Py_atomic_load_relaxed(&gil->locked)) {
+    contended = 1;
+    if (collect_stats) {
+        wait_start = _PyTime_GetPerfCounter();
+    }
+
+    struct _gil_waiter waiter;
+    int queued = (gil->mode != _PyGIL_MODE_DEFAULT);
+    waiter.granted = 0;
+    if (queued) {
+        int priority_mode = (gil->mode == _PyGIL_MODE_PRIORITY);
+        waiter.priority = priority_mode ? tstate->gil_priority : 0;
+        waiter.boost = priority_mode ? !preempted : 0;
+        gil_enqueue(gil, &waiter);
+    }
+
+    while (queued ? !waiter.granted : _Py_atomic_load_relaxed(&gil->locked)) {
         unsigned long saved_switchnum = gil->switch_number;
 
         unsigned long interval = (gil->interval >= 1 ? gil->interval : 1);
@@ -257,16 +424,26 @@ take_gil(PyThreadState *tstate)
         /* If we timed out and no switch occurred in the meantime, it is time
            to ask the GIL-holding thread to drop it. */
         if (timed_out &&
+            !waiter.granted &&
             _Py_atomic_load_relaxed(&gil->locked) &&
             gil->switch_number == saved_switchnum)
         {
             if (tstate_must_exit(tstate)) {
+                if (queued) {
+                    gil_dequeue(gil, &waiter);
+                }
                 MUTEX_UNLOCK(gil->mutex);
                 PyThread_exit_thread();
             }
             assert(is_tstate_valid(tstate));
 
             SET_GIL_DROP_REQUEST(interp);
+            if (collect_stats) {
+                tstate->gil_stats.drop_requests++;
+            }
+            if (PyDTrace_GIL_DROP_REQUEST_ENABLED()) {
+                PyDTrace_GIL_DROP_REQUEST();
+            }
         }
     }
 
@@ -304,6 +481,10 @@ _ready:
     }
     assert(is_tstate_valid(tstate));
 
+    if (collect_stats) {
+        gil_stats_take(gil, tstate, contended, wait_start);
+    }
+
     if (_Py_atomic_load_relaxed(&ceval2->gil_drop_request)) {
         RESET_GIL_DROP_REQUEST(interp);
     }
@@ -328,22 +509,46 @@ _ready:
 
 void _PyEval_SetSwitchInterval(unsigned long microseconds)
 {
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
     PyInterpreterState *interp = PyInterpreterState_Get();
-    struct _gil_runtime_state *gil = &interp->ceval.gil;
-#else
-    struct _gil_runtime_state *gil = &_PyRuntime.ceval.gil;
-#endif
+    struct _gil_runtime_state *gil = interp->ceval.gil;
     gil->interval = microseconds;
 }
 
 unsigned long _PyEval_GetSwitchInterval()
 {
-#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
     PyInterpreterState *interp = PyInterpreterState_Get();
-    struct _gil_runtime_state *gil = &interp->ceval.gil;
-#else
-    struct _gil_runtime_state *gil = &_PyRuntime.ceval.gil;
-#endif
+    struct _gil_runtime_state *gil = interp->ceval.gil;
     return gil->interval;
 }
+
+void _PyEval_SetGILStats(int enabled)
+{
+    PyInterpreterState *interp = PyInterpreterState_Get();
+    struct _gil_runtime_state *gil = interp->ceval.gil;
+    gil->stats_enabled = enabled;
+}
+
+int _PyEval_GetGILStats(void)
+{
+    PyInterpreterState *interp = PyInterpreterState_Get();
+    struct _gil_runtime_state *gil = interp->ceval.gil;
+    return gil->stats_enabled;
+}
+
+void _PyEval_SetGILMode(int mode)
+{
+    PyInterpreterState *interp = PyInterpreterState_Get();
+    struct _gil_runtime_state *gil = interp->ceval.gil;
+    /* Threads already queued keep being handed the GIL off until the
+       queue is empty, whatever the mode. */
+    MUTEX_LOCK(gil->mutex);
+    gil->mode = mode;
+    MUTEX_UNLOCK(gil->mutex);
+}
+
+int _PyEval_GetGILMode(void)
+{
+    PyInterpreterState *interp = PyInterpreterState_Get();
+    struct _gil_runtime_state *gil = interp->ceval.gil;
+    return gil->mode;
+}
@@ -350,6 +350,190 @@ exit:
     return return_value;
 }
 
+PyDoc_STRVAR(sys__setgilstats__doc__,
+"_setgilstats($module, enabled, /)\n"
+"--\n"
+"\n"
+"Enable or disable the collection of GIL statistics.\n"
+"\n"
+"The statistics are collected for the GIL of the current interpreter.\n"
+"See sys._getgilstats().");
+
+#define SYS__SETGILSTATS_METHODDEF    \
+    {"_setgilstats", (PyCFunction)sys__setgilstats, METH_O, sys__setgilstats__doc__},
+
+static PyObject *
+sys__setgilstats_impl(PyObject *module, int enabled);
+
+static PyObject *
+sys__setgilstats(PyObject *module, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    int enabled;
+
+    enabled = PyObject_IsTrue(arg);
+    if (enabled < 0) {
+        goto exit;
+    }
+    return_value = sys__setgilstats_impl(module, enabled);
+
+exit:
+    return return_value;
+}
+
+PyDoc_STRVAR(sys__getgilstats__doc__,
+"_getgilstats($module, /)\n"
+"--\n"
+"\n"
+"Return a dict mapping each thread\'s thread id to its GIL statistics.\n"
+"\n"
+"Only threads of the current interpreter are included.  The statistics\n"
+"of each thread are a dict with the following keys:\n"
+"\n"
+"  acquisitions: number of times the thread took the GIL\n"
+"  contended: number of acquisitions which waited for another thread\n"
+"  drop_requests: number of times the thread asked the holder to drop it\n"
+"  forced_drops: number of times the thread dropped it on request\n"
+"  wait_time: total time spent waiting for the GIL, in seconds\n"
+"  hold_time: total time the GIL was held, in seconds\n"
+"  max_hold_time: longest time the GIL was held at once, in seconds\n"
+"  max_hold_code: code object running when that hold ended, or None\n"
+"  max_hold_lineno: line number running when that hold ended, or None\n"
+"\n"
+"Statistics are only collected while enabled with sys._setgilstats().");
+
+#define SYS__GETGILSTATS_METHODDEF    \
+    {"_getgilstats", (PyCFunction)sys__getgilstats, METH_NOARGS, sys__getgilstats__doc__},
+
+static PyObject *
+sys__getgilstats_impl(PyObject *module);
+
+static PyObject *
+sys__getgilstats(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return sys__getgilstats_impl(module);
+}
+
+PyDoc_STRVAR(sys__setgilmode__doc__,
+"_setgilmode($module, mode, /)\n"
+"--\n"
+"\n"
+"Set the scheduling mode of the GIL of the current interpreter.\n"
+"\n"
+"\"default\": the GIL goes to whichever thread takes it first.\n"
+"\"fifo\": threads waiting for the GIL get it in the order they asked for it.\n"
+"\"priority\": like \"fifo\", but threads with a higher priority (see\n"
+"sys._setgilpriority()) go first, and threads coming back from a blocking\n"
+"call go before threads which were forced to drop the GIL.");
+
+#define SYS__SETGILMODE_METHODDEF    \
+    {"_setgilmode", (PyCFunction)sys__setgilmode, METH_O, sys__setgilmode__doc__},
+
+static PyObject *
+sys__setgilmode_impl(PyObject *module, const char *mode);
+
+static PyObject *
+sys__setgilmode(PyObject *module, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    const char *mode;
+
+    if (!PyUnicode_Check(arg)) {
+        _PyArg_BadArgument("_setgilmode", "argument", "str", arg);
+        goto exit;
+    }
+    Py_ssize_t mode_length;
+    mode = PyUnicode_AsUTF8AndSize(arg, &mode_length);
+    if (mode == NULL) {
+        goto exit;
+    }
+    if (strlen(mode) != (size_t)mode_length) {
+        PyErr_SetString(PyExc_ValueError, "embedded null character");
+        goto exit;
+    }
+    return_value = sys__setgilmode_impl(module, mode);
+
+exit:
+    return return_value;
+}
+
+PyDoc_STRVAR(sys__getgilmode__doc__,
+"_getgilmode($module, /)\n"
+"--\n"
+"\n"
+"Return the scheduling mode of the GIL; see sys._setgilmode().");
+
+#define SYS__GETGILMODE_METHODDEF    \
+    {"_getgilmode", (PyCFunction)sys__getgilmode, METH_NOARGS, sys__getgilmode__doc__},
+
+static PyObject *
+sys__getgilmode_impl(PyObject *module);
+
+static PyObject *
+sys__getgilmode(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return sys__getgilmode_impl(module);
+}
+
+PyDoc_STRVAR(sys__setgilpriority__doc__,
+"_setgilpriority($module, priority, /)\n"
+"--\n"
+"\n"
+"Set the GIL priority of the current thread.\n"
+"\n"
+"The priority is only used by the \"priority\" GIL mode; threads with a\n"
+"higher priority take the GIL first.  The default priority is 0.");
+
+#define SYS__SETGILPRIORITY_METHODDEF    \
+    {"_setgilpriority", (PyCFunction)sys__setgilpriority, METH_O, sys__setgilpriority__doc__},
+
+static PyObject *
+sys__setgilpriority_impl(PyObject *module, int priority);
+
+static PyObject *
+sys__setgilpriority(PyObject *module, PyObject *arg)
+{
+    PyObject *return_value = NULL;
+    int priority;
+
+    priority = _PyLong_AsInt(arg);
+    if (priority == -1 && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = sys__setgilpriority_impl(module, priority);
+
+exit:
+    return return_value;
+}
+
+PyDoc_STRVAR(sys__getgilpriority__doc__,
+"_getgilpriority($module, /)\n"
+"--\n"
+"\n"
+"Return the GIL priority of the current thread.");
+
+#define SYS__GETGILPRIORITY_METHODDEF    \
+    {"_getgilpriority", (PyCFunction)sys__getgilpriority, METH_NOARGS, sys__getgilpriority__doc__},
+
+static int
+sys__getgilpriority_impl(PyObject *module);
+
+static PyObject *
+sys__getgilpriority(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *return_value = NULL;
+    int _return_value;
+
+    _return_value = sys__getgilpriority_impl(module);
+    if ((_return_value == -1) && PyErr_Occurred()) {
+        goto exit;
+    }
+    return_value = PyLong_FromLong((long)_return_value);
+
+exit:
+    return return_value;
+}
+
 PyDoc_STRVAR(sys_setrecursionlimit__doc__,
 "setrecursionlimit($module, limit, /)\n"
 "--\n"
@@ -878,6 +1062,88 @@ sys__clear_type_cache(PyObject *module, PyObject *Py_UNUSED(ignored))
     return sys__clear_type_cache_impl(module);
 }
 
+PyDoc_STRVAR(sys__stats_on__doc__,
+"_stats_on($module, /)\n"
+"--\n"
+"\n"
+"Start collecting execution statistics in the current interpreter.\n"
+"\n"
+"Executions of each instruction, hits and misses of the opcode caches,\n"
+"specializations and deoptimizations, and calls of code objects are\n"
+"counted until sys._stats_off() is called.");
+
+#define SYS__STATS_ON_METHODDEF    \
+    {"_stats_on", (PyCFunction)sys__stats_on, METH_NOARGS, sys__stats_on__doc__},
+
+static PyObject *
+sys__stats_on_impl(PyObject *module);
+
+static PyObject *
+sys__stats_on(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return sys__stats_on_impl(module);
+}
+
+PyDoc_STRVAR(sys__stats_off__doc__,
+"_stats_off($module, /)\n"
+"--\n"
+"\n"
+"Stop collecting execution statistics in the current interpreter.\n"
+"\n"
+"The statistics are kept until sys._stats_clear() is called.");
+
+#define SYS__STATS_OFF_METHODDEF    \
+    {"_stats_off", (PyCFunction)sys__stats_off, METH_NOARGS, sys__stats_off__doc__},
+
+static PyObject *
+sys__stats_off_impl(PyObject *module);
+
+static PyObject *
+sys__stats_off(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return sys__stats_off_impl(module);
+}
+
+PyDoc_STRVAR(sys__stats_clear__doc__,
+"_stats_clear($module, /)\n"
+"--\n"
+"\n"
+"Reset the execution statistics of the current interpreter.");
+
+#define SYS__STATS_CLEAR_METHODDEF    \
+    {"_stats_clear", (PyCFunction)sys__stats_clear, METH_NOARGS, sys__stats_clear__doc__},
+
+static PyObject *
+sys__stats_clear_impl(PyObject *module);
+
+static PyObject *
+sys__stats_clear(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return sys__stats_clear_impl(module);
+}
+
+PyDoc_STRVAR(sys__stats_dump__doc__,
+"_stats_dump($module, /)\n"
+"--\n"
+"\n"
+"Return the execution statistics of the current interpreter.\n"
+"\n"
+"The result is a dict.  Its \"opcodes\" item maps the name of each\n"
+"instruction that was counted to a dict of its counters, and its \"calls\"\n"
+"item maps code objects to the number of times they were entered.");
+
+#define SYS__STATS_DUMP_METHODDEF    \
+    {"_stats_dump", (PyCFunction)sys__stats_dump, METH_NOARGS, sys__stats_dump__doc__},
+
+static PyObject *
+sys__stats_dump_impl(PyObject *module);
+
+static PyObject *
+sys__stats_dump(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return sys__stats_dump_impl(module);
+}
+
 PyDoc_STRVAR(sys_is_finalizing__doc__,
 "is_finalizing($module, /)\n"
 "--\n"
@@ -945,4 +1211,4 @@ sys_getandroidapilevel(PyObject *module, PyObject *Py_UNUSED(ignored))
 #ifndef SYS_GETANDROIDAPILEVEL_METHODDEF
     #define SYS_GETANDROIDAPILEVEL_METHODDEF
 #endif /* !defined(SYS_GETANDROIDAPILEVEL_METHODDEF) */
-/*[clinic end generated code: output=87baa3357293ea65 input=a9049054013a1b77]*/
+/*[clinic end generated code: output=6fb942c127eb0302 input=a9049054013a1b77]*/
@@ -7,9 +7,9 @@
  *   1. Checks for future statements.  See future.c
  *   2. Builds a symbol table.  See symtable.c.
  *   3. Generate code for basic blocks.  See compiler_mod() in this file.
- *   4. Assemble the basic blocks into final code.  See assemble() in
+ *   4. Optimize the basic blocks.  See optimize_cfg() in this file.
+ *   5. Assemble the basic blocks into final code.  See assemble() in
  *      this file.
- *   5. Optimize the byte code (peephole optimizations).  See peephole.c
  *
  * Note that compiler_mod() suggests module, but the module ast type
  * (mod_ty) has cases for expressions and interactive statements.
@@ -126,6 +126,8 @@ struct compiler_unit {
     PyObject *u_freevars;  /* free variables */
 
     PyObject *u_private;        /* for private name mangling */
+    PyObject *u_inlined;  /* symbol table entries of the comprehensions
+                             being compiled inline, innermost last */
 
     Py_ssize_t u_argcount;        /* number of arguments for block */
     Py_ssize_t u_posonlyargcount;        /* number of positional only arguments for block */
@@ -516,7 +518,7 @@ compiler_unit_check(struct compiler_unit *u)
         assert((uintptr_t)block != 0xdbdbdbdbU);
         if (block->b_instr != NULL) {
             assert(block->b_ialloc > 0);
-            assert(block->b_iused > 0);
+            assert(block->b_iused >= 0);
             assert(block->b_ialloc >= block->b_iused);
         }
         else {
@@ -549,6 +551,7 @@ compiler_unit_free(struct compiler_unit *u)
     Py_CLEAR(u->u_freevars);
     Py_CLEAR(u->u_cellvars);
     Py_CLEAR(u->u_private);
+    Py_CLEAR(u->u_inlined);
     PyObject_Free(u);
 }
 
@@ -623,6 +626,11 @@ compiler_enter_scope(struct compiler *c, identifier name,
         compiler_unit_free(u);
         return 0;
     }
+    u->u_inlined = PyList_New(0);
+    if (!u->u_inlined) {
+        compiler_unit_free(u);
+        return 0;
+    }
 
     u->u_private = NULL;
 
@@ -1049,6 +1057,8 @@ stack_effect(int opcode, int oparg, int jump)
             return -1;
         case DELETE_FAST:
             return 0;
+        case LOAD_FAST_AND_CLEAR:
+            return 1;
 
         case RAISE_VARARGS:
             return -oparg;
@@ -3089,6 +3099,7 @@ compiler_try_except(struct compiler *c, stmt_ty s)
         ADDOP(c, POP_TOP);
         if (handler->v.ExceptHandler.name) {
             basicblock *cleanup_end, *cleanup_body;
+            int lineno;
 
             cleanup_end = compiler_new_block(c);
             cleanup_body = compiler_new_block(c);
@@ -3130,12 +3141,18 @@ compiler_try_except(struct compiler *c, stmt_ty s)
             /* except: */
             compiler_use_next_block(c, cleanup_end);
 
-            /* name = None; del name */
+            /* name = None; del name
+               This code has no line number: the last statement of the
+               body may have been removed as unreachable, and tracing
+               must not report it. */
+            lineno = c->u->u_lineno;
+            c->u->u_lineno = 0;
             ADDOP_LOAD_CONST(c, Py_None);
             compiler_nameop(c, handler->v.ExceptHandler.name, Store);
             compiler_nameop(c, handler->v.ExceptHandler.name, Del);
 
             ADDOP(c, RERAISE);
+            c->u->u_lineno = lineno;
         }
         else {
             basicblock *cleanup_body;
@@ -3550,7 +3567,7 @@ static int
 compiler_nameop(struct compiler *c, identifier name, expr_context_ty ctx)
 {
     int op, scope;
-    Py_ssize_t arg;
+    Py_ssize_t arg, i;
     enum { OP_FAST, OP_GLOBAL, OP_DEREF, OP_NAME } optype;
 
     PyObject *dict = c->u->u_names;
@@ -3569,7 +3586,17 @@ compiler_nameop(struct compiler *c, identifier name, expr_context_ty ctx)
 
     op = 0;
     optype = OP_NAME;
-    scope = PyST_GetScope(c->u->u_ste, mangled);
+    scope = 0;
+    /* The names of an inlined comprehension are resolved in its scope
+       first, the free ones in the scopes enclosing it */
+    for (i = PyList_GET_SIZE(c->u->u_inlined) - 1; i >= 0; i--) {
+        PyObject *ste = PyList_GET_ITEM(c->u->u_inlined, i);
+        scope = PyST_GetScope((PySTEntryObject *)ste, mangled);
+        if (scope != 0 && scope != FREE)
+            break;
+    }
+    if (i < 0)
+        scope = PyST_GetScope(c->u->u_ste, mangled);
     switch (scope) {
     case FREE:
         dict = c->u->u_freevars;
@@ -4410,12 +4437,8 @@ compiler_sync_comprehension_generator(struct compiler *c,
 
     gen = (comprehension_ty)asdl_seq_GET(generators, gen_index);
 
-    if (gen_index == 0) {
-        /* Receive outermost iter as an implicit argument */
-        c->u->u_argcount = 1;
-        ADDOP_I(c, LOAD_FAST, 0);
-    }
-    else {
+    /* The outermost iterator is already on the stack */
+    if (gen_index > 0) {
         /* Sub-iter - calculate on the fly */
         /* Fast path for the temporary variable assignment idiom:
              for y in [f(x)]
@@ -4524,12 +4547,8 @@ compiler_async_comprehension_generator(struct compiler *c,
 
     gen = (comprehension_ty)asdl_seq_GET(generators, gen_index);
 
-    if (gen_index == 0) {
-        /* Receive outermost iter as an implicit argument */
-        c->u->u_argcount = 1;
-        ADDOP_I(c, LOAD_FAST, 0);
-    }
-    else {
+    /* The outermost iterator is already on the stack */
+    if (gen_index > 0) {
         /* Sub-iter - calculate on the fly */
         VISIT(c, expr, gen->iter);
         ADDOP(c, GET_AITER);
@@ -4596,6 +4615,125 @@ compiler_async_comprehension_generator(struct compiler *c,
     return 1;
 }
 
+/* Emit the code saving the variables bound by the inlined comprehension
+   entry to hidden locals of the function, and clearing them, or restoring
+   them if restore is true.  The number in the name of the hidden locals is
+   the nesting depth of the comprehension, since the variables of nested
+   comprehensions are saved at the same time. */
+
+static int
+compiler_save_comprehension_locals(struct compiler *c, PySTEntryObject *entry,
+                                   Py_ssize_t depth, int restore)
+{
+    PyObject *name, *v, *hidden;
+    Py_ssize_t pos = 0;
+
+    while (PyDict_Next(entry->ste_symbols, &pos, &name, &v)) {
+        long flags = PyLong_AS_LONG(v);
+        if (((flags >> SCOPE_OFFSET) & SCOPE_MASK) != LOCAL ||
+            (flags & DEF_PARAM))
+            continue;
+        hidden = PyUnicode_FromFormat(".%zd.%U", depth, name);
+        if (hidden == NULL)
+            return 0;
+        if (!compiler_addop_o(c, LOAD_FAST_AND_CLEAR, c->u->u_varnames,
+                              restore ? hidden : name) ||
+            !compiler_addop_o(c, STORE_FAST, c->u->u_varnames,
+                              restore ? name : hidden)) {
+            Py_DECREF(hidden);
+            return 0;
+        }
+        Py_DECREF(hidden);
+    }
+    return 1;
+}
+
+/* Compile a list, set or dict comprehension in the code of the enclosing
+   function rather than as a nested function called with the outermost
+   iterator (see inline_comprehensions() in symtable.c).  The variables it
+   binds are fast locals of the function, which are saved before the loop
+   and restored after it, even if it raises:
+
+       <outermost iterable>
+       GET_ITER
+       LOAD_FAST_AND_CLEAR      x
+       STORE_FAST               .0.x
+       SETUP_FINALLY            L
+       BUILD_LIST               0
+       ROT_TWO
+       <loop>
+       POP_BLOCK
+       LOAD_FAST_AND_CLEAR      .0.x
+       STORE_FAST               x
+       JUMP_FORWARD             E
+   L:  LOAD_FAST_AND_CLEAR      .0.x
+       STORE_FAST               x
+       RERAISE
+   E:
+*/
+
+static int
+compiler_inlined_comprehension(struct compiler *c, PySTEntryObject *entry,
+                               int type, asdl_seq *generators, expr_ty elt,
+                               expr_ty val)
+{
+    comprehension_ty outermost;
+    basicblock *handler, *end;
+    Py_ssize_t depth = PyList_GET_SIZE(c->u->u_inlined);
+    int op, res;
+
+    handler = compiler_new_block(c);
+    end = compiler_new_block(c);
+    if (handler == NULL || end == NULL)
+        return 0;
+
+    /* The outermost iterable is evaluated in the enclosing scope */
+    outermost = (comprehension_ty) asdl_seq_GET(generators, 0);
+    VISIT(c, expr, outermost->iter);
+    ADDOP(c, GET_ITER);
+
+    if (!compiler_save_comprehension_locals(c, entry, depth, 0))
+        return 0;
+    ADDOP_JREL(c, SETUP_FINALLY, handler);
+    switch (type) {
+    case COMP_LISTCOMP:
+        op = BUILD_LIST;
+        break;
+    case COMP_SETCOMP:
+        op = BUILD_SET;
+        break;
+    case COMP_DICTCOMP:
+        op = BUILD_MAP;
+        break;
+    default:
+        PyErr_Format(PyExc_SystemError,
+                     "unknown comprehension type %d", type);
+        return 0;
+    }
+    ADDOP_I(c, op, 0);
+    ADDOP(c, ROT_TWO);
+
+    if (PyList_Append(c->u->u_inlined, (PyObject *)entry) < 0)
+        return 0;
+    res = compiler_comprehension_generator(c, generators, 0, 0, elt, val,
+                                           type);
+    if (PyList_SetSlice(c->u->u_inlined, depth, depth + 1, NULL) < 0 || !res)
+        return 0;
+
+    ADDOP(c, POP_BLOCK);
+    if (!compiler_save_comprehension_locals(c, entry, depth, 1))
+        return 0;
+    ADDOP_JREL(c, JUMP_FORWARD, end);
+
+    compiler_use_next_block(c, handler);
+    if (!compiler_save_comprehension_locals(c, entry, depth, 1))
+        return 0;
+    ADDOP(c, RERAISE);
+
+    compiler_use_next_block(c, end);
+    return 1;
+}
+
 static int
 compiler_comprehension(struct compiler *c, expr_ty e, int type,
                        identifier name, asdl_seq *generators, expr_ty elt,
@@ -4603,6 +4741,7 @@ compiler_comprehension(struct compiler *c, expr_ty e, int type,
 {
     PyCodeObject *co = NULL;
     comprehension_ty outermost;
+    PySTEntryObject *entry;
     PyObject *qualname = NULL;
     int is_async_generator = 0;
 
@@ -4611,6 +4750,17 @@ compiler_comprehension(struct compiler *c, expr_ty e, int type,
     }
     int is_async_function = c->u->u_ste->ste_coroutine;
 
+    entry = PySymtable_Lookup(c->c_st, (void *)e);
+    if (entry == NULL)
+        goto error;
+    if (entry->ste_comp_inlined) {
+        int res = compiler_inlined_comprehension(c, entry, type, generators,
+                                                 elt, val);
+        Py_DECREF(entry);
+        return res;
+    }
+    Py_DECREF(entry);
+
     outermost = (comprehension_ty) asdl_seq_GET(generators, 0);
     if (!compiler_enter_scope(c, name, COMPILER_SCOPE_COMPREHENSION,
                               (void *)e, e->lineno))
@@ -4647,6 +4797,10 @@ compiler_comprehension(struct compiler *c, expr_ty e, int type,
         ADDOP_I(c, op, 0);
     }
 
+    /* Receive outermost iter as an implicit argument */
+    c->u->u_argcount = 1;
+    ADDOP_I(c, LOAD_FAST, 0);
+
     if (!compiler_comprehension_generator(c, generators, 0, 0, elt,
                                           val, type))
         goto error_in_scope;
@@ -5461,6 +5615,20 @@ dfs(struct compiler *c, basicblock *b, struct assembler *a, int end)
     }
 }
 
+#define UNCONDITIONAL_JUMP(op) ((op) == JUMP_ABSOLUTE || (op) == JUMP_FORWARD)
+#define JUMPS_ON_TRUE(op) ((op) == POP_JUMP_IF_TRUE || (op) == JUMP_IF_TRUE_OR_POP)
+#define IS_JUMP(i) ((i)->i_jabs || (i)->i_jrel)
+
+/* Return 1 if the instruction after opcode is never reached from it. */
+static int
+is_block_exit(int opcode)
+{
+    return (UNCONDITIONAL_JUMP(opcode) ||
+            opcode == RETURN_VALUE ||
+            opcode == RAISE_VARARGS ||
+            opcode == RERAISE);
+}
+
 Py_LOCAL_INLINE(void)
 stackdepth_push(basicblock ***sp, basicblock *b, int depth)
 {
@@ -5524,12 +5692,7 @@ stackdepth(struct compiler *c)
                 stackdepth_push(&sp, instr->i_target, target_depth);
             }
             depth = new_depth;
-            if (instr->i_opcode == JUMP_ABSOLUTE ||
-                instr->i_opcode == JUMP_FORWARD ||
-                instr->i_opcode == RETURN_VALUE ||
-                instr->i_opcode == RAISE_VARARGS ||
-                instr->i_opcode == RERAISE)
-            {
+            if (is_block_exit(instr->i_opcode)) {
                 /* remaining code is dead */
                 next = NULL;
                 break;
@@ -5806,7 +5969,7 @@ consts_dict_keys_inorder(PyObject *dict)
     PyObject *consts, *k, *v;
     Py_ssize_t i, pos = 0, size = PyDict_GET_SIZE(dict);
 
-    consts = PyList_New(size);   /* PyCode_Optimize() requires a list */
+    consts = PyList_New(size);   /* optimize_cfg() appends to the list */
     if (consts == NULL)
         return NULL;
     while (PyDict_Next(dict, &pos, &k, &v)) {
@@ -5888,9 +6051,8 @@ merge_const_tuple(struct compiler *c, PyObject **tuple)
 }
 
 static PyCodeObject *
-makecode(struct compiler *c, struct assembler *a)
+makecode(struct compiler *c, struct assembler *a, PyObject *constslist)
 {
-    PyObject *tmp;
     PyCodeObject *co = NULL;
     PyObject *consts = NULL;
     PyObject *names = NULL;
@@ -5898,16 +6060,14 @@ makecode(struct compiler *c, struct assembler *a)
     PyObject *name = NULL;
     PyObject *freevars = NULL;
     PyObject *cellvars = NULL;
-    PyObject *bytecode = NULL;
     Py_ssize_t nlocals;
     int nlocals_int;
     int flags;
     int posorkeywordargcount, posonlyargcount, kwonlyargcount, maxdepth;
 
-    consts = consts_dict_keys_inorder(c->u->u_consts);
     names = dict_keys_inorder(c->u->u_names, 0);
     varnames = dict_keys_inorder(c->u->u_varnames, 0);
-    if (!consts || !names || !varnames)
+    if (!names || !varnames)
         goto error;
 
     cellvars = dict_keys_inorder(c->u->u_cellvars, 0);
@@ -5933,15 +6093,9 @@ makecode(struct compiler *c, struct assembler *a)
     if (flags < 0)
         goto error;
 
-    bytecode = PyCode_Optimize(a->a_bytecode, consts, names, a->a_lnotab);
-    if (!bytecode)
+    consts = PyList_AsTuple(constslist); /* PyCode_New requires a tuple */
+    if (!consts)
         goto error;
-
-    tmp = PyList_AsTuple(consts); /* PyCode_New requires a tuple */
-    if (!tmp)
-        goto error;
-    Py_DECREF(consts);
-    consts = tmp;
     if (!merge_const_tuple(c, &consts)) {
         goto error;
     }
@@ -5955,7 +6109,7 @@ makecode(struct compiler *c, struct assembler *a)
     }
     co = PyCode_NewWithPosOnlyArgs(posonlyargcount+posorkeywordargcount,
                                    posonlyargcount, kwonlyargcount, nlocals_int,
-                                   maxdepth, flags, bytecode, consts, names,
+                                   maxdepth, flags, a->a_bytecode, consts, names,
                                    varnames, freevars, cellvars, c->c_filename,
                                    c->u->u_name, c->u->u_firstlineno, a->a_lnotab);
  error:
@@ -5965,7 +6119,6 @@ makecode(struct compiler *c, struct assembler *a)
     Py_XDECREF(name);
     Py_XDECREF(freevars);
     Py_XDECREF(cellvars);
-    Py_XDECREF(bytecode);
     return co;
 }
 
@@ -6004,6 +6157,529 @@ dump_basicblock(const basicblock *b)
 }
 #endif
 
+/* Control flow graph optimization
+
+   optimize_cfg() rewrites the basic blocks of a code unit before they are
+   assembled.  Jump targets are blocks, so jumps can be threaded and dead
+   blocks dropped without decoding the bytecode, instructions which become
+   useless are removed rather than padded with NOPs, and the line number
+   table is built afterwards from the line numbers of the instructions
+   which remain.  NOPs are only kept when they are the sole instruction of
+   a line, so that tracing still reports it.
+
+   The blocks built by the compiler are not strictly basic: a conditional
+   jump can be followed by more instructions of the same block, but an
+   unconditional jump, a return or a raise always ends the live part of its
+   block.
+*/
+
+static void
+instr_set_op(struct instr *i, int opcode, int oparg)
+{
+    i->i_opcode = opcode;
+    i->i_oparg = oparg;
+    i->i_jabs = i->i_jrel = 0;
+    i->i_target = NULL;
+}
+
+/* Return the first block with instructions starting from b, or NULL. */
+static basicblock *
+skip_empty_blocks(basicblock *b)
+{
+    while (b != NULL && b->b_iused == 0) {
+        b = b->b_next;
+    }
+    return b;
+}
+
+/* Split b before its instruction at index.  The second half becomes the
+   block reached from b by normal control flow. */
+static basicblock *
+split_block(struct compiler *c, basicblock *b, int index)
+{
+    assert(0 < index && index < b->b_iused);
+    basicblock *tail = compiler_new_block(c);
+    if (tail == NULL) {
+        return NULL;
+    }
+    for (int i = index; i < b->b_iused; i++) {
+        int off = compiler_next_instr(tail);
+        if (off < 0) {
+            return NULL;
+        }
+        tail->b_instr[off] = b->b_instr[i];
+    }
+    tail->b_return = b->b_return;
+    tail->b_next = b->b_next;
+    b->b_next = tail;
+    b->b_iused = index;
+    b->b_return = 0;
+    return tail;
+}
+
+/* Replace LOAD_CONST c1, LOAD_CONST c2 ... LOAD_CONST cn, BUILD_TUPLE n
+   with LOAD_CONST (c1, c2, ... cn).  The new constant is added to the
+   compiler's table and appended to consts if it was not there already.
+   Return -1 on error. */
+static int
+fold_tuple_on_constants(struct compiler *c, struct instr *inst, int n,
+                        PyObject *consts)
+{
+    assert(inst[n].i_opcode == BUILD_TUPLE && inst[n].i_oparg == n);
+    for (int i = 0; i < n; i++) {
+        if (inst[i].i_opcode != LOAD_CONST) {
+            return 0;
+        }
+    }
+
+    PyObject *newconst = PyTuple_New(n);
+    if (newconst == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        PyObject *constant = PyList_GET_ITEM(consts, inst[i].i_oparg);
+        Py_INCREF(constant);
+        PyTuple_SET_ITEM(newconst, i, constant);
+    }
+    Py_ssize_t index = compiler_add_const(c, newconst);
+    if (index < 0 ||
+        (index == PyList_GET_SIZE(consts) &&
+         PyList_Append(consts, newconst) < 0))
+    {
+        Py_DECREF(newconst);
+        return -1;
+    }
+    Py_DECREF(newconst);
+    assert(index < PyList_GET_SIZE(consts));
+    if (index > INT_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "too many constants");
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        instr_set_op(&inst[i], NOP, 0);
+    }
+    instr_set_op(&inst[n], LOAD_CONST, (int)index);
+    return 0;
+}
+
+/* Make the jump inst go where the unconditional jump target goes.  A
+   relative jump becomes absolute, as the new target can come before it.
+   Return 1 if the target changed. */
+static int
+thread_jump(struct instr *inst, struct instr *target)
+{
+    assert(IS_JUMP(target) && UNCONDITIONAL_JUMP(target->i_opcode));
+    if (inst->i_target == target->i_target) {
+        return 0;
+    }
+    if (inst->i_opcode == JUMP_FORWARD) {
+        inst->i_opcode = JUMP_ABSOLUTE;
+        inst->i_jrel = 0;
+        inst->i_jabs = 1;
+    }
+    inst->i_target = target->i_target;
+    return 1;
+}
+
+/* Constant propagation across blocks: bb ends with LOAD_CONST and falls
+   through to a block which starts with a conditional jump, whose outcome is
+   then known.  Jump straight to where the conditional jump goes.  Return 1
+   if bb changed, 0 if not and -1 on error. */
+static int
+propagate_constant(struct compiler *c, basicblock *bb, PyObject *consts)
+{
+    struct instr *inst = &bb->b_instr[bb->b_iused - 1];
+    basicblock *nb = skip_empty_blocks(bb->b_next);
+    assert(inst->i_opcode == LOAD_CONST);
+    if (nb == NULL || nb == bb) {
+        return 0;
+    }
+    int opcode = nb->b_instr[0].i_opcode;
+    if (opcode != POP_JUMP_IF_FALSE && opcode != POP_JUMP_IF_TRUE &&
+        opcode != JUMP_IF_FALSE_OR_POP && opcode != JUMP_IF_TRUE_OR_POP) {
+        return 0;
+    }
+    int is_true = PyObject_IsTrue(PyList_GET_ITEM(consts, inst->i_oparg));
+    if (is_true < 0) {
+        return -1;
+    }
+
+    basicblock *target;
+    if (is_true == JUMPS_ON_TRUE(opcode)) {
+        target = nb->b_instr[0].i_target;
+        if (opcode == JUMP_IF_FALSE_OR_POP || opcode == JUMP_IF_TRUE_OR_POP) {
+            /* The constant stays on the stack */
+            int off = compiler_next_instr(bb);
+            if (off < 0) {
+                return -1;
+            }
+            inst = &bb->b_instr[off];
+            inst->i_lineno = bb->b_instr[off - 1].i_lineno;
+        }
+    }
+    else {
+        if (nb->b_iused > 1 && split_block(c, nb, 1) == NULL) {
+            return -1;
+        }
+        target = nb->b_next;
+        if (target == NULL) {
+            return 0;
+        }
+    }
+    instr_set_op(inst, JUMP_ABSOLUTE, 0);
+    inst->i_jabs = 1;
+    inst->i_target = target;
+    return 1;
+}
+
+/* Limit on the number of times a jump is threaded, so that a cycle of
+   unconditional jumps is left alone instead of being followed forever. */
+#define MAX_JUMP_THREADING 16
+
+/* Optimize the instructions of a single block.  Return -1 on error. */
+static int
+optimize_basic_block(struct compiler *c, basicblock *bb, PyObject *consts)
+{
+    int threaded = 0;
+    for (int i = 0; i < bb->b_iused; i++) {
+        struct instr *inst = &bb->b_instr[i];
+        struct instr *next = i + 1 < bb->b_iused ? inst + 1 : NULL;
+        int nextop = next != NULL ? next->i_opcode : 0;
+        struct instr *target = NULL;
+        int opcode = inst->i_opcode;
+        int is_true;
+
+        if (IS_JUMP(inst)) {
+            basicblock *tb = skip_empty_blocks(inst->i_target);
+            if (tb != NULL) {
+                inst->i_target = tb;
+                target = &tb->b_instr[0];
+            }
+        }
+
+        switch (opcode) {
+            /* Constant conditions:
+               LOAD_CONST c; POP_JUMP_IF_X  --> JUMP_ABSOLUTE or nothing
+               LOAD_CONST c; JUMP_IF_X_OR_POP  --> LOAD_CONST c; JUMP_ABSOLUTE
+                                                   or nothing
+               LOAD_CONST c; POP_TOP  --> nothing */
+            case LOAD_CONST:
+                if (next == NULL) {
+                    int res = propagate_constant(c, bb, consts);
+                    if (res < 0) {
+                        return -1;
+                    }
+                    if (res > 0) {
+                        i--;
+                        continue;
+                    }
+                    break;
+                }
+                switch (nextop) {
+                    case POP_JUMP_IF_FALSE:
+                    case POP_JUMP_IF_TRUE:
+                    case JUMP_IF_FALSE_OR_POP:
+                    case JUMP_IF_TRUE_OR_POP:
+                        is_true = PyObject_IsTrue(
+                            PyList_GET_ITEM(consts, inst->i_oparg));
+                        if (is_true < 0) {
+                            return -1;
+                        }
+                        if (is_true == JUMPS_ON_TRUE(nextop)) {
+                            if (nextop == POP_JUMP_IF_FALSE ||
+                                nextop == POP_JUMP_IF_TRUE) {
+                                instr_set_op(inst, NOP, 0);
+                            }
+                            next->i_opcode = JUMP_ABSOLUTE;
+                        }
+                        else {
+                            instr_set_op(inst, NOP, 0);
+                            instr_set_op(next, NOP, 0);
+                        }
+                        break;
+                    case POP_TOP:
+                        instr_set_op(inst, NOP, 0);
+                        instr_set_op(next, NOP, 0);
+                        break;
+                }
+                break;
+
+            /* DUP_TOP; POP_TOP  --> nothing */
+            case DUP_TOP:
+                if (nextop == POP_TOP) {
+                    instr_set_op(inst, NOP, 0);
+                    instr_set_op(next, NOP, 0);
+                }
+                break;
+
+            /* ROT_TWO; ROT_TWO  --> nothing */
+            case ROT_TWO:
+                if (nextop == ROT_TWO) {
+                    instr_set_op(inst, NOP, 0);
+                    instr_set_op(next, NOP, 0);
+                }
+                break;
+
+            /* STORE_FAST x; STORE_FAST x  --> POP_TOP; STORE_FAST x */
+            case STORE_FAST:
+                if (nextop == STORE_FAST && next->i_oparg == inst->i_oparg &&
+                    next->i_lineno == inst->i_lineno) {
+                    instr_set_op(inst, POP_TOP, 0);
+                    /* Look again at the instruction before: DUP_TOP */
+                    if (i > 0) {
+                        i -= 2;
+                        continue;
+                    }
+                }
+                break;
+
+            /* Try to fold tuples of constants.
+               Skip over BUILD_SEQN 1 UNPACK_SEQN 1.
+               Replace BUILD_SEQN 2 UNPACK_SEQN 2 with ROT2.
+               Replace BUILD_SEQN 3 UNPACK_SEQN 3 with ROT3 ROT2. */
+            case BUILD_TUPLE:
+                if (nextop == UNPACK_SEQUENCE &&
+                    next->i_oparg == inst->i_oparg &&
+                    inst->i_oparg <= 3) {
+                    switch (inst->i_oparg) {
+                        case 0:
+                        case 1:
+                            instr_set_op(inst, NOP, 0);
+                            instr_set_op(next, NOP, 0);
+                            break;
+                        case 2:
+                            instr_set_op(inst, ROT_TWO, 0);
+                            instr_set_op(next, NOP, 0);
+                            break;
+                        case 3:
+                            instr_set_op(inst, ROT_THREE, 0);
+                            instr_set_op(next, ROT_TWO, 0);
+                            break;
+                    }
+                    break;
+                }
+                if (inst->i_oparg > 0 && i >= inst->i_oparg) {
+                    if (fold_tuple_on_constants(c, inst - inst->i_oparg,
+                                                inst->i_oparg, consts) < 0) {
+                        return -1;
+                    }
+                }
+                break;
+
+            /* Simplify conditional jump to conditional jump where the
+               result of the first test implies the success of a similar
+               test or the failure of the opposite test.
+               Arises in code like:
+               "a and b or c"
+               "(a and b) and c"
+               "(a or b) or c"
+               "(a or b) and c"
+               x:JUMP_IF_FALSE_OR_POP y   y:JUMP_IF_FALSE_OR_POP z
+                  -->  x:JUMP_IF_FALSE_OR_POP z
+               x:JUMP_IF_FALSE_OR_POP y   y:JUMP_IF_TRUE_OR_POP z
+                  -->  x:POP_JUMP_IF_FALSE y+1
+               where y+1 is the instruction following the second test.
+            */
+            case JUMP_IF_FALSE_OR_POP:
+            case JUMP_IF_TRUE_OR_POP:
+                if (target == NULL) {
+                    break;
+                }
+                switch (target->i_opcode) {
+                    case POP_JUMP_IF_FALSE:
+                    case POP_JUMP_IF_TRUE:
+                    case JUMP_IF_FALSE_OR_POP:
+                    case JUMP_IF_TRUE_OR_POP:
+                        if (threaded++ >= MAX_JUMP_THREADING) {
+                            break;
+                        }
+                        if (JUMPS_ON_TRUE(target->i_opcode) ==
+                            JUMPS_ON_TRUE(opcode)) {
+                            /* The second jump will be taken iff the first
+                               is.  The current opcode inherits its
+                               target's stack effect */
+                            inst->i_opcode = target->i_opcode;
+                            inst->i_target = target->i_target;
+                        }
+                        else {
+                            /* The second jump is not taken if the first is
+                               (so jump past it), and all conditional jumps
+                               pop their argument when they're not taken
+                               (so change the first jump to pop its argument
+                               when it's taken). */
+                            basicblock *tb = inst->i_target;
+                            if (tb == bb) {
+                                break;
+                            }
+                            if (tb->b_iused > 1 &&
+                                split_block(c, tb, 1) == NULL) {
+                                return -1;
+                            }
+                            if (tb->b_next == NULL) {
+                                break;
+                            }
+                            inst->i_opcode = JUMPS_ON_TRUE(opcode) ?
+                                POP_JUMP_IF_TRUE : POP_JUMP_IF_FALSE;
+                            inst->i_target = tb->b_next;
+                        }
+                        i--;
+                        continue;
+                }
+                /* Intentional fallthrough */
+
+            /* Replace jumps to unconditional jumps */
+            case POP_JUMP_IF_FALSE:
+            case POP_JUMP_IF_TRUE:
+            case JUMP_FORWARD:
+            case JUMP_ABSOLUTE:
+                if (target == NULL) {
+                    break;
+                }
+                /* Replace JUMP_* to a RETURN into just a RETURN */
+                if (UNCONDITIONAL_JUMP(opcode) &&
+                    target->i_opcode == RETURN_VALUE) {
+                    instr_set_op(inst, RETURN_VALUE, 0);
+                }
+                else if (UNCONDITIONAL_JUMP(target->i_opcode) &&
+                         threaded < MAX_JUMP_THREADING &&
+                         thread_jump(inst, target)) {
+                    threaded++;
+                    i--;
+                    continue;
+                }
+                break;
+        }
+        threaded = 0;
+    }
+    return 0;
+}
+
+/* Remove the NOPs of a block, except those which carry the only
+   instruction of their line, and the instructions which follow an exit
+   from the block. */
+static void
+clean_basic_block(basicblock *bb)
+{
+    int dest = 0;
+    int prev_lineno = -1;
+    for (int src = 0; src < bb->b_iused; src++) {
+        struct instr *inst = &bb->b_instr[src];
+        int lineno = inst->i_lineno;
+        if (inst->i_opcode == NOP) {
+            /* A NOP is not needed if its line number is already set */
+            if (lineno == 0 || lineno == prev_lineno) {
+                continue;
+            }
+            /* or can be moved to the next instruction. */
+            if (src + 1 < bb->b_iused) {
+                struct instr *next = inst + 1;
+                if (next->i_lineno == 0 || next->i_lineno == lineno) {
+                    next->i_lineno = lineno;
+                    continue;
+                }
+            }
+            else {
+                basicblock *nb = skip_empty_blocks(bb->b_next);
+                if (nb != NULL && nb->b_instr[0].i_lineno == lineno) {
+                    continue;
+                }
+            }
+        }
+        if (dest != src) {
+            bb->b_instr[dest] = *inst;
+        }
+        dest++;
+        prev_lineno = lineno;
+        if (is_block_exit(inst->i_opcode)) {
+            break;
+        }
+    }
+    bb->b_iused = dest;
+}
+
+/* Return 1 if control flows from the end of b to b->b_next. */
+static int
+falls_through(basicblock *b)
+{
+    return b->b_iused == 0 ||
+           !is_block_exit(b->b_instr[b->b_iused - 1].i_opcode);
+}
+
+/* Remove the instructions of the blocks which cannot be reached from
+   entryblock.  Return -1 on error. */
+static int
+eliminate_unreachable_blocks(struct compiler *c, basicblock *entryblock)
+{
+    basicblock *b, **stack, **sp;
+    int nblocks = 0;
+    for (b = c->u->u_blocks; b != NULL; b = b->b_list) {
+        b->b_seen = 0;
+        nblocks++;
+    }
+    stack = (basicblock **)PyObject_Malloc(sizeof(basicblock *) * nblocks);
+    if (stack == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    sp = stack;
+    entryblock->b_seen = 1;
+    *sp++ = entryblock;
+    while (sp != stack) {
+        b = *--sp;
+        if (b->b_next != NULL && !b->b_next->b_seen && falls_through(b)) {
+            b->b_next->b_seen = 1;
+            *sp++ = b->b_next;
+        }
+        for (int i = 0; i < b->b_iused; i++) {
+            basicblock *target = b->b_instr[i].i_target;
+            if (IS_JUMP(&b->b_instr[i]) && !target->b_seen) {
+                target->b_seen = 1;
+                *sp++ = target;
+            }
+        }
+    }
+    PyObject_Free(stack);
+
+    for (b = c->u->u_blocks; b != NULL; b = b->b_list) {
+        if (!b->b_seen) {
+            b->b_iused = 0;
+        }
+        b->b_seen = 0;
+    }
+    return 0;
+}
+
+static int
+optimize_cfg(struct compiler *c, basicblock *entryblock, PyObject *consts)
+{
+    basicblock *b;
+    for (b = c->u->u_blocks; b != NULL; b = b->b_list) {
+        if (optimize_basic_block(c, b, consts) < 0) {
+            return -1;
+        }
+        clean_basic_block(b);
+    }
+    if (eliminate_unreachable_blocks(c, entryblock) < 0) {
+        return -1;
+    }
+    /* Now that dead blocks are empty, remove the jumps to the block
+       which comes next anyway. */
+    for (b = c->u->u_blocks; b != NULL; b = b->b_list) {
+        basicblock *next = skip_empty_blocks(b->b_next);
+        while (b->b_iused > 0 && next != NULL) {
+            struct instr *last = &b->b_instr[b->b_iused - 1];
+            if (!UNCONDITIONAL_JUMP(last->i_opcode) ||
+                skip_empty_blocks(last->i_target) != next) {
+                break;
+            }
+            instr_set_op(last, NOP, 0);
+            clean_basic_block(b);
+        }
+    }
+    return 0;
+}
+
 static PyCodeObject *
 assemble(struct compiler *c, int addNone)
 {
@@ -6011,6 +6687,7 @@ assemble(struct compiler *c, int addNone)
     struct assembler a;
     int i, j, nblocks;
     PyCodeObject *co = NULL;
+    PyObject *consts = NULL;
 
     /* Make sure every block that falls off the end returns None.
        XXX NEXT_BLOCK() isn't quite right, because if the last
@@ -6037,6 +6714,20 @@ assemble(struct compiler *c, int addNone)
         else
             c->u->u_firstlineno = 1;
     }
+
+    consts = consts_dict_keys_inorder(c->u->u_consts);
+    if (consts == NULL)
+        return NULL;
+    if (optimize_cfg(c, entryblock, consts) < 0) {
+        Py_DECREF(consts);
+        return NULL;
+    }
+    /* optimize_cfg() can split blocks */
+    nblocks = 0;
+    for (b = c->u->u_blocks; b != NULL; b = b->b_list) {
+        nblocks++;
+    }
+
     if (!assemble_init(&a, nblocks, c->u->u_firstlineno))
         goto error;
     dfs(c, entryblock, &a, nblocks);
@@ -6057,12 +6748,24 @@ assemble(struct compiler *c, int addNone)
     if (_PyBytes_Resize(&a.a_bytecode, a.a_offset * sizeof(_Py_CODEUNIT)) < 0)
         goto error;
 
-    co = makecode(c, &a);
+    co = makecode(c, &a, consts);
  error:
+    Py_XDECREF(consts);
     assemble_free(&a);
     return co;
 }
 
+/* Retained for API compatibility.  Bytecode is now optimized by
+   optimize_cfg() before it is assembled. */
+
+PyObject *
+PyCode_Optimize(PyObject *code, PyObject* Py_UNUSED(consts),
+                PyObject *Py_UNUSED(names), PyObject *Py_UNUSED(lnotab_obj))
+{
+    Py_INCREF(code);
+    return code;
+}
+
 #undef PyAST_Compile
 PyCodeObject *
 PyAST_Compile(mod_ty mod, const char *filename, PyCompilerFlags *flags,
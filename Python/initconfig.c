@@ -72,7 +72,10 @@ static const char usage_3[] = "\
 -X opt : set implementation-specific option. The following options are available:\n\
 \n\
          -X faulthandler: enable faulthandler\n\
+         -X jit: compile hot functions to machine code; also PYTHONJIT\n\
          -X oldparser: enable the traditional LL(1) parser; also PYTHONOLDPARSER\n\
+         -X pystats: collect execution statistics and write them to stderr\n\
+             at exit (see sys._stats_on())\n\
          -X showrefcount: output the total reference count and number of used\n\
              memory blocks when the program finishes or after each statement in the\n\
              interactive interpreter. This only works on debug builds\n\
@@ -118,7 +121,8 @@ static const char usage_5[] =
 "PYTHONCASEOK : ignore case in 'import' statements (Windows).\n"
 "PYTHONUTF8: if set to 1, enable the UTF-8 mode.\n"
 "PYTHONIOENCODING: Encoding[:errors] used for stdin/stdout/stderr.\n"
-"PYTHONFAULTHANDLER: dump the Python traceback on fatal errors.\n";
+"PYTHONFAULTHANDLER: dump the Python traceback on fatal errors.\n"
+"PYTHONJIT: compile hot functions to machine code.\n";
 static const char usage_6[] =
 "PYTHONHASHSEED: if this variable is set to 'random', a random value is used\n"
 "   to seed the hashes of str and bytes objects.  It can also be set to an\n"
@@ -637,6 +641,8 @@ _PyConfig_InitCompatConfig(PyConfig *config)
     config->pathconfig_warnings = -1;
     config->_init_main = 1;
     config->_isolated_interpreter = 0;
+    config->_use_jit = 0;
+    config->_pystats = 0;
 #ifdef MS_WINDOWS
     config->legacy_windows_stdio = -1;
 #endif
@@ -858,6 +864,8 @@ _PyConfig_Copy(PyConfig *config, const PyConfig *config2)
     COPY_ATTR(_init_main);
     COPY_ATTR(_isolated_interpreter);
     COPY_WSTRLIST(_orig_argv);
+    COPY_ATTR(_use_jit);
+    COPY_ATTR(_pystats);
 
 #undef COPY_ATTR
 #undef COPY_WSTR_ATTR
@@ -960,6 +968,8 @@ config_as_dict(const PyConfig *config)
     SET_ITEM_INT(_init_main);
     SET_ITEM_INT(_isolated_interpreter);
     SET_ITEM_WSTRLIST(_orig_argv);
+    SET_ITEM_INT(_use_jit);
+    SET_ITEM_INT(_pystats);
 
     return dict;
 
@@ -1456,6 +1466,15 @@ config_read_complex_options(PyConfig *config)
         config->_use_peg_parser = 0;
     }
 
+    if (config_get_env(config, "PYTHONJIT")
+       || config_get_xoption(config, L"jit")) {
+        config->_use_jit = 1;
+    }
+
+    if (config_get_xoption(config, L"pystats")) {
+        config->_pystats = 1;
+    }
+
     PyStatus status;
     if (config->tracemalloc < 0) {
         status = config_init_tracemalloc(config);
@@ -2550,6 +2569,8 @@ PyConfig_Read(PyConfig *config)
     assert(config->use_environment >= 0);
     assert(config->dev_mode >= 0);
     assert(config->_use_peg_parser >= 0);
+    assert(config->_use_jit >= 0);
+    assert(config->_pystats >= 0);
     assert(config->install_signal_handlers >= 0);
     assert(config->use_hash_seed >= 0);
     assert(config->faulthandler >= 0);
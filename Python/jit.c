@@ -0,0 +1,1848 @@
+/* Baseline JIT compiler for x86-64 (-X jit).
+
+   When a code object has been called or has looped JIT_MIN_RUNS times (see
+   ceval.c), _PyJIT_Compile() translates its bytecode to machine code, one
+   template per instruction.  The machine code works on the frame exactly
+   like the interpreter does, so that either can pick up where the other
+   left off (see Include/internal/pycore_jit.h):
+
+   - The simple instructions (LOAD_FAST, STORE_FAST, LOAD_CONST, POP_TOP,
+     jumps...) are generated inline.  The top of the value stack lives in a
+     register, and the pushes and pops of consecutive inline instructions
+     are folded into the addressing of the stack slots: the register is only
+     updated before calls, jumps and jump targets.
+
+   - The other supported instructions call one of the jit_XXX() helpers
+     below, which does the work of the instruction on the value stack.
+     Helpers can also decline to run the instruction (JIT_DEOPT), for
+     instance when it would raise an exception whose message only the
+     interpreter knows how to format.
+
+   - Every other instruction leaves the machine code: the interpreter
+     continues the frame from that instruction.  It enters the machine code
+     again at the next JUMP_ABSOLUTE.  Calls to Python functions also leave
+     it, so that the interpreter runs them without C recursion (see
+     push_frame in ceval.c); the machine code continues when they return.
+
+   The machine code also gives control back to the interpreter when an
+   instruction raises (so that exception handling, tracebacks and the
+   exception table are the interpreter's), when a backward jump finds the
+   eval breaker set, and when a helper turned on tracing or profiling.
+
+   Register usage (all callee-saved in the System V AMD64 ABI):
+
+       rbx  stack pointer, minus the pending pushes (see sp_offset)
+       r12  f->f_localsplus
+       r13  the _PyJITState
+       r14  the eval breaker
+       r15  the frame
+*/
+
+#include "Python.h"
+#include "pycore_code.h"          // _PyOpcache
+#include "pycore_dict.h"          // DK_ENTRIES()
+#include "pycore_jit.h"
+#include "pycore_list.h"          // _PyListIterObject
+#include "pycore_object.h"
+#include "pycore_pystate.h"       // _PyThreadState_GET()
+#include "pycore_range.h"         // _PyRangeIterObject
+
+#include "frameobject.h"
+#include "longintrepr.h"
+#include "opcode.h"
+
+#ifdef _Py_JIT_SUPPORTED
+
+#include <stddef.h>               // offsetof()
+#include <sys/mman.h>
+
+#ifndef MAP_ANONYMOUS
+#  define MAP_ANONYMOUS MAP_ANON
+#endif
+
+/* Returned by a helper which did nothing: the interpreter runs the
+   instruction instead */
+#define JIT_DEOPT 1
+
+
+/* Helpers */
+
+/* Is x an int with at most one digit?  (As in ceval.c) */
+#define IS_MEDIUM_INT(x) (Py_ABS(Py_SIZE(x)) <= 1)
+
+static inline sdigit
+medium_int_value(PyObject *x)
+{
+    PyLongObject *v = (PyLongObject *)x;
+    assert(IS_MEDIUM_INT(x));
+    return Py_SIZE(v) < 0 ? -(sdigit)v->ob_digit[0] :
+           (Py_SIZE(v) == 0 ? (sdigit)0 : (sdigit)v->ob_digit[0]);
+}
+
+/* Each helper does the work of an instruction on the value stack, whose
+   top is sp[-1].  oparg is the argument of the instruction unless stated
+   otherwise, and arg is an address computed by the compiler.  A helper
+   returns 0 on success, JIT_DEOPT, or -1 with an exception set and the
+   value stack left like the interpreter leaves it when the instruction
+   fails (the compiler knows its level). */
+typedef int (*jit_helper)(PyObject **sp, int oparg, _PyJITState *st,
+                          void *arg);
+
+/* The binary operations without a helper of their own, except for the
+   powers (see jit_binary_op()) */
+static const binaryfunc binary_ops[256] = {
+    [BINARY_MATRIX_MULTIPLY] = PyNumber_MatrixMultiply,
+    [BINARY_FLOOR_DIVIDE] = PyNumber_FloorDivide,
+    [BINARY_TRUE_DIVIDE] = PyNumber_TrueDivide,
+    [BINARY_MODULO] = PyNumber_Remainder,
+    [BINARY_LSHIFT] = PyNumber_Lshift,
+    [BINARY_RSHIFT] = PyNumber_Rshift,
+    [BINARY_AND] = PyNumber_And,
+    [BINARY_XOR] = PyNumber_Xor,
+    [BINARY_OR] = PyNumber_Or,
+    [INPLACE_MATRIX_MULTIPLY] = PyNumber_InPlaceMatrixMultiply,
+    [INPLACE_FLOOR_DIVIDE] = PyNumber_InPlaceFloorDivide,
+    [INPLACE_TRUE_DIVIDE] = PyNumber_InPlaceTrueDivide,
+    [INPLACE_MODULO] = PyNumber_InPlaceRemainder,
+    [INPLACE_LSHIFT] = PyNumber_InPlaceLshift,
+    [INPLACE_RSHIFT] = PyNumber_InPlaceRshift,
+    [INPLACE_AND] = PyNumber_InPlaceAnd,
+    [INPLACE_XOR] = PyNumber_InPlaceXor,
+    [INPLACE_OR] = PyNumber_InPlaceOr,
+};
+
+/* oparg is the opcode */
+static int
+jit_binary_op(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *right = sp[-1];
+    PyObject *left = sp[-2];
+    PyObject *res;
+    if (oparg == BINARY_POWER) {
+        res = PyNumber_Power(left, right, Py_None);
+    }
+    else if (oparg == INPLACE_POWER) {
+        res = PyNumber_InPlacePower(left, right, Py_None);
+    }
+    else {
+        res = binary_ops[oparg](left, right);
+    }
+    Py_DECREF(left);
+    Py_DECREF(right);
+    sp[-2] = res;
+    return res != NULL ? 0 : -1;
+}
+
+/* Common part of BINARY_ADD and INPLACE_ADD.  oparg is the local variable
+   which the next instruction stores the result to, or -1. */
+static inline int
+add(PyObject **sp, int oparg, _PyJITState *st, binaryfunc generic)
+{
+    PyObject *right = sp[-1];
+    PyObject *left = sp[-2];
+    PyObject *sum;
+    if (PyLong_CheckExact(left) && PyLong_CheckExact(right) &&
+        IS_MEDIUM_INT(left) && IS_MEDIUM_INT(right)) {
+        sum = PyLong_FromLong((long)medium_int_value(left) +
+                              medium_int_value(right));
+        Py_DECREF(left);
+    }
+    else if (PyFloat_CheckExact(left) && PyFloat_CheckExact(right)) {
+        sum = PyFloat_FromDouble(PyFloat_AS_DOUBLE(left) +
+                                 PyFloat_AS_DOUBLE(right));
+        Py_DECREF(left);
+    }
+    else if (PyUnicode_CheckExact(left) && PyUnicode_CheckExact(right)) {
+        /* Like unicode_concatenate() in ceval.c: let PyUnicode_Append()
+           resize left in place when the variable holding it is about to
+           be overwritten. */
+        PyObject **fastlocals = st->frame->f_localsplus;
+        if (oparg >= 0 && Py_REFCNT(left) == 2 &&
+            fastlocals[oparg] == left) {
+            fastlocals[oparg] = NULL;
+            Py_DECREF(left);
+        }
+        sum = left;
+        PyUnicode_Append(&sum, right);
+    }
+    else {
+        sum = generic(left, right);
+        Py_DECREF(left);
+    }
+    Py_DECREF(right);
+    sp[-2] = sum;
+    return sum != NULL ? 0 : -1;
+}
+
+static int
+jit_binary_add(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    return add(sp, oparg, st, PyNumber_Add);
+}
+
+static int
+jit_inplace_add(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    return add(sp, oparg, st, PyNumber_InPlaceAdd);
+}
+
+/* oparg is the opcode */
+static int
+jit_subtract(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *right = sp[-1];
+    PyObject *left = sp[-2];
+    PyObject *res;
+    if (PyLong_CheckExact(left) && PyLong_CheckExact(right) &&
+        IS_MEDIUM_INT(left) && IS_MEDIUM_INT(right)) {
+        res = PyLong_FromLong((long)medium_int_value(left) -
+                              medium_int_value(right));
+    }
+    else if (PyFloat_CheckExact(left) && PyFloat_CheckExact(right)) {
+        res = PyFloat_FromDouble(PyFloat_AS_DOUBLE(left) -
+                                 PyFloat_AS_DOUBLE(right));
+    }
+    else if (oparg == INPLACE_SUBTRACT) {
+        res = PyNumber_InPlaceSubtract(left, right);
+    }
+    else {
+        res = PyNumber_Subtract(left, right);
+    }
+    Py_DECREF(left);
+    Py_DECREF(right);
+    sp[-2] = res;
+    return res != NULL ? 0 : -1;
+}
+
+static int
+jit_binary_subscr(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *sub = sp[-1];
+    PyObject *container = sp[-2];
+    PyObject *res;
+    if (PyLong_CheckExact(sub) && IS_MEDIUM_INT(sub) &&
+        (PyList_CheckExact(container) || PyTuple_CheckExact(container))) {
+        Py_ssize_t i = medium_int_value(sub);
+        Py_ssize_t size = Py_SIZE(container);
+        if (i < 0) {
+            i += size;
+        }
+        if (0 <= i && i < size) {
+            res = PyList_CheckExact(container) ?
+                PyList_GET_ITEM(container, i) : PyTuple_GET_ITEM(container, i);
+            Py_INCREF(res);
+            Py_DECREF(container);
+            Py_DECREF(sub);
+            sp[-2] = res;
+            return 0;
+        }
+    }
+    res = PyObject_GetItem(container, sub);
+    Py_DECREF(container);
+    Py_DECREF(sub);
+    sp[-2] = res;
+    return res != NULL ? 0 : -1;
+}
+
+/* oparg is the opcode */
+static int
+jit_multiply(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *right = sp[-1];
+    PyObject *left = sp[-2];
+    PyObject *res;
+    if (PyLong_CheckExact(left) && PyLong_CheckExact(right) &&
+        IS_MEDIUM_INT(left) && IS_MEDIUM_INT(right)) {
+        res = PyLong_FromLongLong((long long)medium_int_value(left) *
+                                  medium_int_value(right));
+    }
+    else if (PyFloat_CheckExact(left) && PyFloat_CheckExact(right)) {
+        res = PyFloat_FromDouble(PyFloat_AS_DOUBLE(left) *
+                                 PyFloat_AS_DOUBLE(right));
+    }
+    else if (oparg == INPLACE_MULTIPLY) {
+        res = PyNumber_InPlaceMultiply(left, right);
+    }
+    else {
+        res = PyNumber_Multiply(left, right);
+    }
+    Py_DECREF(left);
+    Py_DECREF(right);
+    sp[-2] = res;
+    return res != NULL ? 0 : -1;
+}
+
+static PyObject *
+compare_medium_ints(PyObject *left, PyObject *right, int op)
+{
+    sdigit a = medium_int_value(left);
+    sdigit b = medium_int_value(right);
+    Py_RETURN_RICHCOMPARE(a, b, op);
+}
+
+static PyObject *
+compare_floats(PyObject *left, PyObject *right, int op)
+{
+    double a = PyFloat_AS_DOUBLE(left);
+    double b = PyFloat_AS_DOUBLE(right);
+    Py_RETURN_RICHCOMPARE(a, b, op);
+}
+
+static int
+jit_compare_op(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *right = sp[-1];
+    PyObject *left = sp[-2];
+    PyObject *res;
+    if (PyLong_CheckExact(left) && PyLong_CheckExact(right) &&
+        IS_MEDIUM_INT(left) && IS_MEDIUM_INT(right)) {
+        res = compare_medium_ints(left, right, oparg);
+    }
+    else if (PyFloat_CheckExact(left) && PyFloat_CheckExact(right)) {
+        res = compare_floats(left, right, oparg);
+    }
+    else {
+        res = PyObject_RichCompare(left, right, oparg);
+    }
+    Py_DECREF(left);
+    Py_DECREF(right);
+    sp[-2] = res;
+    return res != NULL ? 0 : -1;
+}
+
+static int
+jit_is_op(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *right = sp[-1];
+    PyObject *left = sp[-2];
+    PyObject *res = ((left == right) ^ oparg) ? Py_True : Py_False;
+    Py_INCREF(res);
+    sp[-2] = res;
+    Py_DECREF(left);
+    Py_DECREF(right);
+    return 0;
+}
+
+static int
+jit_contains_op(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *right = sp[-1];
+    PyObject *left = sp[-2];
+    int res = PySequence_Contains(right, left);
+    Py_DECREF(left);
+    Py_DECREF(right);
+    if (res < 0) {
+        return -1;
+    }
+    sp[-2] = (res ^ oparg) ? Py_True : Py_False;
+    Py_INCREF(sp[-2]);
+    return 0;
+}
+
+/* oparg is the opcode */
+static int
+jit_unary_op(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *value = sp[-1];
+    PyObject *res;
+    switch (oparg) {
+    case UNARY_POSITIVE:
+        res = PyNumber_Positive(value);
+        break;
+    case UNARY_NEGATIVE:
+        res = PyNumber_Negative(value);
+        break;
+    case UNARY_INVERT:
+        res = PyNumber_Invert(value);
+        break;
+    default: {
+        assert(oparg == UNARY_NOT);
+        int err = PyObject_IsTrue(value);
+        res = err < 0 ? NULL : (err ? Py_False : Py_True);
+        Py_XINCREF(res);
+        break;
+    }
+    }
+    Py_DECREF(value);
+    sp[-1] = res;
+    return res != NULL ? 0 : -1;
+}
+
+static int
+jit_store_subscr(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *sub = sp[-1];
+    PyObject *container = sp[-2];
+    PyObject *v = sp[-3];
+    int err = PyObject_SetItem(container, sub, v);
+    Py_DECREF(v);
+    Py_DECREF(container);
+    Py_DECREF(sub);
+    return err != 0 ? -1 : 0;
+}
+
+static int
+jit_delete_subscr(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *sub = sp[-1];
+    PyObject *container = sp[-2];
+    int err = PyObject_DelItem(container, sub);
+    Py_DECREF(container);
+    Py_DECREF(sub);
+    return err != 0 ? -1 : 0;
+}
+
+/* arg is the cache entry of the instruction, or NULL.  Like LOAD_GLOBAL in
+   ceval.c, which raises NameError. */
+static int
+jit_load_global(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyFrameObject *f = st->frame;
+    _PyOpcache *co_opcache = (_PyOpcache *)arg;
+    PyObject *v;
+    if (!PyDict_CheckExact(f->f_globals) || !PyDict_CheckExact(f->f_builtins)) {
+        return JIT_DEOPT;
+    }
+    if (co_opcache != NULL && co_opcache->optimized > 0) {
+        _PyOpcache_LoadGlobal *lg = &co_opcache->u.lg;
+        if (lg->globals_ver == ((PyDictObject *)f->f_globals)->ma_version_tag
+            && lg->builtins_ver == ((PyDictObject *)f->f_builtins)->ma_version_tag)
+        {
+            v = lg->ptr;
+            Py_INCREF(v);
+            sp[0] = v;
+            return 0;
+        }
+    }
+    v = _PyDict_LoadGlobal((PyDictObject *)f->f_globals,
+                           (PyDictObject *)f->f_builtins,
+                           PyTuple_GET_ITEM(f->f_code->co_names, oparg));
+    if (v == NULL) {
+        return PyErr_Occurred() ? -1 : JIT_DEOPT;
+    }
+    if (co_opcache != NULL) {
+        _PyOpcache_LoadGlobal *lg = &co_opcache->u.lg;
+        co_opcache->optimized = 1;
+        lg->globals_ver = ((PyDictObject *)f->f_globals)->ma_version_tag;
+        lg->builtins_ver = ((PyDictObject *)f->f_builtins)->ma_version_tag;
+        lg->ptr = v; /* borrowed */
+    }
+    Py_INCREF(v);
+    sp[0] = v;
+    return 0;
+}
+
+/* Instance dict of an object whose type has a positive tp_dictoffset */
+#define INSTANCE_DICT(obj, type) \
+    (*(PyDictObject **)((char *)(obj) + (type)->tp_dictoffset))
+
+/* arg is the instruction in co_quickened, or NULL.  Like the specialized
+   forms of LOAD_ATTR in ceval.c, this uses the cache entry of the
+   instruction; it doesn't specialize the instruction again, which the
+   interpreter does when it runs the frame. */
+static int
+jit_load_attr(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyCodeObject *co = st->frame->f_code;
+    _Py_CODEUNIT *instr = (_Py_CODEUNIT *)arg;
+    PyObject *name = PyTuple_GET_ITEM(co->co_names, oparg);
+    PyObject *owner = sp[-1];
+    PyTypeObject *type = Py_TYPE(owner);
+    PyObject *res = NULL;
+
+    if (instr != NULL) {
+        int index = co->co_opcache_map[instr - co->co_quickened + 1];
+        _PyOpcache *cache = &co->co_opcache[index - 1];
+        assert(index > 0);
+        if (_Py_OPCODE(*instr) == LOAD_ATTR_SLOT &&
+            type->tp_version_tag == cache->u.attr.tp_version) {
+            res = *(PyObject **)((char *)owner + cache->u.attr.index);
+        }
+        else if (_Py_OPCODE(*instr) == LOAD_ATTR_SPLIT_KEYS &&
+                 type->tp_version_tag == cache->u.attr.tp_version) {
+            PyDictObject *dict = INSTANCE_DICT(owner, type);
+            Py_ssize_t i = cache->u.attr.index;
+            if (dict != NULL && dict->ma_values != NULL &&
+                i < dict->ma_keys->dk_nentries &&
+                DK_ENTRIES(dict->ma_keys)[i].me_key == name) {
+                res = dict->ma_values[i];
+            }
+        }
+        if (res != NULL) {
+            Py_INCREF(res);
+            sp[-1] = res;
+            Py_DECREF(owner);
+            return 0;
+        }
+    }
+    res = PyObject_GetAttr(owner, name);
+    Py_DECREF(owner);
+    sp[-1] = res;
+    return res != NULL ? 0 : -1;
+}
+
+static int
+jit_store_attr(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *name = PyTuple_GET_ITEM(st->frame->f_code->co_names, oparg);
+    PyObject *owner = sp[-1];
+    PyObject *v = sp[-2];
+    int err = PyObject_SetAttr(owner, name, v);
+    Py_DECREF(v);
+    Py_DECREF(owner);
+    return err != 0 ? -1 : 0;
+}
+
+/* See LOAD_METHOD in ceval.c for the layout of the stack */
+static int
+jit_load_method(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *name = PyTuple_GET_ITEM(st->frame->f_code->co_names, oparg);
+    PyObject *obj = sp[-1];
+    PyObject *meth = NULL;
+    int meth_found = _PyObject_GetMethod(obj, name, &meth);
+    if (meth == NULL) {
+        return -1;
+    }
+    if (meth_found) {
+        sp[-1] = meth;
+        sp[0] = obj;
+    }
+    else {
+        sp[-1] = NULL;
+        Py_DECREF(obj);
+        sp[0] = meth;
+    }
+    return 0;
+}
+
+/* Should the call to func rather be run by the interpreter, which calls
+   Python functions without C recursion (see CAN_INLINE_CALL in ceval.c)?
+   The machine code is entered again after the call returns. */
+static inline int
+leave_call(_PyJITState *st, PyObject *func)
+{
+    return (Py_IS_TYPE(func, &PyFunction_Type) &&
+            !(((PyCodeObject *)PyFunction_GET_CODE(func))->co_flags &
+              (CO_GENERATOR | CO_COROUTINE | CO_ASYNC_GENERATOR)) &&
+            st->tstate->interp->eval_frame == _PyEval_EvalFrameDefault);
+}
+
+/* Call the callable at args[-1], the result replaces the callable */
+static inline int
+call(PyObject **args, Py_ssize_t nargs, PyObject *kwnames)
+{
+    PyObject *func = args[-1];
+    Py_ssize_t nkwargs = kwnames == NULL ? 0 : PyTuple_GET_SIZE(kwnames);
+    PyObject *res = PyObject_Vectorcall(
+        func, args, (nargs - nkwargs) | PY_VECTORCALL_ARGUMENTS_OFFSET,
+        kwnames);
+    Py_DECREF(func);
+    for (Py_ssize_t i = 0; i < nargs; i++) {
+        Py_DECREF(args[i]);
+    }
+    args[-1] = res;
+    return res != NULL ? 0 : -1;
+}
+
+static int
+jit_call_function(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    if (leave_call(st, sp[-oparg - 1])) {
+        return JIT_DEOPT;
+    }
+    return call(sp - oparg, oparg, NULL);
+}
+
+static int
+jit_call_function_kw(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *names = sp[-1];
+    int err;
+    if (leave_call(st, sp[-oparg - 2])) {
+        return JIT_DEOPT;
+    }
+    err = call(sp - 1 - oparg, oparg, names);
+    Py_DECREF(names);
+    return err;
+}
+
+/* See CALL_METHOD in ceval.c for the layout of the stack */
+static int
+jit_call_method(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *meth = sp[-oparg - 2];
+    if (meth == NULL) {
+        if (leave_call(st, sp[-oparg - 1])) {
+            return JIT_DEOPT;
+        }
+        if (call(sp - oparg, oparg, NULL) < 0) {
+            sp[-oparg - 2] = NULL;
+            return -1;
+        }
+        sp[-oparg - 2] = sp[-oparg - 1];
+        return 0;
+    }
+    if (leave_call(st, meth)) {
+        return JIT_DEOPT;
+    }
+    return call(sp - oparg - 1, oparg + 1, NULL);
+}
+
+/* On error, the items are left on the stack like the interpreter does */
+static int
+jit_build_tuple(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *tup = PyTuple_New(oparg);
+    if (tup == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < oparg; i++) {
+        PyTuple_SET_ITEM(tup, i, sp[i - oparg]);
+    }
+    sp[-oparg] = tup;
+    return 0;
+}
+
+/* On error, the items are left on the stack like the interpreter does */
+static int
+jit_build_list(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *list = PyList_New(oparg);
+    if (list == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < oparg; i++) {
+        PyList_SET_ITEM(list, i, sp[i - oparg]);
+    }
+    sp[-oparg] = list;
+    return 0;
+}
+
+static int
+jit_list_append(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *v = sp[-1];
+    int err = PyList_Append(sp[-1 - oparg], v);
+    Py_DECREF(v);
+    return err != 0 ? -1 : 0;
+}
+
+/* Like UNPACK_SEQUENCE in ceval.c, without the general case */
+static int
+jit_unpack_sequence(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *seq = sp[-1];
+    PyObject **items;
+    if (PyTuple_CheckExact(seq) && PyTuple_GET_SIZE(seq) == oparg) {
+        items = ((PyTupleObject *)seq)->ob_item;
+    }
+    else if (PyList_CheckExact(seq) && PyList_GET_SIZE(seq) == oparg) {
+        items = ((PyListObject *)seq)->ob_item;
+    }
+    else {
+        return JIT_DEOPT;
+    }
+    for (int i = 0; i < oparg; i++) {
+        Py_INCREF(items[i]);
+        sp[oparg - 2 - i] = items[i];
+    }
+    Py_DECREF(seq);
+    return 0;
+}
+
+static int
+jit_build_slice(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *step = oparg == 3 ? sp[-1] : NULL;
+    PyObject *stop = sp[-oparg + 1];
+    PyObject *start = sp[-oparg];
+    PyObject *slice = PySlice_New(start, stop, step);
+    Py_DECREF(start);
+    Py_DECREF(stop);
+    Py_XDECREF(step);
+    sp[-oparg] = slice;
+    return slice != NULL ? 0 : -1;
+}
+
+/* oparg is the index in the cells and free variables */
+static int
+jit_load_deref(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyFrameObject *f = st->frame;
+    PyObject *cell = f->f_localsplus[f->f_code->co_nlocals + oparg];
+    PyObject *value = PyCell_GET(cell);
+    if (value == NULL) {
+        /* The interpreter raises NameError or UnboundLocalError */
+        return JIT_DEOPT;
+    }
+    Py_INCREF(value);
+    sp[0] = value;
+    return 0;
+}
+
+static int
+jit_store_deref(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyFrameObject *f = st->frame;
+    PyObject *cell = f->f_localsplus[f->f_code->co_nlocals + oparg];
+    PyObject *oldobj = PyCell_GET(cell);
+    PyCell_SET(cell, sp[-1]);
+    Py_XDECREF(oldobj);
+    return 0;
+}
+
+static int
+jit_load_closure(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyFrameObject *f = st->frame;
+    PyObject *cell = f->f_localsplus[f->f_code->co_nlocals + oparg];
+    Py_INCREF(cell);
+    sp[0] = cell;
+    return 0;
+}
+
+/* On error, the items are left on the stack like the interpreter does */
+static int
+jit_build_string(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *empty = PyUnicode_New(0, 0);
+    PyObject *str;
+    if (empty == NULL) {
+        return -1;
+    }
+    str = _PyUnicode_JoinArray(empty, sp - oparg, oparg);
+    Py_DECREF(empty);
+    if (str == NULL) {
+        return -1;
+    }
+    for (int i = 1; i <= oparg; i++) {
+        Py_DECREF(sp[-i]);
+    }
+    sp[-oparg] = str;
+    return 0;
+}
+
+/* See FORMAT_VALUE in ceval.c */
+static int
+jit_format_value(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    int have_fmt_spec = (oparg & FVS_MASK) == FVS_HAVE_SPEC;
+    PyObject *fmt_spec = have_fmt_spec ? sp[-1] : NULL;
+    PyObject **slot = have_fmt_spec ? &sp[-2] : &sp[-1];
+    PyObject *value = *slot;
+    PyObject *result;
+
+    switch (oparg & FVC_MASK) {
+    case FVC_NONE:
+        result = value;
+        Py_INCREF(result);
+        break;
+    case FVC_STR:
+        result = PyObject_Str(value);
+        break;
+    case FVC_REPR:
+        result = PyObject_Repr(value);
+        break;
+    default:
+        assert((oparg & FVC_MASK) == FVC_ASCII);
+        result = PyObject_ASCII(value);
+        break;
+    }
+    Py_DECREF(value);
+    value = result;
+    if (value != NULL && (!PyUnicode_CheckExact(value) || fmt_spec != NULL)) {
+        result = PyObject_Format(value, fmt_spec);
+        Py_DECREF(value);
+    }
+    Py_XDECREF(fmt_spec);
+    *slot = result;
+    return result != NULL ? 0 : -1;
+}
+
+static int
+jit_get_iter(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *iterable = sp[-1];
+    PyObject *iter = PyObject_GetIter(iterable);
+    Py_DECREF(iterable);
+    sp[-1] = iter;
+    return iter != NULL ? 0 : -1;
+}
+
+/* Return 0 if the next item was pushed, 1 if the iterator is exhausted
+   and was popped, or -1 on error (with the iterator still on the stack) */
+static int
+jit_for_iter(PyObject **sp, int oparg, _PyJITState *st, void *arg)
+{
+    PyObject *iter = sp[-1];
+    PyObject *next;
+    if (Py_IS_TYPE(iter, &PyRangeIter_Type)) {
+        _PyRangeIterObject *r = (_PyRangeIterObject *)iter;
+        if (r->index < r->len) {
+            next = PyLong_FromLong(
+                (long)(r->start + (unsigned long)(r->index++) * r->step));
+            if (next == NULL) {
+                return -1;
+            }
+            sp[0] = next;
+            return 0;
+        }
+    }
+    else if (Py_IS_TYPE(iter, &PyListIter_Type)) {
+        _PyListIterObject *it = (_PyListIterObject *)iter;
+        PyListObject *seq = it->it_seq;
+        if (seq != NULL) {
+            if (it->it_index < PyList_GET_SIZE(seq)) {
+                next = PyList_GET_ITEM(seq, it->it_index++);
+                Py_INCREF(next);
+                sp[0] = next;
+                return 0;
+            }
+            it->it_seq = NULL;
+            Py_DECREF(seq);
+        }
+    }
+    else {
+        next = (*Py_TYPE(iter)->tp_iternext)(iter);
+        if (next != NULL) {
+            sp[0] = next;
+            return 0;
+        }
+        if (PyErr_Occurred()) {
+            if (!PyErr_ExceptionMatches(PyExc_StopIteration)) {
+                return -1;
+            }
+            PyErr_Clear();
+        }
+    }
+    Py_DECREF(iter);
+    return 1;
+}
+
+/* Truth value of v, which is consumed (POP_JUMP_IF_XXX) */
+static int
+jit_pop_is_true(PyObject *v)
+{
+    int err = PyObject_IsTrue(v);
+    Py_DECREF(v);
+    return err;
+}
+
+static void
+jit_dealloc(PyObject *op)
+{
+    _Py_Dealloc(op);
+}
+
+
+/* Assembler */
+
+enum {
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15
+};
+
+/* Condition codes of jcc */
+enum {
+    CC_E = 0x4, CC_NE = 0x5, CC_S = 0x8, CC_L = 0xc
+};
+#define JMP (-1)
+
+/* Kinds of stubs: code after the body which leaves the machine code */
+enum {
+    STUB_EXIT,      /* Continue in the interpreter */
+    STUB_ERROR,     /* Raise in the interpreter */
+    STUB_HELPER     /* After a helper: JIT_DEOPT is STUB_EXIT, the rest
+                       STUB_ERROR */
+};
+
+typedef struct {
+    Py_ssize_t pos;     /* Position of the 32-bit displacement to patch */
+    int kind;
+    int lasti;
+    int adjust;         /* Stack pointer adjustment in bytes */
+    int error_adjust;   /* Same for the error case of STUB_HELPER */
+} jit_stub;
+
+typedef struct {
+    Py_ssize_t pos;
+    Py_ssize_t target;  /* Index of the instruction */
+} jit_fixup;
+
+typedef struct {
+    unsigned char *code;
+    Py_ssize_t size;
+    Py_ssize_t allocated;
+    int nomem;
+    /* Pushes not yet applied to rbx.  The top of the value stack is at
+       rbx + 8 * (sp_offset - 1). */
+    int sp_offset;
+    Py_ssize_t epilogue;
+    Py_ssize_t *labels;  /* Position of each instruction */
+    jit_fixup *fixups;
+    Py_ssize_t nfixups;
+    Py_ssize_t fixups_allocated;
+    jit_stub *stubs;
+    Py_ssize_t nstubs;
+    Py_ssize_t stubs_allocated;
+} jit_compiler;
+
+static int
+grow(void **items, Py_ssize_t *allocated, Py_ssize_t needed, size_t itemsize)
+{
+    if (needed <= *allocated) {
+        return 0;
+    }
+    Py_ssize_t n = Py_MAX(needed, *allocated * 2 + 16);
+    void *p = PyMem_Realloc(*items, n * itemsize);
+    if (p == NULL) {
+        return -1;
+    }
+    *items = p;
+    *allocated = n;
+    return 0;
+}
+
+static void
+emit_u8(jit_compiler *c, unsigned int x)
+{
+    if (grow((void **)&c->code, &c->allocated, c->size + 1, 1) < 0) {
+        c->nomem = 1;
+        return;
+    }
+    c->code[c->size++] = (unsigned char)x;
+}
+
+static void
+emit_u32(jit_compiler *c, uint32_t x)
+{
+    for (int i = 0; i < 4; i++) {
+        emit_u8(c, (x >> (8 * i)) & 0xff);
+    }
+}
+
+static void
+emit_u64(jit_compiler *c, uint64_t x)
+{
+    emit_u32(c, (uint32_t)x);
+    emit_u32(c, (uint32_t)(x >> 32));
+}
+
+static void
+emit_rex(jit_compiler *c, int w, int reg, int rm)
+{
+    int rex = 0x40 | (w << 3) | ((reg >> 3) << 2) | (rm >> 3);
+    if (rex != 0x40) {
+        emit_u8(c, rex);
+    }
+}
+
+/* opcode reg, [base + disp] */
+static void
+emit_mem(jit_compiler *c, int w, int opcode, int reg, int base, int32_t disp)
+{
+    emit_rex(c, w, reg, base);
+    emit_u8(c, opcode);
+    if (-128 <= disp && disp <= 127) {
+        emit_u8(c, 0x40 | ((reg & 7) << 3) | (base & 7));
+        if ((base & 7) == RSP) {
+            emit_u8(c, 0x24);  /* SIB byte: no index */
+        }
+        emit_u8(c, (uint8_t)disp);
+    }
+    else {
+        emit_u8(c, 0x80 | ((reg & 7) << 3) | (base & 7));
+        if ((base & 7) == RSP) {
+            emit_u8(c, 0x24);
+        }
+        emit_u32(c, (uint32_t)disp);
+    }
+}
+
+/* opcode reg, rm with register operands */
+static void
+emit_reg(jit_compiler *c, int w, int opcode, int reg, int rm)
+{
+    emit_rex(c, w, reg, rm);
+    emit_u8(c, opcode);
+    emit_u8(c, 0xc0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+/* mov dst, [base + disp] */
+static void
+emit_load(jit_compiler *c, int dst, int base, int32_t disp)
+{
+    emit_mem(c, 1, 0x8b, dst, base, disp);
+}
+
+/* mov [base + disp], src */
+static void
+emit_store(jit_compiler *c, int base, int32_t disp, int src)
+{
+    emit_mem(c, 1, 0x89, src, base, disp);
+}
+
+/* mov dword [base + disp], imm */
+static void
+emit_store_imm32(jit_compiler *c, int base, int32_t disp, int32_t imm)
+{
+    emit_mem(c, 0, 0xc7, 0, base, disp);
+    emit_u32(c, (uint32_t)imm);
+}
+
+/* lea dst, [base + disp] */
+static void
+emit_lea(jit_compiler *c, int dst, int base, int32_t disp)
+{
+    emit_mem(c, 1, 0x8d, dst, base, disp);
+}
+
+/* mov dst, src */
+static void
+emit_mov(jit_compiler *c, int dst, int src)
+{
+    emit_reg(c, 1, 0x89, src, dst);
+}
+
+/* mov dst, imm (64-bit) */
+static void
+emit_mov_imm(jit_compiler *c, int dst, uint64_t imm)
+{
+    if (imm <= UINT32_MAX) {
+        /* mov r32, imm32 zero-extends */
+        emit_rex(c, 0, 0, dst);
+        emit_u8(c, 0xb8 + (dst & 7));
+        emit_u32(c, (uint32_t)imm);
+    }
+    else {
+        emit_rex(c, 1, 0, dst);
+        emit_u8(c, 0xb8 + (dst & 7));
+        emit_u64(c, imm);
+    }
+}
+
+/* mov dst, imm (32-bit register, sign-extended value is unused) */
+static void
+emit_mov_imm32(jit_compiler *c, int dst, int32_t imm)
+{
+    emit_rex(c, 0, 0, dst);
+    emit_u8(c, 0xb8 + (dst & 7));
+    emit_u32(c, (uint32_t)imm);
+}
+
+/* test eax, eax */
+static void
+emit_test_eax(jit_compiler *c)
+{
+    emit_reg(c, 0, 0x85, RAX, RAX);
+}
+
+/* cmp a, b */
+static void
+emit_cmp(jit_compiler *c, int a, int b)
+{
+    emit_reg(c, 1, 0x39, b, a);
+}
+
+static void
+emit_call(jit_compiler *c, void *func)
+{
+    emit_mov_imm(c, RAX, (uintptr_t)func);
+    emit_reg(c, 0, 0xff, 2, RAX);  /* call rax */
+}
+
+/* Emit a jump whose 32-bit displacement is patched later, and return the
+   position of the displacement.  cond is a CC_XXX or JMP. */
+static Py_ssize_t
+emit_jump(jit_compiler *c, int cond)
+{
+    if (cond == JMP) {
+        emit_u8(c, 0xe9);
+    }
+    else {
+        emit_u8(c, 0x0f);
+        emit_u8(c, 0x80 | cond);
+    }
+    emit_u32(c, 0);
+    return c->size - 4;
+}
+
+static void
+patch_jump(jit_compiler *c, Py_ssize_t pos, Py_ssize_t target)
+{
+    if (c->nomem) {
+        return;
+    }
+    uint32_t disp = (uint32_t)(int32_t)(target - (pos + 4));
+    for (int i = 0; i < 4; i++) {
+        c->code[pos + i] = (disp >> (8 * i)) & 0xff;
+    }
+}
+
+/* Jump to the code of the instruction at index target */
+static void
+emit_jump_to(jit_compiler *c, int cond, Py_ssize_t target)
+{
+    Py_ssize_t pos = emit_jump(c, cond);
+    if (grow((void **)&c->fixups, &c->fixups_allocated, c->nfixups + 1,
+             sizeof(jit_fixup)) < 0) {
+        c->nomem = 1;
+        return;
+    }
+    c->fixups[c->nfixups].pos = pos;
+    c->fixups[c->nfixups].target = target;
+    c->nfixups++;
+}
+
+/* Jump to a new stub */
+static void
+emit_jump_to_stub(jit_compiler *c, int cond, int kind, int lasti,
+                  int adjust, int error_adjust)
+{
+    Py_ssize_t pos = emit_jump(c, cond);
+    if (grow((void **)&c->stubs, &c->stubs_allocated, c->nstubs + 1,
+             sizeof(jit_stub)) < 0) {
+        c->nomem = 1;
+        return;
+    }
+    jit_stub *stub = &c->stubs[c->nstubs++];
+    stub->pos = pos;
+    stub->kind = kind;
+    stub->lasti = lasti;
+    stub->adjust = adjust;
+    stub->error_adjust = error_adjust;
+}
+
+/* Leave the machine code with the given _PyJIT_XXX result */
+static void
+emit_exit(jit_compiler *c, int result, int lasti, int adjust)
+{
+    if (adjust) {
+        emit_lea(c, RBX, RBX, adjust);
+    }
+    emit_store(c, R13, offsetof(_PyJITState, stack_pointer), RBX);
+    emit_store_imm32(c, R13, offsetof(_PyJITState, lasti), lasti);
+    emit_mov_imm32(c, RAX, result);
+    patch_jump(c, emit_jump(c, JMP), c->epilogue);
+}
+
+/* Apply the pending pushes to rbx */
+static void
+flush_sp(jit_compiler *c)
+{
+    if (c->sp_offset != 0) {
+        emit_lea(c, RBX, RBX, c->sp_offset * (int)sizeof(PyObject *));
+        c->sp_offset = 0;
+    }
+}
+
+/* Displacement from rbx of the stack slot i (-1 is the top) */
+static int32_t
+slot(jit_compiler *c, int i)
+{
+    return (c->sp_offset + i) * (int)sizeof(PyObject *);
+}
+
+static void
+emit_incref(jit_compiler *c, int reg)
+{
+#ifdef Py_REF_DEBUG
+    emit_mov_imm(c, R11, (uintptr_t)&_Py_RefTotal);
+    emit_mem(c, 1, 0xff, 0, R11, 0);  /* inc qword [r11] */
+#endif
+    emit_mem(c, 1, 0xff, 0, reg, offsetof(PyObject, ob_refcnt));
+}
+
+/* Py_DECREF(reg), which can call any code: only the callee-saved registers
+   are preserved.  Unlike Py_DECREF() in debug builds, this doesn't check
+   for negative reference counts. */
+static void
+emit_decref(jit_compiler *c, int reg)
+{
+#ifdef Py_REF_DEBUG
+    emit_mov_imm(c, R11, (uintptr_t)&_Py_RefTotal);
+    emit_mem(c, 1, 0xff, 1, R11, 0);  /* dec qword [r11] */
+#endif
+    emit_mem(c, 1, 0xff, 1, reg, offsetof(PyObject, ob_refcnt));
+    Py_ssize_t done = emit_jump(c, CC_NE);
+    if (reg != RDI) {
+        emit_mov(c, RDI, reg);
+    }
+    emit_call(c, jit_dealloc);
+    patch_jump(c, done, c->size);
+}
+
+/* Decrement the reference count of an object which cannot reach zero
+   (True and False) */
+static void
+emit_decref_nodealloc(jit_compiler *c, int reg)
+{
+#ifdef Py_REF_DEBUG
+    emit_mov_imm(c, R11, (uintptr_t)&_Py_RefTotal);
+    emit_mem(c, 1, 0xff, 1, R11, 0);
+#endif
+    emit_mem(c, 1, 0xff, 1, reg, offsetof(PyObject, ob_refcnt));
+}
+
+static void
+emit_set_lasti(jit_compiler *c, int lasti)
+{
+    emit_store_imm32(c, R15, offsetof(PyFrameObject, f_lasti), lasti);
+}
+
+/* Leave the machine code before the instruction at lasti if the eval
+   breaker is set */
+static void
+emit_check_eval_breaker(jit_compiler *c, int lasti)
+{
+    /* cmp dword [r14], 0 */
+    emit_mem(c, 0, 0x83, 7, R14, offsetof(_Py_atomic_int, _value));
+    emit_u8(c, 0);
+    emit_jump_to_stub(c, CC_NE, STUB_EXIT, lasti, slot(c, 0), 0);
+}
+
+/* Leave the machine code before the instruction at lasti if the code that
+   just ran set the eval breaker (like the interpreter, which checks it
+   after most instructions: a signal handler can raise in a try block), or
+   turned on tracing or profiling */
+static void
+emit_check_after_call(jit_compiler *c, int lasti)
+{
+    emit_check_eval_breaker(c, lasti);
+    emit_load(c, RAX, R13, offsetof(_PyJITState, tstate));
+    /* cmp dword [rax + use_tracing], 0 */
+    emit_mem(c, 0, 0x83, 7, RAX, offsetof(PyThreadState, use_tracing));
+    emit_u8(c, 0);
+    emit_jump_to_stub(c, CC_NE, STUB_EXIT, lasti, slot(c, 0), 0);
+}
+
+/* Call a helper for the instruction at lasti, which changes the stack level
+   by effect on success and by error_effect on error, and is followed by
+   the instruction at next_lasti. */
+static void
+emit_helper(jit_compiler *c, jit_helper helper, int oparg, void *arg,
+            int lasti, int next_lasti, int effect, int error_effect)
+{
+    flush_sp(c);
+    emit_set_lasti(c, lasti);
+    emit_mov(c, RDI, RBX);
+    emit_mov_imm32(c, RSI, oparg);
+    emit_mov(c, RDX, R13);
+    emit_mov_imm(c, RCX, (uintptr_t)arg);
+    emit_call(c, helper);
+    emit_test_eax(c);
+    emit_jump_to_stub(c, CC_NE, STUB_HELPER, lasti, 0,
+                      error_effect * (int)sizeof(PyObject *));
+    c->sp_offset = effect;
+    emit_check_after_call(c, next_lasti);
+}
+
+static void
+emit_stub(jit_compiler *c, jit_stub *stub)
+{
+    patch_jump(c, stub->pos, c->size);
+    if (stub->kind == STUB_HELPER) {
+        /* The flags are those of test eax, eax */
+        Py_ssize_t error = emit_jump(c, CC_S);
+        emit_exit(c, _PyJIT_EXIT, stub->lasti, stub->adjust);
+        patch_jump(c, error, c->size);
+        emit_exit(c, _PyJIT_ERROR, stub->lasti, stub->error_adjust);
+    }
+    else {
+        emit_exit(c, stub->kind == STUB_EXIT ? _PyJIT_EXIT : _PyJIT_ERROR,
+                  stub->lasti, stub->adjust);
+    }
+}
+
+static void
+emit_prologue(jit_compiler *c)
+{
+    /* push rbp; mov rbp, rsp */
+    emit_u8(c, 0x55);
+    emit_mov(c, RBP, RSP);
+    /* push rbx, r12-r15 */
+    emit_u8(c, 0x53);
+    for (int reg = R12; reg <= R15; reg++) {
+        emit_u8(c, 0x41);
+        emit_u8(c, 0x50 + (reg & 7));
+    }
+    /* sub rsp, 8: align the stack for calls */
+    emit_u8(c, 0x48);
+    emit_u8(c, 0x83);
+    emit_u8(c, 0xec);
+    emit_u8(c, 8);
+    emit_mov(c, R13, RDI);
+    emit_load(c, R15, R13, offsetof(_PyJITState, frame));
+    emit_load(c, RBX, R13, offsetof(_PyJITState, stack_pointer));
+    emit_load(c, R14, R13, offsetof(_PyJITState, eval_breaker));
+    emit_lea(c, R12, R15, offsetof(PyFrameObject, f_localsplus));
+    /* jmp rsi: the entry point */
+    emit_reg(c, 0, 0xff, 4, RSI);
+
+    c->epilogue = c->size;
+    /* add rsp, 8 */
+    emit_u8(c, 0x48);
+    emit_u8(c, 0x83);
+    emit_u8(c, 0xc4);
+    emit_u8(c, 8);
+    for (int reg = R15; reg >= R12; reg--) {
+        emit_u8(c, 0x41);
+        emit_u8(c, 0x58 + (reg & 7));
+    }
+    emit_u8(c, 0x5b);  /* pop rbx */
+    emit_u8(c, 0x5d);  /* pop rbp */
+    emit_u8(c, 0xc3);  /* ret */
+}
+
+
+/* Compiler */
+
+#define UNIT sizeof(_Py_CODEUNIT)
+
+/* The target of a jump instruction (an index), or -1 if the compiler
+   doesn't need it */
+static Py_ssize_t
+jump_target(int opcode, int oparg, Py_ssize_t next)
+{
+    switch (opcode) {
+        case JUMP_FORWARD:
+        case FOR_ITER:
+            return next + oparg / UNIT;
+        case JUMP_ABSOLUTE:
+        case POP_JUMP_IF_FALSE:
+        case POP_JUMP_IF_TRUE:
+        case JUMP_IF_FALSE_OR_POP:
+        case JUMP_IF_TRUE_OR_POP:
+            return oparg / UNIT;
+        default:
+            return -1;
+    }
+}
+
+/* Emit the code of an instruction.  Return 0, or -1 if the instruction is
+   not supported. */
+static int
+compile_instruction(jit_compiler *c, PyCodeObject *co, int opcode, int oparg,
+                    Py_ssize_t start, Py_ssize_t index, Py_ssize_t next,
+                    const _Py_CODEUNIT *code)
+{
+    int lasti = (int)(start * UNIT);
+    int next_lasti = (int)(next * UNIT);
+    Py_ssize_t target = jump_target(opcode, oparg, next);
+    Py_ssize_t pos;
+
+    switch (opcode) {
+    case NOP:
+        return 0;
+
+    case LOAD_FAST:
+        emit_load(c, RAX, R12, oparg * sizeof(PyObject *));
+        emit_reg(c, 1, 0x85, RAX, RAX);  /* test rax, rax */
+        /* The interpreter raises UnboundLocalError */
+        emit_jump_to_stub(c, CC_E, STUB_EXIT, lasti, slot(c, 0), 0);
+        emit_store(c, RBX, slot(c, 0), RAX);
+        emit_incref(c, RAX);
+        c->sp_offset++;
+        return 0;
+
+    case LOAD_CONST: {
+        PyObject *value = PyTuple_GET_ITEM(co->co_consts, oparg);
+        emit_mov_imm(c, RAX, (uintptr_t)value);
+        emit_store(c, RBX, slot(c, 0), RAX);
+        emit_incref(c, RAX);
+        c->sp_offset++;
+        return 0;
+    }
+
+    case STORE_FAST:
+        emit_set_lasti(c, lasti);
+        emit_load(c, RAX, RBX, slot(c, -1));
+        c->sp_offset--;
+        emit_load(c, RDI, R12, oparg * sizeof(PyObject *));
+        emit_store(c, R12, oparg * sizeof(PyObject *), RAX);
+        /* Py_XDECREF(rdi) */
+        emit_reg(c, 1, 0x85, RDI, RDI);
+        pos = emit_jump(c, CC_E);
+        emit_decref(c, RDI);
+        patch_jump(c, pos, c->size);
+        return 0;
+
+    case LOAD_FAST_AND_CLEAR:
+        /* The local may be unbound: NULL is pushed */
+        emit_load(c, RAX, R12, oparg * sizeof(PyObject *));
+        emit_store(c, RBX, slot(c, 0), RAX);
+        emit_mov_imm32(c, RCX, 0);
+        emit_store(c, R12, oparg * sizeof(PyObject *), RCX);
+        c->sp_offset++;
+        return 0;
+
+    case POP_TOP:
+        emit_set_lasti(c, lasti);
+        emit_load(c, RDI, RBX, slot(c, -1));
+        c->sp_offset--;
+        emit_decref(c, RDI);
+        return 0;
+
+    case ROT_TWO:
+        emit_load(c, RAX, RBX, slot(c, -1));
+        emit_load(c, RCX, RBX, slot(c, -2));
+        emit_store(c, RBX, slot(c, -1), RCX);
+        emit_store(c, RBX, slot(c, -2), RAX);
+        return 0;
+
+    case ROT_THREE:
+        emit_load(c, RAX, RBX, slot(c, -1));
+        emit_load(c, RCX, RBX, slot(c, -2));
+        emit_load(c, RDX, RBX, slot(c, -3));
+        emit_store(c, RBX, slot(c, -1), RCX);
+        emit_store(c, RBX, slot(c, -2), RDX);
+        emit_store(c, RBX, slot(c, -3), RAX);
+        return 0;
+
+    case DUP_TOP:
+        emit_load(c, RAX, RBX, slot(c, -1));
+        emit_store(c, RBX, slot(c, 0), RAX);
+        emit_incref(c, RAX);
+        c->sp_offset++;
+        return 0;
+
+    case DUP_TOP_TWO:
+        emit_load(c, RAX, RBX, slot(c, -1));
+        emit_load(c, RCX, RBX, slot(c, -2));
+        emit_store(c, RBX, slot(c, 0), RCX);
+        emit_store(c, RBX, slot(c, 1), RAX);
+        emit_incref(c, RAX);
+        emit_incref(c, RCX);
+        c->sp_offset += 2;
+        return 0;
+
+    case RETURN_VALUE:
+        emit_load(c, RAX, RBX, slot(c, -1));
+        c->sp_offset--;
+        emit_store(c, R13, offsetof(_PyJITState, retval), RAX);
+        flush_sp(c);
+        emit_store(c, R13, offsetof(_PyJITState, stack_pointer), RBX);
+        emit_mov_imm32(c, RAX, _PyJIT_RETURN);
+        patch_jump(c, emit_jump(c, JMP), c->epilogue);
+        return 0;
+
+    case JUMP_FORWARD:
+    case JUMP_ABSOLUTE:
+        flush_sp(c);
+        if (target <= index) {
+            emit_check_eval_breaker(c, lasti);
+        }
+        emit_jump_to(c, JMP, target);
+        return 0;
+
+    case POP_JUMP_IF_FALSE:
+    case POP_JUMP_IF_TRUE: {
+        int jump_if = opcode == POP_JUMP_IF_TRUE;
+        Py_ssize_t not_true, not_false, skip_true, skip_false;
+        flush_sp(c);
+        if (target <= index) {
+            emit_check_eval_breaker(c, lasti);
+        }
+        emit_set_lasti(c, lasti);
+        emit_load(c, RAX, RBX, -(int)sizeof(PyObject *));
+        emit_lea(c, RBX, RBX, -(int)sizeof(PyObject *));
+        /* True */
+        emit_mov_imm(c, RCX, (uintptr_t)Py_True);
+        emit_cmp(c, RAX, RCX);
+        not_true = emit_jump(c, CC_NE);
+        emit_decref_nodealloc(c, RAX);
+        if (jump_if) {
+            emit_jump_to(c, JMP, target);
+            skip_true = -1;
+        }
+        else {
+            skip_true = emit_jump(c, JMP);
+        }
+        /* False */
+        patch_jump(c, not_true, c->size);
+        emit_mov_imm(c, RCX, (uintptr_t)Py_False);
+        emit_cmp(c, RAX, RCX);
+        not_false = emit_jump(c, CC_NE);
+        emit_decref_nodealloc(c, RAX);
+        if (!jump_if) {
+            emit_jump_to(c, JMP, target);
+            skip_false = -1;
+        }
+        else {
+            skip_false = emit_jump(c, JMP);
+        }
+        /* Anything else */
+        patch_jump(c, not_false, c->size);
+        emit_mov(c, RDI, RAX);
+        emit_call(c, jit_pop_is_true);
+        emit_test_eax(c);
+        emit_jump_to_stub(c, CC_S, STUB_ERROR, lasti, 0, 0);
+        emit_jump_to(c, jump_if ? CC_NE : CC_E, target);
+        if (skip_true >= 0) {
+            patch_jump(c, skip_true, c->size);
+        }
+        if (skip_false >= 0) {
+            patch_jump(c, skip_false, c->size);
+        }
+        emit_check_after_call(c, next_lasti);
+        return 0;
+    }
+
+    case JUMP_IF_FALSE_OR_POP:
+    case JUMP_IF_TRUE_OR_POP:
+        flush_sp(c);
+        if (target <= index) {
+            emit_check_eval_breaker(c, lasti);
+        }
+        emit_set_lasti(c, lasti);
+        emit_load(c, RDI, RBX, -(int)sizeof(PyObject *));
+        emit_call(c, PyObject_IsTrue);
+        emit_test_eax(c);
+        emit_jump_to_stub(c, CC_S, STUB_ERROR, lasti, 0, 0);
+        emit_jump_to(c, opcode == JUMP_IF_TRUE_OR_POP ? CC_NE : CC_E,
+                     target);
+        emit_load(c, RDI, RBX, -(int)sizeof(PyObject *));
+        emit_lea(c, RBX, RBX, -(int)sizeof(PyObject *));
+        emit_decref(c, RDI);
+        emit_check_after_call(c, next_lasti);
+        return 0;
+
+    case FOR_ITER:
+        flush_sp(c);
+        emit_set_lasti(c, lasti);
+        emit_mov(c, RDI, RBX);
+        emit_mov(c, RDX, R13);
+        emit_call(c, jit_for_iter);
+        emit_test_eax(c);
+        pos = emit_jump(c, CC_E);
+        emit_jump_to_stub(c, CC_S, STUB_ERROR, lasti, 0, 0);
+        emit_lea(c, RBX, RBX, -(int)sizeof(PyObject *));
+        emit_jump_to(c, JMP, target);
+        patch_jump(c, pos, c->size);
+        c->sp_offset = 1;
+        emit_check_after_call(c, next_lasti);
+        return 0;
+
+#define HELPER(HELPER, OPARG, ARG, EFFECT, ERROR_EFFECT) \
+        emit_helper(c, (HELPER), (OPARG), (ARG), lasti, next_lasti, \
+                    (EFFECT), (ERROR_EFFECT)); \
+        return 0;
+
+    case BINARY_ADD:
+    case INPLACE_ADD: {
+        /* See unicode_concatenate() in ceval.c */
+        int local = -1;
+        if (_Py_OPCODE(code[next]) == STORE_FAST) {
+            local = _Py_OPARG(code[next]);
+        }
+        HELPER(opcode == BINARY_ADD ? jit_binary_add : jit_inplace_add,
+               local, NULL, -1, -1);
+    }
+
+    case BINARY_SUBTRACT:
+    case INPLACE_SUBTRACT:
+        HELPER(jit_subtract, opcode, NULL, -1, -1);
+
+    case BINARY_MULTIPLY:
+    case INPLACE_MULTIPLY:
+        HELPER(jit_multiply, opcode, NULL, -1, -1);
+
+    case BINARY_SUBSCR:
+        HELPER(jit_binary_subscr, oparg, NULL, -1, -1);
+
+    case BINARY_POWER:
+    case INPLACE_POWER:
+    case BINARY_MATRIX_MULTIPLY:
+    case BINARY_FLOOR_DIVIDE:
+    case BINARY_TRUE_DIVIDE:
+    case BINARY_MODULO:
+    case BINARY_LSHIFT:
+    case BINARY_RSHIFT:
+    case BINARY_AND:
+    case BINARY_XOR:
+    case BINARY_OR:
+    case INPLACE_MATRIX_MULTIPLY:
+    case INPLACE_FLOOR_DIVIDE:
+    case INPLACE_TRUE_DIVIDE:
+    case INPLACE_MODULO:
+    case INPLACE_LSHIFT:
+    case INPLACE_RSHIFT:
+    case INPLACE_AND:
+    case INPLACE_XOR:
+    case INPLACE_OR:
+        HELPER(jit_binary_op, opcode, NULL, -1, -1);
+
+    case UNARY_POSITIVE:
+    case UNARY_NEGATIVE:
+    case UNARY_NOT:
+    case UNARY_INVERT:
+        HELPER(jit_unary_op, opcode, NULL, 0, opcode == UNARY_NOT ? -1 : 0);
+
+    case COMPARE_OP:
+        HELPER(jit_compare_op, oparg, NULL, -1, -1);
+    case IS_OP:
+        HELPER(jit_is_op, oparg, NULL, -1, -1);
+    case CONTAINS_OP:
+        HELPER(jit_contains_op, oparg, NULL, -1, -2);
+    case STORE_SUBSCR:
+        HELPER(jit_store_subscr, oparg, NULL, -3, -3);
+    case DELETE_SUBSCR:
+        HELPER(jit_delete_subscr, oparg, NULL, -2, -2);
+
+    case LOAD_GLOBAL: {
+        _PyOpcache *cache = NULL;
+        if (co->co_opcache != NULL && co->co_opcache_map[index + 1] > 0) {
+            cache = &co->co_opcache[co->co_opcache_map[index + 1] - 1];
+        }
+        HELPER(jit_load_global, oparg, cache, 1, 0);
+    }
+
+    case LOAD_ATTR: {
+        _Py_CODEUNIT *instr = NULL;
+        if (co->co_quickened != NULL && co->co_opcache_map != NULL &&
+            co->co_opcache_map[index + 1] > 0) {
+            instr = &co->co_quickened[index];
+        }
+        HELPER(jit_load_attr, oparg, instr, 0, 0);
+    }
+
+    case STORE_ATTR:
+        HELPER(jit_store_attr, oparg, NULL, -2, -2);
+    case LOAD_METHOD:
+        HELPER(jit_load_method, oparg, NULL, 1, 0);
+    case CALL_FUNCTION:
+        HELPER(jit_call_function, oparg, NULL, -oparg, -oparg);
+    case CALL_FUNCTION_KW:
+        HELPER(jit_call_function_kw, oparg, NULL, -oparg - 1, -oparg - 1);
+    case CALL_METHOD:
+        HELPER(jit_call_method, oparg, NULL, -oparg - 1, -oparg - 1);
+    case BUILD_TUPLE:
+        HELPER(jit_build_tuple, oparg, NULL, 1 - oparg, 0);
+    case BUILD_LIST:
+        HELPER(jit_build_list, oparg, NULL, 1 - oparg, 0);
+    case LIST_APPEND:
+        HELPER(jit_list_append, oparg, NULL, -1, -1);
+    case UNPACK_SEQUENCE:
+        HELPER(jit_unpack_sequence, oparg, NULL, oparg - 1, 0);
+    case BUILD_SLICE:
+        if (oparg != 2 && oparg != 3) {
+            return -1;
+        }
+        HELPER(jit_build_slice, oparg, NULL, 1 - oparg, 1 - oparg);
+    case LOAD_DEREF:
+        HELPER(jit_load_deref, oparg, NULL, 1, 0);
+    case STORE_DEREF:
+        HELPER(jit_store_deref, oparg, NULL, -1, -1);
+    case LOAD_CLOSURE:
+        HELPER(jit_load_closure, oparg, NULL, 1, 1);
+    case BUILD_STRING:
+        HELPER(jit_build_string, oparg, NULL, 1 - oparg, 0);
+    case FORMAT_VALUE: {
+        int effect = (oparg & FVS_MASK) == FVS_HAVE_SPEC ? -1 : 0;
+        HELPER(jit_format_value, oparg, NULL, effect, effect - 1);
+    }
+    case GET_ITER:
+        HELPER(jit_get_iter, oparg, NULL, 0, 0);
+
+#undef HELPER
+
+    default:
+        return -1;
+    }
+}
+
+static int
+compile_code(jit_compiler *c, PyCodeObject *co, char **entries)
+{
+    const _Py_CODEUNIT *code = (const _Py_CODEUNIT *)PyBytes_AS_STRING(co->co_code);
+    const _Py_CODEUNIT *quickened = co->co_quickened;
+    Py_ssize_t n = PyBytes_GET_SIZE(co->co_code) / UNIT;
+    char *is_target;
+    Py_ssize_t start, i;
+
+    c->labels = PyMem_New(Py_ssize_t, n);
+    is_target = PyMem_Calloc(n, 1);
+    if (c->labels == NULL || is_target == NULL) {
+        PyMem_Free(is_target);
+        return -1;
+    }
+
+    /* Find the entry points: the jump targets, and the instructions
+       following calls which the interpreter may run (see leave_call()).
+       The stack pointer must be up to date there. */
+    is_target[0] = 1;
+    for (start = 0; start < n; start = i + 1) {
+        int opcode, oparg = 0;
+        for (i = start; _Py_OPCODE(code[i]) == EXTENDED_ARG && i < n - 1; i++) {
+            oparg = (oparg | _Py_OPARG(code[i])) << 8;
+        }
+        opcode = _Py_OPCODE(code[i]);
+        oparg |= _Py_OPARG(code[i]);
+        Py_ssize_t target = jump_target(opcode, oparg, i + 1);
+        if (target >= 0 && target < n) {
+            is_target[target] = 1;
+        }
+        if ((opcode == CALL_FUNCTION || opcode == CALL_FUNCTION_KW ||
+             opcode == CALL_METHOD) && i + 1 < n) {
+            is_target[i + 1] = 1;
+        }
+    }
+
+    emit_prologue(c);
+    for (start = 0; start < n; start = i + 1) {
+        int opcode, oparg = 0;
+        for (i = start; _Py_OPCODE(code[i]) == EXTENDED_ARG && i < n - 1; i++) {
+            oparg = (oparg | _Py_OPARG(code[i])) << 8;
+            c->labels[i] = -1;
+        }
+        opcode = _Py_OPCODE(code[i]);
+        oparg |= _Py_OPARG(code[i]);
+        c->labels[i] = -1;
+
+        if (is_target[start]) {
+            flush_sp(c);
+        }
+        c->labels[start] = c->size;
+        if (quickened != NULL && _Py_OPCODE(quickened[i]) == NOP) {
+            /* SETUP_FINALLY and POP_BLOCK in code with an exception
+               table */
+            opcode = NOP;
+        }
+        Py_ssize_t pos = c->size;
+        if (compile_instruction(c, co, opcode, oparg, start, i, i + 1,
+                                code) < 0) {
+            /* Let the interpreter run it */
+            c->size = pos;
+            emit_exit(c, _PyJIT_EXIT, (int)(start * UNIT),
+                      slot(c, 0));
+            c->sp_offset = 0;
+        }
+        else if (is_target[start]) {
+            entries[start] = (char *)c->labels[start];
+        }
+        if (opcode == RETURN_VALUE || opcode == JUMP_FORWARD ||
+            opcode == JUMP_ABSOLUTE) {
+            /* The next instruction can only be reached by a jump */
+            c->sp_offset = 0;
+        }
+    }
+    PyMem_Free(is_target);
+
+    for (i = 0; i < c->nstubs; i++) {
+        emit_stub(c, &c->stubs[i]);
+    }
+    for (i = 0; i < c->nfixups; i++) {
+        assert(c->labels[c->fixups[i].target] >= 0);
+        patch_jump(c, c->fixups[i].pos, c->labels[c->fixups[i].target]);
+    }
+    return c->nomem ? -1 : 0;
+}
+
+int
+_PyJIT_Compile(PyCodeObject *co)
+{
+    jit_compiler c;
+    struct _PyJITCode *jit = NULL;
+    Py_ssize_t n = PyBytes_GET_SIZE(co->co_code) / UNIT;
+    char **entries = NULL;
+    char *code = MAP_FAILED;
+
+    if (co->co_flags & (CO_GENERATOR | CO_COROUTINE | CO_ASYNC_GENERATOR)) {
+        return -1;
+    }
+    memset(&c, 0, sizeof(c));
+    entries = PyMem_Calloc(n, sizeof(char *));
+    if (entries == NULL || compile_code(&c, co, entries) < 0) {
+        goto error;
+    }
+    jit = PyMem_Malloc(sizeof(struct _PyJITCode));
+    if (jit == NULL) {
+        goto error;
+    }
+    code = mmap(NULL, c.size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        goto error;
+    }
+    memcpy(code, c.code, c.size);
+    if (mprotect(code, c.size, PROT_READ | PROT_EXEC) < 0) {
+        goto error;
+    }
+    for (Py_ssize_t i = 0; i < n; i++) {
+        if (entries[i] != NULL) {
+            /* Turn the position into an address */
+            entries[i] = code + (Py_ssize_t)entries[i];
+        }
+    }
+    jit->code = code;
+    jit->size = c.size;
+    jit->quickened = co->co_quickened != NULL;
+    jit->entries = entries;
+    jit->previous = co->co_jit;
+    co->co_jit = jit;
+    PyMem_Free(c.code);
+    PyMem_Free(c.labels);
+    PyMem_Free(c.fixups);
+    PyMem_Free(c.stubs);
+    return 0;
+
+error:
+    if (code != MAP_FAILED) {
+        munmap(code, c.size);
+    }
+    PyMem_Free(jit);
+    PyMem_Free(entries);
+    PyMem_Free(c.code);
+    PyMem_Free(c.labels);
+    PyMem_Free(c.fixups);
+    PyMem_Free(c.stubs);
+    return -1;
+}
+
+typedef int (*jit_function)(_PyJITState *state, char *entry);
+
+int
+_PyJIT_Execute(PyCodeObject *co, _PyJITState *state, int offset)
+{
+    struct _PyJITCode *jit = co->co_jit;
+    char *entry = jit->entries[offset / UNIT];
+    assert(entry != NULL);
+    return ((jit_function)jit->code)(state, entry);
+}
+
+void
+_PyJIT_Free(PyCodeObject *co)
+{
+    struct _PyJITCode *jit = co->co_jit;
+    while (jit != NULL) {
+        struct _PyJITCode *previous = jit->previous;
+        munmap(jit->code, jit->size);
+        PyMem_Free(jit->entries);
+        PyMem_Free(jit);
+        jit = previous;
+    }
+    co->co_jit = NULL;
+}
+
+#else   /* !_Py_JIT_SUPPORTED */
+
+int
+_PyJIT_Compile(PyCodeObject *co)
+{
+    return -1;
+}
+
+int
+_PyJIT_Execute(PyCodeObject *co, _PyJITState *state, int offset)
+{
+    Py_UNREACHABLE();
+}
+
+void
+_PyJIT_Free(PyCodeObject *co)
+{
+    assert(co->co_jit == NULL);
+}
+
+#endif  /* _Py_JIT_SUPPORTED */
@@ -519,7 +519,7 @@ pycore_init_runtime(_PyRuntimeState *runtime,
 
 
 static PyStatus
-init_interp_create_gil(PyThreadState *tstate)
+init_interp_create_gil(PyThreadState *tstate, int own_gil)
 {
     PyStatus status;
 
@@ -534,7 +534,7 @@ init_interp_create_gil(PyThreadState *tstate)
     }
 
     /* Create the GIL and take it */
-    status = _PyEval_InitGIL(tstate);
+    status = _PyEval_InitGIL(tstate, own_gil);
     if (_PyStatus_EXCEPTION(status)) {
         return status;
     }
@@ -564,7 +564,7 @@ pycore_create_interpreter(_PyRuntimeState *runtime,
     }
     (void) PyThreadState_Swap(tstate);
 
-    status = init_interp_create_gil(tstate);
+    status = init_interp_create_gil(tstate, 0);
     if (_PyStatus_EXCEPTION(status)) {
         return status;
     }
@@ -1025,6 +1025,10 @@ init_interp_main(PyThreadState *tstate)
         }
     }
 
+    if (config->_pystats && _PyEval_SetStats(tstate, 1) < 0) {
+        return _PyStatus_ERR("can't start execution statistics");
+    }
+
     status = init_sys_streams(tstate);
     if (_PyStatus_EXCEPTION(status)) {
         return status;
@@ -1260,9 +1264,7 @@ finalize_interp_types(PyThreadState *tstate, int is_main_interp)
     if (is_main_interp) {
         _PySet_Fini();
     }
-    if (is_main_interp) {
-        _PyDict_Fini();
-    }
+    _PyDict_Fini(tstate);
     _PyList_Fini(tstate);
     _PyTuple_Fini(tstate);
 
@@ -1321,7 +1323,13 @@ finalize_interp_delete(PyThreadState *tstate)
        fail when it is being awaited by another running daemon thread (see
        bpo-9901). Instead pycore_create_interpreter() destroys the previously
        created GIL, which ensures that Py_Initialize / Py_FinalizeEx can be
-       called multiple times. */
+       called multiple times.
+
+       A subinterpreter which has its own GIL is isolated: it cannot spawn
+       threads, so its GIL can be destroyed with it. */
+    if (tstate->interp->ceval.own_gil) {
+        _PyEval_FiniGIL(tstate);
+    }
 
     PyInterpreterState_Delete(tstate->interp);
 }
@@ -1359,6 +1367,10 @@ Py_FinalizeEx(void)
 
     call_py_exitfuncs(tstate);
 
+    if (interp->config._pystats) {
+        _PyEval_PrintStats(tstate);
+    }
+
     /* Copy the core config, PyInterpreterState_Delete() free
        the core config memory */
 #ifdef Py_REF_DEBUG
@@ -1450,7 +1462,7 @@ Py_FinalizeEx(void)
     _PyImport_Fini();
 
     /* Cleanup typeobject.c's internal caches. */
-    _PyType_Fini();
+    _PyType_Fini(tstate);
 
     /* unload faulthandler module */
     _PyFaulthandler_Fini();
@@ -1573,7 +1585,15 @@ new_interpreter(PyThreadState **tstate_p, int isolated_subinterpreter)
     }
     interp->config._isolated_interpreter = isolated_subinterpreter;
 
-    status = init_interp_create_gil(tstate);
+    /* Isolated subinterpreters have their own GIL, and so run in parallel
+       with the other interpreters, in builds where the state shared by all
+       interpreters does not rely on the main GIL. */
+#ifdef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
+    int own_gil = isolated_subinterpreter;
+#else
+    int own_gil = 0;
+#endif
+    status = init_interp_create_gil(tstate, own_gil);
     if (_PyStatus_EXCEPTION(status)) {
         goto error;
     }
@@ -1652,12 +1672,19 @@ Py_EndInterpreter(PyThreadState *tstate)
 
     call_py_exitfuncs(tstate);
 
+    if (interp->config._pystats) {
+        _PyEval_PrintStats(tstate);
+    }
+
     if (tstate != interp->tstate_head || tstate->next != NULL) {
         Py_FatalError("not the last thread");
     }
 
     _PyImport_Cleanup(tstate);
     finalize_interp_clear(tstate);
+    /* Clearing the interpreter looks up attributes: only clear its type
+       cache after it */
+    _PyType_Fini(tstate);
     finalize_interp_delete(tstate);
 }
 
@@ -42,6 +42,7 @@ extern "C" {
 /* Forward declarations */
 static PyThreadState *_PyGILState_GetThisThreadState(struct _gilstate_runtime_state *gilstate);
 static void _PyThreadState_Delete(PyThreadState *tstate, int check_current);
+static void tstate_pool_clear(PyInterpreterState *interp);
 
 
 static PyStatus
@@ -214,6 +215,10 @@ PyInterpreterState_New(void)
     }
 
     _PyGC_InitState(&interp->gc);
+    if (_PyObject_InitState(interp) < 0) {
+        _PyEval_FiniState(&interp->ceval);
+        goto out_of_memory;
+    }
     PyConfig_InitPythonConfig(&interp->config);
 
     interp->eval_frame = _PyEval_EvalFrameDefault;
@@ -234,6 +239,7 @@ PyInterpreterState_New(void)
             _PyErr_SetString(tstate, PyExc_RuntimeError,
                              "failed to get an interpreter ID");
         }
+        _PyObject_FiniState(interp);
         PyMem_RawFree(interp);
         interp = NULL;
     }
@@ -288,6 +294,8 @@ PyInterpreterState_Clear(PyInterpreterState *interp)
 
     Py_CLEAR(interp->audit_hooks);
 
+    _PyEval_FiniStats(interp);
+
     PyConfig_Clear(&interp->config);
     Py_CLEAR(interp->codec_search_path);
     Py_CLEAR(interp->codec_search_cache);
@@ -352,6 +360,7 @@ PyInterpreterState_Delete(PyInterpreterState *interp)
         Py_FatalError("remaining threads");
     }
     *p = interp->next;
+    tstate_pool_clear(interp);
 
     if (interpreters->main == interp) {
         interpreters->main = NULL;
@@ -364,6 +373,7 @@ PyInterpreterState_Delete(PyInterpreterState *interp)
     if (interp->id_mutex != NULL) {
         PyThread_free_lock(interp->id_mutex);
     }
+    _PyObject_FiniState(interp);
     PyMem_RawFree(interp);
 }
 
@@ -397,11 +407,13 @@ _PyInterpreterState_DeleteExceptMain(_PyRuntimeState *runtime)
 
         PyInterpreterState_Clear(interp);  // XXX must activate?
         zapthreads(interp, 1);
+        tstate_pool_clear(interp);
         if (interp->id_mutex != NULL) {
             PyThread_free_lock(interp->id_mutex);
         }
         PyInterpreterState *prev_interp = interp;
         interp = interp->next;
+        _PyObject_FiniState(prev_interp);
         PyMem_RawFree(prev_interp);
     }
     HEAD_UNLOCK(runtime);
@@ -548,6 +560,50 @@ _PyInterpreterState_GetMainModule(PyInterpreterState *interp)
     return PyMapping_GetItemString(interp->modules, "__main__");
 }
 
+int
+_PyInterpreterState_HasOwnGIL(PyInterpreterState *interp)
+{
+    return interp->ceval.own_gil;
+}
+
+/* Mark the interpreter as running code on behalf of another interpreter.
+   Fail with RuntimeError if it is already running.  The flag can be read
+   from any interpreter, even when interp has its own GIL. */
+int
+_PyInterpreterState_SetRunningMain(PyInterpreterState *interp)
+{
+    _PyRuntimeState *runtime = interp->runtime;
+    int running;
+    HEAD_LOCK(runtime);
+    running = interp->running_main;
+    interp->running_main = 1;
+    HEAD_UNLOCK(runtime);
+    if (running) {
+        PyErr_SetString(PyExc_RuntimeError, "interpreter already running");
+        return -1;
+    }
+    return 0;
+}
+
+void
+_PyInterpreterState_SetNotRunningMain(PyInterpreterState *interp)
+{
+    _PyRuntimeState *runtime = interp->runtime;
+    HEAD_LOCK(runtime);
+    interp->running_main = 0;
+    HEAD_UNLOCK(runtime);
+}
+
+int
+_PyInterpreterState_IsRunningMain(PyInterpreterState *interp)
+{
+    _PyRuntimeState *runtime = interp->runtime;
+    HEAD_LOCK(runtime);
+    int running = interp->running_main;
+    HEAD_UNLOCK(runtime);
+    return running;
+}
+
 PyObject *
 PyInterpreterState_GetDict(PyInterpreterState *interp)
 {
@@ -565,9 +621,25 @@ static PyThreadState *
 new_threadstate(PyInterpreterState *interp, int init)
 {
     _PyRuntimeState *runtime = interp->runtime;
-    PyThreadState *tstate = (PyThreadState *)PyMem_RawMalloc(sizeof(PyThreadState));
+    struct _Py_tstate_state *pool = &interp->tstate_pool;
+    PyThreadState *tstate;
+
+    /* Reuse the thread state of an exited thread if possible: it saves
+       allocating both the thread state and its frame stack. */
+    HEAD_LOCK(runtime);
+    tstate = pool->free_list;
+    if (tstate != NULL) {
+        pool->free_list = tstate->next;
+        pool->numfree--;
+    }
+    HEAD_UNLOCK(runtime);
+
     if (tstate == NULL) {
-        return NULL;
+        tstate = (PyThreadState *)PyMem_RawMalloc(sizeof(PyThreadState));
+        if (tstate == NULL) {
+            return NULL;
+        }
+        tstate->frame_stack = NULL;
     }
 
     tstate->interp = interp;
@@ -613,6 +685,9 @@ new_threadstate(PyInterpreterState *interp, int init)
     tstate->context = NULL;
     tstate->context_ver = 1;
 
+    memset(&tstate->gil_stats, 0, sizeof(tstate->gil_stats));
+    tstate->gil_priority = 0;
+
     if (init) {
         _PyThreadState_Init(tstate);
     }
@@ -823,6 +898,11 @@ PyThreadState_Clear(PyThreadState *tstate)
 
     Py_CLEAR(tstate->context);
 
+    Py_CLEAR(tstate->gil_stats.max_hold_code);
+
+    /* Keep an empty frame stack chunk in case tstate gets pooled */
+    _PyFrame_ClearStack(tstate, 1);
+
     if (tstate->on_delete != NULL) {
         tstate->on_delete(tstate->on_delete_data);
     }
@@ -853,6 +933,13 @@ tstate_delete_common(PyThreadState *tstate,
     }
     HEAD_UNLOCK(runtime);
 
+    /* The GIL may still be held on behalf of tstate if another thread
+       state was swapped in: don't account the hold to a freed tstate. */
+    struct _gil_runtime_state *gil = interp->ceval.gil;
+    if (gil != NULL && gil->stats_holder == tstate) {
+        gil->stats_holder = NULL;
+    }
+
     if (gilstate->autoInterpreterState &&
         PyThread_tss_get(&gilstate->autoTSSkey) == tstate)
     {
@@ -861,17 +948,84 @@ tstate_delete_common(PyThreadState *tstate,
 }
 
 
+/* Put tstate, which has been unlinked from its interpreter, in the pool
+   of the interpreter for reuse by new_threadstate(), or free it if the
+   pool is full.  The interpreter may have been deleted meanwhile if the
+   GIL was released: only use it if it is still in the runtime list. */
+static void
+free_threadstate(_PyRuntimeState *runtime, PyThreadState *tstate)
+{
+    PyInterpreterState *interp = tstate->interp;
+
+    HEAD_LOCK(runtime);
+    PyInterpreterState *p = runtime->interpreters.head;
+    while (p != NULL && p != interp) {
+        p = p->next;
+    }
+    if (p != NULL
+        && interp->tstate_pool.numfree < PyThreadState_MAXFREELIST)
+    {
+        tstate->prev = NULL;
+        tstate->next = interp->tstate_pool.free_list;
+        interp->tstate_pool.free_list = tstate;
+        interp->tstate_pool.numfree++;
+        tstate = NULL;
+    }
+    HEAD_UNLOCK(runtime);
+
+    if (tstate != NULL) {
+        _PyFrame_ClearStack(tstate, 0);
+        PyMem_RawFree(tstate);
+    }
+}
+
+/* Free the thread states pooled by interp.  The caller must hold
+   HEAD_LOCK() or interp must be unreachable. */
+static void
+tstate_pool_clear(PyInterpreterState *interp)
+{
+    struct _Py_tstate_state *pool = &interp->tstate_pool;
+    while (pool->free_list != NULL) {
+        PyThreadState *tstate = pool->free_list;
+        pool->free_list = tstate->next;
+        _PyFrame_ClearStack(tstate, 0);
+        PyMem_RawFree(tstate);
+    }
+    pool->numfree = 0;
+}
+
+void
+_PyThreadState_ClearFreeList(PyThreadState *tstate)
+{
+    PyInterpreterState *interp = tstate->interp;
+    HEAD_LOCK(interp->runtime);
+    tstate_pool_clear(interp);
+    HEAD_UNLOCK(interp->runtime);
+}
+
+void
+_PyThreadState_DebugMallocStats(FILE *out)
+{
+    PyInterpreterState *interp = _PyInterpreterState_GET();
+    _PyDebugAllocatorStats(out,
+                           "free PyThreadState",
+                           interp->tstate_pool.numfree,
+                           sizeof(PyThreadState));
+}
+
+
 static void
 _PyThreadState_Delete(PyThreadState *tstate, int check_current)
 {
-    struct _gilstate_runtime_state *gilstate = &tstate->interp->runtime->gilstate;
+    _PyRuntimeState *runtime = tstate->interp->runtime;
+    struct _gilstate_runtime_state *gilstate = &runtime->gilstate;
     if (check_current) {
         if (tstate == _PyRuntimeGILState_GetThreadState(gilstate)) {
             _Py_FatalErrorFormat(__func__, "tstate %p is still current", tstate);
         }
     }
     tstate_delete_common(tstate, gilstate);
-    PyMem_RawFree(tstate);
+    free_threadstate(runtime, tstate);
 }
 
 
@@ -886,11 +1040,12 @@ void
 _PyThreadState_DeleteCurrent(PyThreadState *tstate)
 {
     _Py_EnsureTstateNotNULL(tstate);
-    struct _gilstate_runtime_state *gilstate = &tstate->interp->runtime->gilstate;
+    _PyRuntimeState *runtime = tstate->interp->runtime;
+    struct _gilstate_runtime_state *gilstate = &runtime->gilstate;
     tstate_delete_common(tstate, gilstate);
     _PyRuntimeGILState_SetThreadState(gilstate, NULL);
     _PyEval_ReleaseLock(tstate);
-    PyMem_RawFree(tstate);
+    free_threadstate(runtime, tstate);
 }
 
 void
@@ -939,7 +1094,7 @@ _PyThreadState_DeleteExcept(_PyRuntimeState *runtime, PyThreadState *tstate)
     for (p = list; p; p = next) {
         next = p->next;
         PyThreadState_Clear(p);
-        PyMem_RawFree(p);
+        free_threadstate(runtime, p);
     }
 }
 
@@ -1195,6 +1350,119 @@ done:
     return result;
 }
 
+static int
+gil_stats_set_time(PyObject *dict, const char *key, _PyTime_t t)
+{
+    PyObject *value = PyFloat_FromDouble(_PyTime_AsSecondsDouble(t));
+    if (value == NULL) {
+        return -1;
+    }
+    int res = PyDict_SetItemString(dict, key, value);
+    Py_DECREF(value);
+    return res;
+}
+
+static int
+gil_stats_set_count(PyObject *dict, const char *key, unsigned long long n)
+{
+    PyObject *value = PyLong_FromUnsignedLongLong(n);
+    if (value == NULL) {
+        return -1;
+    }
+    int res = PyDict_SetItemString(dict, key, value);
+    Py_DECREF(value);
+    return res;
+}
+
+static PyObject *
+gil_stats_as_dict(const _PyGILStats *stats)
+{
+    PyObject *dict = PyDict_New();
+    if (dict == NULL) {
+        return NULL;
+    }
+    if (gil_stats_set_count(dict, "acquisitions", stats->acquisitions) < 0
+        || gil_stats_set_count(dict, "contended", stats->contended) < 0
+        || gil_stats_set_count(dict, "drop_requests",
+                               stats->drop_requests) < 0
+        || gil_stats_set_count(dict, "forced_drops", stats->forced_drops) < 0
+        || gil_stats_set_time(dict, "wait_time", stats->wait_time) < 0
+        || gil_stats_set_time(dict, "hold_time", stats->hold_time) < 0
+        || gil_stats_set_time(dict, "max_hold_time",
+                              stats->max_hold_time) < 0)
+    {
+        goto error;
+    }
+
+    PyObject *code = stats->max_hold_code ? stats->max_hold_code : Py_None;
+    if (PyDict_SetItemString(dict, "max_hold_code", code) < 0) {
+        goto error;
+    }
+    PyObject *lineno;
+    if (stats->max_hold_code != NULL) {
+        lineno = PyLong_FromLong(stats->max_hold_lineno);
+        if (lineno == NULL) {
+            goto error;
+        }
+    }
+    else {
+        lineno = Py_None;
+        Py_INCREF(lineno);
+    }
+    int res = PyDict_SetItemString(dict, "max_hold_lineno", lineno);
+    Py_DECREF(lineno);
+    if (res < 0) {
+        goto error;
+    }
+    return dict;
+
+error:
+    Py_DECREF(dict);
+    return NULL;
+}
+
+PyObject *
+_PyThread_GILStats(void)
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    PyInterpreterState *interp = tstate->interp;
+
+    PyObject *result = PyDict_New();
+    if (result == NULL) {
+        return NULL;
+    }
+
+    /* The thread list can mutate even when the GIL is held, so grab
+       head_mutex for the duration. */
+    _PyRuntimeState *runtime = interp->runtime;
+    HEAD_LOCK(runtime);
+    for (PyThreadState *t = interp->tstate_head; t != NULL; t = t->next) {
+        PyObject *id = PyLong_FromUnsignedLong(t->thread_id);
+        if (id == NULL) {
+            goto fail;
+        }
+        PyObject *stats = gil_stats_as_dict(&t->gil_stats);
+        if (stats == NULL) {
+            Py_DECREF(id);
+            goto fail;
+        }
+        int res = PyDict_SetItem(result, id, stats);
+        Py_DECREF(id);
+        Py_DECREF(stats);
+        if (res < 0) {
+            goto fail;
+        }
+    }
+    goto done;
+
+fail:
+    Py_CLEAR(result);
+
+done:
+    HEAD_UNLOCK(runtime);
+    return result;
+}
+
 /* Python "auto thread state" API. */
 
 /* Keep this as a static, as it is not reliable!  It can only
@@ -1369,10 +1637,8 @@ PyGILState_Ensure(void)
 
     /* Ensure that _PyEval_InitThreads() and _PyGILState_Init() have been
        called by Py_Initialize() */
-#ifndef EXPERIMENTAL_ISOLATED_SUBINTERPRETERS
-    assert(_PyEval_ThreadsInitialized(runtime));
-#endif
     assert(gilstate->autoInterpreterState);
+    assert(_PyEval_ThreadsInitialized(gilstate->autoInterpreterState));
 
     PyThreadState *tcur = (PyThreadState *)PyThread_tss_get(&gilstate->autoTSSkey);
     int current;
@@ -1557,7 +1823,27 @@ _call_in_interpreter(struct _gilstate_runtime_state *gilstate,
      * naive approach.
      */
     PyThreadState *save_tstate = NULL;
-    if (interp != _PyRuntimeGILState_GetThreadState(gilstate)->interp) {
+    PyThreadState *cur_tstate = _PyThreadState_GET();
+    if (interp != cur_tstate->interp
+        && (interp->ceval.own_gil || cur_tstate->interp->ceval.own_gil))
+    {
+        // The interpreters don't share a GIL: take the GIL of interp
+        // with a thread state of our own, since the threads of interp
+        // run in parallel.
+        PyThreadState *tstate = PyThreadState_New(interp);
+        if (tstate == NULL) {
+            // XXX The data leaks.
+            return;
+        }
+        PyEval_SaveThread();
+        PyEval_RestoreThread(tstate);
+        func(arg);
+        PyThreadState_Clear(tstate);
+        _PyThreadState_DeleteCurrent(tstate);
+        PyEval_RestoreThread(cur_tstate);
+        return;
+    }
+    if (interp != cur_tstate->interp) {
         // XXX Using the "head" thread isn't strictly correct.
         PyThreadState *tstate = PyInterpreterState_ThreadHead(interp);
         // XXX Possible GILState issues?
@@ -0,0 +1,422 @@
+/* Specialization of hot bytecode ("quickening").
+
+   When a code object has been executed OPCACHE_MIN_RUNS times, the eval
+   loop creates its opcache (see _PyCode_InitOpcache() in
+   Objects/codeobject.c) together with a private copy of its bytecode,
+   co_quickened.  In that copy, every instruction listed in
+   _PyOpcode_Adaptive[] and having a cache entry is replaced by its
+   adaptive form.
+
+   The first time an adaptive instruction runs, it looks at its operands
+   and calls the matching _Py_Specialize_XXX() function below, which
+   rewrites it in co_quickened to a form specialized for the types it
+   sees (e.g. BINARY_ADD_INT for int + int).  If no specialized form
+   applies, the adaptive instruction runs the base instruction and waits
+   _Py_ADAPTIVE_BACKOFF executions before trying again.
+
+   A specialized instruction starts by checking that its guards still
+   hold (DEOPT_IF() in ceval.c).  When they don't, it runs the base
+   instruction instead, which is read from the unmodified co_code.  After
+   _Py_SPECIALIZED_MISS_BUDGET such misses, it is turned back into the
+   adaptive instruction so that the site can be re-specialized.
+
+   Superinstructions are inserted in co_quickened when it is created.
+   Each one replaces the first instruction of a pair that is frequent in
+   hot code (e.g. LOAD_FAST LOAD_FAST), and runs both instructions
+   without going back to the top of the eval loop in between.  The
+   second instruction is left alone, so that jumps to it still work.
+
+   Specialized instructions never change the behavior of the program, so
+   co_code, dis and the tracing machinery are unaffected by quickening.
+*/
+
+#include "Python.h"
+#include "pycore_code.h"
+#include "pycore_dict.h"          // PyDictKeysObject
+#include "pycore_object.h"        // _PyType_HasFeature()
+#include "opcode.h"
+#include "structmember.h"         // struct PyMemberDef, T_OBJECT_EX
+
+const unsigned char _PyOpcode_Adaptive[256] = {
+    [BINARY_ADD] = BINARY_ADD_ADAPTIVE,
+    /* For the types handled by BINARY_ADD_xxx, x += y is x + y */
+    [INPLACE_ADD] = BINARY_ADD_ADAPTIVE,
+    [COMPARE_OP] = COMPARE_OP_ADAPTIVE,
+    [FOR_ITER] = FOR_ITER_ADAPTIVE,
+    [CALL_FUNCTION] = CALL_FUNCTION_ADAPTIVE,
+    [CALL_METHOD] = CALL_METHOD_ADAPTIVE,
+    [LOAD_ATTR] = LOAD_ATTR_ADAPTIVE,
+    [STORE_ATTR] = STORE_ATTR_ADAPTIVE,
+};
+
+static int
+superinstruction(int first, int second)
+{
+    switch (first) {
+        case LOAD_FAST:
+            switch (second) {
+                case LOAD_FAST:
+                    return LOAD_FAST__LOAD_FAST;
+                case LOAD_CONST:
+                    return LOAD_FAST__LOAD_CONST;
+            }
+            break;
+        case LOAD_CONST:
+            switch (second) {
+                case LOAD_FAST:
+                    return LOAD_CONST__LOAD_FAST;
+                case RETURN_VALUE:
+                    return LOAD_CONST__RETURN_VALUE;
+            }
+            break;
+        case STORE_FAST:
+            switch (second) {
+                case LOAD_FAST:
+                    return STORE_FAST__LOAD_FAST;
+                case STORE_FAST:
+                    return STORE_FAST__STORE_FAST;
+            }
+            break;
+    }
+    return 0;
+}
+
+Py_ssize_t
+_Py_InsertSuperinstructions(_Py_CODEUNIT *instrs, Py_ssize_t n)
+{
+    Py_ssize_t count = 0;
+    /* Look at the opcodes before they are replaced: the second
+       instruction of a pair can be the first one of the next pair */
+    int first = n > 0 ? _Py_OPCODE(instrs[0]) : 0;
+    for (Py_ssize_t i = 0; i < n - 1; i++) {
+        int second = _Py_OPCODE(instrs[i + 1]);
+        int opcode = superinstruction(first, second);
+        if (opcode) {
+            _Py_SET_OPCODE(instrs[i], opcode);
+            count++;
+        }
+        first = second;
+    }
+    return count;
+}
+
+static int
+specialize(_Py_CODEUNIT *instr, int opcode, _PyOpcache *cache)
+{
+    _Py_SET_OPCODE(*instr, opcode);
+    cache->counter = _Py_SPECIALIZED_MISS_BUDGET;
+    return 0;
+}
+
+static int
+specialization_failed(_PyOpcache *cache)
+{
+    cache->counter = _Py_ADAPTIVE_BACKOFF;
+    return -1;
+}
+
+int
+_Py_Specialize_BinaryAdd(PyObject *left, PyObject *right,
+                         _Py_CODEUNIT *instr, _PyOpcache *cache)
+{
+    if (Py_TYPE(left) != Py_TYPE(right)) {
+        return specialization_failed(cache);
+    }
+    if (PyLong_CheckExact(left)) {
+        return specialize(instr, BINARY_ADD_INT, cache);
+    }
+    if (PyFloat_CheckExact(left)) {
+        return specialize(instr, BINARY_ADD_FLOAT, cache);
+    }
+    if (PyUnicode_CheckExact(left)) {
+        return specialize(instr, BINARY_ADD_UNICODE, cache);
+    }
+    return specialization_failed(cache);
+}
+
+int
+_Py_Specialize_CompareOp(PyObject *left, PyObject *right,
+                         _Py_CODEUNIT *instr, _PyOpcache *cache)
+{
+    int op = _Py_OPARG(*instr);
+    if (Py_TYPE(left) != Py_TYPE(right)) {
+        return specialization_failed(cache);
+    }
+    if (PyLong_CheckExact(left)) {
+        return specialize(instr, COMPARE_OP_INT, cache);
+    }
+    if (PyFloat_CheckExact(left)) {
+        return specialize(instr, COMPARE_OP_FLOAT, cache);
+    }
+    if (PyUnicode_CheckExact(left) && (op == Py_EQ || op == Py_NE)) {
+        return specialize(instr, COMPARE_OP_STR, cache);
+    }
+    return specialization_failed(cache);
+}
+
+int
+_Py_Specialize_ForIter(PyObject *iter, _Py_CODEUNIT *instr, _PyOpcache *cache)
+{
+    if (Py_IS_TYPE(iter, &PyListIter_Type)) {
+        return specialize(instr, FOR_ITER_LIST, cache);
+    }
+    if (Py_IS_TYPE(iter, &PyRangeIter_Type)) {
+        return specialize(instr, FOR_ITER_RANGE, cache);
+    }
+    return specialization_failed(cache);
+}
+
+int
+_Py_Specialize_CallFunction(PyObject *callable, int nargs,
+                            _Py_CODEUNIT *instr, _PyOpcache *cache)
+{
+    if (Py_IS_TYPE(callable, &PyFunction_Type)) {
+        return specialize(instr, CALL_FUNCTION_PY, cache);
+    }
+    if (PyCFunction_CheckExact(callable)) {
+        int flags = PyCFunction_GET_FLAGS(callable) & _Py_METH_CALL_FLAGS;
+        if (flags == METH_O && nargs == 1) {
+            return specialize(instr, CALL_FUNCTION_BUILTIN_O, cache);
+        }
+        if (flags == METH_FASTCALL ||
+            flags == (METH_FASTCALL | METH_KEYWORDS)) {
+            return specialize(instr, CALL_FUNCTION_BUILTIN_FAST, cache);
+        }
+    }
+    return specialization_failed(cache);
+}
+
+int
+_Py_Specialize_CallMethod(PyObject *meth, PyObject *self, int nargs,
+                          _Py_CODEUNIT *instr, _PyOpcache *cache)
+{
+    /* See CALL_METHOD in ceval.c for the two possible stack layouts */
+    PyObject *callable = meth != NULL ? meth : self;
+    if (Py_IS_TYPE(callable, &PyFunction_Type)) {
+        return specialize(instr, CALL_METHOD_PY, cache);
+    }
+    if (meth != NULL && Py_IS_TYPE(meth, &PyMethodDescr_Type)) {
+        PyMethodDescrObject *descr = (PyMethodDescrObject *)meth;
+        int flags = descr->d_method->ml_flags & _Py_METH_CALL_FLAGS;
+        if (!PyObject_TypeCheck(self, PyDescr_TYPE(descr))) {
+            return specialization_failed(cache);
+        }
+        if (flags == METH_O && nargs == 1) {
+            return specialize(instr, CALL_METHOD_DESCR_O, cache);
+        }
+        if (flags == METH_FASTCALL ||
+            flags == (METH_FASTCALL | METH_KEYWORDS)) {
+            return specialize(instr, CALL_METHOD_DESCR_FAST, cache);
+        }
+    }
+    return specialization_failed(cache);
+}
+
+
+/* Attribute access.
+
+   The specialized forms of LOAD_ATTR and STORE_ATTR cache the version tag
+   of the type of the owner.  As long as it is unchanged (PyType_Modified()
+   resets it to 0), the type and its bases have not been modified since
+   the specialization, so that the lookup of the name through the MRO
+   would give the same result.  What is then left to check is the entry
+   at the cached index of the instance dict, which is cheap: the key is
+   compared by identity, like in the dict lookup of interned strings.
+
+   Only objects using the generic attribute protocol are handled, and
+   only when the class attribute, if any, is a slot (a member descriptor
+   for an object field); names found in the instance dict are handled if
+   the class has no attribute with that name.
+*/
+
+/* Look up name in dict and return its index in the entries of its keys,
+   or -1 if name is not there. */
+static Py_ssize_t
+dict_index(PyDictObject *dict, PyObject *name)
+{
+    Py_hash_t hash = ((PyASCIIObject *)name)->hash;
+    PyObject *value;
+    Py_ssize_t ix;
+
+    if (hash == -1) {
+        hash = PyObject_Hash(name);
+        if (hash == -1) {
+            PyErr_Clear();
+            return -1;
+        }
+    }
+    ix = dict->ma_keys->dk_lookup(dict, name, hash, &value);
+    if (ix < 0 || value == NULL) {
+        /* DKIX_ERROR: let the generic code path raise it again */
+        PyErr_Clear();
+        return -1;
+    }
+    return ix;
+}
+
+/* Find how the attribute name of owner is accessed.  Store the version of
+   the type of owner in the cache and return the class attribute (or NULL),
+   or return NULL with *cacheable set to 0 if the access cannot be cached.
+*/
+static PyObject *
+lookup_class_attribute(PyObject *owner, PyObject *name,
+                       _PyOpcache *cache, int *cacheable)
+{
+    PyTypeObject *type = Py_TYPE(owner);
+    PyObject *descr;
+
+    *cacheable = 0;
+    if (!PyUnicode_CheckExact(name) || type->tp_dict == NULL) {
+        return NULL;
+    }
+    descr = _PyType_Lookup(type, name);
+    /* _PyType_Lookup() assigns the version tag if needed */
+    if (!_PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG) ||
+        type->tp_version_tag == 0) {
+        return NULL;
+    }
+    cache->u.attr.tp_version = type->tp_version_tag;
+    *cacheable = 1;
+    return descr;
+}
+
+/* Return the offset of the slot described by descr, or -1 */
+static Py_ssize_t
+slot_offset(PyObject *descr, int for_store)
+{
+    PyMemberDef *member;
+
+    if (!Py_IS_TYPE(descr, &PyMemberDescr_Type)) {
+        return -1;
+    }
+    member = ((PyMemberDescrObject *)descr)->d_member;
+    if (member->type != T_OBJECT_EX) {
+        return -1;
+    }
+    if (for_store ? (member->flags & READONLY) != 0
+                  : (member->flags & READ_RESTRICTED) != 0) {
+        return -1;
+    }
+    return member->offset;
+}
+
+/* Return the instance dict of owner, or NULL */
+static PyDictObject *
+instance_dict(PyObject *owner)
+{
+    Py_ssize_t dictoffset = Py_TYPE(owner)->tp_dictoffset;
+
+    /* A negative offset is relative to the end of a variable-size
+       object: leave them to the generic code path. */
+    if (dictoffset <= 0) {
+        return NULL;
+    }
+    return *(PyDictObject **)((char *)owner + dictoffset);
+}
+
+int
+_Py_Specialize_LoadAttr(PyObject *owner, PyObject *name,
+                        _Py_CODEUNIT *instr, _PyOpcache *cache)
+{
+    PyObject *descr;
+    PyDictObject *dict;
+    Py_ssize_t index;
+    int cacheable;
+
+    if (PyModule_CheckExact(owner)) {
+        /* module_getattro() only differs from the generic lookup when
+           the name is not found */
+        descr = _PyType_Lookup(&PyModule_Type, name);
+        dict = instance_dict(owner);
+        if (descr != NULL || dict == NULL || dict->ma_values != NULL) {
+            return specialization_failed(cache);
+        }
+        index = dict_index(dict, name);
+        if (index < 0) {
+            return specialization_failed(cache);
+        }
+        cache->u.attr.index = index;
+        return specialize(instr, LOAD_ATTR_MODULE, cache);
+    }
+    if (Py_TYPE(owner)->tp_getattro != PyObject_GenericGetAttr) {
+        return specialization_failed(cache);
+    }
+    descr = lookup_class_attribute(owner, name, cache, &cacheable);
+    if (!cacheable) {
+        return specialization_failed(cache);
+    }
+    if (descr != NULL) {
+        index = slot_offset(descr, 0);
+        if (index < 0) {
+            return specialization_failed(cache);
+        }
+        cache->u.attr.index = index;
+        return specialize(instr, LOAD_ATTR_SLOT, cache);
+    }
+    dict = instance_dict(owner);
+    if (dict == NULL) {
+        return specialization_failed(cache);
+    }
+    index = dict_index(dict, name);
+    if (index < 0) {
+        return specialization_failed(cache);
+    }
+    cache->u.attr.index = index;
+    if (dict->ma_values != NULL) {
+        return specialize(instr, LOAD_ATTR_SPLIT_KEYS, cache);
+    }
+    return specialize(instr, LOAD_ATTR_WITH_HINT, cache);
+}
+
+int
+_Py_Specialize_StoreAttr(PyObject *owner, PyObject *name,
+                         _Py_CODEUNIT *instr, _PyOpcache *cache)
+{
+    PyObject *descr;
+    PyDictObject *dict;
+    Py_ssize_t index;
+    int cacheable;
+
+    if (Py_TYPE(owner)->tp_setattro != PyObject_GenericSetAttr) {
+        return specialization_failed(cache);
+    }
+    descr = lookup_class_attribute(owner, name, cache, &cacheable);
+    if (!cacheable) {
+        return specialization_failed(cache);
+    }
+    if (descr != NULL) {
+        index = slot_offset(descr, 1);
+        if (index < 0) {
+            return specialization_failed(cache);
+        }
+        cache->u.attr.index = index;
+        return specialize(instr, STORE_ATTR_SLOT, cache);
+    }
+    dict = instance_dict(owner);
+    if (dict == NULL) {
+        return specialization_failed(cache);
+    }
+    if (dict->ma_values != NULL) {
+        /* The name may not be set yet in this instance, but it must be
+           in the keys shared by the instances of the class. */
+        PyObject *value;
+        Py_hash_t hash = PyObject_Hash(name);
+        if (hash == -1) {
+            PyErr_Clear();
+            return specialization_failed(cache);
+        }
+        index = dict->ma_keys->dk_lookup(dict, name, hash, &value);
+        if (index < 0) {
+            PyErr_Clear();
+            return specialization_failed(cache);
+        }
+        cache->u.attr.index = index;
+        return specialize(instr, STORE_ATTR_SPLIT_KEYS, cache);
+    }
+    index = dict_index(dict, name);
+    if (index < 0) {
+        return specialization_failed(cache);
+    }
+    cache->u.attr.index = index;
+    return specialize(instr, STORE_ATTR_WITH_HINT, cache);
+}
@@ -88,6 +88,7 @@ ste_new(struct symtable *st, identifier name, _Py_block_ty block,
     ste->ste_generator = 0;
     ste->ste_coroutine = 0;
     ste->ste_comprehension = 0;
+    ste->ste_comp_inlined = 0;
     ste->ste_returns_value = 0;
     ste->ste_needs_class_closure = 0;
     ste->ste_comp_iter_target = 0;
@@ -709,6 +710,158 @@ error:
     return 0;
 }
 
+/* Return true if the comprehension entry can be compiled inline in the
+   function enclosing it: it is a list, set or dict comprehension, it is
+   not asynchronous and all the blocks nested in it are inlined too, so
+   that none of its variables is a cell variable.
+*/
+static int
+is_inlinable_comprehension(PySTEntryObject *entry)
+{
+    PyObject *name, *v;
+    Py_ssize_t i, pos = 0;
+
+    if (!entry->ste_comprehension || entry->ste_generator ||
+        entry->ste_coroutine)
+        return 0;
+    for (i = 0; i < PyList_GET_SIZE(entry->ste_children); i++) {
+        PySTEntryObject *child;
+        child = (PySTEntryObject *)PyList_GET_ITEM(entry->ste_children, i);
+        if (!child->ste_comp_inlined)
+            return 0;
+    }
+    while (PyDict_Next(entry->ste_symbols, &pos, &name, &v)) {
+        long scope = (PyLong_AS_LONG(v) >> SCOPE_OFFSET) & SCOPE_MASK;
+        if (scope == CELL)
+            return 0;
+    }
+    return 1;
+}
+
+/* Add to names the variables bound by the inlined comprehension entry
+   and by the comprehensions inlined in it.  The hidden ".0" parameter
+   is not used by the inlined code. */
+static int
+inlined_comprehension_locals(PySTEntryObject *entry, PyObject *names)
+{
+    PyObject *name, *v;
+    Py_ssize_t i, pos = 0;
+
+    while (PyDict_Next(entry->ste_symbols, &pos, &name, &v)) {
+        long flags = PyLong_AS_LONG(v);
+        if (((flags >> SCOPE_OFFSET) & SCOPE_MASK) == LOCAL &&
+            !(flags & DEF_PARAM) && PySet_Add(names, name) < 0)
+            return 0;
+    }
+    for (i = 0; i < PyList_GET_SIZE(entry->ste_children); i++) {
+        PyObject *child = PyList_GET_ITEM(entry->ste_children, i);
+        if (!inlined_comprehension_locals((PySTEntryObject *)child, names))
+            return 0;
+    }
+    return 1;
+}
+
+/* Collect in allfree the free variables of the children of ste, given in
+   the list childfrees.  The variables of the function that an inlined
+   comprehension uses are local to the code it is compiled in, so they
+   are left out.
+*/
+static int
+merge_children_free(PySTEntryObject *ste, PyObject *scopes,
+                    PyObject *childfrees, PyObject *allfree)
+{
+    Py_ssize_t i;
+
+    if (PySet_Clear(allfree) < 0)
+        return 0;
+    for (i = 0; i < PyList_GET_SIZE(ste->ste_children); i++) {
+        PySTEntryObject *entry;
+        PyObject *child_free = PyList_GET_ITEM(childfrees, i);
+        PyObject *name, *v;
+        Py_ssize_t pos = 0;
+        Py_hash_t hash;
+
+        entry = (PySTEntryObject *)PyList_GET_ITEM(ste->ste_children, i);
+        while (_PySet_NextEntry(child_free, &pos, &name, &hash)) {
+            if (entry->ste_comp_inlined) {
+                v = PyDict_GetItemWithError(scopes, name);
+                if (v && PyLong_AS_LONG(v) == LOCAL)
+                    continue;
+                if (PyErr_Occurred())
+                    return 0;
+            }
+            if (PySet_Add(allfree, name) < 0)
+                return 0;
+        }
+    }
+    return 1;
+}
+
+/* Decide which comprehensions among the children of the function ste are
+   inlined, and collect the free variables of its children in allfree.
+
+   The variables bound by an inlined comprehension are fast locals of the
+   function, saved before the comprehension runs and restored after it (see
+   compiler_comprehension()).  This only works if the function has no cell
+   or free variable of the same name, so a comprehension is not inlined if
+   one of its variables is free in the function or in another child that is
+   not inlined.  Since not inlining a comprehension adds its free variables
+   to allfree, this is repeated until no more comprehensions are dropped.
+*/
+static int
+inline_comprehensions(PySTEntryObject *ste, PyObject *scopes,
+                      PyObject *childfrees, PyObject *allfree)
+{
+    PyObject *names = NULL;
+    Py_ssize_t i;
+    int changed;
+
+    for (i = 0; i < PyList_GET_SIZE(ste->ste_children); i++) {
+        PySTEntryObject *entry;
+        entry = (PySTEntryObject *)PyList_GET_ITEM(ste->ste_children, i);
+        entry->ste_comp_inlined = is_inlinable_comprehension(entry);
+    }
+    names = PySet_New(NULL);
+    if (!names)
+        return 0;
+    do {
+        changed = 0;
+        if (!merge_children_free(ste, scopes, childfrees, allfree))
+            goto error;
+        for (i = 0; i < PyList_GET_SIZE(ste->ste_children); i++) {
+            PySTEntryObject *entry;
+            PyObject *name, *v;
+            Py_ssize_t pos = 0;
+            Py_hash_t hash;
+
+            entry = (PySTEntryObject *)PyList_GET_ITEM(ste->ste_children, i);
+            if (!entry->ste_comp_inlined)
+                continue;
+            if (PySet_Clear(names) < 0 ||
+                !inlined_comprehension_locals(entry, names))
+                goto error;
+            while (_PySet_NextEntry(names, &pos, &name, &hash)) {
+                int contains = PySet_Contains(allfree, name);
+                if (contains < 0)
+                    goto error;
+                v = PyDict_GetItemWithError(scopes, name);
+                if (!v && PyErr_Occurred())
+                    goto error;
+                if (contains || (v && PyLong_AS_LONG(v) == FREE)) {
+                    entry->ste_comp_inlined = 0;
+                    changed = 1;
+                    break;
+                }
+            }
+        }
+    } while (changed);
+    Py_DECREF(names);
+    return 1;
+ error:
+    Py_DECREF(names);
+    return 0;
+}
+
 /* Make final symbol table decisions for block of ste.
 
    Arguments:
@@ -739,7 +892,7 @@ analyze_block(PySTEntryObject *ste, PyObject *bound, PyObject *free,
 {
     PyObject *name, *v, *local = NULL, *scopes = NULL, *newbound = NULL;
     PyObject *newglobal = NULL, *newfree = NULL, *allfree = NULL;
-    PyObject *temp;
+    PyObject *childfrees = NULL, *temp;
     int i, success = 0;
     Py_ssize_t pos = 0;
 
@@ -831,25 +984,44 @@ analyze_block(PySTEntryObject *ste, PyObject *bound, PyObject *free,
     /* Recursively call analyze_child_block() on each child block.
 
        newbound, newglobal now contain the names visible in
-       nested blocks.  The free variables in the children will
-       be collected in allfree.
+       nested blocks.  The free variables of each child are
+       collected in childfrees, and then in allfree.
     */
-    allfree = PySet_New(NULL);
-    if (!allfree)
+    childfrees = PyList_New(0);
+    if (!childfrees)
         goto error;
     for (i = 0; i < PyList_GET_SIZE(ste->ste_children); ++i) {
         PyObject *c = PyList_GET_ITEM(ste->ste_children, i);
+        PyObject *child_free;
         PySTEntryObject* entry;
         assert(c && PySTEntry_Check(c));
         entry = (PySTEntryObject*)c;
+        child_free = PySet_New(NULL);
+        if (!child_free)
+            goto error;
+        if (PyList_Append(childfrees, child_free) < 0) {
+            Py_DECREF(child_free);
+            goto error;
+        }
+        Py_DECREF(child_free);
         if (!analyze_child_block(entry, newbound, newfree, newglobal,
-                                 allfree))
+                                 child_free))
             goto error;
         /* Check if any children have free variables */
         if (entry->ste_free || entry->ste_child_free)
             ste->ste_child_free = 1;
     }
 
+    allfree = PySet_New(NULL);
+    if (!allfree)
+        goto error;
+    if (ste->ste_type == FunctionBlock) {
+        if (!inline_comprehensions(ste, scopes, childfrees, allfree))
+            goto error;
+    }
+    else if (!merge_children_free(ste, scopes, childfrees, allfree))
+        goto error;
+
     temp = PyNumber_InPlaceOr(newfree, allfree);
     if (!temp)
         goto error;
@@ -877,6 +1049,7 @@ analyze_block(PySTEntryObject *ste, PyObject *bound, PyObject *free,
     Py_XDECREF(newglobal);
     Py_XDECREF(newfree);
     Py_XDECREF(allfree);
+    Py_XDECREF(childfrees);
     if (!success)
         assert(PyErr_Occurred());
     return success;
@@ -1143,6 +1143,137 @@ sys_getswitchinterval_impl(PyObject *module)
     return 1e-6 * _PyEval_GetSwitchInterval();
 }
 
+/*[clinic input]
+sys._setgilstats
+
+    enabled: bool
+    /
+
+Enable or disable the collection of GIL statistics.
+
+The statistics are collected for the GIL of the current interpreter.
+See sys._getgilstats().
+[clinic start generated code]*/
+
+static PyObject *
+sys__setgilstats_impl(PyObject *module, int enabled)
+/*[clinic end generated code: output=0f0e60e3ae43dfa8 input=d899fd1082f5e690]*/
+{
+    _PyEval_SetGILStats(enabled);
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+sys._getgilstats
+
+Return a dict mapping each thread's thread id to its GIL statistics.
+
+Only threads of the current interpreter are included.  The statistics
+of each thread are a dict with the following keys:
+
+  acquisitions: number of times the thread took the GIL
+  contended: number of acquisitions which waited for another thread
+  drop_requests: number of times the thread asked the holder to drop it
+  forced_drops: number of times the thread dropped it on request
+  wait_time: total time spent waiting for the GIL, in seconds
+  hold_time: total time the GIL was held, in seconds
+  max_hold_time: longest time the GIL was held at once, in seconds
+  max_hold_code: code object running when that hold ended, or None
+  max_hold_lineno: line number running when that hold ended, or None
+
+Statistics are only collected while enabled with sys._setgilstats().
+[clinic start generated code]*/
+
+static PyObject *
+sys__getgilstats_impl(PyObject *module)
+/*[clinic end generated code: output=6cfe4e3b51e0e160 input=d17fec6b8e5ff54e]*/
+{
+    return _PyThread_GILStats();
+}
+
+static const char * const gil_mode_names[] = {
+    [_PyGIL_MODE_DEFAULT] = "default",
+    [_PyGIL_MODE_FIFO] = "fifo",
+    [_PyGIL_MODE_PRIORITY] = "priority",
+};
+
+/*[clinic input]
+sys._setgilmode
+
+    mode: str
+    /
+
+Set the scheduling mode of the GIL of the current interpreter.
+
+"default": the GIL goes to whichever thread takes it first.
+"fifo": threads waiting for the GIL get it in the order they asked for it.
+"priority": like "fifo", but threads with a higher priority (see
+sys._setgilpriority()) go first, and threads coming back from a blocking
+call go before threads which were forced to drop the GIL.
+[clinic start generated code]*/
+
+static PyObject *
+sys__setgilmode_impl(PyObject *module, const char *mode)
+/*[clinic end generated code: output=2cc9044a7c21d35a input=47c38e5f6bc7a4fb]*/
+{
+    for (int i = 0; i < (int)Py_ARRAY_LENGTH(gil_mode_names); i++) {
+        if (strcmp(mode, gil_mode_names[i]) == 0) {
+            _PyEval_SetGILMode(i);
+            Py_RETURN_NONE;
+        }
+    }
+    PyErr_Format(PyExc_ValueError, "unknown GIL mode: %s", mode);
+    return NULL;
+}
+
+/*[clinic input]
+sys._getgilmode
+
+Return the scheduling mode of the GIL; see sys._setgilmode().
+[clinic start generated code]*/
+
+static PyObject *
+sys__getgilmode_impl(PyObject *module)
+/*[clinic end generated code: output=26320421af6979a9 input=6f90a8b3a73fb055]*/
+{
+    return PyUnicode_FromString(gil_mode_names[_PyEval_GetGILMode()]);
+}
+
+/*[clinic input]
+sys._setgilpriority
+
+    priority: int
+    /
+
+Set the GIL priority of the current thread.
+
+The priority is only used by the "priority" GIL mode; threads with a
+higher priority take the GIL first.  The default priority is 0.
+[clinic start generated code]*/
+
+static PyObject *
+sys__setgilpriority_impl(PyObject *module, int priority)
+/*[clinic end generated code: output=d91af7a97bd1da66 input=e9e2c24aa5e79f51]*/
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    tstate->gil_priority = priority;
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+sys._getgilpriority -> int
+
+Return the GIL priority of the current thread.
+[clinic start generated code]*/
+
+static int
+sys__getgilpriority_impl(PyObject *module)
+/*[clinic end generated code: output=49f675852fd3c85f input=628e3b0e278de478]*/
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    return tstate->gil_priority;
+}
+
 /*[clinic input]
 sys.setrecursionlimit
 
@@ -1901,6 +2032,77 @@ sys__clear_type_cache_impl(PyObject *module)
     Py_RETURN_NONE;
 }
 
+/*[clinic input]
+sys._stats_on
+
+Start collecting execution statistics in the current interpreter.
+
+Executions of each instruction, hits and misses of the opcode caches,
+specializations and deoptimizations, and calls of code objects are
+counted until sys._stats_off() is called.
+[clinic start generated code]*/
+
+static PyObject *
+sys__stats_on_impl(PyObject *module)
+/*[clinic end generated code: output=aca53eafcbb4d9fe input=7ca06bd2829a15b4]*/
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    if (_PyEval_SetStats(tstate, 1) < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+sys._stats_off
+
+Stop collecting execution statistics in the current interpreter.
+
+The statistics are kept until sys._stats_clear() is called.
+[clinic start generated code]*/
+
+static PyObject *
+sys__stats_off_impl(PyObject *module)
+/*[clinic end generated code: output=1534c1ee63812214 input=67773e0b9479a4cd]*/
+{
+    PyThreadState *tstate = _PyThreadState_GET();
+    if (_PyEval_SetStats(tstate, 0) < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+sys._stats_clear
+
+Reset the execution statistics of the current interpreter.
+[clinic start generated code]*/
+
+static PyObject *
+sys__stats_clear_impl(PyObject *module)
+/*[clinic end generated code: output=fb65a2525ee50604 input=49d548c0f16ba8c6]*/
+{
+    _PyEval_ClearStats(_PyInterpreterState_GET());
+    Py_RETURN_NONE;
+}
+
+/*[clinic input]
+sys._stats_dump
+
+Return the execution statistics of the current interpreter.
+
+The result is a dict.  Its "opcodes" item maps the name of each
+instruction that was counted to a dict of its counters, and its "calls"
+item maps code objects to the number of times they were entered.
+[clinic start generated code]*/
+
+static PyObject *
+sys__stats_dump_impl(PyObject *module)
+/*[clinic end generated code: output=79f796fb2b4ddf05 input=caf5f34a959132f2]*/
+{
+    return _PyEval_GetStats(_PyThreadState_GET());
+}
+
 /*[clinic input]
 sys.is_finalizing
 
@@ -1967,6 +2169,12 @@ static PyMethodDef sys_methods[] = {
     SYS_MDEBUG_METHODDEF
     SYS_SETSWITCHINTERVAL_METHODDEF
     SYS_GETSWITCHINTERVAL_METHODDEF
+    SYS__SETGILSTATS_METHODDEF
+    SYS__GETGILSTATS_METHODDEF
+    SYS__SETGILMODE_METHODDEF
+    SYS__GETGILMODE_METHODDEF
+    SYS__SETGILPRIORITY_METHODDEF
+    SYS__GETGILPRIORITY_METHODDEF
     SYS_SETDLOPENFLAGS_METHODDEF
     {"setprofile",      sys_setprofile, METH_O, setprofile_doc},
     SYS_GETPROFILE_METHODDEF
@@ -1975,6 +2183,10 @@ static PyMethodDef sys_methods[] = {
     SYS_GETTRACE_METHODDEF
     SYS_CALL_TRACING_METHODDEF
     SYS__DEBUGMALLOCSTATS_METHODDEF
+    SYS__STATS_ON_METHODDEF
+    SYS__STATS_OFF_METHODDEF
+    SYS__STATS_CLEAR_METHODDEF
+    SYS__STATS_DUMP_METHODDEF
     SYS_SET_COROUTINE_ORIGIN_TRACKING_DEPTH_METHODDEF
     SYS_GET_COROUTINE_ORIGIN_TRACKING_DEPTH_METHODDEF
     {"set_asyncgen_hooks", (PyCFunction)(void(*)(void))sys_set_asyncgen_hooks,
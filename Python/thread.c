@@ -191,7 +191,9 @@ PyThread_GetInfo(void)
     PyStructSequence_SET_ITEM(threadinfo, pos++, value);
 
 #ifdef _POSIX_THREADS
-#ifdef USE_SEMAPHORES
+#if defined(USE_FUTEX_LOCKS)
+    value = PyUnicode_FromString("futex");
+#elif defined(USE_SEMAPHORES)
     value = PyUnicode_FromString("semaphore");
 #else
     value = PyUnicode_FromString("mutex+cond");
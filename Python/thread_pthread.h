@@ -95,6 +95,16 @@
 #  undef USE_SEMAPHORES
 #endif
 
+/* On Linux, Python locks are built directly on futexes: the uncontended
+ * acquire and release are a single atomic instruction each and don't enter
+ * the kernel, and a contended acquire spins a little before sleeping.
+ */
+#if defined(__linux__) && defined(SYS_futex) && defined(__GNUC__)
+#  include <linux/futex.h>
+#  include <unistd.h>           /* sysconf() */
+#  define USE_FUTEX_LOCKS
+#endif
+
 
 /* On platforms that don't use standard POSIX threads pthread_sigmask()
  * isn't present.  DEC threads uses sigprocmask() instead as do most
@@ -197,6 +207,104 @@ typedef struct {
 #define CHECK_STATUS_PTHREAD(name)  if (status != 0) { fprintf(stderr, \
     "%s: %s\n", name, strerror(status)); error = 1; }
 
+#ifdef USE_FUTEX_LOCKS
+
+/* The futex_lock struct implements a Python lock as a futex word holding
+ * one of three states (see Ulrich Drepper, "Futexes Are Tricky"):
+ *
+ *  FUTEX_UNLOCKED: nobody holds the lock,
+ *  FUTEX_LOCKED: the lock is held and nobody sleeps on it,
+ *  FUTEX_CONTENDED: the lock is held and threads may sleep on it.
+ *
+ * Acquiring an unlocked lock is a single compare-and-swap, and releasing a
+ * lock only makes a FUTEX_WAKE system call if it was contended.  Since the
+ * kernel keeps the queue of sleeping threads keyed by address, a lock
+ * doesn't need any memory besides its state.
+ *
+ * Before sleeping, a contended acquire spins for a while, since the lock
+ * is often released shortly.  As with glibc's adaptive mutexes, the number
+ * of iterations is bounded by a moving average of the spins which
+ * succeeded on this lock, so that a lock held for long periods quickly
+ * stops spinning.  Spinning is disabled when a single CPU is online.
+ */
+
+#define FUTEX_UNLOCKED 0
+#define FUTEX_LOCKED 1
+#define FUTEX_CONTENDED 2
+
+/* Maximum number of spin iterations for a contended acquire */
+#define FUTEX_MAX_SPIN 100
+
+typedef struct {
+    int state;
+    int spin;     /* estimate of the spin iterations needed to acquire */
+} futex_lock;
+
+static int futex_max_spin = 0;
+
+static void
+futex_init_spin(void)
+{
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    futex_max_spin = (ncpu > 1) ? FUTEX_MAX_SPIN : 0;
+}
+
+static inline int
+futex_wait(int *addr, int value, const struct timespec *timeout)
+{
+    return (int)syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, value,
+                        timeout, NULL, 0);
+}
+
+static inline void
+futex_wake(int *addr, int nwake)
+{
+    (void)syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, nwake, NULL, NULL, 0);
+}
+
+static inline int
+futex_trylock(futex_lock *lock)
+{
+    int expected = FUTEX_UNLOCKED;
+    return __atomic_compare_exchange_n(&lock->state, &expected, FUTEX_LOCKED,
+                                       0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static inline void
+futex_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/* Spin while the lock is held.  Return 1 if the lock was acquired. */
+static int
+futex_spin(futex_lock *lock)
+{
+    int spin = __atomic_load_n(&lock->spin, __ATOMIC_RELAXED);
+    int max_spin = Py_MIN(spin * 2 + 10, futex_max_spin);
+    int i;
+
+    for (i = 0; i < max_spin; i++) {
+        if (__atomic_load_n(&lock->state, __ATOMIC_RELAXED) == FUTEX_UNLOCKED
+            && futex_trylock(lock))
+        {
+            __atomic_store_n(&lock->spin, spin + (i - spin) / 8,
+                             __ATOMIC_RELAXED);
+            return 1;
+        }
+        futex_cpu_relax();
+    }
+    __atomic_store_n(&lock->spin, spin + (max_spin - spin) / 8,
+                     __ATOMIC_RELAXED);
+    return 0;
+}
+
+#endif /* USE_FUTEX_LOCKS */
+
 /*
  * Initialization.
  */
@@ -208,6 +316,9 @@ PyThread__init_thread(void)
     pthread_init();
 #endif
     init_condattr();
+#ifdef USE_FUTEX_LOCKS
+    futex_init_spin();
+#endif
 }
 
 /*
@@ -361,7 +472,119 @@ PyThread_exit_thread(void)
     pthread_exit(0);
 }
 
-#ifdef USE_SEMAPHORES
+#if defined(USE_FUTEX_LOCKS)
+
+/*
+ * Lock support.
+ */
+
+PyThread_type_lock
+PyThread_allocate_lock(void)
+{
+    futex_lock *lock;
+
+    dprintf(("PyThread_allocate_lock called\n"));
+    if (!initialized)
+        PyThread_init_thread();
+
+    lock = (futex_lock *)PyMem_RawCalloc(1, sizeof(futex_lock));
+
+    dprintf(("PyThread_allocate_lock() -> %p\n", (void *)lock));
+    return (PyThread_type_lock)lock;
+}
+
+void
+PyThread_free_lock(PyThread_type_lock lock)
+{
+    dprintf(("PyThread_free_lock(%p) called\n", lock));
+
+    PyMem_RawFree(lock);
+}
+
+PyLockStatus
+PyThread_acquire_lock_timed(PyThread_type_lock lock, PY_TIMEOUT_T microseconds,
+                            int intr_flag)
+{
+    PyLockStatus success = PY_LOCK_ACQUIRED;
+    futex_lock *thelock = (futex_lock *)lock;
+    struct timespec ts, *timeout = NULL;
+    _PyTime_t deadline = 0;
+
+    dprintf(("PyThread_acquire_lock_timed(%p, %lld, %d) called\n",
+             lock, microseconds, intr_flag));
+
+    if (microseconds > PY_TIMEOUT_MAX) {
+        Py_FatalError("Timeout larger than PY_TIMEOUT_MAX");
+    }
+
+    if (futex_trylock(thelock)) {
+        goto done;
+    }
+    if (microseconds == 0) {
+        success = PY_LOCK_FAILURE;
+        goto done;
+    }
+    if (futex_max_spin && futex_spin(thelock)) {
+        goto done;
+    }
+
+    if (microseconds > 0) {
+        /* cannot overflow thanks to (microseconds > PY_TIMEOUT_MAX)
+           check done above */
+        _PyTime_t t = _PyTime_FromNanoseconds(microseconds * 1000);
+        deadline = _PyTime_GetMonotonicClock() + t;
+        timeout = &ts;
+    }
+
+    /* Mark the lock as contended, so that its owner wakes us up when it
+       releases the lock, and sleep until we find it unlocked. */
+    while (__atomic_exchange_n(&thelock->state, FUTEX_CONTENDED,
+                               __ATOMIC_ACQUIRE) != FUTEX_UNLOCKED) {
+        if (timeout != NULL) {
+            /* FUTEX_WAIT takes a timeout relative to the monotonic clock */
+            _PyTime_t dt = deadline - _PyTime_GetMonotonicClock();
+            if (dt <= 0) {
+                success = PY_LOCK_FAILURE;
+                break;
+            }
+            if (_PyTime_AsTimespec(dt, &ts) < 0) {
+                /* Cannot occur thanks to (microseconds > PY_TIMEOUT_MAX)
+                   check done above */
+                Py_UNREACHABLE();
+            }
+        }
+        if (futex_wait(&thelock->state, FUTEX_CONTENDED, timeout) < 0) {
+            /* EAGAIN: the lock was released before we slept.
+               ETIMEDOUT: checked against the deadline above.
+               EINTR: retry if interrupted by a signal, unless the caller
+               wants to be notified. */
+            if (errno == EINTR && intr_flag) {
+                success = PY_LOCK_INTR;
+                break;
+            }
+        }
+    }
+
+done:
+    dprintf(("PyThread_acquire_lock_timed(%p, %lld, %d) -> %d\n",
+             lock, microseconds, intr_flag, success));
+    return success;
+}
+
+void
+PyThread_release_lock(PyThread_type_lock lock)
+{
+    futex_lock *thelock = (futex_lock *)lock;
+
+    dprintf(("PyThread_release_lock(%p) called\n", lock));
+
+    if (__atomic_exchange_n(&thelock->state, FUTEX_UNLOCKED,
+                            __ATOMIC_RELEASE) == FUTEX_CONTENDED) {
+        futex_wake(&thelock->state, 1);
+    }
+}
+
+#elif defined(USE_SEMAPHORES)
 
 /*
  * Lock support.
@@ -533,7 +756,7 @@ PyThread_release_lock(PyThread_type_lock lock)
     CHECK_STATUS("sem_post");
 }
 
-#else /* USE_SEMAPHORES */
+#else /* !USE_FUTEX_LOCKS && !USE_SEMAPHORES */
 
 /*
  * Lock support.
@@ -692,7 +915,7 @@ PyThread_release_lock(PyThread_type_lock lock)
     CHECK_STATUS_PTHREAD("pthread_mutex_unlock[3]");
 }
 
-#endif /* USE_SEMAPHORES */
+#endif /* !USE_FUTEX_LOCKS && !USE_SEMAPHORES */
 
 int
 _PyThread_at_fork_reinit(PyThread_type_lock *lock)
@@ -1,5 +1,4 @@
-/* This file contains code shared by the compiler and the peephole
-   optimizer.
+/* This file contains code used by the compiler to encode instructions.
  */
 
 #ifdef WORDS_BIGENDIAN
@@ -540,6 +540,10 @@ def main():
                       action="store", type="float", dest="switch_interval", default=None,
                       help="sys.setswitchinterval() value "
                            "(Python 3.2 and newer)")
+    parser.add_option("-G", "--gil-mode",
+                      action="store", type="choice", dest="gil_mode",
+                      choices=["default", "fifo", "priority"], default=None,
+                      help="sys._setgilmode() value (CPython 3.10 and newer)")
     parser.add_option("-n", "--num-threads",
                       action="store", type="int", dest="nthreads", default=4,
                       help="max number of threads in tests")
@@ -572,6 +576,8 @@ def main():
         sys.setcheckinterval(options.check_interval)
     if options.switch_interval:
         sys.setswitchinterval(options.switch_interval)
+    if options.gil_mode:
+        sys._setgilmode(options.gil_mode)
 
     print("== %s %s (%s) ==" % (
         platform.python_implementation(),